@@ -0,0 +1,191 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks guarding the number of memory allocations in hot paths.
+ */
+
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/filepath.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/util.h"
+#include "src/aurora/language.h"
+#include "src/aurora/locstring.h"
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/erffile.h"
+#include "src/aurora/gff3writer.h"
+
+#include "src/xml/gffdumper.h"
+
+#include "src/archives/util.h"
+
+#include "bench/benchmark.h"
+
+/** Listing the contents of an ERF archive, like unerf does. */
+class BenchmarkArchiveListing : public Bench::Benchmark {
+public:
+	BenchmarkArchiveListing(bool directories) :
+		Bench::Benchmark(directories ? "archive listing (directories)" : "archive listing", 50),
+		_directories(directories) {
+
+		setAllocationLimit(directories ? 3.0 : 20.0);
+	}
+
+	void setUp() {
+		static const Aurora::FileType kTypes[] = {
+			Aurora::kFileTypeUTC, Aurora::kFileTypeDLG, Aurora::kFileTypeNCS, Aurora::kFileTypeTGA
+		};
+
+		static const byte kData[] = { 0x00, 0x01, 0x02, 0x03 };
+
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+
+		{
+			Aurora::ERFWriter writer(MKTAG('E', 'R', 'F', ' '), kResourceCount, *_data);
+
+			for (size_t i = 0; i < kResourceCount; i++) {
+				Common::MemoryReadStream resource(kData);
+
+				writer.add(Common::UString::format("resource%05u", (uint) i), kTypes[i % ARRAYSIZE(kTypes)], resource);
+			}
+		}
+
+		_erf.reset(new Aurora::ERFFile(new Common::MemoryReadStream(_data->getData(), _data->size())));
+	}
+
+	void run() {
+		const Aurora::Archive::ResourceList &resources = _erf->getResources();
+
+		for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			const Aurora::FileType type = TypeMan.aliasFileType(r->type, Aurora::kGameIDUnknown);
+
+			Common::UString path = Archives::findPath(r->name, type, r->hash, _erf->getNameHashAlgo());
+			if (_directories)
+				continue;
+
+			Common::UString name = Common::FilePath::getStem(Common::FilePath::getFile(path));
+			Common::UString ext  = Common::FilePath::getExtension(path);
+		}
+	}
+
+	void tearDown() {
+		_erf.reset();
+		_data.reset();
+	}
+
+	size_t getDataSize() const {
+		return _data->size();
+	}
+
+	size_t getItemCount() const {
+		return kResourceCount;
+	}
+
+private:
+	static const size_t kResourceCount = 2000;
+
+	bool _directories;
+
+	Common::ScopedPtr<Common::MemoryWriteStreamDynamic> _data;
+	Common::ScopedPtr<Aurora::ERFFile> _erf;
+};
+
+/** Dumping a GFF3 into XML, like gff2xml does. */
+class BenchmarkGFF3Dump : public Bench::Benchmark {
+public:
+	BenchmarkGFF3Dump() : Bench::Benchmark("GFF3 dump to XML", 50) {
+		setAllocationLimit(24000.0);
+	}
+
+	void setUp() {
+		Aurora::GFF3Writer writer(MKTAG('U', 'T', 'C', ' '));
+
+		Aurora::GFF3WriterStructPtr top = writer.getTopLevel();
+		top->addExoString("Tag", "bench_creature");
+		top->addResRef("TemplateResRef", "bench_creature");
+
+		LangMan.declareLanguages(Aurora::kGameIDNWN);
+
+		Aurora::LocString name;
+		name.setString(Aurora::kLanguageEnglish, "A benchmarking creature");
+		top->addLocString("FirstName", name);
+
+		Aurora::GFF3WriterListPtr items = top->addList("ItemList");
+		for (uint32 i = 0; i < kStructCount; i++) {
+			Aurora::GFF3WriterStructPtr item = items->addStruct();
+
+			item->addResRef("InventoryRes", Common::UString::format("item%04u", i));
+			item->addUint16("Repos_PosX", i % 16);
+			item->addUint16("Repos_PosY", i / 16);
+			item->addSint32("StackSize", i);
+			item->addFloat("Weight", i * 0.5f);
+			item->addExoString("Comment", Common::UString::format("This is item number %u", i));
+			item->addVector("Position", i, i * 2.0f, i * 3.0f);
+
+			Aurora::GFF3WriterListPtr properties = item->addList("PropertiesList");
+			for (uint32 j = 0; j < 3; j++) {
+				Aurora::GFF3WriterStructPtr property = properties->addStruct();
+
+				property->addByte("PropertyName", j);
+				property->addUint16("Subtype", i + j);
+			}
+		}
+
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		writer.write(*_data);
+	}
+
+	void run() {
+		Common::MemoryReadStream input(_data->getData(), _data->size());
+
+		Common::ScopedPtr<XML::GFFDumper> dumper(XML::GFFDumper::identify(input));
+
+		Bench::NullWriteStream output;
+		dumper->dump(output, new Common::MemoryReadStream(_data->getData(), _data->size()),
+		             Common::kEncodingUTF8);
+	}
+
+	void tearDown() {
+		_data.reset();
+	}
+
+	size_t getDataSize() const {
+		return _data->size();
+	}
+
+private:
+	static const uint32 kStructCount = 200;
+
+	Common::ScopedPtr<Common::MemoryWriteStreamDynamic> _data;
+};
+
+int main(int argc, char **argv) {
+	Bench::Benchmarks benchmarks;
+
+	benchmarks.push_back(new BenchmarkArchiveListing(false));
+	benchmarks.push_back(new BenchmarkArchiveListing(true));
+	benchmarks.push_back(new BenchmarkGFF3Dump);
+
+	return Bench::benchmarkMain(argc, argv, benchmarks);
+}
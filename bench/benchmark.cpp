@@ -0,0 +1,256 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A small framework for our benchmarks.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <atomic>
+#include <chrono>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "bench/benchmark.h"
+
+/* Count all memory allocations, by replacing the global operator new.
+ * The counters are atomic, so that multithreaded code can be measured. */
+
+static std::atomic<size_t> kAllocationCount(0);
+static std::atomic<size_t> kAllocationSize (0);
+
+static void *countedAllocate(size_t size) {
+	kAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	kAllocationSize.fetch_add(size, std::memory_order_relaxed);
+
+	void *ptr = std::malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void *operator new(size_t size) {
+	return countedAllocate(size);
+}
+
+void *operator new[](size_t size) {
+	return countedAllocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+namespace Bench {
+
+size_t getAllocationCount() {
+	return kAllocationCount.load(std::memory_order_relaxed);
+}
+
+size_t getAllocationSize() {
+	return kAllocationSize.load(std::memory_order_relaxed);
+}
+
+
+NullWriteStream::NullWriteStream() : _size(0) {
+}
+
+NullWriteStream::~NullWriteStream() {
+}
+
+size_t NullWriteStream::write(const void *UNUSED(dataPtr), size_t dataSize) {
+	_size += dataSize;
+
+	return dataSize;
+}
+
+size_t NullWriteStream::size() const {
+	return _size;
+}
+
+
+Benchmark::Benchmark(const Common::UString &name, size_t iterations) : _name(name),
+	_iterations(iterations), _allocationLimit(0.0) {
+
+}
+
+Benchmark::~Benchmark() {
+}
+
+const Common::UString &Benchmark::getName() const {
+	return _name;
+}
+
+size_t Benchmark::getIterations() const {
+	return _iterations;
+}
+
+void Benchmark::setAllocationLimit(double limit) {
+	_allocationLimit = limit;
+}
+
+double Benchmark::getAllocationLimit() const {
+	return _allocationLimit;
+}
+
+void Benchmark::setUp() {
+}
+
+void Benchmark::tearDown() {
+}
+
+size_t Benchmark::getDataSize() const {
+	return 0;
+}
+
+size_t Benchmark::getItemCount() const {
+	return 1;
+}
+
+size_t Benchmark::getPixelCount() const {
+	return 0;
+}
+
+
+Result::Result() : seconds(0.0), iterations(0), allocations(0), allocatedBytes(0),
+	dataSize(0), itemCount(0), pixelCount(0) {
+
+}
+
+double Result::getMBPerSecond() const {
+	if (seconds <= 0.0)
+		return 0.0;
+
+	return (((double) dataSize) * iterations) / (1024.0 * 1024.0) / seconds;
+}
+
+double Result::getMegapixelsPerSecond() const {
+	if (seconds <= 0.0)
+		return 0.0;
+
+	return (((double) pixelCount) * iterations) / (1000.0 * 1000.0) / seconds;
+}
+
+double Result::getAllocationsPerItem() const {
+	if ((iterations == 0) || (itemCount == 0))
+		return 0.0;
+
+	return ((double) allocations) / (((double) iterations) * itemCount);
+}
+
+
+Result runBenchmark(Benchmark &benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	benchmark.setUp();
+
+	Result result;
+
+	result.iterations = benchmark.getIterations();
+	result.dataSize   = benchmark.getDataSize();
+	result.itemCount  = benchmark.getItemCount();
+	result.pixelCount = benchmark.getPixelCount();
+
+	const size_t allocationCount = getAllocationCount();
+	const size_t allocationSize  = getAllocationSize();
+
+	const Clock::time_point start = Clock::now();
+
+	for (size_t i = 0; i < result.iterations; i++)
+		benchmark.run();
+
+	const Clock::time_point end = Clock::now();
+
+	result.allocations    = getAllocationCount() - allocationCount;
+	result.allocatedBytes = getAllocationSize()  - allocationSize;
+
+	result.seconds = std::chrono::duration<double>(end - start).count();
+
+	benchmark.tearDown();
+
+	return result;
+}
+
+bool runBenchmarks(Benchmarks &benchmarks, const Common::UString &filter) {
+	std::printf("%-40s | %6s | %12s | %10s | %10s | %12s | %12s\n", "Benchmark", "Iter",
+	            "ms/iter", "MB/s", "MP/s", "allocs/item", "limit");
+	std::printf("%s\n", Common::UString('=', 40 + 6 + 12 + 10 + 10 + 12 + 12 + 6 * 3).c_str());
+
+	bool success = true;
+	for (Benchmarks::iterator b = benchmarks.begin(); b != benchmarks.end(); ++b) {
+		if (!filter.empty() && !(*b)->getName().contains(filter))
+			continue;
+
+		const Result result = runBenchmark(**b);
+
+		const double limit          = (*b)->getAllocationLimit();
+		const double allocsPerItem  = result.getAllocationsPerItem();
+		const bool   exceedsLimit   = (limit > 0.0) && (allocsPerItem > limit);
+
+		const double msPerIteration = (result.seconds * 1000.0) / MAX<size_t>(result.iterations, 1);
+
+		const Common::UString limitString = (limit > 0.0) ? Common::UString::format("%12.1f", limit) : "-";
+		const Common::UString mpString    = (result.pixelCount > 0) ?
+			Common::UString::format("%10.2f", result.getMegapixelsPerSecond()) : "-";
+
+		std::printf("%-40s | %6u | %12.3f | %10.2f | %10s | %12.1f | %12s%s\n", (*b)->getName().c_str(),
+		            (uint) result.iterations, msPerIteration, result.getMBPerSecond(), mpString.c_str(),
+		            allocsPerItem, limitString.c_str(), exceedsLimit ? "  EXCEEDED" : "");
+
+		success = success && !exceedsLimit;
+	}
+
+	return success;
+}
+
+int benchmarkMain(int argc, char **argv, Benchmarks &benchmarks) {
+	if ((argc > 2) || ((argc == 2) && (!std::strcmp(argv[1], "-h") || !std::strcmp(argv[1], "--help")))) {
+		std::printf("Usage: %s [<filter>]\n\n", argv[0]);
+		std::printf("Run all benchmarks whose name contains <filter>.\n");
+		std::printf("Fails if any benchmark exceeds its allocation limit.\n");
+		return (argc == 2) ? 0 : 1;
+	}
+
+	try {
+		const Common::UString filter = (argc == 2) ? argv[1] : "";
+
+		if (!runBenchmarks(benchmarks, filter)) {
+			std::printf("\nAllocation limits exceeded\n");
+			return 1;
+		}
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+	}
+
+	return 0;
+}
+
+} // End of namespace Bench
@@ -0,0 +1,143 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A small framework for our benchmarks.
+ */
+
+#ifndef BENCH_BENCHMARK_H
+#define BENCH_BENCHMARK_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/ptrvector.h"
+#include "src/common/writestream.h"
+
+namespace Bench {
+
+/** Return the number of memory allocations done so far. */
+size_t getAllocationCount();
+/** Return the number of bytes allocated so far. */
+size_t getAllocationSize();
+
+/** A write stream that throws away all data written into it. */
+class NullWriteStream : public Common::WriteStream {
+public:
+	NullWriteStream();
+	~NullWriteStream();
+
+	size_t write(const void *dataPtr, size_t dataSize);
+
+	/** Return the number of bytes written into the stream so far. */
+	size_t size() const;
+
+private:
+	size_t _size;
+};
+
+/** The base class for a single benchmark.
+ *
+ *  A benchmark runs a piece of code, run(), for a number of iterations,
+ *  measuring the time taken and the number of memory allocations done.
+ *  Preparing the benchmark data in setUp() and cleaning up in tearDown()
+ *  is not measured.
+ *
+ *  Each iteration processes a number of items (files, resources, strings,
+ *  ...) and a number of bytes. These are used to report the throughput
+ *  and the allocations per item. Image benchmarks can additionally
+ *  report the number of pixels, for a throughput in megapixels.
+ *
+ *  A benchmark can additionally have an allocation limit, in allocations
+ *  per item. When the limit is exceeded, the benchmark fails. This can
+ *  be used to guard against regressions in hot paths.
+ */
+class Benchmark : boost::noncopyable {
+public:
+	Benchmark(const Common::UString &name, size_t iterations);
+	virtual ~Benchmark();
+
+	const Common::UString &getName() const;
+	size_t getIterations() const;
+
+	/** Set the maximum number of allocations per item. 0 means no limit. */
+	void setAllocationLimit(double limit);
+	double getAllocationLimit() const;
+
+	/** Prepare the benchmark data. */
+	virtual void setUp();
+	/** Run one iteration of the benchmark. */
+	virtual void run() = 0;
+	/** Clean up the benchmark data. */
+	virtual void tearDown();
+
+	/** Return the number of bytes processed in one iteration. */
+	virtual size_t getDataSize() const;
+	/** Return the number of items processed in one iteration. */
+	virtual size_t getItemCount() const;
+	/** Return the number of image pixels processed in one iteration, if any. */
+	virtual size_t getPixelCount() const;
+
+private:
+	Common::UString _name;
+
+	size_t _iterations;
+	double _allocationLimit;
+};
+
+/** The measured results of a benchmark. */
+struct Result {
+	double seconds;        ///< Time taken by all iterations.
+	size_t iterations;     ///< Number of iterations run.
+	size_t allocations;    ///< Number of allocations done by all iterations.
+	size_t allocatedBytes; ///< Number of bytes allocated by all iterations.
+
+	size_t dataSize;  ///< Number of bytes processed in one iteration.
+	size_t itemCount; ///< Number of items processed in one iteration.
+
+	size_t pixelCount; ///< Number of image pixels processed in one iteration.
+
+	Result();
+
+	double getMBPerSecond() const;
+	double getMegapixelsPerSecond() const;
+	double getAllocationsPerItem() const;
+};
+
+typedef Common::PtrVector<Benchmark> Benchmarks;
+
+/** Run a single benchmark and return the measured results. */
+Result runBenchmark(Benchmark &benchmark);
+
+/** Run all benchmarks whose name contains the filter and print a report to stdout.
+ *
+ *  @return true if all benchmarks stayed within their allocation limits.
+ */
+bool runBenchmarks(Benchmarks &benchmarks, const Common::UString &filter = "");
+
+/** Parse the command line of a benchmark program, run the benchmarks and return the exit code. */
+int benchmarkMain(int argc, char **argv, Benchmarks &benchmarks);
+
+} // End of namespace Bench
+
+#endif // BENCH_BENCHMARK_H
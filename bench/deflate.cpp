@@ -0,0 +1,343 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Throughput benchmarks for DEFLATE decompression and CRC-32 checksums.
+ *
+ *  The corpora are compressed with zlib in setUp() and then decompressed
+ *  with decompressDeflate(), which uses the one-shot decoder when the
+ *  output size is known. As a baseline, the same data is decompressed
+ *  with zlib's streaming inflate(), the way decompressDeflate() did
+ *  before, including the allocation of the output buffer.
+ *
+ *  Small resources, like the ones found in ERF archives, and large blobs
+ *  are measured separately, since the setup cost of the decoder matters
+ *  more for the former.
+ *
+ *  ZIP archives additionally checksum every decompressed file with CRC-32,
+ *  so calcCRC32() is measured over the uncompressed corpora, against zlib's
+ *  crc32() as a baseline.
+ */
+
+#include <cstring>
+
+#include <zlib.h>
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/deflate.h"
+#include "src/common/crc32.h"
+
+#include "bench/benchmark.h"
+
+/** Number of uncompressed bytes each benchmark should roughly process over all its iterations. */
+static const size_t kByteBudget = 256 * 1024 * 1024;
+
+/** The kinds of data we compress. */
+enum CorpusKind {
+	kCorpusText,   ///< Text, like scripts, 2DA and XML files.
+	kCorpusBinary, ///< Binary structures with a lot of repetition, like models.
+	kCorpusNoise   ///< Data that's hard to compress, like already compressed textures.
+};
+
+/** A corpus description. */
+struct CorpusDescription {
+	const char *name;
+
+	CorpusKind kind;
+
+	size_t fileSize;  ///< Size of a single uncompressed file.
+	size_t fileCount; ///< Number of files in the corpus.
+};
+
+static const CorpusDescription kCorpora[] = {
+	{ "text small"  , kCorpusText  ,        4096, 256 },
+	{ "text large"  , kCorpusText  , 1024 * 1024,   4 },
+	{ "binary small", kCorpusBinary,        4096, 256 },
+	{ "binary large", kCorpusBinary, 1024 * 1024,   4 },
+	{ "noise large" , kCorpusNoise , 1024 * 1024,   4 }
+};
+
+static const char *kWords[] = {
+	"the", "of", "and", "a", "to", "in", "is", "you", "that", "it", "he", "was", "for", "on",
+	"are", "as", "with", "his", "they", "at", "be", "this", "have", "from", "or", "one", "had",
+	"by", "word", "but", "not", "what", "all", "were", "we", "when", "your", "can", "said",
+	"GetObjectByTag", "SetLocalInt", "ActionStartConversation", "OBJECT_SELF", "int", "void",
+	"object", "string", "float", "return", "if", "else", "while", "<struct", "</struct>",
+	"<uint32", "label=\"", "\">", "</uint32>", "****", "Appearance_Type", "0x0000"
+};
+
+/** A set of compressed files. */
+class Corpus : boost::noncopyable {
+public:
+	Corpus(const CorpusDescription &description) : _description(&description) {
+	}
+
+	Common::UString getName() const {
+		return _description->name;
+	}
+
+	size_t getFileSize() const {
+		return _description->fileSize;
+	}
+
+	size_t getFileCount() const {
+		return _description->fileCount;
+	}
+
+	size_t getIterations() const {
+		return MAX<size_t>(1, kByteBudget / (getFileSize() * getFileCount()));
+	}
+
+	const std::vector<byte> &getCompressed(size_t i) const {
+		return _compressed[i];
+	}
+
+	const std::vector<byte> &getUncompressed(size_t i) const {
+		return _uncompressed[i];
+	}
+
+	/** Create and compress the files. */
+	void create() {
+		_uncompressed.resize(getFileCount());
+		_compressed.resize(getFileCount());
+
+		uint32 seed = 0xC0FFEE;
+		for (size_t i = 0; i < getFileCount(); i++) {
+			createFile(_uncompressed[i], seed);
+			compressFile(_uncompressed[i], _compressed[i]);
+		}
+	}
+
+	void clear() {
+		_uncompressed.clear();
+		_compressed.clear();
+	}
+
+private:
+	const CorpusDescription *_description;
+
+	std::vector< std::vector<byte> > _uncompressed;
+	std::vector< std::vector<byte> > _compressed;
+
+	static uint32 random(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	void createFile(std::vector<byte> &data, uint32 &seed) const {
+		data.resize(getFileSize());
+
+		size_t n = 0;
+		while (n < data.size()) {
+			switch (_description->kind) {
+				case kCorpusText: {
+					const char *word = kWords[random(seed) % ARRAYSIZE(kWords)];
+					for (; *word && (n < data.size()); word++)
+						data[n++] = *word;
+
+					if (n < data.size())
+						data[n++] = ((random(seed) % 12) == 0) ? '\n' : ' ';
+					break;
+				}
+
+				case kCorpusBinary: {
+					// A "vertex": three floats with few distinct values and some flags
+					for (size_t i = 0; (i < 16) && (n < data.size()); i++, n++)
+						data[n] = (i % 4 == 3) ? (random(seed) % 4) : ((n >> 6) ^ i) & 0x7F;
+					break;
+				}
+
+				case kCorpusNoise:
+					data[n++] = random(seed) & 0xFF;
+					break;
+			}
+		}
+	}
+
+	static void compressFile(const std::vector<byte> &data, std::vector<byte> &compressed) {
+		z_stream strm;
+		std::memset(&strm, 0, sizeof(strm));
+
+		if (deflateInit2(&strm, Z_BEST_COMPRESSION, Z_DEFLATED, Common::kWindowBitsMaxRaw, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw Common::Exception("Failed to initialize zlib deflate");
+
+		compressed.resize(deflateBound(&strm, data.size()));
+
+		strm.next_in   = const_cast<byte *>(&data[0]);
+		strm.avail_in  = data.size();
+		strm.next_out  = &compressed[0];
+		strm.avail_out = compressed.size();
+
+		const int zResult = deflate(&strm, Z_FINISH);
+
+		compressed.resize(strm.total_out);
+		deflateEnd(&strm);
+
+		if (zResult != Z_STREAM_END)
+			throw Common::Exception("Failed to deflate: %d", zResult);
+	}
+};
+
+typedef Common::PtrVector<Corpus> Corpora;
+
+
+// --- Benchmarks ---
+
+/** Base class for benchmarks working on one corpus. Items are files, the data size is uncompressed. */
+class BenchmarkDeflate : public Bench::Benchmark {
+public:
+	BenchmarkDeflate(const Common::UString &operation, Corpus &corpus) :
+		Bench::Benchmark(operation + " " + corpus.getName(), corpus.getIterations()), _corpus(&corpus) {
+	}
+
+	void setUp() {
+		_corpus->create();
+	}
+
+	void tearDown() {
+		_corpus->clear();
+	}
+
+	size_t getDataSize() const {
+		return _corpus->getFileSize() * _corpus->getFileCount();
+	}
+
+	size_t getItemCount() const {
+		return _corpus->getFileCount();
+	}
+
+protected:
+	Corpus *_corpus;
+};
+
+/** Decompressing with decompressDeflate(), like the archive readers do. */
+class BenchmarkDecompressDeflate : public BenchmarkDeflate {
+public:
+	BenchmarkDecompressDeflate(Corpus &corpus) : BenchmarkDeflate("decompressDeflate", corpus) {
+		setAllocationLimit(2.0);
+	}
+
+	void run() {
+		for (size_t i = 0; i < _corpus->getFileCount(); i++) {
+			const std::vector<byte> &compressed = _corpus->getCompressed(i);
+
+			Common::ScopedArray<byte> data(Common::decompressDeflate(&compressed[0], compressed.size(),
+			                               _corpus->getFileSize(), Common::kWindowBitsMaxRaw));
+		}
+	}
+};
+
+/** Decompressing with zlib's streaming inflate(), as a baseline. */
+class BenchmarkZlibInflate : public BenchmarkDeflate {
+public:
+	BenchmarkZlibInflate(Corpus &corpus) : BenchmarkDeflate("zlib inflate", corpus) {
+	}
+
+	void run() {
+		for (size_t i = 0; i < _corpus->getFileCount(); i++) {
+			const std::vector<byte> &compressed = _corpus->getCompressed(i);
+
+			Common::ScopedArray<byte> data(new byte[_corpus->getFileSize()]);
+
+			z_stream strm;
+			std::memset(&strm, 0, sizeof(strm));
+
+			if (inflateInit2(&strm, Common::kWindowBitsMaxRaw) != Z_OK)
+				throw Common::Exception("Failed to initialize zlib inflate");
+
+			strm.next_in   = const_cast<byte *>(&compressed[0]);
+			strm.avail_in  = compressed.size();
+			strm.next_out  = data.get();
+			strm.avail_out = _corpus->getFileSize();
+
+			const int zResult = inflate(&strm, Z_FINISH);
+			inflateEnd(&strm);
+
+			if (zResult != Z_STREAM_END)
+				throw Common::Exception("Failed to inflate: %d", zResult);
+		}
+	}
+};
+
+/** Checksumming with calcCRC32(), like the ZIP reader does. */
+class BenchmarkCRC32 : public BenchmarkDeflate {
+public:
+	BenchmarkCRC32(Corpus &corpus) : BenchmarkDeflate("calcCRC32", corpus), _crc(0) {
+	}
+
+	void run() {
+		for (size_t i = 0; i < _corpus->getFileCount(); i++) {
+			const std::vector<byte> &data = _corpus->getUncompressed(i);
+
+			_crc ^= Common::calcCRC32(&data[0], data.size());
+		}
+	}
+
+private:
+	uint32 _crc;
+};
+
+/** Checksumming with zlib's crc32(), as a baseline. */
+class BenchmarkZlibCRC32 : public BenchmarkDeflate {
+public:
+	BenchmarkZlibCRC32(Corpus &corpus) : BenchmarkDeflate("zlib crc32", corpus), _crc(0) {
+	}
+
+	void run() {
+		for (size_t i = 0; i < _corpus->getFileCount(); i++) {
+			const std::vector<byte> &data = _corpus->getUncompressed(i);
+
+			_crc ^= crc32(0, &data[0], data.size());
+		}
+	}
+
+private:
+	uLong _crc;
+};
+
+
+int main(int argc, char **argv) {
+	Corpora corpora;
+
+	for (size_t i = 0; i < ARRAYSIZE(kCorpora); i++)
+		corpora.push_back(new Corpus(kCorpora[i]));
+
+	Bench::Benchmarks benchmarks;
+
+	for (Corpora::iterator c = corpora.begin(); c != corpora.end(); ++c)
+		benchmarks.push_back(new BenchmarkZlibInflate(**c));
+	for (Corpora::iterator c = corpora.begin(); c != corpora.end(); ++c)
+		benchmarks.push_back(new BenchmarkDecompressDeflate(**c));
+	for (Corpora::iterator c = corpora.begin(); c != corpora.end(); ++c)
+		benchmarks.push_back(new BenchmarkZlibCRC32(**c));
+	for (Corpora::iterator c = corpora.begin(); c != corpora.end(); ++c)
+		benchmarks.push_back(new BenchmarkCRC32(**c));
+
+	return Bench::benchmarkMain(argc, argv, benchmarks);
+}
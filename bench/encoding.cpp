@@ -0,0 +1,437 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Throughput benchmarks for the string encoding conversions.
+ *
+ *  The corpus consists of short names, about the size of a ResRef, and
+ *  longer lines of dialog in the languages the games were localized into.
+ *  Every encoding is measured with the languages it can represent.
+ *
+ *  readString(), readStringFixed(), convertString() and hashString()
+ *  are measured over the public encoding API, so a different conversion
+ *  backend behind it can be compared directly. As a baseline, decoding
+ *  with plain iconv() into a preallocated buffer is measured as well.
+ */
+
+#include <cstring>
+#include <cerrno>
+
+#include <iconv.h>
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/encoding.h"
+#include "src/common/hash.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "bench/benchmark.h"
+
+/** Number of encoded bytes each benchmark should roughly process over all its iterations. */
+static const size_t kByteBudget = 1024 * 1024;
+
+/** Number of strings in one iteration. */
+static const size_t kStringCount = 512;
+
+/** A text sample in one language. */
+struct Sample {
+	const char *language;
+
+	const char *shortText; ///< A name, about the size of a ResRef.
+	const char *longText;  ///< A line of dialog.
+};
+
+enum Language {
+	kLanguageEnglish            = 1 << 0,
+	kLanguageFrench             = 1 << 1,
+	kLanguageGerman             = 1 << 2,
+	kLanguagePolish             = 1 << 3,
+	kLanguageRussian            = 1 << 4,
+	kLanguageJapanese           = 1 << 5,
+	kLanguageChineseSimplified  = 1 << 6,
+	kLanguageKorean             = 1 << 7,
+	kLanguageChineseTraditional = 1 << 8,
+
+	kLanguageAll                = 0x1FF
+};
+
+/** The samples, in UTF-8, in the order of the Language enum. */
+static const Sample kSamples[] = {
+	{
+		"English",
+		"tavern_door01",
+		"Greetings, traveller. The roads north of the city have grown dangerous since the bandits took the old mill. If you would clear them out, the merchants' guild will pay handsomely."
+	},
+	{
+		"French",
+		"\xC3\x89""p\xC3\xA9""e du h\xC3\xA9""ros",
+		"Bonjour, voyageur ! Les routes au nord de la cit\xC3\xA9"" sont devenues dangereuses depuis que des brigands ont pris le vieux moulin. La guilde des marchands paiera 500 \xE2\x82\xAC"" \xC3\xA0"" qui les chassera."
+	},
+	{
+		"German",
+		"Gr\xC3\xB6""\xC3\x9F""e St\xC3\xA4""rke",
+		"Gr\xC3\xBC""\xC3\x9F"" Gott, Reisender! Die Stra\xC3\x9F""en n\xC3\xB6""rdlich der Stadt sind gef\xC3\xA4""hrlich geworden, seit R\xC3\xA4""uber die alte M\xC3\xBC""hle besetzt haben. Die H\xC3\xA4""ndlergilde zahlt gro\xC3\x9F""z\xC3\xBC""gig f\xC3\xBC""r ihre Vertreibung."
+	},
+	{
+		"Polish",
+		"Miecz \xC5\x82""owcy",
+		"Witaj, w\xC4\x99""drowcze! Drogi na p\xC3\xB3""\xC5\x82""noc od miasta sta\xC5\x82""y si\xC4\x99"" niebezpieczne, odk\xC4\x85""d zb\xC3\xB3""je zaj\xC4\x99""li stary m\xC5\x82""yn. Gildia kupc\xC3\xB3""w sowicie zap\xC5\x82""aci za ich przep\xC4\x99""dzenie."
+	},
+	{
+		"Russian",
+		"\xD0\x9C""\xD0\xB5""\xD1\x87"" \xD0\xB3""\xD0\xB5""\xD1\x80""\xD0\xBE""\xD1\x8F",
+		"\xD0\x9F""\xD1\x80""\xD0\xB8""\xD0\xB2""\xD0\xB5""\xD1\x82""\xD1\x81""\xD1\x82""\xD0\xB2""\xD1\x83""\xD1\x8E"", \xD0\xBF""\xD1\x83""\xD1\x82""\xD0\xBD""\xD0\xB8""\xD0\xBA""! \xD0\x94""\xD0\xBE""\xD1\x80""\xD0\xBE""\xD0\xB3""\xD0\xB8"" \xD0\xBA"" \xD1\x81""\xD0\xB5""\xD0\xB2""\xD0\xB5""\xD1\x80""\xD1\x83"" \xD0\xBE""\xD1\x82"" \xD0\xB3""\xD0\xBE""\xD1\x80""\xD0\xBE""\xD0\xB4""\xD0\xB0"" \xD1\x81""\xD1\x82""\xD0\xB0""\xD0\xBB""\xD0\xB8"" \xD0\xBE""\xD0\xBF""\xD0\xB0""\xD1\x81""\xD0\xBD""\xD1\x8B"" \xD1\x81"" \xD1\x82""\xD0\xB5""\xD1\x85"" \xD0\xBF""\xD0\xBE""\xD1\x80"", \xD0\xBA""\xD0\xB0""\xD0\xBA"" \xD1\x80""\xD0\xB0""\xD0\xB7""\xD0\xB1""\xD0\xBE""\xD0\xB9""\xD0\xBD""\xD0\xB8""\xD0\xBA""\xD0\xB8"" \xD0\xB7""\xD0\xB0""\xD1\x85""\xD0\xB2""\xD0\xB0""\xD1\x82""\xD0\xB8""\xD0\xBB""\xD0\xB8"" \xD1\x81""\xD1\x82""\xD0\xB0""\xD1\x80""\xD1\x83""\xD1\x8E"" \xD0\xBC""\xD0\xB5""\xD0\xBB""\xD1\x8C""\xD0\xBD""\xD0\xB8""\xD1\x86""\xD1\x83"". \xD0\x93""\xD0\xB8""\xD0\xBB""\xD1\x8C""\xD0\xB4""\xD0\xB8""\xD1\x8F"" \xD1\x82""\xD0\xBE""\xD1\x80""\xD0\xB3""\xD0\xBE""\xD0\xB2""\xD1\x86""\xD0\xB5""\xD0\xB2"" \xD1\x89""\xD0\xB5""\xD0\xB4""\xD1\x80""\xD0\xBE"" \xD0\xB7""\xD0\xB0""\xD0\xBF""\xD0\xBB""\xD0\xB0""\xD1\x82""\xD0\xB8""\xD1\x82"" \xD0\xB7""\xD0\xB0"" \xD0\xB8""\xD1\x85"" \xD0\xB8""\xD0\xB7""\xD0\xB3""\xD0\xBD""\xD0\xB0""\xD0\xBD""\xD0\xB8""\xD0\xB5""."
+	},
+	{
+		"Japanese",
+		"\xE5\x8B\x87""\xE8\x80\x85""\xE3\x81\xAE""\xE5\x89\xA3",
+		"\xE3\x82\x88""\xE3\x81\x86""\xE3\x81\x93""\xE3\x81\x9D""\xE3\x80\x81""\xE6\x97\x85""\xE3\x81\xAE""\xE6\x96\xB9""\xE3\x80\x82""\xE7\x94\xBA""\xE3\x81\xAE""\xE5\x8C\x97""\xE3\x81\xAE""\xE8\xA1\x97""\xE9\x81\x93""\xE3\x81\xAF""\xE3\x80\x81""\xE7\x9B\x97""\xE8\xB3\x8A""\xE3\x81\x8C""\xE5\x8F\xA4""\xE3\x81\x84""\xE6\xB0\xB4""\xE8\xBB\x8A""\xE5\xB0\x8F""\xE5\xB1\x8B""\xE3\x82\x92""\xE5\x8D\xA0""\xE6\x8B\xA0""\xE3\x81\x97""\xE3\x81\xA6""\xE3\x81\x8B""\xE3\x82\x89""\xE5\x8D\xB1""\xE9\x99\xBA""\xE3\x81\xAB""\xE3\x81\xAA""\xE3\x82\x8A""\xE3\x81\xBE""\xE3\x81\x97""\xE3\x81\x9F""\xE3\x80\x82""\xE5\xBD\xBC""\xE3\x82\x89""\xE3\x82\x92""\xE8\xBF\xBD""\xE3\x81\x84""\xE6\x89\x95""\xE3\x81\xA3""\xE3\x81\xA6""\xE3\x81\x8F""\xE3\x81\xA0""\xE3\x81\x95""\xE3\x82\x8C""\xE3\x81\xB0""\xE3\x80\x81""\xE5\x95\x86""\xE4\xBA\xBA""\xE3\x82\xAE""\xE3\x83\xAB""\xE3\x83\x89""\xE3\x81\x8C""\xE5\x8D\x81""\xE5\x88\x86""\xE3\x81\xAA""\xE5\xA0\xB1""\xE9\x85\xAC""\xE3\x82\x92""\xE6\x94\xAF""\xE6\x89\x95""\xE3\x81\x84""\xE3\x81\xBE""\xE3\x81\x99""\xE3\x80\x82"
+	},
+	{
+		"Simplified Chinese",
+		"\xE5\x8B\x87""\xE8\x80\x85""\xE4\xB9\x8B""\xE5\x89\x91",
+		"\xE6\xAC\xA2""\xE8\xBF\x8E""\xE4\xBD\xA0""\xEF\xBC\x8C""\xE6\x97\x85""\xE8\xA1\x8C""\xE8\x80\x85""\xE3\x80\x82""\xE8\x87\xAA""\xE4\xBB\x8E""\xE5\xBC\xBA""\xE7\x9B\x97""\xE5\x8D\xA0""\xE6\x8D\xAE""\xE4\xBA\x86""\xE6\x97\xA7""\xE7\xA3\xA8""\xE5\x9D\x8A""\xE4\xBB\xA5""\xE6\x9D\xA5""\xEF\xBC\x8C""\xE5\x9F\x8E""\xE5\x8C\x97""\xE7\x9A\x84""\xE9\x81\x93""\xE8\xB7\xAF""\xE5\x8F\x98""\xE5\xBE\x97""\xE5\x8D\x81""\xE5\x88\x86""\xE5\x8D\xB1""\xE9\x99\xA9""\xE3\x80\x82""\xE5\xA6\x82""\xE6\x9E\x9C""\xE4\xBD\xA0""\xE8\x83\xBD""\xE6\x8A\x8A""\xE4\xBB\x96""\xE4\xBB\xAC""\xE8\xB5\xB6""\xE8\xB5\xB0""\xEF\xBC\x8C""\xE5\x95\x86""\xE4\xBC\x9A""\xE5\xB0\x86""\xE4\xBC\x9A""\xE9\x87\x8D""\xE9\x87\x91""\xE9\x85\xAC""\xE8\xB0\xA2""\xE3\x80\x82"
+	},
+	{
+		"Korean",
+		"\xEC\x9A\xA9""\xEC\x82\xAC""\xEC\x9D\x98"" \xEA\xB2\x80",
+		"\xEC\x96\xB4""\xEC\x84\x9C"" \xEC\x98\xA4""\xEA\xB2\x8C"", \xEC\x97\xAC""\xED\x96\x89""\xEC\x9E\x90""\xEC\x97\xAC"". \xEB\x8F\x84""\xEC\xA0\x81""\xEB\x93\xA4""\xEC\x9D\xB4"" \xEB\x82\xA1""\xEC\x9D\x80"" \xEB\xB0\xA9""\xEC\x95\x97""\xEA\xB0\x84""\xEC\x9D\x84"" \xEC\xA0\x90""\xEA\xB1\xB0""\xED\x95\x9C"" \xEB\x92\xA4""\xEB\xA1\x9C"" \xEB\x8F\x84""\xEC\x8B\x9C"" \xEB\xB6\x81""\xEC\xAA\xBD"" \xEA\xB8\xB8""\xEC\x9D\xB4"" \xEC\x9C\x84""\xED\x97\x98""\xED\x95\xB4""\xEC\xA1\x8C""\xEB\x8B\xA4""\xEB\x84\xA4"". \xEA\xB7\xB8""\xEB\x93\xA4""\xEC\x9D\x84"" \xEC\xAB\x93""\xEC\x95\x84""\xEB\x82\xB4"" \xEC\xA4\x80""\xEB\x8B\xA4""\xEB\xA9\xB4"" \xEC\x83\x81""\xEC\x9D\xB8"" \xEC\xA1\xB0""\xED\x95\xA9""\xEC\x9D\xB4"" \xED\x9B\x84""\xED\x95\x98""\xEA\xB2\x8C"" \xEB\xB3\xB4""\xEC\x83\x81""\xED\x95\xA0"" \xEA\xB1\xB8""\xEC\x84\xB8""."
+	},
+	{
+		"Traditional Chinese",
+		"\xE5\x8B\x87""\xE8\x80\x85""\xE4\xB9\x8B""\xE5\x8A\x8D",
+		"\xE6\xAD\xA1""\xE8\xBF\x8E""\xE4\xBD\xA0""\xEF\xBC\x8C""\xE6\x97\x85""\xE8\xA1\x8C""\xE8\x80\x85""\xE3\x80\x82""\xE8\x87\xAA""\xE5\xBE\x9E""\xE5\xBC\xB7""\xE7\x9B\x9C""\xE4\xBD\x94""\xE6\x93\x9A""\xE4\xBA\x86""\xE8\x88\x8A""\xE7\xA3\xA8""\xE5\x9D\x8A""\xE4\xBB\xA5""\xE4\xBE\x86""\xEF\xBC\x8C""\xE5\x9F\x8E""\xE5\x8C\x97""\xE7\x9A\x84""\xE9\x81\x93""\xE8\xB7\xAF""\xE8\xAE\x8A""\xE5\xBE\x97""\xE5\x8D\x81""\xE5\x88\x86""\xE5\x8D\xB1""\xE9\x9A\xAA""\xE3\x80\x82""\xE5\xA6\x82""\xE6\x9E\x9C""\xE4\xBD\xA0""\xE8\x83\xBD""\xE6\x8A\x8A""\xE4\xBB\x96""\xE5\x80\x91""\xE8\xB6\x95""\xE8\xB5\xB0""\xEF\xBC\x8C""\xE5\x95\x86""\xE6\x9C\x83""\xE5\xB0\x87""\xE6\x9C\x83""\xE9\x87\x8D""\xE9\x87\x91""\xE9\x85\xAC""\xE8\xAC\x9D""\xE3\x80\x82"
+	},
+};
+
+/** An encoding, and the languages it can represent. */
+struct EncodingCorpus {
+	Common::Encoding encoding;
+	uint32 languages;
+
+	const char *iconvName; ///< The name iconv knows this encoding under.
+};
+
+static const EncodingCorpus kCorpora[] = {
+	{ Common::kEncodingASCII  , kLanguageEnglish                                          , "ASCII"        },
+	{ Common::kEncodingUTF8   , kLanguageAll                                              , "UTF-8"        },
+	{ Common::kEncodingUTF16LE, kLanguageAll                                              , "UTF-16LE"     },
+	{ Common::kEncodingUTF16BE, kLanguageAll                                              , "UTF-16BE"     },
+	{ Common::kEncodingLatin9 , kLanguageEnglish | kLanguageFrench | kLanguageGerman      , "ISO-8859-15"  },
+	{ Common::kEncodingCP1250 , kLanguageEnglish | kLanguagePolish                        , "WINDOWS-1250" },
+	{ Common::kEncodingCP1251 , kLanguageEnglish | kLanguageRussian                       , "WINDOWS-1251" },
+	{ Common::kEncodingCP1252 , kLanguageEnglish | kLanguageFrench | kLanguageGerman      , "WINDOWS-1252" },
+	{ Common::kEncodingCP932  , kLanguageEnglish | kLanguageJapanese                      , "CP932"        },
+	{ Common::kEncodingCP936  , kLanguageEnglish | kLanguageChineseSimplified             , "CP936"        },
+	{ Common::kEncodingCP949  , kLanguageEnglish | kLanguageKorean                        , "CP949"        },
+	{ Common::kEncodingCP950  , kLanguageEnglish | kLanguageChineseTraditional            , "CP950"        }
+};
+
+/** A set of strings in one encoding, both as UString and encoded. */
+class StringSet : boost::noncopyable {
+public:
+	StringSet(const EncodingCorpus &corpus, bool longText) : _corpus(&corpus), _longText(longText) {
+	}
+
+	Common::Encoding getEncoding() const {
+		return _corpus->encoding;
+	}
+
+	const char *getIconvName() const {
+		return _corpus->iconvName;
+	}
+
+	Common::UString getName() const {
+		return Common::getEncodingName(_corpus->encoding) + (_longText ? " long" : " short");
+	}
+
+	/** Create the strings, cycling through the samples of the corpus' languages. */
+	void create() {
+		std::vector<const char *> samples;
+		getSamples(samples);
+
+		_strings.clear();
+		_lengths.clear();
+
+		Common::MemoryWriteStreamDynamic encoded(true);
+		Common::MemoryWriteStreamDynamic terminated(true);
+
+		for (size_t i = 0; i < kStringCount; i++) {
+			_strings.push_back(samples[i % samples.size()]);
+
+			_lengths.push_back(Common::writeString(encoded, _strings.back(), _corpus->encoding, false));
+			Common::writeString(terminated, _strings.back(), _corpus->encoding, true);
+		}
+
+		_encoded.reset(new Common::MemoryReadStream(encoded.getData(), encoded.size(), true));
+		encoded.setDisposable(false);
+
+		_terminated.reset(new Common::MemoryReadStream(terminated.getData(), terminated.size(), true));
+		terminated.setDisposable(false);
+	}
+
+	void clear() {
+		_strings.clear();
+		_lengths.clear();
+
+		_encoded.reset();
+		_terminated.reset();
+	}
+
+	const std::vector<Common::UString> &getStrings() const {
+		return _strings;
+	}
+
+	/** Return the encoded lengths of all strings, in bytes, without terminator. */
+	const std::vector<size_t> &getLengths() const {
+		return _lengths;
+	}
+
+	/** Return all strings encoded back-to-back, without terminators. */
+	Common::MemoryReadStream &getEncoded() const {
+		return *_encoded;
+	}
+
+	/** Return all strings encoded back-to-back, each with a terminator. */
+	Common::MemoryReadStream &getTerminated() const {
+		return *_terminated;
+	}
+
+	/** Return a number of iterations that processes roughly the byte budget, measured in UTF-8. */
+	size_t getIterations() const {
+		std::vector<const char *> samples;
+		getSamples(samples);
+
+		size_t size = 0;
+		for (size_t i = 0; i < kStringCount; i++)
+			size += std::strlen(samples[i % samples.size()]);
+
+		return MAX<size_t>(2, kByteBudget / size);
+	}
+
+private:
+	const EncodingCorpus *_corpus;
+	bool _longText;
+
+	std::vector<Common::UString> _strings;
+	std::vector<size_t> _lengths;
+
+	Common::ScopedPtr<Common::MemoryReadStream> _encoded;
+	Common::ScopedPtr<Common::MemoryReadStream> _terminated;
+
+	void getSamples(std::vector<const char *> &samples) const {
+		for (size_t i = 0; i < ARRAYSIZE(kSamples); i++)
+			if (_corpus->languages & (1 << i))
+				samples.push_back(_longText ? kSamples[i].longText : kSamples[i].shortText);
+	}
+};
+
+typedef Common::PtrVector<StringSet> StringSets;
+
+
+// --- Benchmarks ---
+
+/** Base class for benchmarks working on one set of strings. Items are strings. */
+class BenchmarkEncoding : public Bench::Benchmark {
+public:
+	BenchmarkEncoding(const Common::UString &operation, StringSet &strings) :
+		Bench::Benchmark(operation + " " + strings.getName(), strings.getIterations()), _strings(&strings) {
+	}
+
+	void setUp() {
+		_strings->create();
+	}
+
+	void tearDown() {
+		_strings->clear();
+	}
+
+	size_t getDataSize() const {
+		return _strings->getEncoded().size();
+	}
+
+	size_t getItemCount() const {
+		return kStringCount;
+	}
+
+protected:
+	StringSet *_strings;
+};
+
+/** Reading terminated strings out of a stream, like the GFF and 2DA readers do. */
+class BenchmarkReadString : public BenchmarkEncoding {
+public:
+	BenchmarkReadString(StringSet &strings) : BenchmarkEncoding("readString", strings) {
+		setAllocationLimit(16.0);
+	}
+
+	void run() {
+		Common::MemoryReadStream &stream = _strings->getTerminated();
+
+		stream.seek(0);
+		for (size_t i = 0; i < kStringCount; i++)
+			Common::readString(stream, _strings->getEncoding());
+	}
+};
+
+/** Reading strings of a known length out of a stream, like the TLK and GFF readers do. */
+class BenchmarkReadStringFixed : public BenchmarkEncoding {
+public:
+	BenchmarkReadStringFixed(StringSet &strings) : BenchmarkEncoding("readStringFixed", strings) {
+		setAllocationLimit(6.0);
+	}
+
+	void run() {
+		Common::MemoryReadStream &stream = _strings->getEncoded();
+		const std::vector<size_t> &lengths = _strings->getLengths();
+
+		stream.seek(0);
+		for (size_t i = 0; i < kStringCount; i++)
+			Common::readStringFixed(stream, _strings->getEncoding(), lengths[i]);
+	}
+};
+
+/** Converting strings into the encoding, like all writers do. */
+class BenchmarkConvertString : public BenchmarkEncoding {
+public:
+	BenchmarkConvertString(StringSet &strings) : BenchmarkEncoding("convertString", strings) {
+		setAllocationLimit(4.0);
+	}
+
+	void run() {
+		const std::vector<Common::UString> &strings = _strings->getStrings();
+
+		for (size_t i = 0; i < kStringCount; i++)
+			delete Common::convertString(strings[i], _strings->getEncoding(), false);
+	}
+};
+
+/** Hashing strings as a series of bytes in the encoding, like the GDA column lookup does. */
+class BenchmarkHashString : public BenchmarkEncoding {
+public:
+	BenchmarkHashString(StringSet &strings) : BenchmarkEncoding("hashString", strings), _hash(0) {
+		setAllocationLimit(6.0);
+	}
+
+	void run() {
+		const std::vector<Common::UString> &strings = _strings->getStrings();
+
+		for (size_t i = 0; i < kStringCount; i++)
+			_hash += Common::hashString(strings[i], Common::kHashCRC32, _strings->getEncoding());
+	}
+
+private:
+	uint64 _hash;
+};
+
+/** The baseline: decoding the strings into UTF-8 with plain iconv(), without any allocations. */
+class BenchmarkIconv : public BenchmarkEncoding {
+public:
+	BenchmarkIconv(StringSet &strings) : BenchmarkEncoding("iconv", strings), _context((iconv_t) -1) {
+		setAllocationLimit(1.0);
+	}
+
+	void setUp() {
+		BenchmarkEncoding::setUp();
+
+		_context = iconv_open("UTF-8", _strings->getIconvName());
+		if (_context == ((iconv_t) -1))
+			throw Common::Exception("iconv_open(\"%s\") failed: %s", _strings->getIconvName(), strerror(errno));
+
+		size_t maxLength = 0;
+		for (size_t i = 0; i < kStringCount; i++)
+			maxLength = MAX(maxLength, _strings->getLengths()[i]);
+
+		// UTF-8 needs at most 4 bytes for each input byte
+		_output.resize(maxLength * 4 + 1);
+	}
+
+	void tearDown() {
+		if (_context != ((iconv_t) -1))
+			iconv_close(_context);
+
+		_context = (iconv_t) -1;
+
+		BenchmarkEncoding::tearDown();
+	}
+
+	void run() {
+		const Common::MemoryReadStream &stream = _strings->getEncoded();
+		const std::vector<size_t> &lengths = _strings->getLengths();
+
+		const byte *input = stream.getData();
+		for (size_t i = 0; i < kStringCount; i++) {
+			char  *in    = const_cast<char *>(reinterpret_cast<const char *>(input));
+			size_t nIn   = lengths[i];
+			char  *out   = reinterpret_cast<char *>(&_output[0]);
+			size_t nOut  = _output.size();
+
+			iconv(_context, 0, 0, 0, 0);
+			if (iconv(_context, const_cast<ICONV_CONST char **>(&in), &nIn, &out, &nOut) == ((size_t) -1))
+				throw Common::Exception("iconv() failed: %s", strerror(errno));
+
+			input += lengths[i];
+		}
+	}
+
+private:
+	iconv_t _context;
+
+	std::vector<byte> _output;
+};
+
+
+int main(int argc, char **argv) {
+	StringSets strings;
+
+	for (size_t i = 0; i < ARRAYSIZE(kCorpora); i++) {
+		if (!Common::hasSupportEncoding(kCorpora[i].encoding)) {
+			status("Skipping unsupported encoding %s", Common::getEncodingName(kCorpora[i].encoding).c_str());
+			continue;
+		}
+
+		strings.push_back(new StringSet(kCorpora[i], false));
+		strings.push_back(new StringSet(kCorpora[i], true));
+	}
+
+	Bench::Benchmarks benchmarks;
+
+	for (StringSets::iterator s = strings.begin(); s != strings.end(); ++s)
+		benchmarks.push_back(new BenchmarkReadString(**s));
+	for (StringSets::iterator s = strings.begin(); s != strings.end(); ++s)
+		benchmarks.push_back(new BenchmarkReadStringFixed(**s));
+	for (StringSets::iterator s = strings.begin(); s != strings.end(); ++s)
+		benchmarks.push_back(new BenchmarkConvertString(**s));
+	for (StringSets::iterator s = strings.begin(); s != strings.end(); ++s)
+		benchmarks.push_back(new BenchmarkHashString(**s));
+	for (StringSets::iterator s = strings.begin(); s != strings.end(); ++s)
+		benchmarks.push_back(new BenchmarkIconv(**s));
+
+	return Bench::benchmarkMain(argc, argv, benchmarks);
+}
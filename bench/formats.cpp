@@ -0,0 +1,800 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Throughput benchmarks for the GFF, 2DA and TLK loaders and converters.
+ *
+ *  All inputs are synthetic, but modelled after real game files: GFF3s
+ *  with deep struct lists and many labels, GFF4s of both versions with
+ *  generic lists, large 2DAs and TLKs in several encodings.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/util.h"
+#include "src/common/endianness.h"
+#include "src/common/encoding.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/language.h"
+#include "src/aurora/locstring.h"
+#include "src/aurora/gff3writer.h"
+#include "src/aurora/gff3file.h"
+#include "src/aurora/gff4file.h"
+#include "src/aurora/2dafile.h"
+#include "src/aurora/talktable_tlk.h"
+
+#include "src/xml/gffdumper.h"
+#include "src/xml/gffcreator.h"
+#include "src/xml/tlkdumper.h"
+#include "src/xml/tlkcreator.h"
+
+#include "bench/benchmark.h"
+
+/** Base class for benchmarks that process one synthetic file per iteration. */
+class BenchmarkFile : public Bench::Benchmark {
+public:
+	BenchmarkFile(const Common::UString &name, size_t iterations) : Bench::Benchmark(name, iterations) {
+	}
+
+	void tearDown() {
+		_data.reset();
+	}
+
+	size_t getDataSize() const {
+		return _data->size();
+	}
+
+protected:
+	Common::ScopedPtr<Common::MemoryWriteStreamDynamic> _data;
+
+	/** Create a fresh stream over the benchmark data. */
+	Common::MemoryReadStream *createInput() const {
+		return new Common::MemoryReadStream(_data->getData(), _data->size());
+	}
+
+	/** Replace the benchmark data with the contents of this stream. */
+	void setData(Common::MemoryWriteStreamDynamic &data) {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		_data->write(data.getData(), data.size());
+	}
+};
+
+
+// --- GFF3 ---
+
+static const uint32 kGFF3Depth      =  5; ///< Levels of nested struct lists.
+static const uint32 kGFF3Width      =  4; ///< Structs per list.
+static const uint32 kGFF3ValueCount = 24; ///< Plain value fields per struct.
+
+static void addGFF3Struct(Aurora::GFF3WriterStructPtr strct, uint32 depth, uint32 &id) {
+	strct->addExoString("Tag", Common::UString::format("bench_struct_%05u", id));
+	strct->addResRef("TemplateResRef", Common::UString::format("bench%05u", id));
+
+	Aurora::LocString name;
+	name.setString(Aurora::kLanguageEnglish, Common::UString::format("Synthetic struct number %u", id));
+	strct->addLocString("LocName", name);
+
+	for (uint32 i = 0; i < kGFF3ValueCount; i++) {
+		const Common::UString label = Common::UString::format("Value%02u", i);
+
+		switch (i % 4) {
+			case 0:
+				strct->addUint32(label, id * i);
+				break;
+			case 1:
+				strct->addSint16(label, (int16) (i - id));
+				break;
+			case 2:
+				strct->addFloat(label, id * 0.25f + i);
+				break;
+			default:
+				strct->addVector(label, id, i, id * 0.5f);
+				break;
+		}
+	}
+
+	id++;
+
+	if (depth == 0)
+		return;
+
+	Aurora::GFF3WriterListPtr children = strct->addList("Children");
+	for (uint32 i = 0; i < kGFF3Width; i++)
+		addGFF3Struct(children->addStruct(), depth - 1, id);
+}
+
+/** Write a GFF3 with deep struct lists and many labels. */
+static void writeGFF3(Common::WriteStream &out) {
+	LangMan.declareLanguages(Aurora::kGameIDNWN);
+
+	Aurora::GFF3Writer writer(MKTAG('U', 'T', 'C', ' '));
+
+	uint32 id = 0;
+	addGFF3Struct(writer.getTopLevel(), kGFF3Depth, id);
+
+	writer.write(out);
+}
+
+static size_t walkGFF3(const Aurora::GFF3Struct &strct) {
+	size_t count = strct.getFieldCount();
+
+	strct.getString("Tag");
+	strct.getUint("Value00");
+
+	if (!strct.hasField("Children"))
+		return count;
+
+	const Aurora::GFF3List &children = strct.getList("Children");
+	for (Aurora::GFF3List::const_iterator c = children.begin(); c != children.end(); ++c)
+		count += walkGFF3(**c);
+
+	return count;
+}
+
+/** Loading a GFF3 and reading through all its structs. */
+class BenchmarkGFF3Load : public BenchmarkFile {
+public:
+	BenchmarkGFF3Load() : BenchmarkFile("GFF3 load", 10) {
+		setAllocationLimit(110000.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		writeGFF3(*_data);
+	}
+
+	void run() {
+		Aurora::GFF3File gff3(createInput());
+
+		walkGFF3(gff3.getTopLevel());
+	}
+};
+
+/** Converting a GFF3 in XML back into binary, like xml2gff does. */
+class BenchmarkGFF3Create : public BenchmarkFile {
+public:
+	BenchmarkGFF3Create() : BenchmarkFile("GFF3 create from XML", 5) {
+		setAllocationLimit(570000.0);
+	}
+
+	void setUp() {
+		Common::MemoryWriteStreamDynamic gff3(true);
+		writeGFF3(gff3);
+
+		Common::MemoryReadStream input(gff3.getData(), gff3.size());
+		Common::ScopedPtr<XML::GFFDumper> dumper(XML::GFFDumper::identify(input));
+
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		dumper->dump(*_data, new Common::MemoryReadStream(gff3.getData(), gff3.size()), Common::kEncodingUTF8);
+	}
+
+	void run() {
+		Common::ScopedPtr<Common::MemoryReadStream> input(createInput());
+
+		Bench::NullWriteStream output;
+		XML::GFFCreator::create(output, *input, "bench.utc.xml");
+	}
+};
+
+
+// --- GFF4 ---
+
+static const uint32 kGFF4Depth        =   4; ///< Levels of nested struct lists.
+static const uint32 kGFF4Width        =   6; ///< Structs per list.
+static const uint32 kGFF4GenericCount = 800; ///< Elements in the generic list.
+
+/** Lays out a GFF4 file by hand.
+ *
+ *  The top-level struct holds an ID, a name, a list of item structs (which
+ *  themselves contain lists of child items, down to a certain depth) and a
+ *  list of generics with elements of alternating types.
+ *
+ *  V4.0 files store their strings as UTF-16LE in the data section, while
+ *  V4.1 files reference a shared string table instead.
+ */
+class GFF4Builder {
+public:
+	GFF4Builder(bool sharedStrings) : _sharedStrings(sharedStrings) {
+	}
+
+	void write(Common::WriteStream &out) {
+		/* Top-level struct: ID, name, item list, generic list.
+		 * Item struct: ID, weight, name, position, children list. */
+
+		_data.clear();
+		_strings.clear();
+
+		const uint32 top = allocate(kTopSize);
+
+		uint32 id = 0;
+		put32(top + 0, id++);
+		put32(top + 4, addString("bench_top"));
+		writeItems(top + 8, kGFF4Depth, kGFF4Width, id);
+		writeGenerics(top + 12, kGFF4GenericCount, id);
+
+		writeFile(out);
+	}
+
+private:
+	static const uint32 kTopSize  = 16;
+	static const uint32 kItemSize = 28;
+
+	static const uint32 kFieldUint32   =  4;
+	static const uint32 kFieldFloat32  =  8;
+	static const uint32 kFieldVector3f = 10;
+	static const uint32 kFieldString   = 14;
+	static const uint32 kFieldGeneric  = 0xFFFF;
+
+	static const uint32 kFlagList      = 0x8000;
+	static const uint32 kFlagStruct    = 0x4000;
+	static const uint32 kFlagReference = 0x2000;
+
+	bool _sharedStrings;
+
+	std::vector<byte> _data;
+	std::vector<Common::UString> _strings;
+
+	uint32 allocate(uint32 size) {
+		const uint32 offset = _data.size();
+
+		_data.resize(_data.size() + size, 0);
+		return offset;
+	}
+
+	void put32(uint32 offset, uint32 value) {
+		WRITE_LE_UINT32(&_data[offset], value);
+	}
+
+	void putFloat(uint32 offset, float value) {
+		put32(offset, convertIEEEFloat(value));
+	}
+
+	/** Write the string into the data section and return its offset, or its index into the shared strings. */
+	uint32 addString(const Common::UString &str) {
+		if (_sharedStrings) {
+			_strings.push_back(str);
+			return _strings.size() - 1;
+		}
+
+		return writeString(str);
+	}
+
+	uint32 writeString(const Common::UString &str) {
+		const uint32 offset = allocate(4 + str.size() * 2);
+
+		put32(offset, str.size());
+
+		uint32 pos = offset + 4;
+		for (Common::UString::iterator c = str.begin(); c != str.end(); ++c, pos += 2)
+			WRITE_LE_UINT16(&_data[pos], *c);
+
+		return offset;
+	}
+
+	void writeItem(uint32 offset, uint32 id) {
+		put32   (offset +  0, id);
+		putFloat(offset +  4, id * 0.25f);
+		put32   (offset +  8, addString(Common::UString::format("bench_item_%05u", id)));
+		putFloat(offset + 12, id);
+		putFloat(offset + 16, id * 2.0f);
+		putFloat(offset + 20, id * 3.0f);
+		put32   (offset + 24, 0xFFFFFFFF);
+	}
+
+	void writeItems(uint32 fieldOffset, uint32 depth, uint32 width, uint32 &id) {
+		const uint32 list = allocate(4 + width * kItemSize);
+
+		put32(fieldOffset, list);
+		put32(list, width);
+
+		for (uint32 i = 0; i < width; i++) {
+			const uint32 item = list + 4 + i * kItemSize;
+
+			writeItem(item, id++);
+			if (depth > 0)
+				writeItems(item + 24, depth - 1, width, id);
+		}
+	}
+
+	void writeGenerics(uint32 fieldOffset, uint32 count, uint32 &id) {
+		const uint32 list = allocate(4 + count * 8);
+
+		put32(fieldOffset, list);
+		put32(list, count);
+
+		for (uint32 i = 0; i < count; i++) {
+			const uint32 element = list + 4 + i * 8;
+
+			switch (i % 4) {
+				case 0:
+					put32(element, kFieldUint32);
+					put32(element + 4, allocate(4));
+					put32(_data.size() - 4, i);
+					break;
+
+				case 1:
+					put32(element, kFieldFloat32);
+					put32(element + 4, allocate(4));
+					putFloat(_data.size() - 4, i * 0.5f);
+					break;
+
+				case 2:
+					put32(element, kFieldString);
+					if (_sharedStrings) {
+						put32(element + 4, allocate(4));
+						put32(_data.size() - 4, addString(Common::UString::format("generic %u", i)));
+					} else
+						put32(element + 4, writeString(Common::UString::format("generic %u", i)));
+					break;
+
+				default:
+					put32(element, (kFlagStruct << 16) | 1);
+					put32(element + 4, allocate(kItemSize));
+					writeItem(_data.size() - kItemSize, id++);
+					break;
+			}
+		}
+	}
+
+	static void writeField(Common::WriteStream &out, uint32 label, uint32 type, uint32 flags, uint32 offset) {
+		out.writeUint32LE(label);
+		out.writeUint32LE((flags << 16) | type);
+		out.writeUint32LE(offset);
+	}
+
+	void writeFile(Common::WriteStream &out) const {
+		static const uint32 kTopFieldCount  = 4;
+		static const uint32 kItemFieldCount = 5;
+
+		const uint32 headerSize = _sharedStrings ? 36 : 28;
+		const uint32 fieldStart = headerSize + 2 * 16;
+
+		uint32 stringSize = 0;
+		for (std::vector<Common::UString>::const_iterator s = _strings.begin(); s != _strings.end(); ++s)
+			stringSize += std::strlen(s->c_str()) + 1;
+
+		const uint32 stringOffset = fieldStart + (kTopFieldCount + kItemFieldCount) * 12;
+		const uint32 dataOffset   = stringOffset + stringSize;
+
+		out.writeUint32BE(MKTAG('G', 'F', 'F', ' '));
+		out.writeUint32BE(_sharedStrings ? MKTAG('V', '4', '.', '1') : MKTAG('V', '4', '.', '0'));
+		out.writeUint32BE(MKTAG('P', 'C', ' ', ' '));
+		out.writeUint32BE(MKTAG('B', 'N', 'C', 'H'));
+		out.writeUint32BE(MKTAG('V', '0', '.', '1'));
+		out.writeUint32LE(2);
+
+		if (_sharedStrings) {
+			out.writeUint32LE(_strings.size());
+			out.writeUint32LE(stringOffset);
+		}
+
+		out.writeUint32LE(dataOffset);
+
+		out.writeUint32BE(MKTAG('T', 'O', 'P', ' '));
+		out.writeUint32LE(kTopFieldCount);
+		out.writeUint32LE(fieldStart);
+		out.writeUint32LE(kTopSize);
+
+		out.writeUint32BE(MKTAG('I', 'T', 'E', 'M'));
+		out.writeUint32LE(kItemFieldCount);
+		out.writeUint32LE(fieldStart + kTopFieldCount * 12);
+		out.writeUint32LE(kItemSize);
+
+		writeField(out, 1, kFieldUint32 , 0, 0);
+		writeField(out, 2, kFieldString , 0, 4);
+		writeField(out, 3, 1, kFlagList | kFlagStruct, 8);
+		writeField(out, 4, kFieldGeneric, kFlagList | kFlagReference, 12);
+
+		writeField(out, 10, kFieldUint32  , 0,  0);
+		writeField(out, 11, kFieldFloat32 , 0,  4);
+		writeField(out, 12, kFieldString  , 0,  8);
+		writeField(out, 13, kFieldVector3f, 0, 12);
+		writeField(out, 14, 1, kFlagList | kFlagStruct, 24);
+
+		for (std::vector<Common::UString>::const_iterator s = _strings.begin(); s != _strings.end(); ++s)
+			out.write(s->c_str(), std::strlen(s->c_str()) + 1);
+
+		out.write(&_data[0], _data.size());
+	}
+};
+
+static size_t walkGFF4(const Aurora::GFF4Struct &strct) {
+	size_t count = strct.getFieldCount();
+
+	strct.getUint(10);
+	strct.getString(12);
+
+	const Aurora::GFF4List &children = strct.getList(strct.hasField(3) ? 3 : 14);
+	for (Aurora::GFF4List::const_iterator c = children.begin(); c != children.end(); ++c)
+		if (*c)
+			count += walkGFF4(**c);
+
+	const Aurora::GFF4Struct *generic = strct.getGeneric(4);
+	if (generic)
+		count += generic->getFieldCount();
+
+	return count;
+}
+
+/** Loading a GFF4 and reading through all its structs. */
+class BenchmarkGFF4Load : public BenchmarkFile {
+public:
+	BenchmarkGFF4Load(bool sharedStrings) :
+		BenchmarkFile(sharedStrings ? "GFF4 V4.1 load" : "GFF4 V4.0 load", 10), _sharedStrings(sharedStrings) {
+
+		setAllocationLimit(130000.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		GFF4Builder(_sharedStrings).write(*_data);
+	}
+
+	void run() {
+		Aurora::GFF4File gff4(createInput());
+
+		walkGFF4(gff4.getTopLevel());
+	}
+
+private:
+	bool _sharedStrings;
+};
+
+
+// --- GFF dumping ---
+
+/** Dumping a GFF into XML, like gff2xml does. */
+class BenchmarkGFFDump : public BenchmarkFile {
+public:
+	enum Input {
+		kInputGFF3,
+		kInputGFF40,
+		kInputGFF41
+	};
+
+	BenchmarkGFFDump(Input input) : BenchmarkFile(getName(input), 5), _input(input) {
+		setAllocationLimit((input == kInputGFF3) ? 350000.0 : 550000.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+
+		if (_input == kInputGFF3)
+			writeGFF3(*_data);
+		else
+			GFF4Builder(_input == kInputGFF41).write(*_data);
+	}
+
+	void run() {
+		Common::ScopedPtr<Common::MemoryReadStream> input(createInput());
+		Common::ScopedPtr<XML::GFFDumper> dumper(XML::GFFDumper::identify(*input));
+
+		Bench::NullWriteStream output;
+		dumper->dump(output, input.release(), Common::kEncodingUTF8);
+	}
+
+private:
+	Input _input;
+
+	static Common::UString getName(Input input) {
+		switch (input) {
+			case kInputGFF3:
+				return "GFF3 dump to XML (deep)";
+			case kInputGFF40:
+				return "GFF4 V4.0 dump to XML";
+			default:
+				return "GFF4 V4.1 dump to XML";
+		}
+	}
+};
+
+
+// --- 2DA ---
+
+static const size_t k2DARowCount    = 4000;
+static const size_t k2DAColumnCount =   16;
+
+/** Write a large ASCII 2DA with a mix of labels, numbers, floats and empty cells.
+ *
+ *  Like in real 2DAs, many cells share the same value. The binary 2DA
+ *  format needs that, since it can only address 64KB of unique cell data.
+ */
+static void write2DA(Common::WriteStream &out) {
+	out.writeString("2DA V2.0\n\n");
+
+	out.writeString("    ");
+	for (size_t i = 0; i < k2DAColumnCount; i++)
+		out.writeString(Common::UString::format(" Column%02u", (uint) i));
+	out.writeString("\n");
+
+	for (size_t i = 0; i < k2DARowCount; i++) {
+		Common::UString line = Common::UString::format("%u", (uint) i);
+
+		for (size_t j = 0; j < k2DAColumnCount; j++) {
+			switch (j % 4) {
+				case 0:
+					line += Common::UString::format(" label_%u_%u", (uint) (i % 256), (uint) j);
+					break;
+				case 1:
+					line += Common::UString::format(" %u", (uint) ((i * j) % 1000));
+					break;
+				case 2:
+					line += Common::UString::format(" %.3f", (i % 64) * 0.125f);
+					break;
+				default:
+					line += ((i + j) % 3) ? " \"quoted value\"" : " ****";
+					break;
+			}
+		}
+
+		out.writeString(line + "\n");
+	}
+}
+
+/** Loading a 2DA, in either ASCII or binary form. */
+class Benchmark2DALoad : public BenchmarkFile {
+public:
+	Benchmark2DALoad(bool binary) :
+		BenchmarkFile(binary ? "2DA load (binary)" : "2DA load (ASCII)", 10), _binary(binary) {
+
+		setAllocationLimit(5000.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		write2DA(*_data);
+
+		if (_binary) {
+			Common::ScopedPtr<Common::MemoryReadStream> input(createInput());
+			Aurora::TwoDAFile twoda(*input);
+
+			Common::MemoryWriteStreamDynamic binary(true);
+			twoda.writeBinary(binary);
+
+			setData(binary);
+		}
+	}
+
+	void run() {
+		Common::ScopedPtr<Common::MemoryReadStream> input(createInput());
+
+		Aurora::TwoDAFile twoda(*input);
+	}
+
+private:
+	bool _binary;
+};
+
+/** Converting an ASCII 2DA into another format, like convert2da does. */
+class Benchmark2DAConvert : public BenchmarkFile {
+public:
+	enum Format {
+		kFormatASCII,
+		kFormatBinary,
+		kFormatCSV
+	};
+
+	Benchmark2DAConvert(Format format) : BenchmarkFile(getName(format), 10), _format(format) {
+		setAllocationLimit(7500.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		write2DA(*_data);
+	}
+
+	void run() {
+		Common::ScopedPtr<Common::MemoryReadStream> input(createInput());
+		Aurora::TwoDAFile twoda(*input);
+
+		Bench::NullWriteStream output;
+
+		switch (_format) {
+			case kFormatASCII:
+				twoda.writeASCII(output);
+				break;
+			case kFormatBinary:
+				twoda.writeBinary(output);
+				break;
+			default:
+				twoda.writeCSV(output);
+				break;
+		}
+	}
+
+private:
+	Format _format;
+
+	static Common::UString getName(Format format) {
+		switch (format) {
+			case kFormatASCII:
+				return "2DA convert to ASCII";
+			case kFormatBinary:
+				return "2DA convert to binary";
+			default:
+				return "2DA convert to CSV";
+		}
+	}
+};
+
+
+// --- TLK ---
+
+static const uint32 kTLKStringCount = 5000;
+
+/** A TLK version and encoding, together with a text in a matching script. */
+struct TLKFlavor {
+	TLKFlavor(XML::TLKCreator::Version v, Common::Encoding e, const char *t) : version(v), encoding(e), text(t) {
+	}
+
+	XML::TLKCreator::Version version;
+	Common::Encoding encoding;
+	Common::UString text;
+
+	Common::UString getName() const {
+		return Common::UString::format("TLK %s %s", (version == XML::TLKCreator::kVersion30) ? "V3.0" : "V4.0",
+		                               Common::getEncodingName(encoding).c_str());
+	}
+};
+
+static void writeTLK(Common::WriteStream &out, const TLKFlavor &flavor) {
+	Aurora::TalkTable_TLK tlk(flavor.encoding, 0);
+
+	for (uint32 i = 0; i < kTLKStringCount; i++) {
+		const Common::UString sound = (i % 3) ? Common::UString::format("vo_%05u", i) : "";
+
+		tlk.setEntry(i, Common::UString::format("%u: ", i) + flavor.text, sound, 0, 0,
+		             sound.empty() ? -1.0f : 1.5f, i);
+	}
+
+	if (flavor.version == XML::TLKCreator::kVersion30)
+		tlk.write30(out);
+	else
+		tlk.write40(out);
+}
+
+/** Loading a TLK and reading all its strings. */
+class BenchmarkTLKLoad : public BenchmarkFile {
+public:
+	BenchmarkTLKLoad(const TLKFlavor &flavor) : BenchmarkFile(flavor.getName() + " load", 10), _flavor(flavor) {
+		setAllocationLimit(110000.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		writeTLK(*_data, _flavor);
+	}
+
+	void run() {
+		Aurora::TalkTable_TLK tlk(createInput(), _flavor.encoding);
+
+		const std::list<uint32> &strRefs = tlk.getStrRefs();
+		for (std::list<uint32>::const_iterator s = strRefs.begin(); s != strRefs.end(); ++s) {
+			Common::UString string, soundResRef;
+			tlk.getString(*s, string, soundResRef);
+		}
+	}
+
+private:
+	TLKFlavor _flavor;
+};
+
+/** Dumping a TLK into XML, like tlk2xml does. */
+class BenchmarkTLKDump : public BenchmarkFile {
+public:
+	BenchmarkTLKDump(const TLKFlavor &flavor) : BenchmarkFile(flavor.getName() + " dump to XML", 5), _flavor(flavor) {
+		setAllocationLimit(160000.0);
+	}
+
+	void setUp() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		writeTLK(*_data, _flavor);
+	}
+
+	void run() {
+		Bench::NullWriteStream output;
+		XML::TLKDumper::dump(output, createInput(), _flavor.encoding);
+	}
+
+private:
+	TLKFlavor _flavor;
+};
+
+/** Converting a TLK in XML back into binary, like xml2tlk does. */
+class BenchmarkTLKCreate : public BenchmarkFile {
+public:
+	BenchmarkTLKCreate(const TLKFlavor &flavor) :
+		BenchmarkFile(flavor.getName() + " create from XML", 5), _flavor(flavor) {
+
+		setAllocationLimit(105000.0);
+	}
+
+	void setUp() {
+		Common::MemoryWriteStreamDynamic tlk(true);
+		writeTLK(tlk, _flavor);
+
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		XML::TLKDumper::dump(*_data, new Common::MemoryReadStream(tlk.getData(), tlk.size()), _flavor.encoding);
+	}
+
+	void run() {
+		Common::ScopedPtr<Common::MemoryReadStream> input(createInput());
+
+		XML::TLKCreator::Version version = _flavor.version;
+
+		Bench::NullWriteStream output;
+		XML::TLKCreator::create(output, *input, version, _flavor.encoding, "bench.tlk.xml");
+	}
+
+private:
+	TLKFlavor _flavor;
+};
+
+
+int main(int argc, char **argv) {
+	Bench::Benchmarks benchmarks;
+
+	benchmarks.push_back(new BenchmarkGFF3Load);
+	benchmarks.push_back(new BenchmarkGFFDump(BenchmarkGFFDump::kInputGFF3));
+	benchmarks.push_back(new BenchmarkGFF3Create);
+
+	benchmarks.push_back(new BenchmarkGFF4Load(false));
+	benchmarks.push_back(new BenchmarkGFF4Load(true));
+	benchmarks.push_back(new BenchmarkGFFDump(BenchmarkGFFDump::kInputGFF40));
+	benchmarks.push_back(new BenchmarkGFFDump(BenchmarkGFFDump::kInputGFF41));
+
+	benchmarks.push_back(new Benchmark2DALoad(false));
+	benchmarks.push_back(new Benchmark2DALoad(true));
+	benchmarks.push_back(new Benchmark2DAConvert(Benchmark2DAConvert::kFormatASCII));
+	benchmarks.push_back(new Benchmark2DAConvert(Benchmark2DAConvert::kFormatBinary));
+	benchmarks.push_back(new Benchmark2DAConvert(Benchmark2DAConvert::kFormatCSV));
+
+	std::vector<TLKFlavor> flavors;
+	flavors.push_back(TLKFlavor(XML::TLKCreator::kVersion30, Common::kEncodingCP1252,
+	                            "The quick brown fox jumps over the lazy dog. \xC3\x89t\xC3\xA9 \xC3\xA0 l'ombre."));
+	flavors.push_back(TLKFlavor(XML::TLKCreator::kVersion30, Common::kEncodingCP1250,
+	                            "Za\xC5\xBC\xC3\xB3\xC5\x82\xC4\x87 g\xC4\x99\xC5\x9Bl\xC4\x85 ja\xC5\xBA\xC5\x84. "
+	                            "P\xC5\x99\xC3\xAD\xC5\xA1" "ern\xC4\x9B \xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD k\xC5\xAF\xC5\x88."));
+	flavors.push_back(TLKFlavor(XML::TLKCreator::kVersion30, Common::kEncodingCP932,
+	                            "\xE3\x81\x84\xE3\x82\x8D\xE3\x81\xAF\xE3\x81\xAB\xE3\x81\xBB\xE3\x81\xB8\xE3\x81\xA8 "
+	                            "\xE3\x81\xA1\xE3\x82\x8A\xE3\x81\xAC\xE3\x82\x8B\xE3\x82\x92 \xE5\x86\x92\xE9\x99\xBA"));
+	flavors.push_back(TLKFlavor(XML::TLKCreator::kVersion30, Common::kEncodingUTF8,
+	                            "Mixed text: \xC3\x89t\xC3\xA9, \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, "
+	                            "\xE5\x86\x92\xE9\x99\xBA and plain ASCII."));
+	flavors.push_back(TLKFlavor(XML::TLKCreator::kVersion40, Common::kEncodingCP1252,
+	                            "The quick brown fox jumps over the lazy dog. \xC3\x89t\xC3\xA9 \xC3\xA0 l'ombre."));
+	flavors.push_back(TLKFlavor(XML::TLKCreator::kVersion40, Common::kEncodingUTF8,
+	                            "Mixed text: \xC3\x89t\xC3\xA9, \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, "
+	                            "\xE5\x86\x92\xE9\x99\xBA and plain ASCII."));
+
+	for (std::vector<TLKFlavor>::const_iterator f = flavors.begin(); f != flavors.end(); ++f) {
+		benchmarks.push_back(new BenchmarkTLKLoad(*f));
+		benchmarks.push_back(new BenchmarkTLKDump(*f));
+		benchmarks.push_back(new BenchmarkTLKCreate(*f));
+	}
+
+	return Bench::benchmarkMain(argc, argv, benchmarks);
+}
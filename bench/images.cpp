@@ -0,0 +1,869 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Throughput benchmarks for the image decoders and the TGA writer.
+ *
+ *  All inputs are synthetic, covering the formats and layouts found in
+ *  the games: S3TC compressed TPC, DDS and TXB textures with full mip
+ *  map chains, swizzled raw textures, cube maps, SBM fonts, XEOSITEX
+ *  and the Nintendo DS NCGR/NCLR and NSBTX formats.
+ *
+ *  Decoding, de-swizzling, flipping and writing TGAs are measured
+ *  separately, for each format, in megapixels per second.
+ */
+
+#include <cstring>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/endianness.h"
+#include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/nsbtxfile.h"
+
+#include "src/images/types.h"
+#include "src/images/util.h"
+#include "src/images/decoder.h"
+#include "src/images/tpc.h"
+#include "src/images/dds.h"
+#include "src/images/txb.h"
+#include "src/images/sbm.h"
+#include "src/images/xoreositex.h"
+#include "src/images/ncgr.h"
+
+#include "bench/benchmark.h"
+
+/** Number of pixels each benchmark should roughly process over all its iterations. */
+static const size_t kPixelBudget = 2 * 1024 * 1024;
+
+/** Write n bytes of deterministic noise. */
+static void writeNoise(Common::WriteStream &out, size_t n, uint32 &seed) {
+	for (size_t i = 0; i < n; i++) {
+		seed = seed * 1103515245 + 12345;
+
+		out.writeByte((seed >> 16) & 0xFF);
+	}
+}
+
+/** A synthetic image file of one specific format. */
+class ImageSource : boost::noncopyable {
+public:
+	ImageSource(const Common::UString &format, uint32 width, uint32 height, uint32 imageCount = 1) :
+		_name(Common::UString::format("%s %ux%u", format.c_str(), width, height)),
+		_width(width), _height(height), _imageCount(imageCount) {
+	}
+
+	virtual ~ImageSource() {
+	}
+
+	const Common::UString &getName() const {
+		return _name;
+	}
+
+	/** Return the number of full-size pixels in the file, over all images and layers. */
+	size_t getPixelCount() const {
+		return _width * _height * _imageCount;
+	}
+
+	/** Return a number of iterations that processes roughly the pixel budget. */
+	size_t getIterations() const {
+		return MAX<size_t>(2, kPixelBudget / getPixelCount());
+	}
+
+	/** Write the image file. */
+	virtual void write(Common::WriteStream &out) const = 0;
+
+	/** Decode all images in the file. */
+	virtual void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const = 0;
+
+protected:
+	Common::UString _name;
+
+	uint32 _width;
+	uint32 _height;
+	uint32 _imageCount;
+};
+
+typedef Common::PtrVector<ImageSource> ImageSources;
+
+
+// --- TPC ---
+
+/** A TPC, as used by Star Wars: Knights of the Old Republic I and II. */
+class TPCSource : public ImageSource {
+public:
+	enum Encoding {
+		kEncodingDXT1,
+		kEncodingDXT5,
+		kEncodingSwizzledBGRA
+	};
+
+	TPCSource(Encoding encoding, uint32 size, bool cubeMap) :
+		ImageSource(getFormatName(encoding, cubeMap), size, size, cubeMap ? 6 : 1),
+		_encoding(encoding), _cubeMap(cubeMap) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		static const byte   kEncodingByte [] = { 0x02, 0x04, 0x0C };
+		static const uint32 kMinDataSize  [] = {    8,   16,    4 };
+
+		// Compressed TPCs store the size of the base image, raw ones store 0
+		uint32 dataSize = 0;
+		if      (_encoding == kEncodingDXT1)
+			dataSize = (_width * _height) / 2;
+		else if (_encoding == kEncodingDXT5)
+			dataSize = _width * _height;
+
+		const uint32 mipMapCount = Common::intLog2(_width) + 1;
+
+		out.writeUint32LE(dataSize);
+		out.writeUint32LE(0);
+		out.writeUint16LE(_width);
+		out.writeUint16LE(_cubeMap ? (_height * 6) : _height);
+		out.writeByte(kEncodingByte[_encoding]);
+		out.writeByte(mipMapCount);
+		out.writeZeros(114);
+
+		const uint32 fullSize = (dataSize != 0) ? dataSize : (_width * _height * 4);
+
+		uint32 seed = 0;
+		for (uint32 layer = 0; layer < _imageCount; layer++)
+			for (uint32 i = 0; i < mipMapCount; i++)
+				writeNoise(out, MAX(fullSize >> (2 * i), kMinDataSize[_encoding]), seed);
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		images.push_back(new Images::TPC(in));
+	}
+
+private:
+	Encoding _encoding;
+	bool _cubeMap;
+
+	static Common::UString getFormatName(Encoding encoding, bool cubeMap) {
+		static const char * const kNames[] = { "TPC DXT1", "TPC DXT5", "TPC BGRA swizzled" };
+
+		return Common::UString(kNames[encoding]) + (cubeMap ? " cube" : "");
+	}
+};
+
+
+// --- DDS ---
+
+/** A DDS, either in the standard Microsoft format or the BioWare variant. */
+class DDSSource : public ImageSource {
+public:
+	enum Format {
+		kFormatDXT1,
+		kFormatDXT3,
+		kFormatDXT5
+	};
+
+	DDSSource(Format format, uint32 size, bool bioWare) :
+		ImageSource(getFormatName(format, bioWare), size, size), _format(format), _bioWare(bioWare) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		static const uint32 kFourCC[] = {
+			MKTAG('D', 'X', 'T', '1'), MKTAG('D', 'X', 'T', '3'), MKTAG('D', 'X', 'T', '5')
+		};
+
+		const uint32 mipMapCount = Common::intLog2(_width) + 1;
+
+		if (_bioWare) {
+			out.writeUint32LE(_width);
+			out.writeUint32LE(_height);
+			out.writeUint32LE((_format == kFormatDXT1) ? 3 : 4);
+			out.writeUint32LE(Images::getDataSize(getPixelFormat(), _width, _height));
+			out.writeUint32LE(0);
+
+		} else {
+			out.writeUint32BE(MKTAG('D', 'D', 'S', ' '));
+			out.writeUint32LE(124);
+			out.writeUint32LE(0x00021007); // Caps, height, width, pixel format, mip maps
+			out.writeUint32LE(_height);
+			out.writeUint32LE(_width);
+			out.writeUint32LE(Images::getDataSize(getPixelFormat(), _width, _height));
+			out.writeUint32LE(0);
+			out.writeUint32LE(mipMapCount);
+			out.writeZeros(44);
+
+			out.writeUint32LE(32);
+			out.writeUint32LE(0x00000004); // Has FourCC
+			out.writeUint32BE(kFourCC[_format]);
+			out.writeZeros(5 * 4);
+
+			out.writeUint32LE(0x00401008); // Complex, texture, mip maps
+			out.writeZeros(3 * 4 + 4);
+		}
+
+		uint32 seed = 0;
+		for (uint32 i = 0; i < mipMapCount; i++) {
+			const uint32 width  = MAX<uint32>(_width  >> i, 1);
+			const uint32 height = MAX<uint32>(_height >> i, 1);
+
+			writeNoise(out, Images::getDataSize(getPixelFormat(), width, height), seed);
+		}
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		images.push_back(new Images::DDS(in));
+	}
+
+private:
+	Format _format;
+	bool _bioWare;
+
+	Images::PixelFormat getPixelFormat() const {
+		static const Images::PixelFormat kPixelFormat[] = {
+			Images::kPixelFormatDXT1, Images::kPixelFormatDXT3, Images::kPixelFormatDXT5
+		};
+
+		return kPixelFormat[_format];
+	}
+
+	static Common::UString getFormatName(Format format, bool bioWare) {
+		static const char * const kNames[] = { "DXT1", "DXT3", "DXT5" };
+
+		return Common::UString(bioWare ? "DDS BioWare " : "DDS ") + kNames[format];
+	}
+};
+
+
+// --- TXB ---
+
+/** A TXB, as used by Jade Empire. */
+class TXBSource : public ImageSource {
+public:
+	enum Encoding {
+		kEncodingBGRA,
+		kEncodingGray,
+		kEncodingDXT1,
+		kEncodingDXT5
+	};
+
+	TXBSource(Encoding encoding, uint32 size) :
+		ImageSource(getFormatName(encoding), size, size), _encoding(encoding) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		static const byte kEncodingByte[] = { 0x04, 0x09, 0x0A, 0x0C };
+
+		const uint32 mipMapCount = Common::intLog2(_width) + 1;
+
+		uint32 dataSize = 0;
+		for (uint32 i = 0; i < mipMapCount; i++)
+			dataSize += getMipMapSize(i);
+
+		out.writeUint32LE(dataSize);
+		out.writeUint32LE(0);
+		out.writeUint16LE(_width);
+		out.writeUint16LE(_height);
+		out.writeByte(kEncodingByte[_encoding]);
+		out.writeByte(mipMapCount);
+		out.writeUint16LE(0x0101);
+		out.writeUint32LE(0);
+		out.writeZeros(108);
+
+		uint32 seed = 0;
+		for (uint32 i = 0; i < mipMapCount; i++)
+			writeNoise(out, getMipMapSize(i), seed);
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		images.push_back(new Images::TXB(in));
+	}
+
+private:
+	Encoding _encoding;
+
+	uint32 getMipMapSize(uint32 mipMap) const {
+		const uint32 width  = MAX<uint32>(_width  >> mipMap, 1);
+		const uint32 height = MAX<uint32>(_height >> mipMap, 1);
+
+		switch (_encoding) {
+			case kEncodingBGRA:
+				return width * height * 4;
+			case kEncodingGray:
+				return width * height;
+			case kEncodingDXT1:
+				return Images::getDataSize(Images::kPixelFormatDXT1, width, height);
+			case kEncodingDXT5:
+				return Images::getDataSize(Images::kPixelFormatDXT5, width, height);
+		}
+
+		return 0;
+	}
+
+	static Common::UString getFormatName(Encoding encoding) {
+		static const char * const kNames[] = { "TXB BGRA swizzled", "TXB gray swizzled", "TXB DXT1", "TXB DXT5" };
+
+		return kNames[encoding];
+	}
+};
+
+
+// --- SBM ---
+
+/** An SBM font, as used by Jade Empire. */
+class SBMSource : public ImageSource {
+public:
+	SBMSource(uint32 rows, bool deswizzle) :
+		ImageSource(deswizzle ? "SBM swizzled" : "SBM", 128, rows * 32), _rows(rows), _deswizzle(deswizzle) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		uint32 seed = 0;
+		writeNoise(out, _rows * 1024, seed);
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		images.push_back(new Images::SBM(in, _deswizzle));
+	}
+
+private:
+	uint32 _rows;
+	bool _deswizzle;
+};
+
+
+// --- XEOSITEX ---
+
+/** A XEOSITEX, our own intermediate texture format. */
+class XEOSITEXSource : public ImageSource {
+public:
+	XEOSITEXSource(uint32 bpp, uint32 size, bool mipMaps) :
+		ImageSource(getFormatName(bpp, mipMaps), size, size), _bpp(bpp), _mipMaps(mipMaps) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		const uint32 mipMapCount = _mipMaps ? (Common::intLog2(_width) + 1) : 1;
+
+		out.writeUint32BE(MKTAG('X', 'E', 'O', 'S'));
+		out.writeUint32BE(MKTAG('I', 'T', 'E', 'X'));
+		out.writeUint32LE(0);
+		out.writeUint32LE(_bpp);
+		out.writeZeros(6); // Wrap, flip, coordinate transform and filter
+		out.writeUint32LE(mipMapCount);
+
+		uint32 seed = 0;
+		for (uint32 i = 0; i < mipMapCount; i++) {
+			const uint32 width  = MAX<uint32>(_width  >> i, 1);
+			const uint32 height = MAX<uint32>(_height >> i, 1);
+
+			out.writeUint32LE(width);
+			out.writeUint32LE(height);
+			out.writeUint32LE(width * height * _bpp);
+
+			writeNoise(out, width * height * _bpp, seed);
+		}
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		images.push_back(new Images::XEOSITEX(in));
+	}
+
+private:
+	uint32 _bpp;
+	bool _mipMaps;
+
+	static Common::UString getFormatName(uint32 bpp, bool mipMaps) {
+		return Common::UString(bpp == 3 ? "XEOSITEX BGR" : "XEOSITEX BGRA") + (mipMaps ? "" : " flat");
+	}
+};
+
+
+// --- Nitro ---
+
+/** Write the generic header of a little-endian Nintendo DS file. */
+static void writeNitroHeader(Common::WriteStream &out, uint32 tag, byte versionMinor, byte versionMajor,
+                             uint32 fileSize) {
+
+	out.writeUint32LE(tag);
+	out.writeUint16BE(0xFFFE); // Little-endian BOM
+	out.writeByte(versionMinor);
+	out.writeByte(versionMajor);
+	out.writeUint32LE(fileSize);
+	out.writeUint16LE(16);
+	out.writeUint16LE(1);
+}
+
+/** Write a palette of 256 BGR555 colors. */
+static void writeNitroPalette(Common::WriteStream &out) {
+	for (uint32 i = 0; i < 256; i++)
+		out.writeUint16LE(((i & 0x1F) << 10) | (((i >> 3) & 0x1F) << 5) | ((255 - i) & 0x1F));
+}
+
+/** An 8-bit NCGR image together with its NCLR palette, as used by Sonic Chronicles. */
+class NCGRSource : public ImageSource {
+public:
+	NCGRSource(uint32 size) : ImageSource("NCGR+NCLR", size, size) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		// NCLR
+
+		writeNitroHeader(out, MKTAG('N', 'C', 'L', 'R'), 0, 1, kNCLRSize);
+
+		out.writeUint32LE(MKTAG('P', 'L', 'T', 'T'));
+		out.writeUint32LE(kNCLRSize - 16);
+		out.writeUint16LE(4); // 8 bit
+		out.writeZeros(6);
+		out.writeUint32LE(256 * 2);
+		out.writeUint32LE(16);
+
+		writeNitroPalette(out);
+
+		// NCGR
+
+		const uint32 dataSize = _width * _height;
+
+		writeNitroHeader(out, MKTAG('N', 'C', 'G', 'R'), 1, 1, 16 + 32 + dataSize);
+
+		out.writeUint32LE(MKTAG('C', 'H', 'A', 'R'));
+		out.writeUint32LE(32 + dataSize);
+		out.writeUint16LE(_height / 8);
+		out.writeUint16LE(_width  / 8);
+		out.writeUint32LE(4); // 8 bit
+		out.writeUint32LE(0);
+		out.writeByte(0);     // Tiled
+		out.writeByte(0);     // Not partitioned
+		out.writeUint16LE(0);
+		out.writeUint32LE(dataSize);
+		out.writeUint32LE(24);
+
+		uint32 seed = 0;
+		writeNoise(out, dataSize, seed);
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		Common::SeekableSubReadStream nclr(&in, 0, kNCLRSize);
+		Common::SeekableSubReadStream ncgr(&in, kNCLRSize, in.size());
+
+		images.push_back(new Images::NCGR(ncgr, nclr));
+	}
+
+private:
+	static const uint32 kNCLRSize = 16 + 24 + 256 * 2;
+};
+
+const uint32 NCGRSource::kNCLRSize;
+
+/** An NSBTX texture collection in all the common paletted and direct color formats. */
+class NSBTXSource : public ImageSource {
+public:
+	NSBTXSource(uint32 size) : ImageSource("NSBTX", size, size, kTextureCount) {
+	}
+
+	void write(Common::WriteStream &out) const {
+		// 8bpp, 4bpp, A3I5 and 16bpp
+		static const uint8 kFormat[kTextureCount] = { 4, 3, 1, 7 };
+		static const char * const kName[kTextureCount] = { "tex_8bpp", "tex_4bpp", "tex_a3i5", "tex_16bpp" };
+
+		static const uint32 kPaletteCount = kTextureCount - 1;
+
+		uint32 textureSize[kTextureCount];
+		textureSize[0] = _width * _height;
+		textureSize[1] = _width * _height / 2;
+		textureSize[2] = _width * _height;
+		textureSize[3] = _width * _height * 2;
+
+		uint32 textureDataSize = 0;
+		for (uint32 i = 0; i < kTextureCount; i++)
+			textureDataSize += textureSize[i];
+
+		// Offsets relative to the start of the TEX0 section
+		const uint32 textureInfoOffset = 60;
+		const uint32 paletteInfoOffset = textureInfoOffset + 16 + 28 * kTextureCount;
+		const uint32 textureDataOffset = (paletteInfoOffset + 16 + 24 * kPaletteCount + 7) & ~7;
+		const uint32 paletteDataOffset = textureDataOffset + textureDataSize;
+		const uint32 sectionSize       = paletteDataOffset + kPaletteCount * 256 * 2;
+
+		out.writeUint32BE(MKTAG('B', 'T', 'X', '0'));
+		out.writeUint16BE(0xFFFE);
+		out.writeByte(1);
+		out.writeByte(0);
+		out.writeUint32LE(20 + sectionSize);
+		out.writeUint16LE(16);
+		out.writeUint16LE(1);
+		out.writeUint32LE(20);
+
+		// TEX0 info header
+
+		out.writeUint32BE(MKTAG('T', 'E', 'X', '0'));
+		out.writeUint32LE(sectionSize);
+		out.writeUint32LE(0);
+		out.writeUint16LE(textureDataSize >> 3);
+		out.writeUint16LE(textureInfoOffset);
+		out.writeUint32LE(0);
+		out.writeUint32LE(textureDataOffset);
+		out.writeZeros(4 + 2 + 2 + 4 + 4 + 4 + 4);
+		out.writeUint32LE(kPaletteCount * 256 * 2);
+		out.writeUint32LE(paletteInfoOffset);
+		out.writeUint32LE(paletteDataOffset);
+
+		// Texture info
+
+		writeInfoListHeader(out, kTextureCount, 8);
+
+		uint32 offset = 0;
+		for (uint32 i = 0; i < kTextureCount; i++) {
+			const uint16 flags = ((Common::intLog2(_width ) - 3) << 4) |
+			                     ((Common::intLog2(_height) - 3) << 7) |
+			                     (kFormat[i] << 10) | (1 << 13);
+
+			out.writeUint16LE(offset >> 3);
+			out.writeUint16LE(flags);
+			out.writeUint32LE(0);
+
+			offset += textureSize[i];
+		}
+
+		for (uint32 i = 0; i < kTextureCount; i++)
+			writeName(out, kName[i]);
+
+		// Palette info
+
+		writeInfoListHeader(out, kPaletteCount, 4);
+
+		for (uint32 i = 0; i < kPaletteCount; i++) {
+			out.writeUint16LE((i * 256 * 2) >> 3);
+			out.writeUint16LE(0);
+		}
+
+		for (uint32 i = 0; i < kPaletteCount; i++)
+			writeName(out, kName[i]);
+
+		out.writeZeros(textureDataOffset - (paletteInfoOffset + 16 + 24 * kPaletteCount));
+
+		// Texture and palette data
+
+		uint32 seed = 0;
+		writeNoise(out, textureDataSize, seed);
+
+		for (uint32 i = 0; i < kPaletteCount; i++)
+			writeNitroPalette(out);
+	}
+
+	void decode(Common::SeekableReadStream &in, Common::PtrVector<Images::Decoder> &images) const {
+		Aurora::NSBTXFile nsbtx(new Common::SeekableSubReadStream(&in, 0, in.size()));
+
+		for (uint32 i = 0; i < nsbtx.getResources().size(); i++) {
+			Common::ScopedPtr<Common::SeekableReadStream> texture(nsbtx.getResource(i));
+
+			images.push_back(new Images::XEOSITEX(*texture));
+		}
+	}
+
+private:
+	static const uint32 kTextureCount = 4;
+
+	static void writeInfoListHeader(Common::WriteStream &out, uint32 count, uint32 entrySize) {
+		out.writeByte(0);
+		out.writeByte(count);
+		out.writeUint16LE(16 + (4 + entrySize + 16) * count);
+		out.writeZeros(2 + 2 + 4 + count * (2 + 2));
+		out.writeUint16LE(4 + entrySize * count);
+		out.writeUint16LE(entrySize);
+	}
+
+	static void writeName(Common::WriteStream &out, const char *name) {
+		const size_t length = std::strlen(name);
+
+		out.write(name, length);
+		out.writeZeros(16 - length);
+	}
+};
+
+const uint32 NSBTXSource::kTextureCount;
+
+
+// --- Benchmarks ---
+
+/** Return the number of pixels over all mip maps and layers of an image. */
+static size_t countPixels(const Images::Decoder &image) {
+	size_t count = 0;
+
+	for (size_t layer = 0; layer < image.getLayerCount(); layer++)
+		for (size_t i = 0; i < image.getMipMapCount(); i++)
+			count += image.getMipMap(i, layer).width * image.getMipMap(i, layer).height;
+
+	return count;
+}
+
+/** Return the number of mip maps over all layers of an image. */
+static size_t countMipMaps(const Images::Decoder &image) {
+	return image.getLayerCount() * image.getMipMapCount();
+}
+
+/** Base class for benchmarks working on one synthetic image file. */
+class BenchmarkImage : public Bench::Benchmark {
+public:
+	BenchmarkImage(const Common::UString &operation, const ImageSource &source) :
+		Bench::Benchmark(operation + " " + source.getName(), source.getIterations()),
+		_source(&source), _dataSize(0), _itemCount(1), _pixelCount(0) {
+	}
+
+	void tearDown() {
+		_images.clear();
+		_data.reset();
+	}
+
+	size_t getDataSize() const {
+		return _dataSize;
+	}
+
+	size_t getItemCount() const {
+		return _itemCount;
+	}
+
+	size_t getPixelCount() const {
+		return _pixelCount;
+	}
+
+protected:
+	const ImageSource *_source;
+
+	Common::ScopedPtr<Common::MemoryWriteStreamDynamic> _data;
+	Common::PtrVector<Images::Decoder> _images;
+
+	size_t _dataSize;
+	size_t _itemCount;
+	size_t _pixelCount;
+
+	/** Write the image file and decode it. */
+	void createImages() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+		_source->write(*_data);
+
+		decodeImages(_images);
+	}
+
+	void decodeImages(Common::PtrVector<Images::Decoder> &images) const {
+		Common::MemoryReadStream input(_data->getData(), _data->size());
+
+		_source->decode(input, images);
+	}
+};
+
+/** Reading an image file, decompressing it into raw pixel data. Items are mip maps. */
+class BenchmarkImageDecode : public BenchmarkImage {
+public:
+	BenchmarkImageDecode(const ImageSource &source) : BenchmarkImage("decode", source) {
+		setAllocationLimit(20.0);
+	}
+
+	void setUp() {
+		createImages();
+
+		_dataSize = _data->size();
+
+		_itemCount = _pixelCount = 0;
+		for (Common::PtrVector<Images::Decoder>::const_iterator i = _images.begin(); i != _images.end(); ++i) {
+			_itemCount  += countMipMaps(**i);
+			_pixelCount += countPixels(**i);
+		}
+	}
+
+	void run() {
+		Common::PtrVector<Images::Decoder> images;
+
+		decodeImages(images);
+	}
+};
+
+/** Flipping already decoded images in place. Items are mip maps. */
+class BenchmarkImageFlip : public BenchmarkImage {
+public:
+	BenchmarkImageFlip(const ImageSource &source, bool horizontally) :
+		BenchmarkImage(horizontally ? "flip H" : "flip V", source), _horizontally(horizontally) {
+		setAllocationLimit(2.0);
+	}
+
+	void setUp() {
+		createImages();
+
+		_dataSize = _itemCount = _pixelCount = 0;
+		for (Common::PtrVector<Images::Decoder>::const_iterator i = _images.begin(); i != _images.end(); ++i) {
+			for (size_t layer = 0; layer < (*i)->getLayerCount(); layer++)
+				for (size_t m = 0; m < (*i)->getMipMapCount(); m++)
+					_dataSize += (*i)->getMipMap(m, layer).size;
+
+			_itemCount  += countMipMaps(**i);
+			_pixelCount += countPixels(**i);
+		}
+	}
+
+	void run() {
+		for (Common::PtrVector<Images::Decoder>::iterator i = _images.begin(); i != _images.end(); ++i) {
+			if (_horizontally)
+				(*i)->flipHorizontally();
+			else
+				(*i)->flipVertically();
+		}
+	}
+
+private:
+	bool _horizontally;
+};
+
+/** Writing already decoded images as TGA, like the image conversion tools do. Items are images. */
+class BenchmarkImageDumpTGA : public BenchmarkImage {
+public:
+	BenchmarkImageDumpTGA(const ImageSource &source) : BenchmarkImage("dumpTGA", source) {
+		setAllocationLimit(4.0);
+	}
+
+	void setUp() {
+		createImages();
+
+		Bench::NullWriteStream output;
+
+		_itemCount  = _images.size();
+		_pixelCount = 0;
+		for (Common::PtrVector<Images::Decoder>::const_iterator i = _images.begin(); i != _images.end(); ++i) {
+			(*i)->dumpTGA(output);
+
+			// Only the base image of each layer is written
+			for (size_t layer = 0; layer < (*i)->getLayerCount(); layer++)
+				_pixelCount += (*i)->getMipMap(0, layer).width * (*i)->getMipMap(0, layer).height;
+		}
+
+		_dataSize = output.size();
+	}
+
+	void run() {
+		Bench::NullWriteStream output;
+
+		for (Common::PtrVector<Images::Decoder>::const_iterator i = _images.begin(); i != _images.end(); ++i)
+			(*i)->dumpTGA(output);
+	}
+};
+
+/** De-swizzling raw pixel data, as done for Xbox textures. */
+class BenchmarkDeSwizzle : public Bench::Benchmark {
+public:
+	BenchmarkDeSwizzle(uint32 width, uint32 height, uint8 bpp) :
+		Bench::Benchmark(Common::UString::format("deswizzle %ubpp %ux%u", (uint) bpp * 8, width, height),
+		                 MAX<size_t>(2, kPixelBudget / (width * height))),
+		_width(width), _height(height), _bpp(bpp) {
+	}
+
+	void setUp() {
+		const size_t size = _width * _height * _bpp;
+
+		_src.reset(new byte[size]);
+		_dst.reset(new byte[size]);
+
+		for (size_t i = 0; i < size; i++)
+			_src[i] = i & 0xFF;
+	}
+
+	void tearDown() {
+		_src.reset();
+		_dst.reset();
+	}
+
+	void run() {
+		Images::deSwizzle(_dst.get(), _src.get(), _width, _height, _bpp);
+	}
+
+	size_t getDataSize() const {
+		return _width * _height * _bpp;
+	}
+
+	size_t getPixelCount() const {
+		return _width * _height;
+	}
+
+private:
+	uint32 _width;
+	uint32 _height;
+	uint8 _bpp;
+
+	Common::ScopedArray<byte> _src;
+	Common::ScopedArray<byte> _dst;
+};
+
+
+int main(int argc, char **argv) {
+	static const uint32 kSizes[] = { 128, 512 };
+
+	ImageSources sources;
+
+	for (size_t i = 0; i < ARRAYSIZE(kSizes); i++) {
+		sources.push_back(new TPCSource(TPCSource::kEncodingDXT1, kSizes[i], false));
+		sources.push_back(new TPCSource(TPCSource::kEncodingDXT5, kSizes[i], false));
+		sources.push_back(new TPCSource(TPCSource::kEncodingSwizzledBGRA, kSizes[i], false));
+		sources.push_back(new TPCSource(TPCSource::kEncodingDXT1, kSizes[i], true));
+
+		sources.push_back(new DDSSource(DDSSource::kFormatDXT1, kSizes[i], false));
+		sources.push_back(new DDSSource(DDSSource::kFormatDXT3, kSizes[i], false));
+		sources.push_back(new DDSSource(DDSSource::kFormatDXT5, kSizes[i], false));
+		sources.push_back(new DDSSource(DDSSource::kFormatDXT5, kSizes[i], true));
+
+		sources.push_back(new TXBSource(TXBSource::kEncodingBGRA, kSizes[i]));
+		sources.push_back(new TXBSource(TXBSource::kEncodingGray, kSizes[i]));
+		sources.push_back(new TXBSource(TXBSource::kEncodingDXT1, kSizes[i]));
+		sources.push_back(new TXBSource(TXBSource::kEncodingDXT5, kSizes[i]));
+
+		sources.push_back(new SBMSource(kSizes[i] / 32, false));
+		sources.push_back(new SBMSource(kSizes[i] / 32, true));
+
+		sources.push_back(new XEOSITEXSource(4, kSizes[i], true));
+		sources.push_back(new XEOSITEXSource(3, kSizes[i], false));
+	}
+
+	// Nintendo DS textures are small, and the NSBTX offsets don't reach beyond 512KB
+	sources.push_back(new NCGRSource(64));
+	sources.push_back(new NCGRSource(256));
+	sources.push_back(new NSBTXSource(64));
+	sources.push_back(new NSBTXSource(256));
+
+	Bench::Benchmarks benchmarks;
+
+	for (ImageSources::const_iterator s = sources.begin(); s != sources.end(); ++s)
+		benchmarks.push_back(new BenchmarkImageDecode(**s));
+
+	for (size_t i = 0; i < ARRAYSIZE(kSizes); i++) {
+		benchmarks.push_back(new BenchmarkDeSwizzle(kSizes[i], kSizes[i], 4));
+		benchmarks.push_back(new BenchmarkDeSwizzle(kSizes[i], kSizes[i], 3));
+		benchmarks.push_back(new BenchmarkDeSwizzle(kSizes[i], kSizes[i] / 2, 4));
+	}
+
+	for (ImageSources::const_iterator s = sources.begin(); s != sources.end(); ++s) {
+		benchmarks.push_back(new BenchmarkImageFlip(**s, true));
+		benchmarks.push_back(new BenchmarkImageFlip(**s, false));
+	}
+
+	for (ImageSources::const_iterator s = sources.begin(); s != sources.end(); ++s)
+		benchmarks.push_back(new BenchmarkImageDumpTGA(**s));
+
+	return Bench::benchmarkMain(argc, argv, benchmarks);
+}
@@ -0,0 +1,829 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Scaling benchmarks for the NWScript bytecode analysis.
+ *
+ *  The scripts are synthetic, generated with a controllable number of
+ *  subroutines, statements and nesting depth of if and while blocks.
+ *  They call engine functions from each game's function table, so the
+ *  type checks of the stack analysis are exercised as well.
+ *
+ *  Parsing, the stack analysis, the control flow analysis and each
+ *  output mode of the disassembler are measured separately. Items are
+ *  instructions, and the allocation limits are per instruction, so a
+ *  growing script size doesn't lead to a super-linear growth.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+
+#include "src/nwscript/variable.h"
+#include "src/nwscript/instruction.h"
+#include "src/nwscript/game.h"
+#include "src/nwscript/ncsfile.h"
+#include "src/nwscript/disassembler.h"
+
+#include "bench/benchmark.h"
+
+using namespace NWScript;
+
+/** Number of instructions each benchmark should roughly process over all its iterations. */
+static const size_t kInstructionBudget = 200000;
+
+/** The size of the NCS header, up to and including the script size instruction. */
+static const uint32 kHeaderSize = 13;
+
+/** Assembles NWScript bytecode, resolving the jump labels at the end. */
+class Assembler {
+public:
+	Assembler() : _instructionCount(0) {
+	}
+
+	size_t getInstructionCount() const {
+		return _instructionCount;
+	}
+
+	/** Create a new label, not yet placed anywhere. */
+	size_t createLabel() {
+		_labels.push_back(0xFFFFFFFF);
+
+		return _labels.size() - 1;
+	}
+
+	/** Place a label at the current position. */
+	void placeLabel(size_t label) {
+		_labels[label] = getAddress();
+	}
+
+	void emit(Opcode opcode, InstructionType type) {
+		_code.push_back((byte) opcode);
+		_code.push_back((byte) type);
+
+		_instructionCount++;
+	}
+
+	/** Emit an instruction with a single 32-bit argument. */
+	void emit(Opcode opcode, InstructionType type, int32 arg) {
+		emit(opcode, type);
+		writeUint32((uint32) arg);
+	}
+
+	/** Emit a stack copy instruction, with an offset and a size. */
+	void emitCopy(Opcode opcode, int32 offset, int16 size) {
+		emit(opcode, kInstTypeDirect, offset);
+		writeUint16((uint16) size);
+	}
+
+	void emitConst(int32 value) {
+		emit(kOpcodeCONST, kInstTypeInt, value);
+	}
+
+	void emitConst(const char *value) {
+		const size_t length = std::strlen(value);
+
+		emit(kOpcodeCONST, kInstTypeString);
+		writeUint16(length);
+
+		_code.insert(_code.end(), value, value + length);
+	}
+
+	void emitAction(size_t function, size_t parameterCount) {
+		emit(kOpcodeACTION, kInstTypeNone);
+		writeUint16(function);
+		_code.push_back(parameterCount);
+	}
+
+	/** Emit a jump instruction to a label. */
+	void emitJump(Opcode opcode, size_t label) {
+		Fixup fixup;
+		fixup.instruction = getAddress();
+		fixup.argument    = _code.size() + 2;
+		fixup.label       = label;
+
+		_fixups.push_back(fixup);
+
+		emit(opcode, kInstTypeNone, 0);
+	}
+
+	/** Write the complete NCS file. */
+	void write(Common::WriteStream &out) {
+		for (std::vector<Fixup>::const_iterator f = _fixups.begin(); f != _fixups.end(); ++f) {
+			if (_labels[f->label] == 0xFFFFFFFF)
+				throw Common::Exception("Assembler: Label %u not placed", (uint) f->label);
+
+			const uint32 offset = _labels[f->label] - f->instruction;
+
+			_code[f->argument + 0] = (offset >> 24) & 0xFF;
+			_code[f->argument + 1] = (offset >> 16) & 0xFF;
+			_code[f->argument + 2] = (offset >>  8) & 0xFF;
+			_code[f->argument + 3] =  offset        & 0xFF;
+		}
+
+		out.writeUint32BE(MKTAG('N', 'C', 'S', ' '));
+		out.writeUint32BE(MKTAG('V', '1', '.', '0'));
+		out.writeByte(kOpcodeSCRIPTSIZE);
+		out.writeUint32BE(kHeaderSize + _code.size());
+
+		out.write(&_code[0], _code.size());
+	}
+
+private:
+	/** A jump argument that needs to be filled in with the label's offset. */
+	struct Fixup {
+		uint32 instruction; ///< Address of the jump instruction.
+		size_t argument;    ///< Position of the argument within the code.
+		size_t label;       ///< The label that's the jump destination.
+	};
+
+	std::vector<byte> _code;
+	std::vector<uint32> _labels;
+	std::vector<Fixup> _fixups;
+
+	size_t _instructionCount;
+
+	uint32 getAddress() const {
+		return kHeaderSize + _code.size();
+	}
+
+	void writeUint32(uint32 value) {
+		writeUint16(value >> 16);
+		writeUint16(value & 0xFFFF);
+	}
+
+	void writeUint16(uint16 value) {
+		_code.push_back(value >> 8);
+		_code.push_back(value & 0xFF);
+	}
+};
+
+/** The shape of a synthetic script. */
+struct ScriptShape {
+	uint32 subRoutines; ///< Number of subroutines besides _start(), _global() and main().
+	uint32 statements;  ///< Number of statements in each block.
+	uint32 nesting;     ///< Maximum nesting depth of if and while blocks.
+	uint32 globals;     ///< Number of global variables.
+
+	ScriptShape(uint32 s, uint32 st, uint32 n, uint32 g) : subRoutines(s), statements(st), nesting(n), globals(g) {
+	}
+
+	/** Return the shape as "<subroutines>x<statements>x<nesting>". */
+	Common::UString getName() const {
+		return Common::UString::format("%ux%ux%u", subRoutines, statements, nesting);
+	}
+};
+
+/** Generates a synthetic script, with integer local variables and parameters.
+ *
+ *  The script is laid out like the BioWare compiler does it: _start()
+ *  calls _global(), which creates the global variables and calls main().
+ *  main() calls the first subroutines, and each subroutine can call the
+ *  two subroutines following it, so the call graph stays free of recursion.
+ */
+class ScriptGenerator {
+public:
+	ScriptGenerator(Aurora::GameID game, const ScriptShape &shape) :
+		_game(game), _shape(shape), _seed(0), _temps(0), _current(0) {
+
+		findFunctions();
+	}
+
+	/** Generate the script, and return the number of instructions in it. */
+	size_t generate(Common::WriteStream &out) {
+		_subRoutines.clear();
+		for (uint32 i = 0; i < _shape.subRoutines + 2; i++)
+			_subRoutines.push_back(_asm.createLabel());
+
+		_seed = 0;
+
+		const size_t labelGlobal = _subRoutines[0];
+		const size_t labelMain   = _subRoutines[1];
+
+		// _start()
+		_asm.emitJump(kOpcodeJSR, (_shape.globals > 0) ? labelGlobal : labelMain);
+		_asm.emit(kOpcodeRETN, kInstTypeNone);
+
+		// _global()
+		if (_shape.globals > 0) {
+			_asm.placeLabel(labelGlobal);
+
+			for (uint32 i = 0; i < _shape.globals; i++) {
+				_asm.emit(kOpcodeRSADD, kInstTypeInt);
+				_asm.emitConst((int32) i);
+				_asm.emitCopy(kOpcodeCPDOWNSP, -8, 4);
+				_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+			}
+
+			_asm.emit(kOpcodeSAVEBP, kInstTypeNone);
+			_asm.emitJump(kOpcodeJSR, labelMain);
+			_asm.emit(kOpcodeRESTOREBP, kInstTypeNone);
+			_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4 * (int32) _shape.globals);
+			_asm.emit(kOpcodeRETN, kInstTypeNone);
+		}
+
+		// main() and the subroutines, each with its own set of locals
+		for (uint32 i = 1; i < _subRoutines.size(); i++) {
+			_current = i;
+
+			generateSubRoutine();
+		}
+
+		_asm.write(out);
+
+		return _asm.getInstructionCount();
+	}
+
+private:
+	static const uint32 kLocalCount = 3;
+
+	Aurora::GameID _game;
+	ScriptShape _shape;
+
+	Assembler _asm;
+	std::vector<size_t> _subRoutines;
+
+	/** Engine function returning an int, taking one int. -1 if none. */
+	int32 _functionIntInt;
+	/** Engine function returning nothing, taking one string. -1 if none. */
+	int32 _functionVoidString;
+
+	uint32 _seed;
+	uint32 _temps;   ///< Number of temporary values on top of the locals.
+	uint32 _current; ///< Index of the current subroutine. 1 is main().
+
+	uint32 random(uint32 n) {
+		_seed = _seed * 1103515245 + 12345;
+
+		return (_seed >> 16) % n;
+	}
+
+	void findFunctions() {
+		_functionIntInt = _functionVoidString = -1;
+
+		for (size_t i = 0; i < getFunctionCount(_game); i++) {
+			if (!hasFunction(_game, i) || (getFunctionParameterCount(_game, i) != 1))
+				continue;
+
+			const VariableType returnType = getFunctionReturnType(_game, i);
+			const VariableType paramType  = getFunctionParameters(_game, i)[0];
+
+			if ((_functionIntInt < 0) && (returnType == kTypeInt) && (paramType == kTypeInt))
+				_functionIntInt = i;
+			if ((_functionVoidString < 0) && (returnType == kTypeVoid) && (paramType == kTypeString))
+				_functionVoidString = i;
+		}
+	}
+
+	bool isMain() const {
+		return _current == 1;
+	}
+
+	/** Offset of a local variable, relative to the top of the stack. */
+	int32 getLocalOffset(uint32 local) const {
+		return -4 * (int32) ((kLocalCount - 1 - local) + _temps + 1);
+	}
+
+	/** Offset of the subroutine parameter, relative to the top of the stack. */
+	int32 getParameterOffset() const {
+		return -4 * (int32) (kLocalCount + _temps + 1);
+	}
+
+	/** Offset of the subroutine return value, relative to the top of the stack. */
+	int32 getReturnOffset() const {
+		return -4 * (int32) (kLocalCount + _temps + 2);
+	}
+
+	/** Offset of a global variable, relative to the base pointer. */
+	int32 getGlobalOffset(uint32 global) const {
+		return -4 * (int32) (_shape.globals - global);
+	}
+
+	void push() {
+		_temps++;
+	}
+
+	void pop(uint32 count = 1) {
+		_temps -= count;
+	}
+
+	void generateSubRoutine() {
+		_asm.placeLabel(_subRoutines[_current]);
+
+		for (uint32 i = 0; i < kLocalCount; i++) {
+			_asm.emit(kOpcodeRSADD, kInstTypeInt);
+			_asm.emitConst((int32) i);
+			_asm.emitCopy(kOpcodeCPDOWNSP, -8, 4);
+			_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+		}
+
+		if (!isMain()) {
+			// local0 = param
+			_asm.emitCopy(kOpcodeCPTOPSP, getParameterOffset(), 4);
+			push();
+			_asm.emitCopy(kOpcodeCPDOWNSP, getLocalOffset(0), 4);
+			_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+			pop();
+		}
+
+		generateBlock(0);
+
+		if (!isMain()) {
+			// return local1
+			_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(1), 4);
+			push();
+			_asm.emitCopy(kOpcodeCPDOWNSP, getReturnOffset(), 4);
+			_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+			pop();
+		}
+
+		_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4 * (int32) kLocalCount);
+		if (!isMain())
+			_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+
+		_asm.emit(kOpcodeRETN, kInstTypeNone);
+	}
+
+	void generateBlock(uint32 depth) {
+		for (uint32 i = 0; i < _shape.statements; i++)
+			generateStatement(depth);
+	}
+
+	void generateStatement(uint32 depth) {
+		const bool canNest = depth < _shape.nesting;
+
+		switch (random(9)) {
+			case 0:
+				generateAssignment();
+				break;
+
+			case 1:
+				if (_functionIntInt >= 0)
+					generateActionInt();
+				else
+					generateAssignment();
+				break;
+
+			case 2:
+				if (_functionVoidString >= 0)
+					generateActionString();
+				else
+					generateAssignment();
+				break;
+
+			case 3:
+			case 4:
+				if ((_current + 1) < _subRoutines.size())
+					generateCall();
+				else
+					generateAssignment();
+				break;
+
+			case 5:
+				if (_shape.globals > 0)
+					generateGlobalAssignment();
+				else
+					generateAssignment();
+				break;
+
+			case 6:
+				if (canNest)
+					generateIf(depth, false);
+				else
+					generateAssignment();
+				break;
+
+			case 7:
+				if (canNest)
+					generateIf(depth, true);
+				else
+					generateAssignment();
+				break;
+
+			case 8:
+				if (canNest)
+					generateWhile(depth);
+				else
+					generateAssignment();
+				break;
+		}
+	}
+
+	/** Copy the result on top of the stack into a local variable, and pop it. */
+	void storeLocal(uint32 local) {
+		_asm.emitCopy(kOpcodeCPDOWNSP, getLocalOffset(local), 4);
+		_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+		pop();
+	}
+
+	/** Push the comparison of a local variable with a constant. */
+	void generateCondition(Opcode comparison) {
+		_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(random(kLocalCount)), 4);
+		push();
+		_asm.emitConst((int32) random(16));
+		push();
+		_asm.emit(comparison, kInstTypeIntInt);
+		pop();
+	}
+
+	// localA = localB + c
+	void generateAssignment() {
+		_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(random(kLocalCount)), 4);
+		push();
+		_asm.emitConst((int32) random(100));
+		push();
+		_asm.emit(kOpcodeADD, kInstTypeIntInt);
+		pop();
+
+		storeLocal(random(kLocalCount));
+	}
+
+	// globalA = globalB + localC
+	void generateGlobalAssignment() {
+		_asm.emitCopy(kOpcodeCPTOPBP, getGlobalOffset(random(_shape.globals)), 4);
+		push();
+		_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(random(kLocalCount)), 4);
+		push();
+		_asm.emit(kOpcodeADD, kInstTypeIntInt);
+		pop();
+
+		_asm.emitCopy(kOpcodeCPDOWNBP, getGlobalOffset(random(_shape.globals)), 4);
+		_asm.emit(kOpcodeMOVSP, kInstTypeNone, -4);
+		pop();
+	}
+
+	// localA = intFunction(localB)
+	void generateActionInt() {
+		_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(random(kLocalCount)), 4);
+		_asm.emitAction(_functionIntInt, 1);
+		push();
+
+		storeLocal(random(kLocalCount));
+	}
+
+	// voidFunction("...")
+	void generateActionString() {
+		static const char * const kStrings[] = { "Hello", "xoreos", "NWScript benchmark string" };
+
+		_asm.emitConst(kStrings[random(ARRAYSIZE(kStrings))]);
+		_asm.emitAction(_functionVoidString, 1);
+	}
+
+	// localA = sub(localB)
+	void generateCall() {
+		const uint32 maxCallee = MIN<uint32>(_current + 2, _subRoutines.size() - 1);
+		const uint32 callee    = _current + 1 + random(maxCallee - _current);
+
+		_asm.emit(kOpcodeRSADD, kInstTypeInt);
+		push();
+		_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(random(kLocalCount)), 4);
+		_asm.emitJump(kOpcodeJSR, _subRoutines[callee]);
+
+		storeLocal(random(kLocalCount));
+	}
+
+	// if (localA > c) { ... } [else { ... }]
+	void generateIf(uint32 depth, bool hasElse) {
+		const size_t labelElse = _asm.createLabel();
+		const size_t labelEnd  = _asm.createLabel();
+
+		generateCondition(kOpcodeGT);
+		_asm.emitJump(kOpcodeJZ, labelElse);
+		pop();
+
+		generateBlock(depth + 1);
+
+		if (hasElse) {
+			_asm.emitJump(kOpcodeJMP, labelEnd);
+			_asm.placeLabel(labelElse);
+
+			generateBlock(depth + 1);
+		} else
+			_asm.placeLabel(labelElse);
+
+		_asm.placeLabel(labelEnd);
+	}
+
+	// while (localA < c) { ...; localA++; }
+	void generateWhile(uint32 depth) {
+		const size_t labelHead = _asm.createLabel();
+		const size_t labelEnd  = _asm.createLabel();
+
+		const uint32 counter = random(kLocalCount);
+
+		_asm.placeLabel(labelHead);
+
+		_asm.emitCopy(kOpcodeCPTOPSP, getLocalOffset(counter), 4);
+		push();
+		_asm.emitConst((int32) random(16));
+		push();
+		_asm.emit(kOpcodeLT, kInstTypeIntInt);
+		pop();
+		_asm.emitJump(kOpcodeJZ, labelEnd);
+		pop();
+
+		generateBlock(depth + 1);
+
+		_asm.emit(kOpcodeINCSP, kInstTypeInt, getLocalOffset(counter));
+		_asm.emitJump(kOpcodeJMP, labelHead);
+
+		_asm.placeLabel(labelEnd);
+	}
+};
+
+const uint32 ScriptGenerator::kLocalCount;
+
+
+// --- Benchmarks ---
+
+static const char *getGameName(Aurora::GameID game) {
+	switch (game) {
+		case Aurora::kGameIDNWN:
+			return "NWN";
+		case Aurora::kGameIDNWN2:
+			return "NWN2";
+		case Aurora::kGameIDKotOR:
+			return "KotOR";
+		case Aurora::kGameIDKotOR2:
+			return "KotOR2";
+		case Aurora::kGameIDJade:
+			return "Jade";
+		case Aurora::kGameIDWitcher:
+			return "Witcher";
+		case Aurora::kGameIDDragonAge:
+			return "DragonAge";
+		case Aurora::kGameIDDragonAge2:
+			return "DragonAge2";
+		default:
+			break;
+	}
+
+	return "unknown";
+}
+
+/** Base class for benchmarks working on one synthetic script. */
+class BenchmarkNCS : public Bench::Benchmark {
+public:
+	BenchmarkNCS(const Common::UString &operation, Aurora::GameID game, const ScriptShape &shape) :
+		Bench::Benchmark(operation + " " + getGameName(game) + " " + shape.getName(),
+		                 getIterationCount(game, shape)),
+		_game(game), _shape(shape), _instructionCount(0) {
+	}
+
+	void tearDown() {
+		_data.reset();
+	}
+
+	size_t getDataSize() const {
+		return _data ? _data->size() : 0;
+	}
+
+	size_t getItemCount() const {
+		return _instructionCount;
+	}
+
+protected:
+	Aurora::GameID _game;
+	ScriptShape _shape;
+
+	Common::ScopedPtr<Common::MemoryWriteStreamDynamic> _data;
+
+	size_t _instructionCount;
+
+	void createScript() {
+		_data.reset(new Common::MemoryWriteStreamDynamic(true));
+
+		ScriptGenerator generator(_game, _shape);
+		_instructionCount = generator.generate(*_data);
+	}
+
+	NCSFile *parseScript() const {
+		Common::MemoryReadStream input(_data->getData(), _data->size());
+
+		return new NCSFile(input, _game);
+	}
+
+private:
+	/** Return a number of iterations that processes roughly the instruction budget. */
+	static size_t getIterationCount(Aurora::GameID game, const ScriptShape &shape) {
+		Bench::NullWriteStream output;
+
+		ScriptGenerator generator(game, shape);
+
+		return MAX<size_t>(2, kInstructionBudget / generator.generate(output));
+	}
+};
+
+/** Parsing the bytecode into instructions, blocks and subroutines. */
+class BenchmarkNCSParse : public BenchmarkNCS {
+public:
+	BenchmarkNCSParse(Aurora::GameID game, const ScriptShape &shape) :
+		BenchmarkNCS("parse", game, shape) {
+
+		setAllocationLimit(8.0);
+	}
+
+	void setUp() {
+		createScript();
+	}
+
+	void run() {
+		Common::ScopedPtr<NCSFile> ncs(parseScript());
+	}
+};
+
+/** Analyzing an already parsed script, either its stack or its control flow.
+ *
+ *  Since the analysis can only be done once for each NCSFile, every
+ *  iteration analyzes a separate copy of the script.
+ */
+class BenchmarkNCSAnalyze : public BenchmarkNCS {
+public:
+	BenchmarkNCSAnalyze(Aurora::GameID game, const ScriptShape &shape, bool stack) :
+		BenchmarkNCS(stack ? "analyze stack" : "analyze control flow", game, shape),
+		_stack(stack), _current(0) {
+
+		setAllocationLimit(stack ? 20.0 : 4.0);
+	}
+
+	void setUp() {
+		createScript();
+
+		for (size_t i = 0; i < getIterations(); i++)
+			_scripts.push_back(parseScript());
+
+		_current = 0;
+	}
+
+	void tearDown() {
+		_scripts.clear();
+
+		BenchmarkNCS::tearDown();
+	}
+
+	void run() {
+		NCSFile &ncs = *_scripts[_current++];
+
+		if (_stack)
+			ncs.analyzeStack();
+		else
+			ncs.analyzeControlFlow();
+	}
+
+private:
+	bool _stack;
+
+	Common::PtrVector<NCSFile> _scripts;
+	size_t _current;
+};
+
+/** Writing a fully analyzed script in one of the disassembler's output modes. */
+class BenchmarkNCSDisassemble : public BenchmarkNCS {
+public:
+	enum Mode {
+		kModeListing,
+		kModeListingStack,
+		kModeAssembly,
+		kModeAssemblyStack,
+		kModeDot,
+		kModeDotControlTypes
+	};
+
+	BenchmarkNCSDisassemble(Aurora::GameID game, const ScriptShape &shape, Mode mode) :
+		BenchmarkNCS(getModeName(mode), game, shape), _mode(mode), _outputSize(0) {
+
+		setAllocationLimit(40.0);
+	}
+
+	void setUp() {
+		createScript();
+
+		_disassembler.reset(new Disassembler(parseScript()));
+		_disassembler->analyzeStack();
+		_disassembler->analyzeControlFlow();
+
+		Bench::NullWriteStream output;
+		disassemble(output);
+
+		_outputSize = output.size();
+	}
+
+	void tearDown() {
+		_disassembler.reset();
+
+		BenchmarkNCS::tearDown();
+	}
+
+	void run() {
+		Bench::NullWriteStream output;
+
+		disassemble(output);
+	}
+
+	size_t getDataSize() const {
+		return _outputSize;
+	}
+
+private:
+	Mode _mode;
+
+	Common::ScopedPtr<Disassembler> _disassembler;
+	size_t _outputSize;
+
+	void disassemble(Common::WriteStream &output) {
+		switch (_mode) {
+			case kModeListing:
+			case kModeListingStack:
+				_disassembler->createListing(output, _mode == kModeListingStack);
+				break;
+
+			case kModeAssembly:
+			case kModeAssemblyStack:
+				_disassembler->createAssembly(output, _mode == kModeAssemblyStack);
+				break;
+
+			case kModeDot:
+			case kModeDotControlTypes:
+				_disassembler->createDot(output, _mode == kModeDotControlTypes);
+				break;
+		}
+	}
+
+	static const char *getModeName(Mode mode) {
+		static const char * const kNames[] = {
+			"listing", "listing+stack", "assembly", "assembly+stack", "dot", "dot+control types"
+		};
+
+		return kNames[mode];
+	}
+};
+
+
+int main(int argc, char **argv) {
+	static const Aurora::GameID kGames[] = {
+		Aurora::kGameIDNWN, Aurora::kGameIDNWN2, Aurora::kGameIDKotOR, Aurora::kGameIDKotOR2,
+		Aurora::kGameIDJade, Aurora::kGameIDWitcher, Aurora::kGameIDDragonAge, Aurora::kGameIDDragonAge2
+	};
+
+	static const BenchmarkNCSDisassemble::Mode kModes[] = {
+		BenchmarkNCSDisassemble::kModeListing,  BenchmarkNCSDisassemble::kModeListingStack,
+		BenchmarkNCSDisassemble::kModeAssembly, BenchmarkNCSDisassemble::kModeAssemblyStack,
+		BenchmarkNCSDisassemble::kModeDot,      BenchmarkNCSDisassemble::kModeDotControlTypes
+	};
+
+	// Scaling in the number of subroutines, and in the nesting depth
+	std::vector<ScriptShape> shapes;
+	shapes.push_back(ScriptShape( 16, 4, 2, 4));
+	shapes.push_back(ScriptShape( 64, 4, 2, 4));
+	shapes.push_back(ScriptShape(256, 4, 2, 4));
+	shapes.push_back(ScriptShape( 32, 3, 5, 4));
+
+	const ScriptShape gameShape(32, 4, 2, 4);
+
+	Bench::Benchmarks benchmarks;
+
+	for (size_t i = 0; i < ARRAYSIZE(kGames); i++)
+		benchmarks.push_back(new BenchmarkNCSParse(kGames[i], gameShape));
+	for (size_t i = 0; i < ARRAYSIZE(kGames); i++)
+		benchmarks.push_back(new BenchmarkNCSAnalyze(kGames[i], gameShape, true));
+	for (size_t i = 0; i < ARRAYSIZE(kGames); i++)
+		benchmarks.push_back(new BenchmarkNCSAnalyze(kGames[i], gameShape, false));
+
+	for (std::vector<ScriptShape>::const_iterator s = shapes.begin(); s != shapes.end(); ++s) {
+		benchmarks.push_back(new BenchmarkNCSParse(Aurora::kGameIDNWN, *s));
+		benchmarks.push_back(new BenchmarkNCSAnalyze(Aurora::kGameIDNWN, *s, true));
+		benchmarks.push_back(new BenchmarkNCSAnalyze(Aurora::kGameIDNWN, *s, false));
+
+		for (size_t i = 0; i < ARRAYSIZE(kModes); i++)
+			benchmarks.push_back(new BenchmarkNCSDisassemble(Aurora::kGameIDNWN, *s, kModes[i]));
+	}
+
+	return Bench::benchmarkMain(argc, argv, benchmarks);
+}
@@ -0,0 +1,78 @@
+# xoreos-tools - Tools to help with xoreos development
+#
+# xoreos-tools is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos-tools is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos-tools is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+
+
+# Benchmarks.
+#
+# These are not built by default. Use "make bench" to build and run them.
+# A benchmark program fails when it exceeds its allocation limits.
+
+bench_LIBS = \
+    src/archives/libarchives.la \
+    src/xml/libxml.la \
+    src/images/libimages.la \
+    src/nwscript/libnwscript.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    $(LDADD)
+
+bench_SOURCES = \
+    bench/benchmark.h \
+    bench/benchmark.cpp \
+    $(EMPTY)
+
+EXTRA_PROGRAMS                  += bench/bench_allocations
+bench_bench_allocations_SOURCES  = $(bench_SOURCES) bench/allocations.cpp
+bench_bench_allocations_LDADD    = $(bench_LIBS)
+
+BENCHMARKS += bench/bench_allocations
+
+EXTRA_PROGRAMS              += bench/bench_formats
+bench_bench_formats_SOURCES  = $(bench_SOURCES) bench/formats.cpp
+bench_bench_formats_LDADD    = $(bench_LIBS)
+
+BENCHMARKS += bench/bench_formats
+
+EXTRA_PROGRAMS               += bench/bench_encoding
+bench_bench_encoding_SOURCES  = $(bench_SOURCES) bench/encoding.cpp
+bench_bench_encoding_LDADD    = $(bench_LIBS)
+
+BENCHMARKS += bench/bench_encoding
+
+EXTRA_PROGRAMS              += bench/bench_deflate
+bench_bench_deflate_SOURCES  = $(bench_SOURCES) bench/deflate.cpp
+bench_bench_deflate_LDADD    = $(bench_LIBS)
+
+BENCHMARKS += bench/bench_deflate
+
+EXTRA_PROGRAMS             += bench/bench_images
+bench_bench_images_SOURCES  = $(bench_SOURCES) bench/images.cpp
+bench_bench_images_LDADD    = $(bench_LIBS)
+
+BENCHMARKS += bench/bench_images
+
+EXTRA_PROGRAMS               += bench/bench_nwscript
+bench_bench_nwscript_SOURCES  = $(bench_SOURCES) bench/nwscript.cpp
+bench_bench_nwscript_LDADD    = $(bench_LIBS)
+
+BENCHMARKS += bench/bench_nwscript
+
+.PHONY: bench
+bench: $(BENCHMARKS)
+	@for b in $(BENCHMARKS); do echo "--- $$b"; ./$$b || exit 1; done
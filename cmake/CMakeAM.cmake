@@ -53,6 +53,7 @@ function(am_target_name AM_FOLDER AM_FILE_NAME AM_OUTPUT)
   string(REPLACE "/" "_" AM_TARGET_NAME "${AM_TARGET_NAME}")
   string(REGEX REPLACE "^src_" "" AM_TARGET_NAME "${AM_TARGET_NAME}")
   string(REGEX REPLACE "^tests_tests_" "tests_" AM_TARGET_NAME "${AM_TARGET_NAME}")
+  string(REGEX REPLACE "^bench_bench_" "bench_" AM_TARGET_NAME "${AM_TARGET_NAME}")
   set(${AM_OUTPUT} ${AM_TARGET_NAME} PARENT_SCOPE)
 endfunction()
 
@@ -233,7 +234,7 @@ function(parse_automake AM_FILE_NAME)
 
   # Search for programs, creating CMake targets
   set(AM_PROGRAMS)
-  foreach(AM_FILE ${bin_PROGRAMS} ${check_PROGRAMS})
+  foreach(AM_FILE ${bin_PROGRAMS} ${check_PROGRAMS} ${EXTRA_PROGRAMS})
     string(REPLACE "." "_" AM_NAME "${AM_FILE}")
     string(REPLACE "/" "_" AM_NAME "${AM_NAME}")
     am_add_target(bin ${AM_FOLDER} ${AM_FILE} "${${AM_NAME}_SOURCES}" "${${AM_NAME}_LDADD}")
@@ -42,5 +42,6 @@ dist_man1_MANS += \
     man/ncsdis.1 \
     man/erf.1 \
     man/untws.1 \
+    man/arcdiff.1 \
     man/tws.1 \
     $(EMPTY)
@@ -52,3 +52,5 @@ include utf8cpp/rules.mk
 include src/rules.mk
 
 include tests/rules.mk
+
+include bench/rules.mk
@@ -0,0 +1,383 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Tool to list the differences between two versions of an archive.
+ */
+
+#include <cstring>
+#include <cstdio>
+
+#include <vector>
+#include <map>
+#include <exception>
+
+#include "src/version/version.h"
+
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/strutil.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/memreadstream.h"
+#include "src/common/cli.h"
+
+#include "src/aurora/archive.h"
+
+#include "src/archives/util.h"
+#include "src/archives/input.h"
+
+#include "src/util.h"
+
+/** A resource within one of the archives making up one side of the diff. */
+struct Resource {
+	const Aurora::Archive *archive;
+	uint32 index;
+
+	Resource(const Aurora::Archive *a = 0, uint32 i = 0) : archive(a), index(i) { }
+};
+
+/** All resources on one side of the diff, sorted by their path. */
+typedef std::map<Common::UString, Resource> ResourceMap;
+
+enum DiffStatus {
+	kStatusAdded,
+	kStatusRemoved,
+	kStatusChanged,
+	kStatusUnchanged,
+	kStatusError,
+	kStatusMAX
+};
+
+const char kStatusChar[kStatusMAX] = { 'A', 'D', 'M', '=', 'E' };
+
+/** A resource found in both archives, whose contents still need to be compared. */
+struct CompareEntry {
+	Common::UString path;
+	Resource oldResource;
+	Resource newResource;
+
+	Common::ScopedPtr<Common::MemoryReadStream>   oldPacked;
+	Common::ScopedPtr<Common::MemoryReadStream>   newPacked;
+	Common::ScopedPtr<Common::SeekableReadStream> oldStream;
+	Common::ScopedPtr<Common::SeekableReadStream> newStream;
+
+	bool changed;
+
+	std::exception_ptr error;
+
+	CompareEntry(const Common::UString &p, const Resource &o, const Resource &n) :
+		path(p), oldResource(o), newResource(n), changed(false) {
+	}
+};
+
+/** A line of the diff's output. */
+struct DiffEntry {
+	Common::UString path;
+	DiffStatus status;
+	CompareEntry *compare; ///< The comparison deciding the status, if still pending.
+
+	DiffEntry(const Common::UString &p, DiffStatus s, CompareEntry *c = 0) :
+		path(p), status(s), compare(c) {
+	}
+};
+
+bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
+                      Common::UString &oldFile, Common::UString &newFile);
+
+void collectResources(const Common::PtrVector<Aurora::Archive> &archives, ResourceMap &resources);
+
+int diffArchives(const Common::PtrVector<Aurora::Archive> &oldArchives,
+                 const Common::PtrVector<Aurora::Archive> &newArchives);
+
+int main(int argc, char **argv) {
+	initPlatform();
+
+	// Like diff(1), errors are set apart from differences
+	int status = 2;
+
+	try {
+		std::vector<Common::UString> args;
+		Common::Platform::getParameters(argc, argv, args);
+
+		int returnValue = 1;
+		Common::UString oldFile, newFile;
+
+		if (!parseCommandLine(args, returnValue, oldFile, newFile))
+			return (returnValue == 0) ? 0 : 2;
+
+		Common::PtrVector<Aurora::Archive> oldArchives, newArchives;
+
+		Archives::openArchives(oldFile, oldArchives);
+		Archives::openArchives(newFile, newArchives);
+
+		status = diffArchives(oldArchives, newArchives);
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+	} catch (std::exception &e) {
+		Common::Exception se(e);
+		Common::printException(se);
+	} catch (...) {
+		Common::Exception se("Unknown exception caught");
+		Common::printException(se);
+	}
+
+	deinitPlatform();
+	return status;
+}
+
+bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
+                      Common::UString &oldFile, Common::UString &newFile) {
+	using Common::CLI::Parser;
+	using Common::CLI::ValGetter;
+	using Common::CLI::NoOption;
+	using Common::CLI::makeEndArgs;
+	NoOption oldFileOpt(false, new ValGetter<Common::UString &>(oldFile, "old archive"));
+	NoOption newFileOpt(false, new ValGetter<Common::UString &>(newFile, "new archive"));
+	Parser parser(argv[0], "BioWare archive differ\n",
+	              "Lists the resources that were added (A), removed (D) or changed (M)\n"
+	              "between two versions of an ERF, RIM, HERF or ZIP archive, or of a KEY\n"
+	              "file together with the BIF files it indexes.\n\n"
+	              "Examples:\n"
+	              "arcdiff old/foo.mod new/foo.mod\n"
+	              "arcdiff old/chitin.key new/chitin.key",
+	              returnValue, makeEndArgs(&oldFileOpt, &newFileOpt));
+
+	addThreadCountOption(parser);
+
+	return parser.process(argv);
+}
+
+/** Index the resources of all archives by their path.
+ *
+ *  Resources without a name are indexed by the path of their known name, or
+ *  their hash, so that archives of the same kind can still be compared. If
+ *  several archives hold the same resource, the last one wins, as it would
+ *  in the game.
+ */
+void collectResources(const Common::PtrVector<Aurora::Archive> &archives, ResourceMap &resources) {
+	for (Common::PtrVector<Aurora::Archive>::const_iterator a = archives.begin(); a != archives.end(); ++a) {
+		const Aurora::Archive::ResourceList &list = (*a)->getResources();
+
+		for (Aurora::Archive::ResourceList::const_iterator r = list.begin(); r != list.end(); ++r) {
+			const Common::UString path = Archives::findPath(r->name, r->type, r->hash, (*a)->getNameHashAlgo());
+
+			resources[path.toLower()] = Resource(*a, r->index);
+		}
+	}
+}
+
+static bool compareStreams(Common::SeekableReadStream &stream1, Common::SeekableReadStream &stream2) {
+	if (stream1.size() != stream2.size())
+		return false;
+
+	static const size_t kBufferSize = 64 * 1024;
+
+	Common::ScopedArray<byte> buffer1(new byte[kBufferSize]);
+	Common::ScopedArray<byte> buffer2(new byte[kBufferSize]);
+
+	stream1.seek(0);
+	stream2.seek(0);
+
+	size_t size = stream1.size();
+	while (size > 0) {
+		const size_t chunk = MIN(size, kBufferSize);
+
+		if ((stream1.read(buffer1.get(), chunk) != chunk) || (stream2.read(buffer2.get(), chunk) != chunk))
+			throw Common::Exception(Common::kReadError);
+
+		if (std::memcmp(buffer1.get(), buffer2.get(), chunk) != 0)
+			return false;
+
+		size -= chunk;
+	}
+
+	return true;
+}
+
+/** Read a resource from its archive. Packed resources are only read, to be unpacked later. */
+static void readResource(const Resource &resource, Common::ScopedPtr<Common::MemoryReadStream> &packed,
+                         Common::ScopedPtr<Common::SeekableReadStream> &stream) {
+
+	packed.reset(resource.archive->getPackedResource(resource.index));
+	if (!packed)
+		stream.reset(resource.archive->getResource(resource.index));
+}
+
+/** Read resource pairs from the archives, and unpack and compare them.
+ *
+ *  Like when extracting, the archives are read one resource at a time, and
+ *  the unpacking and comparing is then done in parallel.
+ */
+class ComparePipeline : public Archives::ResourcePipeline {
+public:
+	ComparePipeline(Common::PtrVector<CompareEntry> &entries) : _entries(entries) {
+	}
+
+	size_t read(size_t index) {
+		CompareEntry &entry = *_entries[index];
+
+		try {
+			readResource(entry.oldResource, entry.oldPacked, entry.oldStream);
+			readResource(entry.newResource, entry.newPacked, entry.newStream);
+		} catch (...) {
+			entry.error = std::current_exception();
+			return 0;
+		}
+
+		return (entry.oldPacked ? entry.oldPacked->size() : entry.oldStream->size()) +
+		       (entry.newPacked ? entry.newPacked->size() : entry.newStream->size());
+	}
+
+	void unpack(size_t index) {
+		CompareEntry &entry = *_entries[index];
+		if (entry.error)
+			return;
+
+		try {
+			if (entry.oldPacked)
+				entry.oldStream.reset(entry.oldResource.archive->unpackResource(entry.oldResource.index,
+				                                                                entry.oldPacked.release()));
+			if (entry.newPacked)
+				entry.newStream.reset(entry.newResource.archive->unpackResource(entry.newResource.index,
+				                                                                entry.newPacked.release()));
+
+			entry.changed = !compareStreams(*entry.oldStream, *entry.newStream);
+		} catch (...) {
+			entry.error = std::current_exception();
+		}
+
+		entry.oldStream.reset();
+		entry.newStream.reset();
+	}
+
+	void finish(size_t UNUSED(index)) {
+	}
+
+private:
+	Common::PtrVector<CompareEntry> &_entries;
+};
+
+/** Print why comparing this resource failed. */
+static void printCompareError(const CompareEntry &entry) {
+	const Common::UString reason = Common::UString::format("Failed to compare \"%s\"", entry.path.c_str());
+
+	try {
+		std::rethrow_exception(entry.error);
+	} catch (Common::Exception &e) {
+		e.add("%s", reason.c_str());
+		Common::printException(e);
+	} catch (std::exception &e) {
+		Common::Exception se(e);
+		se.add("%s", reason.c_str());
+		Common::printException(se);
+	} catch (...) {
+		Common::Exception se("%s", reason.c_str());
+		Common::printException(se);
+	}
+}
+
+/** Print the resources that differ between the two sets of archives.
+ *
+ *  Resources are matched by their path. A resource whose size changed has
+ *  changed; only the contents of resources with the same size are read and
+ *  compared. A resource that can't be read is listed as an error, and the
+ *  remaining resources are still compared.
+ *
+ *  Return 0 if the archives are the same, 1 if they differ and 2 if any
+ *  resource couldn't be compared.
+ */
+int diffArchives(const Common::PtrVector<Aurora::Archive> &oldArchives,
+                 const Common::PtrVector<Aurora::Archive> &newArchives) {
+
+	ResourceMap oldResources, newResources;
+
+	collectResources(oldArchives, oldResources);
+	collectResources(newArchives, newResources);
+
+	std::vector<DiffEntry> diff;
+	Common::PtrVector<CompareEntry> compare;
+
+	ResourceMap::const_iterator o = oldResources.begin();
+	ResourceMap::const_iterator n = newResources.begin();
+	while ((o != oldResources.end()) || (n != newResources.end())) {
+		if ((n == newResources.end()) || ((o != oldResources.end()) && (o->first < n->first))) {
+			diff.push_back(DiffEntry(o->first, kStatusRemoved));
+			++o;
+			continue;
+		}
+
+		if ((o == oldResources.end()) || (n->first < o->first)) {
+			diff.push_back(DiffEntry(n->first, kStatusAdded));
+			++n;
+			continue;
+		}
+
+		const uint32 oldSize = o->second.archive->getResourceSize(o->second.index);
+		const uint32 newSize = n->second.archive->getResourceSize(n->second.index);
+
+		if ((oldSize != 0xFFFFFFFF) && (newSize != 0xFFFFFFFF) && (oldSize != newSize)) {
+			diff.push_back(DiffEntry(o->first, kStatusChanged));
+		} else {
+			compare.push_back(new CompareEntry(o->first, o->second, n->second));
+			diff.push_back(DiffEntry(o->first, kStatusUnchanged, compare.back()));
+		}
+
+		++o;
+		++n;
+	}
+
+	ComparePipeline pipeline(compare);
+	Archives::runPipeline(compare.size(), pipeline);
+
+	size_t counts[kStatusMAX] = { 0 };
+
+	for (std::vector<DiffEntry>::iterator d = diff.begin(); d != diff.end(); ++d) {
+		if (d->compare && d->compare->error) {
+			printCompareError(*d->compare);
+			d->status = kStatusError;
+		} else if (d->compare && d->compare->changed)
+			d->status = kStatusChanged;
+
+		counts[d->status]++;
+
+		if (d->status != kStatusUnchanged)
+			std::printf("%c\t%s\n", kStatusChar[d->status], d->path.c_str());
+	}
+
+	std::printf("\n%s added, %s removed, %s changed, %s unchanged",
+	            Common::composeString(counts[kStatusAdded]).c_str(),
+	            Common::composeString(counts[kStatusRemoved]).c_str(),
+	            Common::composeString(counts[kStatusChanged]).c_str(),
+	            Common::composeString(counts[kStatusUnchanged]).c_str());
+
+	if (counts[kStatusError] > 0)
+		std::printf(", %s failed", Common::composeString(counts[kStatusError]).c_str());
+
+	std::printf("\n");
+
+	if (counts[kStatusError] > 0)
+		return 2;
+
+	return ((counts[kStatusAdded] + counts[kStatusRemoved] + counts[kStatusChanged]) > 0) ? 1 : 0;
+}
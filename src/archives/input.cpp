@@ -0,0 +1,329 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Opening archives, and files within archives, as tool inputs.
+ */
+
+#include <cstring>
+
+#include "src/common/scopedptr.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/readstream.h"
+#include "src/common/readfile.h"
+#include "src/common/filepath.h"
+
+#include "src/aurora/util.h"
+#include "src/aurora/resref.h"
+#include "src/aurora/archive.h"
+#include "src/aurora/erffile.h"
+#include "src/aurora/rimfile.h"
+#include "src/aurora/herffile.h"
+#include "src/aurora/zipfile.h"
+#include "src/aurora/keyfile.h"
+#include "src/aurora/keydatafile.h"
+#include "src/aurora/biffile.h"
+#include "src/aurora/bzffile.h"
+
+#include "src/archives/input.h"
+#include "src/archives/util.h"
+
+namespace Archives {
+
+/** A resource read out of an archive, keeping the archives it was read from open. */
+class ArchiveMemberStream : public Common::SeekableReadStream {
+public:
+	ArchiveMemberStream(Common::PtrVector<Aurora::Archive> &archives, Common::SeekableReadStream *stream) :
+		_stream(stream) {
+
+		_archives.swap(archives);
+	}
+
+	~ArchiveMemberStream() {
+		_stream.reset();
+
+		// Nested archives read from their parents, so close them in reverse
+		while (!_archives.empty())
+			_archives.pop_back();
+	}
+
+	bool eos() const {
+		return _stream->eos();
+	}
+
+	size_t read(void *dataPtr, size_t dataSize) {
+		return _stream->read(dataPtr, dataSize);
+	}
+
+	size_t pos() const {
+		return _stream->pos();
+	}
+
+	size_t size() const {
+		return _stream->size();
+	}
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin) {
+		return _stream->seek(offset, whence);
+	}
+
+private:
+	Common::PtrVector<Aurora::Archive> _archives;
+	Common::ScopedPtr<Common::SeekableReadStream> _stream;
+};
+
+
+/** Find a BIF indexed by a KEY, relative to the directory the KEY is in. */
+static Common::UString findKEYDataFile(const Common::UString &keyDir, const Common::UString &bif) {
+	Common::UString bifPath = bif;
+	bifPath.replaceAll('\\', '/');
+
+	const Common::UString bifFile = Common::FilePath::getFile(bifPath);
+
+	Common::UString dir = keyDir;
+
+	const Common::UString bifDir = Common::FilePath::getDirectory(bifPath);
+	if (!bifDir.empty())
+		dir = Common::FilePath::findSubDirectory(keyDir, bifDir, true);
+
+	if (!dir.empty()) {
+		const Common::UString candidates[] = {
+			bifFile, bifFile.toLower(), bifFile.toUpper(),
+			Common::FilePath::changeExtension(bifFile, ".bzf"),
+			Common::FilePath::changeExtension(bifFile.toLower(), ".bzf")
+		};
+
+		for (size_t i = 0; i < ARRAYSIZE(candidates); i++) {
+			const Common::UString path = dir + "/" + candidates[i];
+			if (Common::FilePath::isRegularFile(path))
+				return path;
+		}
+	}
+
+	throw Common::Exception("Can't find \"%s\", indexed by the KEY file", bif.c_str());
+}
+
+/** Open the BIF/BZF with this index within a KEY, giving its resources the names from the KEY. */
+static Aurora::KEYDataFile *openKEYDataFile(const Aurora::KEYFile &key, const Common::UString &keyDir, uint32 index) {
+	const Common::UString bifPath = findKEYDataFile(keyDir, key.getBIFs()[index]);
+
+	Common::ScopedPtr<Aurora::KEYDataFile> bif;
+	if (Common::FilePath::getExtension(bifPath).equalsIgnoreCase(".bzf"))
+		bif.reset(new Aurora::BZFFile(new Common::ReadFile(bifPath)));
+	else
+		bif.reset(new Aurora::BIFFile(new Common::ReadFile(bifPath)));
+
+	bif->mergeKEY(key, index);
+
+	return bif.release();
+}
+
+static Common::UString getKEYDirectory(const Common::UString &file) {
+	return Common::FilePath::getDirectory(Common::FilePath::absolutize(file));
+}
+
+static void openKEY(const Common::UString &file, Common::PtrVector<Aurora::Archive> &archives) {
+	Common::ReadFile keyFile(file);
+	Aurora::KEYFile key(keyFile);
+
+	const Common::UString keyDir = getKEYDirectory(file);
+
+	for (size_t i = 0; i < key.getBIFs().size(); i++)
+		archives.push_back(openKEYDataFile(key, keyDir, i));
+}
+
+/** Look up a member in the index of a KEY, returning the index of its resource or 0xFFFFFFFF. */
+static uint32 findKEYMember(const Aurora::KEYFile &key, const Common::UString &member) {
+	Common::UString name = member;
+	const Aurora::FileType type = TypeMan.splitFileType(name);
+
+	if (!Aurora::ResRef::fits(name))
+		return 0xFFFFFFFF;
+
+	const uint32 index = key.findResource(Aurora::ResRef(name), type);
+	if ((index == 0xFFFFFFFF) || (key.getResources()[index].bifIndex >= key.getBIFs().size()))
+		return 0xFFFFFFFF;
+
+	return index;
+}
+
+static uint32 readArchiveID(Common::SeekableReadStream &stream) {
+	uint32 id = 0;
+
+	if (stream.size() >= 4) {
+		id = stream.readUint32BE();
+		stream.seek(0);
+	}
+
+	return id;
+}
+
+/** Open a self-contained archive, detecting its type by its magic ID. */
+static Aurora::Archive *openArchive(Common::SeekableReadStream *stream, uint32 id) {
+	Common::ScopedPtr<Common::SeekableReadStream> archive(stream);
+
+	if (id == MKTAG('K', 'E', 'Y', ' '))
+		throw Common::Exception("KEY files can only be opened from the filesystem");
+
+	if (id == MKTAG('R', 'I', 'M', ' '))
+		return new Aurora::RIMFile(archive.release());
+	if (id == 0xC0A5F100)
+		return new Aurora::HERFFile(archive.release());
+	if ((id >> 16) == MKTAG_16('P', 'K'))
+		return new Aurora::ZIPFile(archive.release());
+
+	return new Aurora::ERFFile(archive.release());
+}
+
+void openArchives(const Common::UString &file, Common::PtrVector<Aurora::Archive> &archives) {
+	Common::ScopedPtr<Common::SeekableReadStream> archive(new Common::ReadFile(file));
+
+	const uint32 id = readArchiveID(*archive);
+
+	if (id == MKTAG('K', 'E', 'Y', ' '))
+		openKEY(file, archives);
+	else
+		archives.push_back(openArchive(archive.release(), id));
+}
+
+bool splitArchiveMember(const Common::UString &input, Common::UString &archive, Common::UString &member) {
+	if (Common::FilePath::isRegularFile(input))
+		return false;
+
+	const char *str = input.c_str();
+	for (const char *colon = std::strchr(str, ':'); colon; colon = std::strchr(colon + 1, ':')) {
+		const Common::UString file(str, colon - str);
+		if (file.empty() || !Common::FilePath::isRegularFile(file))
+			continue;
+
+		archive = file;
+		member  = colon + 1;
+
+		return true;
+	}
+
+	return false;
+}
+
+/** If the file is a KEY, open only the BIF/BZF that holds the member.
+ *
+ *  The member, or the nested archive at its start, is looked up in the
+ *  KEY's index, so that the other BIF/BZF files don't need to be opened.
+ *  Returns false if the file is not a KEY or the member can't be found this way.
+ */
+static bool openKEYMember(const Common::UString &file, const Common::UString &member,
+                          Common::PtrVector<Aurora::Archive> &archives) {
+
+	Common::ReadFile keyFile(file);
+	if (readArchiveID(keyFile) != MKTAG('K', 'E', 'Y', ' '))
+		return false;
+
+	Aurora::KEYFile key(keyFile);
+
+	uint32 index = findKEYMember(key, member);
+	if (index == 0xFFFFFFFF) {
+		const char *str   = member.c_str();
+		const char *colon = std::strchr(str, ':');
+
+		if (colon)
+			index = findKEYMember(key, Common::UString(str, colon - str));
+	}
+
+	if (index == 0xFFFFFFFF)
+		return false;
+
+	archives.push_back(openKEYDataFile(key, getKEYDirectory(file), key.getResources()[index].bifIndex));
+	return true;
+}
+
+/** Find the resource with this path in the archives from first onwards.
+ *
+ *  If several archives hold the same resource, the last one wins, as it would in the game.
+ */
+static bool findMember(const Common::PtrVector<Aurora::Archive> &archives, size_t first,
+                       const Common::UString &member, const Aurora::Archive *&archive, uint32 &index) {
+
+	Common::UString path = member;
+	path.replaceAll('\\', '/');
+
+	bool found = false;
+
+	for (Common::PtrVector<Aurora::Archive>::const_iterator a = archives.begin() + first; a != archives.end(); ++a) {
+		const Aurora::Archive::ResourceList &resources = (*a)->getResources();
+
+		for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			if (!findPath(r->name, r->type, r->hash, (*a)->getNameHashAlgo()).equalsIgnoreCase(path))
+				continue;
+
+			archive = *a;
+			index   = r->index;
+			found   = true;
+		}
+	}
+
+	return found;
+}
+
+Common::SeekableReadStream *openInputFile(const Common::UString &input) {
+	Common::UString archiveFile, member;
+	if (!splitArchiveMember(input, archiveFile, member))
+		return new Common::ReadFile(input);
+
+	Common::PtrVector<Aurora::Archive> archives;
+	if (!openKEYMember(archiveFile, member, archives))
+		openArchives(archiveFile, archives);
+
+	Common::UString container = archiveFile;
+	size_t first = 0;
+
+	while (true) {
+		const Aurora::Archive *archive = 0;
+		uint32 index = 0;
+
+		if (findMember(archives, first, member, archive, index)) {
+			Common::ScopedPtr<Common::SeekableReadStream> stream(archive->getResource(index, true));
+
+			return new ArchiveMemberStream(archives, stream.release());
+		}
+
+		// Not a resource by that name, so maybe a resource within a nested archive
+		const char *str   = member.c_str();
+		const char *colon = std::strchr(str, ':');
+
+		const Common::UString nested(str, colon ? (colon - str) : 0);
+		if (!colon || !findMember(archives, first, nested, archive, index))
+			throw Common::Exception("No file \"%s\" in archive \"%s\"", member.c_str(), container.c_str());
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive->getResource(index, true));
+		const uint32 id = readArchiveID(*stream);
+
+		// Only look in the nested archive from now on, but keep its parents open
+		archives.push_back(openArchive(stream.release(), id));
+		first = archives.size() - 1;
+
+		const Common::UString rest(colon + 1);
+
+		container = container + ":" + nested;
+		member    = rest;
+	}
+}
+
+} // End of namespace Archives
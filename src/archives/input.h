@@ -0,0 +1,73 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Opening archives, and files within archives, as tool inputs.
+ */
+
+#ifndef ARCHIVES_INPUT_H
+#define ARCHIVES_INPUT_H
+
+#include "src/common/ustring.h"
+#include "src/common/ptrvector.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
+
+namespace Aurora {
+	class Archive;
+}
+
+namespace Archives {
+
+/** Open an archive file, detecting its type by its magic ID.
+ *
+ *  KEY, RIM, HERF and ZIP files are recognized, everything else is read as
+ *  an ERF. A KEY file opens all the BIF/BZF files it indexes, found relative
+ *  to the KEY's directory, and adds them to the list instead of the KEY.
+ */
+void openArchives(const Common::UString &file, Common::PtrVector<Aurora::Archive> &archives);
+
+/** Split an input of the form "archive:member" into its archive and member parts.
+ *
+ *  If the input names an existing file, it is taken as-is and false is
+ *  returned. Otherwise, the input is split at the first colon that ends
+ *  the name of an existing file. The member can itself name a member of
+ *  a nested archive, like "data.erf:module.mod:area001.are".
+ */
+bool splitArchiveMember(const Common::UString &input, Common::UString &archive, Common::UString &member);
+
+/** Open a tool's input file for reading.
+ *
+ *  The input can be either a plain file, or a resource within an archive,
+ *  given as "archive:member" (see splitArchiveMember()). Members are named
+ *  by their full path, as listed by the archive tools, for example
+ *  "module.mod:area001.are" or "chitin.key:appearance.2da".
+ *
+ *  Uncompressed resources are read straight from the archive file,
+ *  without copying them into memory first. Members of a KEY are looked
+ *  up in the KEY's index, and only the BIF/BZF holding them is opened.
+ */
+Common::SeekableReadStream *openInputFile(const Common::UString &input);
+
+} // End of namespace Archives
+
+#endif // ARCHIVES_INPUT_H
@@ -26,10 +26,12 @@ src_archives_libarchives_la_SOURCES += \
     src/archives/files_dragonage.h \
     src/archives/files_sonic.h \
     src/archives/util.h \
+    src/archives/input.h \
     $(EMPTY)
 
 src_archives_libarchives_la_SOURCES += \
     src/archives/files_dragonage.cpp \
     src/archives/files_sonic.cpp \
     src/archives/util.cpp \
+    src/archives/input.cpp \
     $(EMPTY)
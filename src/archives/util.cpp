@@ -23,17 +23,28 @@
  */
 
 #include <cstdio>
+#include <cstring>
 
 #include <vector>
+#include <chrono>
+#include <utility>
+#include <exception>
+#include <thread>
+
+#include <boost/noncopyable.hpp>
 
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/hash.h"
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/filepath.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/writefile.h"
+#include "src/common/parallel.h"
+#include "src/common/boundedqueue.h"
 
 #include "src/aurora/util.h"
 #include "src/aurora/archive.h"
@@ -46,13 +57,15 @@
 
 namespace Archives {
 
-static Common::UString findPath(const Common::UString &name, Aurora::FileType type,
-                                uint64 hash, Common::HashAlgo algo) {
+Common::UString findPath(const Common::UString &name, Aurora::FileType type,
+                         uint64 hash, Common::HashAlgo algo) {
 
 	Common::UString path;
 
-	if (!name.empty())
-		path = TypeMan.addFileType(name, type);
+	if (!name.empty()) {
+		path = name;
+		TypeMan.appendFileType(path, type);
+	}
 
 	if (path.empty()) {
 		const char * const fromDAHash = findDragonAgeFile(hash, algo);
@@ -66,8 +79,10 @@ static Common::UString findPath(const Common::UString &name, Aurora::FileType ty
 			path = fromSonicHash;
 	}
 
-	if (path.empty())
-		path = TypeMan.addFileType(Common::formatHash(hash), type);
+	if (path.empty()) {
+		path = Common::formatHash(hash);
+		TypeMan.appendFileType(path, type);
+	}
 
 	path.replaceAll('\\', '/');
 
@@ -80,11 +95,262 @@ struct FileEntry {
 	uint32 size;
 	uint32 bifIndex;
 
-	FileEntry(const Common::UString &f = "", const Common::UString &e = "", uint32 s = 0xFFFFFFFF) :
-		file(f), ext(e), size(s), bifIndex(0xFFFFFFFF) { }
+	FileEntry(Common::UString f = "", Common::UString e = "", uint32 s = 0xFFFFFFFF) :
+		file(std::move(f)), ext(std::move(e)), size(s), bifIndex(0xFFFFFFFF) { }
+};
+
+/** Writes machine-readable listings to stdout, through a large buffer.
+ *
+ *  The records are written field by field, and strings can be written in
+ *  pieces, so that no temporary strings need to be constructed.
+ */
+class ListWriter : boost::noncopyable {
+public:
+	ListWriter(ListFormat format) : _format(format), _buffer(new char[kBufferSize]), _size(0), _fieldCount(0) {
+	}
+
+	~ListWriter() {
+		flush();
+	}
+
+	/** Write the header line naming the fields, if the format has one. */
+	void writeHeader(const char * const *fields, size_t count) {
+		if (_format != kListFormatTSV)
+			return;
+
+		for (size_t i = 0; i < count; i++) {
+			if (i > 0)
+				put('\t');
+
+			put(fields[i]);
+		}
+
+		put('\n');
+	}
+
+	void beginRecord() {
+		_fieldCount = 0;
+
+		if (_format == kListFormatJSONL)
+			put('{');
+	}
+
+	void endRecord() {
+		if (_format == kListFormatJSONL)
+			put('}');
+
+		put('\n');
+	}
+
+	void beginString(const char *name) {
+		beginField(name);
+
+		if (_format == kListFormatJSONL)
+			put('"');
+	}
+
+	void appendString(const char *str) {
+		appendString(str, std::strlen(str));
+	}
+
+	void appendString(const char *str, size_t length) {
+		for (size_t i = 0; i < length; i++)
+			putEscaped(str[i]);
+	}
+
+	/** Append a hash, formatted like Common::formatHash(). */
+	void appendHash(uint64 hash) {
+		static const char kDigits[] = "0123456789ABCDEF";
+
+		put('0');
+		put('x');
+
+		for (int shift = 60; shift >= 0; shift -= 4)
+			put(kDigits[(hash >> shift) & 0xF]);
+	}
+
+	void endString() {
+		if (_format == kListFormatJSONL)
+			put('"');
+	}
+
+	void addString(const char *name, const char *str) {
+		beginString(name);
+		appendString(str);
+		endString();
+	}
+
+	void addHash(const char *name, uint64 hash) {
+		beginString(name);
+		appendHash(hash);
+		endString();
+	}
+
+	void addNumber(const char *name, uint64 number) {
+		beginField(name);
+
+		char digits[20];
+		size_t count = 0;
+
+		do {
+			digits[count++] = '0' + (number % 10);
+			number /= 10;
+		} while (number > 0);
+
+		while (count > 0)
+			put(digits[--count]);
+	}
+
+	/** Add a field whose value is unknown. */
+	void addNull(const char *name) {
+		beginField(name);
+
+		if (_format == kListFormatJSONL)
+			put("null");
+	}
+
+	void flush() {
+		if (_size > 0)
+			std::fwrite(_buffer.get(), 1, _size, stdout);
+
+		_size = 0;
+	}
+
+private:
+	static const size_t kBufferSize = 1024 * 1024;
+
+	ListFormat _format;
+
+	Common::ScopedArray<char> _buffer;
+	size_t _size;
+
+	size_t _fieldCount; ///< Number of fields written in the current record.
+
+	void put(char c) {
+		if (_size == kBufferSize)
+			flush();
+
+		_buffer[_size++] = c;
+	}
+
+	void put(const char *str) {
+		while (*str)
+			put(*str++);
+	}
+
+	void putEscaped(char c) {
+		static const char kDigits[] = "0123456789abcdef";
+
+		if (c == '\\') {
+			put("\\\\");
+		} else if (c == '\t') {
+			put("\\t");
+		} else if (c == '\n') {
+			put("\\n");
+		} else if (c == '\r') {
+			put("\\r");
+		} else if ((c == '"') && (_format == kListFormatJSONL)) {
+			put("\\\"");
+		} else if (((byte) c < 0x20) && (_format == kListFormatJSONL)) {
+			put("\\u00");
+			put(kDigits[((byte) c) >> 4]);
+			put(kDigits[((byte) c) & 0xF]);
+		} else
+			put(c);
+	}
+
+	void beginField(const char *name) {
+		if (_fieldCount++ > 0)
+			put((_format == kListFormatJSONL) ? ',' : '\t');
+
+		if (_format == kListFormatJSONL) {
+			put('"');
+			put(name);
+			put("\":");
+		}
+	}
 };
 
-void listFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directories) {
+/** Write the path of a resource, the same one findPath() returns. */
+static void writePath(ListWriter &writer, const Aurora::Archive::Resource &resource,
+                      Aurora::FileType type, Common::HashAlgo algo) {
+
+	writer.beginString("name");
+
+	const char *fromDAHash = 0, *fromSonicHash = 0;
+
+	if (!resource.name.empty()) {
+		writer.appendString(resource.name.c_str());
+		writer.appendString(TypeMan.getExtension(type));
+
+	} else if ((fromDAHash = findDragonAgeFile(resource.hash, algo)) != 0) {
+		const char *ext = std::strrchr(fromDAHash, '.');
+		if (ext && std::strchr(ext, '/'))
+			ext = 0;
+
+		writer.appendString(fromDAHash, ext ? (ext - fromDAHash) : std::strlen(fromDAHash));
+		writer.appendString(TypeMan.getExtension(type));
+
+	} else if ((fromSonicHash = findSonicFile(resource.hash, algo)) != 0) {
+		writer.appendString(fromSonicHash);
+
+	} else {
+		writer.appendHash(resource.hash);
+		writer.appendString(TypeMan.getExtension(type));
+	}
+
+	writer.endString();
+}
+
+static void listFilesMachineReadable(const Aurora::Archive &archive, Aurora::GameID game, ListFormat format) {
+	static const char * const kFields[] = { "name", "hash", "offset", "packed_size", "size", "compression" };
+
+	const Common::HashAlgo algo = archive.getNameHashAlgo();
+
+	ListWriter writer(format);
+	writer.writeHeader(kFields, ARRAYSIZE(kFields));
+
+	const Aurora::Archive::ResourceList &resources = archive.getResources();
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		writer.beginRecord();
+
+		writePath(writer, *r, TypeMan.aliasFileType(r->type, game), algo);
+
+		if (algo != Common::kHashNone)
+			writer.addHash(kFields[1], r->hash);
+		else
+			writer.addNull(kFields[1]);
+
+		Aurora::Archive::ResourceStorage storage;
+		if (archive.getResourceStorage(r->index, storage)) {
+			writer.addNumber(kFields[2], storage.offset);
+			writer.addNumber(kFields[3], storage.packedSize);
+			writer.addNumber(kFields[4], storage.size);
+			writer.addString(kFields[5], storage.compression ? storage.compression : "none");
+		} else {
+			const uint32 size = archive.getResourceSize(r->index);
+
+			writer.addNull(kFields[2]);
+			writer.addNull(kFields[3]);
+
+			if (size != 0xFFFFFFFF)
+				writer.addNumber(kFields[4], size);
+			else
+				writer.addNull(kFields[4]);
+
+			writer.addNull(kFields[5]);
+		}
+
+		writer.endRecord();
+	}
+}
+
+void listFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directories, ListFormat format) {
+	if (format != kListFormatTable) {
+		listFilesMachineReadable(archive, game, format);
+		return;
+	}
+
 	const Aurora::Archive::ResourceList &resources = archive.getResources();
 	const size_t fileCount = resources.size();
 
@@ -97,15 +363,20 @@ void listFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directo
 	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
 		const Aurora::FileType type = TypeMan.aliasFileType(r->type, game);
 
-		const Common::UString path     = findPath(r->name, type, r->hash, archive.getNameHashAlgo());
-		const Common::UString fileName = Common::FilePath::getFile(path);
-		const Common::UString name     = directories ? path :  Common::FilePath::getStem(fileName);
-		const Common::UString ext      = directories ? "" : Common::FilePath::getExtension(path);
+		Common::UString path = findPath(r->name, type, r->hash, archive.getNameHashAlgo());
+		Common::UString name, ext;
+
+		if (directories) {
+			name = std::move(path);
+		} else {
+			name = Common::FilePath::getStem(Common::FilePath::getFile(path));
+			ext  = Common::FilePath::getExtension(path);
+		}
 
 		nameLength = MAX<size_t>(nameLength, name.size());
 		extLength = MAX<size_t>(extLength, ext.size());
 
-		fileEntries.push_back(FileEntry(name, ext, archive.getResourceSize(r->index)));
+		fileEntries.push_back(FileEntry(std::move(name), std::move(ext), archive.getResourceSize(r->index)));
 	}
 
 	size_t namePrintLength = MAX<size_t>(10, nameLength + extLength + 1);
@@ -145,7 +416,7 @@ void listFiles(const Aurora::KEYFile &key, const Common::UString &keyName, Auror
 		nameLength = MAX<size_t>(nameLength, r->name.size());
 		extLength = MAX<size_t>(extLength, ext.size());
 
-		fileEntries.push_back(FileEntry(r->name, ext));
+		fileEntries.push_back(FileEntry(r->name.getString(), ext));
 		fileEntries.back().bifIndex = r->bifIndex;
 	}
 
@@ -169,6 +440,40 @@ void listFiles(const Aurora::KEYFile &key, const Common::UString &keyName, Auror
 	}
 }
 
+void listFiles(const std::vector<Aurora::KEYFile *> &keys, const std::vector<Common::UString> &keyNames,
+               Aurora::GameID game, ListFormat format) {
+
+	static const char * const kFields[] = { "key", "name", "bif", "resource_index" };
+
+	ListWriter writer(format);
+	writer.writeHeader(kFields, ARRAYSIZE(kFields));
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		const Aurora::KEYFile::BIFList &bifs = keys[i]->getBIFs();
+
+		const Aurora::KEYFile::ResourceList &resources = keys[i]->getResources();
+		for (Aurora::KEYFile::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			writer.beginRecord();
+
+			writer.addString(kFields[0], keyNames[i].c_str());
+
+			writer.beginString(kFields[1]);
+			writer.appendString(r->name.getString().c_str());
+			writer.appendString(TypeMan.getExtension(TypeMan.aliasFileType(r->type, game)));
+			writer.endString();
+
+			if (r->bifIndex < bifs.size())
+				writer.addString(kFields[2], bifs[r->bifIndex].c_str());
+			else
+				writer.addNull(kFields[2]);
+
+			writer.addNumber(kFields[3], r->resIndex);
+
+			writer.endRecord();
+		}
+	}
+}
+
 void listFiles(const Aurora::NSBTXFile &nsbtx) {
 	const Aurora::Archive::ResourceList &resources = nsbtx.getResources();
 	const size_t fileCount = resources.size();
@@ -193,6 +498,264 @@ static void dumpStream(Common::SeekableReadStream &stream, const Common::UString
 	file.close();
 }
 
+/** A resource that's being extracted from an archive. */
+struct ExtractEntry {
+	uint32 index;         ///< The resource's index within the archive.
+	size_t number;        ///< The resource's position in the archive, for display.
+	Common::UString name; ///< The file to extract the resource into.
+
+	uint32 size; ///< The resource's size according to the archive's index, or 0xFFFFFFFF if unknown.
+
+	Common::ScopedPtr<Common::MemoryReadStream>   packed; ///< Data still to be unpacked.
+	Common::ScopedPtr<Common::SeekableReadStream> stream; ///< The resource's contents.
+
+	std::exception_ptr error; ///< The error that occurred getting the resource, if any.
+
+	ExtractEntry(uint32 i, size_t n, const Common::UString &f) : index(i), number(n), name(f), size(0xFFFFFFFF) { }
+};
+
+/** A batch of pipeline items, [start, end). */
+struct PipelineBatch {
+	size_t start;
+	size_t end;
+
+	PipelineBatch(size_t s = 0, size_t e = 0) : start(s), end(e) { }
+};
+
+/** The reader stage of a pipeline, reading batches of items on a thread of its own. */
+class PipelineReader : boost::noncopyable {
+public:
+	/** The maximum number of bytes of a batch. */
+	static const size_t kMaxBatchSize = 32 * 1024 * 1024;
+
+	/** Start reading. */
+	PipelineReader(size_t count, ResourcePipeline &pipeline) : _count(count), _pipeline(pipeline),
+		_batches(kMaxBatchSize) {
+
+		_thread = std::thread(runReader, this);
+	}
+
+	/** Stop reading, if still running. */
+	~PipelineReader() {
+		_batches.close();
+		_thread.join();
+	}
+
+	/** Take the next batch that was read, waiting for it if necessary.
+	 *
+	 *  @return false if all batches have been taken.
+	 */
+	bool pop(PipelineBatch &batch) {
+		if (_batches.pop(batch))
+			return true;
+
+		if (_error)
+			std::rethrow_exception(_error);
+
+		return false;
+	}
+
+private:
+	const size_t _count;
+	ResourcePipeline &_pipeline;
+
+	/** The batches that were read, with the number of bytes they hold as their cost. */
+	Common::BoundedQueue<PipelineBatch> _batches;
+
+	std::thread _thread;
+	std::exception_ptr _error;
+
+	void read() {
+		const size_t maxBatchCount = 4 * Common::getThreadCount();
+
+		try {
+			size_t start = 0;
+			while (start < _count) {
+				size_t end = start, batchSize = 0;
+				while ((end < _count) && ((end - start) < maxBatchCount) && (batchSize < kMaxBatchSize))
+					batchSize += _pipeline.read(end++);
+
+				// Waits while the consumer is still busy with the previous batches
+				if (!_batches.push(PipelineBatch(start, end), batchSize))
+					break;
+
+				start = end;
+			}
+		} catch (...) {
+			_error = std::current_exception();
+		}
+
+		_batches.close();
+	}
+
+	static void runReader(PipelineReader *reader) {
+		reader->read();
+	}
+};
+
+const size_t PipelineReader::kMaxBatchSize;
+
+/** The unpacking stage of a pipeline, run in parallel over a batch. */
+class PipelineUnpackJob : public Common::ParallelJob {
+public:
+	PipelineUnpackJob(ResourcePipeline &pipeline, size_t start) : _pipeline(pipeline), _start(start) {
+	}
+
+	void run(size_t index) {
+		_pipeline.unpack(_start + index);
+	}
+
+private:
+	ResourcePipeline &_pipeline;
+	size_t _start;
+};
+
+void runPipeline(size_t count, ResourcePipeline &pipeline) {
+	if (count == 0)
+		return;
+
+	PipelineReader reader(count, pipeline);
+
+	PipelineBatch batch;
+	while (reader.pop(batch)) {
+		PipelineUnpackJob job(pipeline, batch.start);
+		Common::parallelFor(batch.end - batch.start, job);
+
+		for (size_t i = batch.start; i < batch.end; i++)
+			pipeline.finish(i);
+	}
+}
+
+/** Read the resource from the archive. Packed resources are only read, to be unpacked later. */
+static void readEntry(const Aurora::Archive &archive, ExtractEntry &entry) {
+	try {
+		entry.size = archive.getResourceSize(entry.index);
+
+		entry.packed.reset(archive.getPackedResource(entry.index));
+		if (!entry.packed)
+			entry.stream.reset(archive.getResource(entry.index));
+	} catch (...) {
+		entry.error = std::current_exception();
+	}
+}
+
+static void writeEntry(ExtractEntry &entry, size_t fileCount) {
+	std::printf("Extracting %s/%s: %s ... ", Common::composeString(entry.number).c_str(),
+	                                         Common::composeString(fileCount).c_str(),
+	                                         entry.name.c_str());
+	std::fflush(stdout);
+
+	try {
+		if (entry.error)
+			std::rethrow_exception(entry.error);
+
+		dumpStream(*entry.stream, entry.name);
+
+		std::printf("Done\n");
+	} catch (Common::Exception &e) {
+		Common::printException(e, "");
+	}
+
+	entry.stream.reset();
+}
+
+/** Check that the resource could be read, and that its size matches the archive's index.
+ *
+ *  The size of the verified resource is added to dataSize.
+ */
+static bool verifyEntry(ExtractEntry &entry, size_t fileCount, uint64 &dataSize) {
+	std::printf("Verifying %s/%s: %s ... ", Common::composeString(entry.number).c_str(),
+	                                        Common::composeString(fileCount).c_str(),
+	                                        entry.name.c_str());
+	std::fflush(stdout);
+
+	bool verified = false;
+
+	try {
+		if (entry.error)
+			std::rethrow_exception(entry.error);
+
+		if ((entry.size != 0xFFFFFFFF) && (entry.stream->size() != entry.size))
+			throw Common::Exception("Size mismatch (%u != %u)", (uint)entry.stream->size(), entry.size);
+
+		dataSize += entry.stream->size();
+
+		std::printf("OK\n");
+		verified = true;
+	} catch (Common::Exception &e) {
+		Common::printException(e, "");
+	}
+
+	entry.stream.reset();
+
+	return verified;
+}
+
+/** Reading and unpacking the resources of an archive, to extract or verify them. */
+class ExtractPipeline : public ResourcePipeline {
+public:
+	ExtractPipeline(const Aurora::Archive &archive, Common::PtrVector<ExtractEntry> &entries,
+	                size_t fileCount, bool verify) : _archive(archive), _entries(entries),
+	                _fileCount(fileCount), _verify(verify), _failed(0), _dataSize(0) {
+	}
+
+	size_t read(size_t index) {
+		ExtractEntry &entry = *_entries[index];
+
+		readEntry(_archive, entry);
+
+		// Resources that don't need unpacking are held in memory whole until written
+		if (entry.packed)
+			return entry.packed->size();
+		if (entry.stream)
+			return entry.stream->size();
+
+		return 0;
+	}
+
+	void unpack(size_t index) {
+		ExtractEntry &entry = *_entries[index];
+		if (!entry.packed)
+			return;
+
+		try {
+			entry.stream.reset(_archive.unpackResource(entry.index, entry.packed.release()));
+		} catch (...) {
+			entry.error = std::current_exception();
+		}
+	}
+
+	void finish(size_t index) {
+		if (!_verify) {
+			writeEntry(*_entries[index], _fileCount);
+			return;
+		}
+
+		if (!verifyEntry(*_entries[index], _fileCount, _dataSize))
+			_failed++;
+	}
+
+	/** Return the number of resources that failed to verify. */
+	size_t getFailed() const {
+		return _failed;
+	}
+
+	/** Return the number of bytes of all verified resources. */
+	uint64 getDataSize() const {
+		return _dataSize;
+	}
+
+private:
+	const Aurora::Archive &_archive;
+	Common::PtrVector<ExtractEntry> &_entries;
+
+	size_t _fileCount; ///< The number of files in the archive, for display.
+	bool   _verify;    ///< Verify the resources instead of writing them?
+
+	size_t _failed;
+	uint64 _dataSize;
+};
+
 void extractFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directories,
                   const std::set<Common::UString> &files) {
 
@@ -201,6 +764,8 @@ void extractFiles(const Aurora::Archive &archive, Aurora::GameID game, bool dire
 
 	std::printf("Number of files: %s\n\n", Common::composeString(fileCount).c_str());
 
+	Common::PtrVector<ExtractEntry> entries;
+
 	size_t i = 1;
 	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r, ++i) {
 		const Aurora::FileType type = TypeMan.aliasFileType(r->type, game);
@@ -216,21 +781,50 @@ void extractFiles(const Aurora::Archive &archive, Aurora::GameID game, bool dire
 		if (directories && !dirName.empty())
 			Common::FilePath::createDirectories(dirName);
 
-		std::printf("Extracting %s/%s: %s ... ", Common::composeString(i).c_str(),
-		                                         Common::composeString(fileCount).c_str(),
-		                                         name.c_str());
-		std::fflush(stdout);
+		entries.push_back(new ExtractEntry(r->index, i, name));
+	}
 
-		try {
-			Common::ScopedPtr<Common::SeekableReadStream> stream(archive.getResource(r->index));
+	ExtractPipeline pipeline(archive, entries, fileCount, false);
+	runPipeline(entries.size(), pipeline);
+}
+
+bool verifyFiles(const Aurora::Archive &archive, Aurora::GameID game) {
+	const Aurora::Archive::ResourceList &resources = archive.getResources();
+	const size_t fileCount = resources.size();
 
-			dumpStream(*stream, name);
+	std::printf("Number of files: %s\n\n", Common::composeString(fileCount).c_str());
 
-			std::printf("Done\n");
-		} catch (Common::Exception &e) {
-			Common::printException(e, "");
-		}
+	Common::PtrVector<ExtractEntry> entries;
+
+	size_t i = 1;
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r, ++i) {
+		const Aurora::FileType type = TypeMan.aliasFileType(r->type, game);
+
+		entries.push_back(new ExtractEntry(r->index, i, findPath(r->name, type, r->hash, archive.getNameHashAlgo())));
+	}
+
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	ExtractPipeline pipeline(archive, entries, fileCount, true);
+	runPipeline(entries.size(), pipeline);
+
+	const size_t failed   = pipeline.getFailed();
+	const uint64 dataSize = pipeline.getDataSize();
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	const double megabytes = dataSize / (1024.0 * 1024.0);
+
+	std::printf("\nRead %.2f MB in %.2f seconds (%.2f MB/s)\n", megabytes, seconds,
+	            (seconds > 0.0) ? (megabytes / seconds) : 0.0);
+
+	if (failed > 0) {
+		std::printf("%s of %s files failed verification\n", Common::composeString(failed).c_str(),
+		                                                     Common::composeString(fileCount).c_str());
+		return false;
 	}
+
+	std::printf("All %s files verified\n", Common::composeString(fileCount).c_str());
+	return true;
 }
 
 void extractFiles(const Aurora::NSBTXFile &nsbtx, const std::set<Common::UString> &files,
@@ -265,6 +859,19 @@ void extractFiles(const Aurora::NSBTXFile &nsbtx, const std::set<Common::UString
 	}
 }
 
+bool parseListFormat(const Common::UString &str, ListFormat &format) {
+	if      (str == "table")
+		format = kListFormatTable;
+	else if (str == "tsv")
+		format = kListFormatTSV;
+	else if (str == "jsonl")
+		format = kListFormatJSONL;
+	else
+		throw Common::Exception("Unknown listing format \"%s\"", str.c_str());
+
+	return true;
+}
+
 std::set<Common::UString> fixPathSeparator(const std::set<Common::UString> &files) {
 	std::set<Common::UString> newFiles;
 
@@ -26,8 +26,10 @@
 #define ARCHIVES_UTIL_H
 
 #include <set>
+#include <vector>
 
 #include "src/common/ustring.h"
+#include "src/common/hash.h"
 
 #include "src/aurora/types.h"
 
@@ -40,19 +42,87 @@ namespace Aurora {
 
 namespace Archives {
 
+/** The format of a file listing. */
+enum ListFormat {
+	kListFormatTable, ///< A table meant to be read by humans.
+	kListFormatTSV,   ///< Tab-separated values, with a header line.
+	kListFormatJSONL  ///< One JSON object per line.
+};
+
+/** Find the path of a resource within an archive.
+ *
+ *  If the resource has no name, its hash is looked up in the lists of
+ *  known file names. Failing that, the hash itself is used as the name.
+ */
+Common::UString findPath(const Common::UString &name, Aurora::FileType type,
+                         uint64 hash, Common::HashAlgo algo);
+
 /** List all files found in this archive on stdout.
+ *
+ *  The machine-readable formats always print the full paths, together with
+ *  the files' hashes, and where and how they're stored in the archive.
+ *  These listings are written straight from the archive's index, to list
+ *  even archives with millions of files quickly.
  *
  *  @param archive The archive to list the contents of.
  *  @param game The game to alias types with.
  *  @param directories Print directories? If false, directories will be stripped.
+ *  @param format The format to print the list in.
  */
-void listFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directories);
+void listFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directories,
+               ListFormat format = kListFormatTable);
 
 /** List all files found in a KEY on stdout. */
 void listFiles(const Aurora::KEYFile &key, const Common::UString &keyName, Aurora::GameID game);
+/** List all files found in these KEYs on stdout, in a machine-readable format. */
+void listFiles(const std::vector<Aurora::KEYFile *> &keys, const std::vector<Common::UString> &keyNames,
+               Aurora::GameID game, ListFormat format);
 /** List the images found in an NSBTX file on stdout. */
 void listFiles(const Aurora::NSBTXFile &nsbtx);
 
+/** The stages of processing a list of resources read from archives.
+ *
+ *  Reading from an archive has to happen one resource at a time, while
+ *  unpacking (decrypting, decompressing, ...) the resources can be done for
+ *  several of them in parallel. The results then often need to be handled
+ *  in order again, for example to print progress messages.
+ *
+ *  See runPipeline().
+ */
+class ResourcePipeline {
+public:
+	virtual ~ResourcePipeline() { }
+
+	/** Read the item with this index from its archive.
+	 *
+	 *  This is called for all items in order, from a thread of its own.
+	 *  Errors should be remembered for finish() to report instead of thrown.
+	 *
+	 *  @return The number of bytes now held in memory for the item.
+	 */
+	virtual size_t read(size_t index) = 0;
+
+	/** Unpack an item that was read. This is called for several items at once. */
+	virtual void unpack(size_t index) = 0;
+
+	/** Handle the unpacked item, for example write it to disk, and free its memory.
+	 *
+	 *  This is called for all items in order, from the thread that called runPipeline().
+	 */
+	virtual void finish(size_t index) = 0;
+};
+
+/** Run all items in [0, count) through the stages of a pipeline.
+ *
+ *  A reader thread reads the items in batches, which are limited in the
+ *  number of items and in the bytes they hold in memory. The batches are
+ *  handed over through a BoundedQueue, so that the reader stays at most
+ *  one batch ahead. Each batch is then unpacked in parallel, and finished
+ *  in order on the calling thread, while the reader already reads the
+ *  next batches.
+ */
+void runPipeline(size_t count, ResourcePipeline &pipeline);
+
 /** Extract files from an archive.
  *
  *  @param archive The archive to extract from.
@@ -65,10 +135,26 @@ void listFiles(const Aurora::NSBTXFile &nsbtx);
 void extractFiles(const Aurora::Archive &archive, Aurora::GameID game, bool directories,
                   const std::set<Common::UString> &files);
 
+/** Verify that all files in an archive can be read, without writing them anywhere.
+ *
+ *  The files are decrypted, decompressed and, where the archive stores
+ *  checksums, checked against them, several files in parallel. Their
+ *  sizes are checked against the archive's index. Files that fail are
+ *  reported as they are found, and the throughput is printed at the end.
+ *
+ *  @param  archive The archive to verify.
+ *  @param  game The game to alias types with.
+ *  @return true if all files verified without errors.
+ */
+bool verifyFiles(const Aurora::Archive &archive, Aurora::GameID game);
+
 /** Extract files from an NSBTX. */
 void extractFiles(const Aurora::NSBTXFile &nsbtx, const std::set<Common::UString> &files,
                   void (*dumper)(Common::SeekableReadStream &stream, const Common::UString &fileName));
 
+/** Parse the name of a listing format ("table", "tsv" or "jsonl"), for the command line. */
+bool parseListFormat(const Common::UString &str, ListFormat &format);
+
 std::set<Common::UString> fixPathSeparator(const std::set<Common::UString> &files);
 
 } // End of namespace Archives
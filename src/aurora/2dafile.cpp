@@ -27,6 +27,9 @@
  */
 
 #include <cassert>
+#include <cstring>
+#include <new>
+#include <utility>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -36,6 +39,7 @@
 #include "src/common/readstream.h"
 #include "src/common/writefile.h"
 #include "src/common/streamtokenizer.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/2dafile.h"
@@ -141,6 +145,8 @@ TwoDAFile::~TwoDAFile() {
 }
 
 void TwoDAFile::load(Common::SeekableReadStream &twoda) {
+	XOREOS_TRACE_SPAN("format", "TwoDAFile::load");
+
 	readHeader(twoda);
 
 	if ((_id != k2DAID) && (_id != k2DAIDTab))
@@ -232,7 +238,7 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 	const size_t columnCount = _headers.size();
 
 	while (!twoda.eos()) {
-		Common::ScopedPtr<TwoDARow> row(new TwoDARow(*this));
+		Common::ScopedPtr<TwoDARow, Common::DeallocatorDestruct> row(createRow());
 
 		/* Skip the first token, which is the row index, possibly indented.
 		 * The row index is implicit in the data and its use in the 2DA
@@ -317,7 +323,7 @@ void TwoDAFile::readRows2b(Common::SeekableReadStream &twoda) {
 	const size_t dataOffset = twoda.pos();
 
 	for (size_t i = 0; i < rowCount; i++) {
-		_rows[i] = new TwoDARow(*this);
+		_rows[i] = createRow();
 
 		_rows[i]->_data.resize(columnCount);
 
@@ -338,44 +344,58 @@ void TwoDAFile::createHeaderMap() {
 		_headerMap.insert(std::make_pair(_headers[i], i));
 }
 
+TwoDARow *TwoDAFile::createRow() {
+	return new (_arena.allocate<TwoDARow>()) TwoDARow(*this);
+}
+
 void TwoDAFile::load(const GDAFile &gda) {
+	XOREOS_TRACE_SPAN("format", "TwoDAFile::load(GDA)");
+
 	try {
 
 		const GDAFile::Headers &headers = gda.getHeaders();
 		assert(headers.size() == gda.getColumnCount());
 
-		_headers.resize(gda.getColumnCount());
-		for (size_t i = 0; i < gda.getColumnCount(); i++) {
+		const size_t columnCount = gda.getColumnCount();
+
+		_headers.resize(columnCount);
+		for (size_t i = 0; i < columnCount; i++) {
 			const char *headerString = findGDAHeader(headers[i].hash);
 
 			_headers[i] = headerString ? headerString : Common::UString::format("[%u]", headers[i].hash);
 		}
 
+		static const Common::UString kEmptyCell("****");
+
 		_rows.resize(gda.getRowCount(), 0);
 		for (size_t i = 0; i < gda.getRowCount(); i++) {
 			const GFF4Struct *row = gda.getRow(i);
 
-			_rows[i] = new TwoDARow(*this);
-			_rows[i]->_data.resize(gda.getColumnCount());
+			_rows[i] = createRow();
 
-			for (size_t j = 0; j < gda.getColumnCount(); j++) {
+			std::vector<Common::UString> &data = _rows[i]->_data;
+			data.resize(columnCount);
+
+			for (size_t j = 0; j < columnCount; j++) {
 				if (row) {
+					const uint32 field = headers[j].field;
+
 					switch (headers[j].type) {
 						case GDAFile::kTypeString:
 						case GDAFile::kTypeResource:
-							_rows[i]->_data[j] = row->getString(headers[j].field);
+							data[j] = row->getString(field);
 							break;
 
 						case GDAFile::kTypeInt:
-							_rows[i]->_data[j] = Common::UString::format("%d", (int) row->getSint(headers[j].field));
+							data[j] = Common::composeString((int) row->getSint(field));
 							break;
 
 						case GDAFile::kTypeFloat:
-							_rows[i]->_data[j] = Common::UString::format("%f", row->getDouble(headers[j].field));
+							data[j] = Common::composeString(row->getDouble(field));
 							break;
 
 						case GDAFile::kTypeBool:
-							_rows[i]->_data[j] = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
+							data[j] = Common::composeString((uint) row->getUint(field));
 							break;
 
 						default:
@@ -383,8 +403,8 @@ void TwoDAFile::load(const GDAFile &gda) {
 					}
 				}
 
-				if (_rows[i]->_data[j].empty())
-					_rows[i]->_data[j] = "****";
+				if (data[j].empty())
+					data[j] = kEmptyCell;
 
 			}
 		}
@@ -545,16 +565,16 @@ void TwoDAFile::writeBinary(Common::WriteStream &out) const {
 	 *
 	 * Basically, this involves going through each cell, and looking up
 	 * if we already saved this particular piece of data. If not, save
-	 * it, otherwise only remember the offset. There's no need to be
-	 * particularly smart about it, so we're just doing it the naive
-	 * O(n^2) way.
+	 * it, otherwise only remember the offset. The lookup goes through a
+	 * map, since large 2DAs can easily have tens of thousands of cells.
 	 */
 
+	typedef std::map<Common::UString, size_t, Common::UString::sless> DataMap;
+
 	std::vector<Common::UString> data;
-	std::vector<size_t> offsets;
+	DataMap dataOffsets;
 
 	data.reserve(cellCount);
-	offsets.reserve(cellCount);
 
 	size_t dataSize = 0;
 
@@ -565,32 +585,25 @@ void TwoDAFile::writeBinary(Common::WriteStream &out) const {
 		assert(_rows[i]);
 
 		for (size_t j = 0; j < columnCount; j++) {
-			const Common::UString cell = _rows[i]->getString(j);
+			const Common::UString &cell = _rows[i]->getString(j);
 
 			// Do we already know about this cell data string?
-			size_t foundCell = SIZE_MAX;
-			for (size_t k = 0; k < data.size(); k++) {
-				if (data[k] == cell) {
-					foundCell = k;
-					break;
-				}
-			}
+			DataMap::const_iterator found = dataOffsets.find(cell);
 
 			// If not, add it to the cell data array
-			if (foundCell == SIZE_MAX) {
-				foundCell = data.size();
+			if (found == dataOffsets.end()) {
+				found = dataOffsets.insert(std::make_pair(cell, dataSize)).first;
 
 				data.push_back(cell);
-				offsets.push_back(dataSize);
 
-				dataSize += data.back().size() + 1;
+				dataSize += std::strlen(cell.c_str()) + 1;
 
 				if (dataSize > 65535)
 					throw Common::Exception("TwoDAFile::writeBinary(): Cell data size overflow");
 			}
 
 			// Remember the offset to the cell data array
-			cells.push_back(offsets[foundCell]);
+			cells.push_back(found->second);
 		}
 	}
 
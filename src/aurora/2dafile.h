@@ -34,6 +34,7 @@
 #include "src/common/deallocator.h"
 #include "src/common/ptrvector.h"
 #include "src/common/ustring.h"
+#include "src/common/memoryarena.h"
 
 #include "src/aurora/aurorafile.h"
 
@@ -94,7 +95,7 @@ private:
 	friend class TwoDAFile;
 
 	template<typename T>
-	friend void Common::DeallocatorDefault::destroy(T *);
+	friend void Common::DeallocatorDestruct::destroy(T *);
 };
 
 /** Class to hold the two-dimensional array of a 2DA file.
@@ -173,8 +174,11 @@ private:
 	std::vector<Common::UString> _headers;
 	HeaderMap _headerMap;
 
+	/** The memory arena our rows are allocated from. */
+	Common::MemoryArena _arena;
+
 	TwoDARow _emptyRow;
-	Common::PtrVector<TwoDARow> _rows;
+	Common::PtrVector<TwoDARow, Common::DeallocatorDestruct> _rows;
 
 	// Loading helpers
 	void load(Common::SeekableReadStream &twoda);
@@ -196,6 +200,9 @@ private:
 
 	void createHeaderMap();
 
+	/** Create a new, empty row within our memory arena. */
+	TwoDARow *createRow();
+
 	static int32 parseInt(const Common::UString &str);
 	static float parseFloat(const Common::UString &str);
 
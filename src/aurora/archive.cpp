@@ -23,6 +23,7 @@
  */
 
 #include "src/common/system.h"
+#include "src/common/memreadstream.h"
 
 #include "src/aurora/archive.h"
 
@@ -31,6 +32,9 @@ namespace Aurora {
 Archive::Resource::Resource() : hash(0), type(kFileTypeNone), index(0xFFFFFFFF) {
 }
 
+Archive::ResourceStorage::ResourceStorage() : offset(0), packedSize(0), size(0), compression(0) {
+}
+
 Archive::Archive() {
 }
 
@@ -41,6 +45,19 @@ uint32 Archive::getResourceSize(uint32 UNUSED(index)) const {
 	return 0xFFFFFFFF;
 }
 
+bool Archive::getResourceStorage(uint32 UNUSED(index), ResourceStorage &UNUSED(storage)) const {
+	return false;
+}
+
+Common::MemoryReadStream *Archive::getPackedResource(uint32 UNUSED(index)) const {
+	return 0;
+}
+
+Common::SeekableReadStream *Archive::unpackResource(uint32 UNUSED(index),
+                                                    Common::MemoryReadStream *packed) const {
+	return packed;
+}
+
 Common::HashAlgo Archive::getNameHashAlgo() const {
 	return Common::kHashNone;
 }
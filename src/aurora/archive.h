@@ -37,6 +37,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
 }
 
 namespace Aurora {
@@ -56,6 +57,24 @@ public:
 
 	typedef std::list<Resource> ResourceList;
 
+	/** How a resource is stored within the archive. */
+	struct ResourceStorage {
+		/** The offset of the resource within the archive.
+		 *
+		 *  For archives that store a header in front of each resource,
+		 *  like ZIP, this is the offset of that header.
+		 */
+		uint64 offset;
+
+		uint32 packedSize; ///< The size of the resource as stored in the archive.
+		uint32 size;       ///< The size of the resource once unpacked.
+
+		/** The name of the resource's compression method, or 0 if it's not compressed. */
+		const char *compression;
+
+		ResourceStorage();
+	};
+
 	Archive();
 	virtual ~Archive();
 
@@ -65,6 +84,12 @@ public:
 	/** Return the size of a resource. */
 	virtual uint32 getResourceSize(uint32 index) const;
 
+	/** Find out how a resource is stored within the archive, from the archive's index alone.
+	 *
+	 *  @return false if the archive can't provide this information.
+	 */
+	virtual bool getResourceStorage(uint32 index, ResourceStorage &storage) const;
+
 	/** Return a stream of the resource's contents.
 	 *
 	 *  @param  index The index of the resource we want.
@@ -73,6 +98,25 @@ public:
 	 */
 	virtual Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const = 0;
 
+	/** Return the packed contents of a resource, as they are stored in the archive.
+	 *
+	 *  Together with unpackResource(), this splits getResource() into reading
+	 *  the archive, which only one thread can do at a time, and decrypting and
+	 *  decompressing the resource, which can be done for several resources in
+	 *  parallel.
+	 *
+	 *  Archives that don't need to unpack a resource return 0, in which case
+	 *  getResource() should be used instead.
+	 */
+	virtual Common::MemoryReadStream *getPackedResource(uint32 index) const;
+
+	/** Unpack the contents of a resource returned by getPackedResource().
+	 *
+	 *  Takes over the packed stream. Unlike all other methods, this may be
+	 *  called from several threads at once.
+	 */
+	virtual Common::SeekableReadStream *unpackResource(uint32 index, Common::MemoryReadStream *packed) const;
+
 	/** Return with which algorithm the name is hashed. */
 	virtual Common::HashAlgo getNameHashAlgo() const;
 
@@ -32,6 +32,7 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/biffile.h"
 #include "src/aurora/keyfile.h"
@@ -52,6 +53,8 @@ BIFFile::~BIFFile() {
 }
 
 void BIFFile::load(Common::SeekableReadStream &bif) {
+	XOREOS_TRACE_SPAN("archive", "BIFFile::load");
+
 	readHeader(bif);
 
 	if (_id != kBIFID)
@@ -110,11 +113,11 @@ void BIFFile::mergeKEY(const KEYFile &key, uint32 dataFileIndex) {
 
 		if (keyRes->type != _iResources[keyRes->resIndex].type)
 			warning("KEY and BIF disagree on the type of the resource \"%s\" (%d, %d). Trusting the BIF",
-			        keyRes->name.c_str(), keyRes->type, _iResources[keyRes->resIndex].type);
+			        keyRes->name.getString().c_str(), keyRes->type, _iResources[keyRes->resIndex].type);
 
 		Resource res;
 
-		res.name  = keyRes->name;
+		res.name  = keyRes->name.getString();
 		res.type  = _iResources[keyRes->resIndex].type;
 		res.index = keyRes->resIndex;
 
@@ -142,7 +145,20 @@ uint32 BIFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool BIFFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	storage.offset      = res.offset;
+	storage.packedSize  = res.size;
+	storage.size        = res.size;
+	storage.compression = 0;
+
+	return true;
+}
+
 Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool tryNoCopy) const {
+	XOREOS_TRACE_SPAN("archive", "BIFFile::getResource");
+
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
@@ -32,6 +32,7 @@
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/lzma.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/bzffile.h"
 #include "src/aurora/keyfile.h"
@@ -51,6 +52,8 @@ BZFFile::~BZFFile() {
 }
 
 void BZFFile::load(Common::SeekableReadStream &bzf) {
+	XOREOS_TRACE_SPAN("archive", "BZFFile::load");
+
 	readHeader(bzf);
 
 	if (_id != kBZFID)
@@ -112,11 +115,11 @@ void BZFFile::mergeKEY(const KEYFile &key, uint32 dataFileIndex) {
 
 		if (keyRes->type != _iResources[keyRes->resIndex].type)
 			warning("KEY and BZF disagree on the type of the resource \"%s\" (%d, %d). Trusting the BZF",
-			        keyRes->name.c_str(), keyRes->type, _iResources[keyRes->resIndex].type);
+			        keyRes->name.getString().c_str(), keyRes->type, _iResources[keyRes->resIndex].type);
 
 		Resource res;
 
-		res.name  = keyRes->name;
+		res.name  = keyRes->name.getString();
 		res.type  = _iResources[keyRes->resIndex].type;
 		res.index = keyRes->resIndex;
 
@@ -144,12 +147,43 @@ uint32 BZFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool BZFFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	storage.offset      = res.offset;
+	storage.packedSize  = res.packedSize;
+	storage.size        = res.size;
+	storage.compression = "lzma";
+
+	return true;
+}
+
 Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
+	XOREOS_TRACE_SPAN("archive", "BZFFile::getResource");
+
+	return unpackResource(index, getPackedResource(index));
+}
+
+Common::MemoryReadStream *BZFFile::getPackedResource(uint32 index) const {
 	const IResource &res = getIResource(index);
 
 	_bzf->seek(res.offset);
 
-	return Common::decompressLZMA1(*_bzf, res.packedSize, res.size, true);
+	return _bzf->readStream(res.packedSize);
+}
+
+Common::SeekableReadStream *BZFFile::unpackResource(uint32 index, Common::MemoryReadStream *packed) const {
+	XOREOS_TRACE_SPAN("archive", "BZFFile::unpackResource");
+
+	assert(packed);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(packed);
+
+	const IResource &res = getIResource(index);
+
+	const byte *data = Common::decompressLZMA1(stream->getData(), stream->size(), res.size, true);
+
+	return new Common::MemoryReadStream(data, res.size, true);
 }
 
 } // End of namespace Aurora
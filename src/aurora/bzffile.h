@@ -39,6 +39,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
 }
 
 namespace Aurora {
@@ -67,9 +68,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Find out how a resource is stored within the BZF. */
+	bool getResourceStorage(uint32 index, ResourceStorage &storage) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return the LZMA compressed contents of a resource, as they are stored in the BZF. */
+	Common::MemoryReadStream *getPackedResource(uint32 index) const;
+
+	/** Decompress the packed contents of a resource. */
+	Common::SeekableReadStream *unpackResource(uint32 index, Common::MemoryReadStream *packed) const;
+
 	/** Merge information from the KEY into the data file.
 	 *
 	 *  Without this step, this data file archive does not contain any
@@ -37,6 +37,7 @@
 #include "src/common/md5.h"
 #include "src/common/blowfish.h"
 #include "src/common/deflate.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/erffile.h"
 #include "src/aurora/util.h"
@@ -273,6 +274,8 @@ void ERFFile::readNWNPremiumHeader(Common::SeekableReadStream &erf, ERFHeader &h
 }
 
 void ERFFile::load() {
+	XOREOS_TRACE_SPAN("archive", "ERFFile::load");
+
 	readHeader(*_erf);
 
 	verifyVersion(_id, _version, _utf16le);
@@ -292,6 +295,10 @@ void ERFFile::load() {
 
 		_header.clearStringTable();
 
+		// Expand the key once, instead of for every single resource
+		if (_header.encryption != kEncryptionNone)
+			_key.reset(new Common::BlowfishKey(_password));
+
 	} catch (Common::Exception &e) {
 		e.add("Failed reading ERF file");
 		throw;
@@ -302,9 +309,9 @@ void ERFFile::load() {
 void ERFFile::decryptNWNPremium() {
 	assert(_header.encryption == kEncryptionBlowfishNWN);
 
-	_erf->seek(0);
-
-	_erf.reset(decrypt(*_erf, kEncryptionBlowfishNWN, _password));
+	/* Decrypt the module on the fly, as it's read. Premium modules are large, and
+	 * usually only the resource lists and a few resources are ever looked at. */
+	_erf.reset(new Common::BlowfishEBCReadStream(_erf.release(), _password));
 
 	_header.encryption = kEncryptionNone;
 }
@@ -709,7 +716,37 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).unpackedSize;
 }
 
+bool ERFFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	storage.offset      = res.offset;
+	storage.packedSize  = res.packedSize;
+	storage.size        = res.unpackedSize;
+	storage.compression = 0;
+
+	switch (_header.compression) {
+		case kCompressionBioWareZlib:
+			storage.compression = "biowarezlib";
+			break;
+
+		case kCompressionHeaderlessZlib:
+			storage.compression = "deflate";
+			break;
+
+		case kCompressionStandardZlib:
+			storage.compression = "zlib";
+			break;
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
 Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) const {
+	XOREOS_TRACE_SPAN("archive", "ERFFile::getResource");
+
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy && (_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
@@ -717,15 +754,36 @@ Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) c
 
 	_erf->seek(res.offset);
 
-	// Read
-	Common::MemoryReadStream *stream = _erf->readStream(res.packedSize);
+	return unpackResource(index, _erf->readStream(res.packedSize));
+}
+
+Common::MemoryReadStream *ERFFile::getPackedResource(uint32 index) const {
+	if ((_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
+		return 0;
+
+	const IResource &res = getIResource(index);
+
+	_erf->seek(res.offset);
+
+	return _erf->readStream(res.packedSize);
+}
+
+Common::SeekableReadStream *ERFFile::unpackResource(uint32 index, Common::MemoryReadStream *packed) const {
+	assert(packed);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(packed);
+
+	const IResource &res = getIResource(index);
 
 	// Decrypt
-	if (_header.encryption != kEncryptionNone)
-		stream = decrypt(stream, _header.encryption, _password);
+	if (_header.encryption != kEncryptionNone) {
+		assert(_key);
+
+		stream.reset(Common::decryptBlowfishEBC(*stream, *_key));
+	}
 
 	// Decompress
-	return decompress(stream, res.unpackedSize);
+	return decompress(stream.release(), res.unpackedSize);
 }
 
 Common::MemoryReadStream *ERFFile::decrypt(Common::SeekableReadStream &cryptStream,
@@ -38,6 +38,8 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
+	class BlowfishKey;
 }
 
 namespace Aurora {
@@ -126,9 +128,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Find out how a resource is stored within the ERF. */
+	bool getResourceStorage(uint32 index, ResourceStorage &storage) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return the packed contents of a resource, if it needs to be decrypted or decompressed. */
+	Common::MemoryReadStream *getPackedResource(uint32 index) const;
+
+	/** Decrypt and decompress the packed contents of a resource. */
+	Common::SeekableReadStream *unpackResource(uint32 index, Common::MemoryReadStream *packed) const;
+
 	/** Return the year the ERF was built. */
 	uint32 getBuildYear() const;
 	/** Return the day of year the ERF was built. */
@@ -222,6 +233,9 @@ private:
 	/** The password we were given, if any. */
 	std::vector<byte> _password;
 
+	/** The expanded Blowfish key, for Dragon Age encrypted resources. */
+	Common::ScopedPtr<Common::BlowfishKey> _key;
+
 	void load();
 
 	// .--- Header
@@ -27,11 +27,15 @@
  */
 
 #include <cassert>
+#include <algorithm>
 
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/hash.h"
 #include "src/common/strutil.h"
+#include "src/common/scopedptr.h"
+#include "src/common/parallel.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/gdafile.h"
 #include "src/aurora/gff4file.h"
@@ -51,6 +55,13 @@ GDAFile::GDAFile(Common::SeekableReadStream *gda) : _columns(0), _rowCount(0) {
 	load(gda);
 }
 
+GDAFile::GDAFile(const std::vector<Common::SeekableReadStream *> &gdas) : _columns(0), _rowCount(0) {
+	if (gdas.empty())
+		throw Common::Exception("No GDA files given");
+
+	add(gdas);
+}
+
 GDAFile::~GDAFile() {
 }
 
@@ -73,23 +84,21 @@ bool GDAFile::hasRow(size_t row) const {
 const GFF4Struct *GDAFile::getRow(size_t row) const {
 	assert(_rowStarts.size() == _rows.size());
 
-	/* To find the correct GFF4 for this row, we go through
-	 * the list of row start indices in reverse, until we
-	 * found one that's not bigger than the row we want.
+	/* To find the correct GFF4 for this row, we look for the last
+	 * row start index that's not bigger than the row we want.
 	 */
 
-	for (ptrdiff_t i = _rowStarts.size() - 1; i >= 0; i--) {
-		if (_rowStarts[i] <= row) {
-			row -= _rowStarts[i];
+	RowStarts::const_iterator start = std::upper_bound(_rowStarts.begin(), _rowStarts.end(), row);
+	if (start == _rowStarts.begin())
+		return 0;
 
-			if (row >= _rows[i]->size())
-				return 0;
+	const size_t i = (start - _rowStarts.begin()) - 1;
 
-			return (*_rows[i])[row];
-		}
-	}
+	row -= _rowStarts[i];
+	if (row >= _rows[i]->size())
+		return 0;
 
-	return 0;
+	return (*_rows[i])[row];
 }
 
 size_t GDAFile::findRow(uint32 id) const {
@@ -271,32 +280,59 @@ GDAFile::Type GDAFile::identifyType(const Columns &columns, const Row &rows, siz
 	return kTypeEmpty;
 }
 
-void GDAFile::load(Common::SeekableReadStream *gda) {
-	try {
-		_gff4s.push_back(new GFF4File(gda, kG2DAID));
+/** Read a GFF4 out of this stream and make sure it's a GDA we support. */
+static GFF4File *openGDA(Common::SeekableReadStream *gda) {
+	Common::ScopedPtr<GFF4File> gff4(new GFF4File(gda, kG2DAID));
 
-		const uint32 version = _gff4s.back()->getTypeVersion();
-		if ((version != kVersion01) && (version != kVersion02))
-			throw Common::Exception("Unsupported GDA file version %s", Common::debugTag(version).c_str());
+	const uint32 version = gff4->getTypeVersion();
+	if ((version != kVersion01) && (version != kVersion02))
+		throw Common::Exception("Unsupported GDA file version %s", Common::debugTag(version).c_str());
 
-		const GFF4Struct &top = _gff4s.back()->getTopLevel();
+	return gff4.release();
+}
 
-		_columns = &top.getList(kGFF4G2DAColumnList);
-		_rows.push_back(&top.getList(kGFF4G2DARowList));
+/** Parse the GFF4s of several GDA streams in parallel. */
+class GDAOpenJob : public Common::ParallelJob {
+public:
+	GDAOpenJob(const std::vector<Common::SeekableReadStream *> &gdas) {
+		_gdas.reserve(gdas.size());
+		for (std::vector<Common::SeekableReadStream *>::const_iterator g = gdas.begin(); g != gdas.end(); ++g)
+			_gdas.push_back(*g);
 
-		_rowStarts.push_back(_rowCount);
-		_rowCount += _rows.back()->size();
+		_gff4s.resize(gdas.size(), 0);
+	}
 
-		_headers.resize(_columns->size());
-		for (size_t i = 0; i < _columns->size(); i++) {
-			if (!(*_columns)[i])
-				continue;
+	void run(size_t index) {
+		// Each index is only ever touched by one thread
+		Common::SeekableReadStream *gda = _gdas[index];
+		_gdas[index] = 0;
 
-			_headers[i].hash  = (uint32) (*_columns)[i]->getUint(kGFF4G2DAColumnHash);
-			_headers[i].type  =          identifyType(_columns, _rows.back(), i);
-			_headers[i].field = (uint32) kGFF4G2DAColumn1 + i;
+		try {
+			_gff4s[index] = openGDA(gda);
+		} catch (Common::Exception &e) {
+			e.add("Failed reading GDA file %u", (uint)index);
+			throw;
 		}
+	}
+
+	/** Hand over the parsed GFF4 with this index. */
+	GFF4File *release(size_t index) {
+		GFF4File *gff4 = _gff4s[index];
+		_gff4s[index] = 0;
+
+		return gff4;
+	}
+
+private:
+	Common::PtrVector<Common::SeekableReadStream> _gdas;
+	Common::PtrVector<GFF4File> _gff4s;
+};
 
+void GDAFile::load(Common::SeekableReadStream *gda) {
+	XOREOS_TRACE_SPAN("format", "GDAFile::load");
+
+	try {
+		addGFF4(openGDA(gda));
 	} catch (Common::Exception &e) {
 		e.add("Failed reading GDA file");
 		throw;
@@ -305,40 +341,71 @@ void GDAFile::load(Common::SeekableReadStream *gda) {
 
 void GDAFile::add(Common::SeekableReadStream *gda) {
 	try {
-		_gff4s.push_back(new GFF4File(gda, kG2DAID));
+		addGFF4(openGDA(gda));
+	} catch (Common::Exception &e) {
+		e.add("Failed adding GDA file");
+		throw;
+	}
+}
+
+void GDAFile::add(const std::vector<Common::SeekableReadStream *> &gdas) {
+	try {
+		GDAOpenJob job(gdas);
+		Common::parallelFor(gdas.size(), job);
+
+		for (size_t i = 0; i < gdas.size(); i++)
+			addGFF4(job.release(i));
+
+	} catch (Common::Exception &e) {
+		e.add("Failed adding GDA file");
+		throw;
+	}
+}
+
+void GDAFile::addGFF4(GFF4File *gff4) {
+	_gff4s.push_back(gff4);
+
+	const GFF4Struct &top = gff4->getTopLevel();
+
+	Columns columns = &top.getList(kGFF4G2DAColumnList);
+	Row     rows    = &top.getList(kGFF4G2DARowList);
+
+	if (!_columns) {
+		// The first GDA defines the column layout. Resolve it once, into our headers
 
-		const uint32 version = _gff4s.back()->getTypeVersion();
-		if ((version != kVersion01) && (version != kVersion02))
-			throw Common::Exception("Unsupported GDA file version %s", Common::debugTag(version).c_str());
+		_columns = columns;
 
-		const GFF4Struct &top = _gff4s.back()->getTopLevel();
+		_headers.resize(_columns->size());
+		for (size_t i = 0; i < _columns->size(); i++) {
+			if (!(*_columns)[i])
+				continue;
 
-		_rows.push_back(&top.getList(kGFF4G2DARowList));
+			_headers[i].hash  = (uint32) (*_columns)[i]->getUint(kGFF4G2DAColumnHash);
+			_headers[i].type  =          identifyType(_columns, rows, i);
+			_headers[i].field = (uint32) kGFF4G2DAColumn1 + i;
+		}
 
-		_rowStarts.push_back(_rowCount);
-		_rowCount += _rows.back()->size();
+	} else {
+		// All further GDAs have to match the layout in our headers
 
-		Columns columns = &top.getList(kGFF4G2DAColumnList);
-		if (columns->size() != _columns->size())
+		if (columns->size() != _headers.size())
 			throw Common::Exception("Column counts don't match (%u vs. %u)",
-			                        (uint)columns->size(), (uint)_columns->size());
+			                        (uint)columns->size(), (uint)_headers.size());
 
 		for (size_t i = 0; i < columns->size(); i++) {
-			const uint32 hash1 = (uint32) (* columns)[i]->getUint(kGFF4G2DAColumnHash);
-			const uint32 hash2 = (uint32) (*_columns)[i]->getUint(kGFF4G2DAColumnHash);
+			const uint32 hash = (*columns)[i] ? (uint32) (*columns)[i]->getUint(kGFF4G2DAColumnHash) : 0;
+			const Type   type = identifyType(columns, rows, i);
 
-			const Type type1 = identifyType( columns, _rows.back(), i);
-			const Type type2 = identifyType(_columns, _rows[0]    , i);
-
-			if ((hash1 != hash2) || (type1 != type2))
+			if ((hash != _headers[i].hash) || (type != _headers[i].type))
 				throw Common::Exception("Columns don't match (%u: %u+%d vs. %u+%d)", (uint) i,
-				                        hash1, (int)type1, hash2, (int)type2);
+				                        hash, (int)type, _headers[i].hash, (int)_headers[i].type);
 		}
-
-	} catch (Common::Exception &e) {
-		e.add("Failed adding GDA file");
-		throw;
 	}
+
+	_rows.push_back(rows);
+
+	_rowStarts.push_back(_rowCount);
+	_rowCount += rows->size();
 }
 
 } // End of namespace Aurora
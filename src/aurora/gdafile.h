@@ -86,6 +86,11 @@ public:
 
 	/** Take over this stream and read a GDA file out of it. */
 	GDAFile(Common::SeekableReadStream *gda);
+	/** Take over these streams and read them as one combined GDA, like add() does.
+	 *
+	 *  The GFF4s within the streams are parsed in parallel.
+	 */
+	GDAFile(const std::vector<Common::SeekableReadStream *> &gdas);
 	~GDAFile();
 
 	/** Add another GDA with the same column structure to the bottom of this GDA.
@@ -99,6 +104,15 @@ public:
 	 */
 	void add(Common::SeekableReadStream *gda);
 
+	/** Add several GDAs with the same column structure to the bottom of this GDA.
+	 *
+	 *  Works like add() on each stream in turn, except that the GFF4s within
+	 *  the streams are parsed in parallel.
+	 *
+	 *  The ownership of all streams will be transferred to this GDAFile object.
+	 */
+	void add(const std::vector<Common::SeekableReadStream *> &gdas);
+
 	/** Return the number of columns in the array. */
 	size_t getColumnCount() const;
 	/** Return the number of rows in the array. */
@@ -160,6 +174,9 @@ private:
 
 	void load(Common::SeekableReadStream *gda);
 
+	/** Add an already parsed GFF4 to the bottom, checking its columns against our headers. */
+	void addGFF4(GFF4File *gff4);
+
 	Type identifyType(const Columns &columns, const Row &rows, size_t column) const;
 
 	const GFF4Struct *getRowColumn(size_t row, uint32 hash, size_t &column) const;
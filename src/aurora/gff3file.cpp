@@ -27,12 +27,14 @@
  */
 
 #include <cassert>
+#include <new>
 
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
 #include "src/common/ustring.h"
 #include "src/common/strutil.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/gff3file.h"
 #include "src/aurora/util.h"
@@ -62,8 +64,10 @@ void GFF3File::Header::read(Common::SeekableReadStream &gff3) {
 }
 
 
-GFF3File::GFF3File(Common::SeekableReadStream *gff3, uint32 id, bool repairNWNPremium) :
-	_stream(gff3), _repairNWNPremium(repairNWNPremium), _offsetCorrection(0) {
+GFF3File::GFF3File(Common::SeekableReadStream *gff3, uint32 id, bool repairNWNPremium,
+                   Common::MemoryArena *arena) :
+	_stream(gff3), _ownArena(arena ? 0 : new Common::MemoryArena), _arena(arena ? arena : _ownArena.get()),
+	_repairNWNPremium(repairNWNPremium), _offsetCorrection(0) {
 
 	assert(_stream);
 
@@ -84,6 +88,8 @@ const GFF3Struct &GFF3File::getTopLevel() const {
 // --- Loader ---
 
 void GFF3File::load(uint32 id) {
+	XOREOS_TRACE_SPAN("format", "GFF3File::load");
+
 	try {
 
 		loadHeader(id);
@@ -173,8 +179,11 @@ void GFF3File::loadStructs() {
 	static const uint32 kStructSize = 12;
 
 	_structs.reserve(_header.structCount);
-	for (uint32 i = 0; i < _header.structCount; i++)
-		_structs.push_back(new GFF3Struct(*this, _header.structOffset + i * kStructSize));
+	for (uint32 i = 0; i < _header.structCount; i++) {
+		void *memory = _arena->allocate<GFF3Struct>();
+
+		_structs.push_back(new (memory) GFF3Struct(*this, _header.structOffset + i * kStructSize));
+	}
 }
 
 void GFF3File::loadLists() {
@@ -290,7 +299,9 @@ GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
 }
 
 
-GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent) {
+GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent),
+	_fields(FieldMap::key_compare(), FieldMap::allocator_type(*parent._arena)) {
+
 	load(offset);
 }
 
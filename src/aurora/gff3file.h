@@ -34,6 +34,7 @@
 #include "src/common/scopedptr.h"
 #include "src/common/ptrvector.h"
 #include "src/common/ustring.h"
+#include "src/common/memoryarena.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/aurorafile.h"
@@ -79,13 +80,19 @@ class GFF3Struct;
  *  LocStrings is different. Since xoreos has more flexible handling of
  *  language IDs anyway, this doesn't concern us.
  *
+ *  The structs of a GFF3 file are allocated out of a memory arena. By
+ *  default, each GFF3File creates its own arena, but an external arena
+ *  can be passed into the constructor, to be reused for many files in a
+ *  row. That arena must outlive the GFF3File.
+ *
  *  See also: GFF4File in gff4file.h for the later V4.0/V4.1 versions of
  *  the GFF format.
  */
 class GFF3File : boost::noncopyable, public AuroraFile {
 public:
 	/** Take over this stream and read a GFF3 file out of it. */
-	GFF3File(Common::SeekableReadStream *gff3, uint32 id = 0xFFFFFFFF, bool repairNWNPremium = false);
+	GFF3File(Common::SeekableReadStream *gff3, uint32 id = 0xFFFFFFFF, bool repairNWNPremium = false,
+	         Common::MemoryArena *arena = 0);
 	virtual ~GFF3File();
 
 	/** Return the GFF3's specific type. */
@@ -116,12 +123,17 @@ private:
 		void read(Common::SeekableReadStream &gff3);
 	};
 
-	typedef Common::PtrVector<GFF3Struct> StructArray;
+	typedef Common::PtrVector<GFF3Struct, Common::DeallocatorDestruct> StructArray;
 	typedef std::vector<GFF3List> ListArray;
 
 
 	Common::ScopedPtr<Common::SeekableReadStream> _stream;
 
+	/** Our own memory arena, if none was given to us. */
+	Common::ScopedPtr<Common::MemoryArena> _ownArena;
+	/** The memory arena our structs are allocated from. */
+	Common::MemoryArena *_arena;
+
 	Header _header; ///< The GFF3's header.
 
 	/** Should we try to read GFF3 files found in Neverwinter Nights premium modules? */
@@ -250,7 +262,9 @@ private:
 		Field(FieldType t, uint32 d);
 	};
 
-	typedef std::map<Common::UString, Field> FieldMap;
+	typedef std::pair<const Common::UString, Field> FieldMapEntry;
+	typedef std::map<Common::UString, Field, std::less<Common::UString>,
+	                 Common::ArenaAllocator<FieldMapEntry> > FieldMap;
 
 
 	const GFF3File *_parent; ///< The parent GFF3.
@@ -289,7 +303,7 @@ private:
 	friend class GFF3File;
 
 	template<typename T>
-	friend void Common::DeallocatorDefault::destroy(T *);
+	friend void Common::DeallocatorDestruct::destroy(T *);
 };
 
 } // End of namespace Aurora
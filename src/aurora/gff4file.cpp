@@ -27,11 +27,15 @@
  */
 
 #include <cassert>
+#include <cstring>
+#include <new>
 
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/encoding.h"
 #include "src/common/strutil.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/gff4file.h"
 #include "src/aurora/util.h"
@@ -40,6 +44,8 @@ static const uint32 kGFFID     = MKTAG('G', 'F', 'F', ' ');
 static const uint32 kVersion40 = MKTAG('V', '4', '.', '0');
 static const uint32 kVersion41 = MKTAG('V', '4', '.', '1');
 
+static const Common::UString kEmptyString;
+
 namespace Aurora {
 
 void GFF4File::Header::read(Common::SeekableReadStream &gff4, uint32 version) {
@@ -73,8 +79,9 @@ bool GFF4File::Header::isBigEndian() const {
 }
 
 
-GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type) :
-	_origStream(gff4), _topLevelStruct(0) {
+GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type, Common::MemoryArena *arena) :
+	_origStream(gff4), _ownArena(arena ? 0 : new Common::MemoryArena), _arena(arena ? arena : _ownArena.get()),
+	_structs(StructMap::key_compare(), StructMap::allocator_type(*_arena)), _topLevelStruct(0) {
 
 	assert(_origStream);
 
@@ -90,10 +97,14 @@ void GFF4File::clear() {
 	_stream.reset();
 
 	for (StructMap::iterator s = _structs.begin(); s != _structs.end(); ++s)
-		delete s->second;
+		Common::DeallocatorDestruct::destroy(s->second);
 
 	_structs.clear();
 	_topLevelStruct = 0;
+
+	_sharedStringData.clear();
+	_sharedStrings.clear();
+	_strings.clear();
 }
 
 uint32 GFF4File::getType() const {
@@ -128,6 +139,8 @@ const GFF4Struct &GFF4File::getTopLevel() const {
 // --- Loader ---
 
 void GFF4File::load(uint32 type) {
+	XOREOS_TRACE_SPAN("format", "GFF4File::load");
+
 	try {
 
 		loadHeader(type);
@@ -225,7 +238,7 @@ void GFF4File::loadStructs() {
 
 	/* And load the top level struct, which itself recurses into field structs.
 	 * The top level struct is always constructed using the first template. */
-	_topLevelStruct = new GFF4Struct(*this, _header.dataOffset, _structTemplates[0]);
+	_topLevelStruct = GFF4Struct::create(*this, _header.dataOffset, _structTemplates[0]);
 	_topLevelStruct->_refCount++;
 }
 
@@ -234,16 +247,48 @@ void GFF4File::loadStrings() {
 	 *
 	 * If this GFF4 file has such a table (which is only supported in V4.1),
 	 * each individual string field in a struct doesn't provide its own data.
-	 * Instead, they then reference this shared string table. */
+	 * Instead, they then reference this shared string table.
+	 *
+	 * Since a small number of shared strings is usually referenced over and
+	 * over again, we only read the raw table here and find where each string
+	 * starts. The strings themselves are decoded once, on first access. */
 
 	if (!_header.hasSharedStrings)
 		return;
 
 	_sharedStrings.resize(_header.stringCount);
+	if (_header.stringCount == 0)
+		return;
+
+	// The string table runs until the data section, or until the end of the file
+	size_t tableEnd = _stream->size();
+	if ((_header.dataOffset > _header.stringOffset) && (_header.dataOffset < tableEnd))
+		tableEnd = _header.dataOffset;
+
+	if (_header.stringOffset > tableEnd)
+		throw Common::Exception("GFF4: Invalid shared string table offset (%u > %u)",
+		                        _header.stringOffset, (uint) tableEnd);
+
+	_sharedStringData.resize(tableEnd - _header.stringOffset + 1);
 
 	_stream->seek(_header.stringOffset);
-	for (uint32 i = 0; i < _header.stringCount; i++)
-		_sharedStrings[i] = Common::readString(*_stream, Common::kEncodingUTF8);
+	const size_t tableSize = _stream->read(&_sharedStringData[0], _sharedStringData.size() - 1);
+
+	// Make sure the last string is always terminated
+	_sharedStringData[tableSize] = '\0';
+
+	const byte *table = &_sharedStringData[0];
+
+	size_t offset = 0;
+	for (uint32 i = 0; i < _header.stringCount; i++) {
+		const byte *end = static_cast<const byte *>(std::memchr(table + offset, '\0', tableSize + 1 - offset));
+		assert(end);
+
+		_sharedStrings[i].offset = offset;
+		_sharedStrings[i].length = end - (table + offset);
+
+		offset = MIN<size_t>(offset + _sharedStrings[i].length + 1, tableSize);
+	}
 }
 
 // --- Helpers for GFF4Struct ---
@@ -300,15 +345,42 @@ bool GFF4File::hasSharedStrings() const {
 	return _header.hasSharedStrings;
 }
 
-Common::UString GFF4File::getSharedString(uint32 i) const {
+const Common::UString &GFF4File::getSharedString(uint32 i) const {
 	if (i == 0xFFFFFFFF)
-		return "";
+		return kEmptyString;
 
 	if (i >= _sharedStrings.size())
 		throw Common::Exception("GFF4: Shared string index out of range (%u >= %u)",
 		                        i, (uint) _sharedStrings.size());
 
-	return _sharedStrings[i];
+	SharedString &str = _sharedStrings[i];
+	if (!str.decoded) {
+		str.string  = Common::readString(&_sharedStringData[str.offset], str.length, Common::kEncodingUTF8);
+		str.decoded = true;
+	}
+
+	return str.string;
+}
+
+const Common::UString *GFF4File::findString(uint32 offset, Common::Encoding encoding) const {
+	StringMap::const_iterator s = _strings.find((((uint64) offset) << 32) | (uint32) encoding);
+	if (s == _strings.end())
+		return 0;
+
+	return &s->second;
+}
+
+const Common::UString &GFF4File::addString(uint32 offset, Common::Encoding encoding,
+                                           const Common::UString &str) const {
+
+	/* Remember a string that was decoded from the data section.
+	 *
+	 * Several fields can point to the same string data, and the dumpers
+	 * tend to read the same field several times. The conversion from the
+	 * file's encoding into UTF-8 is costly, so we only want to do that
+	 * once for every offset and encoding. */
+
+	return _strings.insert(std::make_pair((((uint64) offset) << 32) | (uint32) encoding, str)).first->second;
 }
 
 
@@ -359,7 +431,8 @@ GFF4Struct::Field::~Field() {
 
 
 GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt) :
-	_parent(&parent), _label(tmplt.label), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _label(tmplt.label), _refCount(0), _fieldCount(0),
+	_fields(FieldMap::key_compare(), FieldMap::allocator_type(*parent._arena)) {
 
 	// Constructor for a real struct, from a template
 
@@ -375,7 +448,8 @@ GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTe
 }
 
 GFF4Struct::GFF4Struct(GFF4File &parent, const Field &genericParent) :
-	_parent(&parent), _label(0), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _label(0), _refCount(0), _fieldCount(0),
+	_fields(FieldMap::key_compare(), FieldMap::allocator_type(*parent._arena)) {
 
 	// Constructor for a generic, converted into a struct
 
@@ -393,6 +467,14 @@ GFF4Struct::GFF4Struct(GFF4File &parent, const Field &genericParent) :
 GFF4Struct::~GFF4Struct() {
 }
 
+GFF4Struct *GFF4Struct::create(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt) {
+	return new (parent._arena->allocate<GFF4Struct>()) GFF4Struct(parent, offset, tmplt);
+}
+
+GFF4Struct *GFF4Struct::create(GFF4File &parent, const Field &genericParent) {
+	return new (parent._arena->allocate<GFF4Struct>()) GFF4Struct(parent, genericParent);
+}
+
 uint64 GFF4Struct::getID() const {
 	return _id;
 }
@@ -462,8 +544,8 @@ void GFF4Struct::loadStructs(GFF4File &parent, Field &field) {
 
 	Common::SeekableSubReadStreamEndian &data = parent.getStream(field.offset);
 
-	const uint32 structCount = getListCount(data, field);
 	const uint32 structSize  = field.isReference ? 4 : tmplt.size;
+	const uint32 structCount = getListCount(data, field, structSize);
 	const uint32 structStart = data.pos();
 
 	field.structs.resize(structCount, 0);
@@ -474,7 +556,7 @@ void GFF4Struct::loadStructs(GFF4File &parent, Field &field) {
 
 		GFF4Struct *strct = parent.findStruct(generateID(offset, &tmplt));
 		if (!strct)
-			strct = new GFF4Struct(parent, offset, tmplt);
+			strct = create(parent, offset, tmplt);
 
 		strct->_refCount++;
 
@@ -491,7 +573,7 @@ void GFF4Struct::loadGeneric(GFF4File &parent, Field &field) {
 
 	GFF4Struct *strct = parent.findStruct(generateID(field.offset));
 	if (!strct)
-		strct = new GFF4Struct(parent, field);
+		strct = create(parent, field);
 
 	strct->_refCount++;
 
@@ -658,7 +740,8 @@ uint32 GFF4Struct::getVectorMatrixLength(const Field &field, uint32 minLength, u
 	return length;
 }
 
-uint32 GFF4Struct::getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field) const {
+uint32 GFF4Struct::getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field,
+                                uint32 elementSize) const {
 	if (!field.isList)
 		return 1;
 
@@ -668,7 +751,14 @@ uint32 GFF4Struct::getListCount(Common::SeekableSubReadStreamEndian &data, const
 
 	data.seek(_parent->getDataOffset() + listOffset);
 
-	return data.readUint32();
+	const uint32 count = data.readUint32();
+
+	// Make sure a corrupt count doesn't make us allocate huge lists before reading them
+	if ((elementSize > 0) && (count > ((data.size() - data.pos()) / elementSize)))
+		throw Common::Exception("GFF4: List count %u is too large for its data (%u bytes left)",
+		                        count, (uint) (data.size() - data.pos()));
+
+	return count;
 }
 
 uint32 GFF4Struct::getFieldSize(FieldType type) const {
@@ -824,6 +914,148 @@ float GFF4Struct::getFloat(Common::SeekableSubReadStreamEndian &data, FieldType
 	throw Common::Exception("GFF4: Field is not a float type");
 }
 
+void GFF4Struct::getUint(Common::SeekableSubReadStreamEndian &data, FieldType type,
+                         uint64 *values, size_t count) const {
+
+	/* Read a whole array of integer values in one go, and only then convert
+	 * them (from the file's endianness and integer width) into the output. */
+
+	if (count == 0)
+		return;
+
+	switch (type) {
+		case kFieldTypeUint8:
+		case kFieldTypeSint8:
+			{
+				std::vector<byte> raw(count);
+				if (data.read(&raw[0], count) != count)
+					throw Common::Exception(Common::kReadError);
+
+				if (type == kFieldTypeUint8)
+					for (size_t i = 0; i < count; i++)
+						values[i] = (uint64) raw[i];
+				else
+					for (size_t i = 0; i < count; i++)
+						values[i] = (uint64) ((int64) ((int8) raw[i]));
+			}
+			return;
+
+		case kFieldTypeUint16:
+		case kFieldTypeSint16:
+			{
+				std::vector<uint16> raw(count);
+				data.readUint16(&raw[0], count);
+
+				if (type == kFieldTypeUint16)
+					for (size_t i = 0; i < count; i++)
+						values[i] = (uint64) raw[i];
+				else
+					for (size_t i = 0; i < count; i++)
+						values[i] = (uint64) ((int64) ((int16) raw[i]));
+			}
+			return;
+
+		case kFieldTypeUint32:
+		case kFieldTypeSint32:
+			{
+				std::vector<uint32> raw(count);
+				data.readUint32(&raw[0], count);
+
+				if (type == kFieldTypeUint32)
+					for (size_t i = 0; i < count; i++)
+						values[i] = (uint64) raw[i];
+				else
+					for (size_t i = 0; i < count; i++)
+						values[i] = (uint64) ((int64) ((int32) raw[i]));
+			}
+			return;
+
+		case kFieldTypeUint64:
+		case kFieldTypeSint64:
+			data.readUint64(values, count);
+			return;
+
+		default:
+			break;
+	}
+
+	throw Common::Exception("GFF4: Field is not an int type");
+}
+
+void GFF4Struct::getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type,
+                           double *values, size_t count) const {
+
+	if (count == 0)
+		return;
+
+	switch (type) {
+		case kFieldTypeFloat32:
+		case kFieldTypeNDSFixed:
+			{
+				std::vector<uint32> raw(count);
+				data.readUint32(&raw[0], count);
+
+				if (type == kFieldTypeFloat32)
+					for (size_t i = 0; i < count; i++)
+						values[i] = (double) convertIEEEFloat(raw[i]);
+				else
+					for (size_t i = 0; i < count; i++)
+						values[i] = readNintendoFixedPoint(raw[i], true, 19, 12);
+			}
+			return;
+
+		case kFieldTypeFloat64:
+			{
+				std::vector<uint64> raw(count);
+				data.readUint64(&raw[0], count);
+
+				for (size_t i = 0; i < count; i++)
+					values[i] = convertIEEEDouble(raw[i]);
+			}
+			return;
+
+		default:
+			break;
+	}
+
+	throw Common::Exception("GFF4: Field is not a float type");
+}
+
+void GFF4Struct::getFloat(Common::SeekableSubReadStreamEndian &data, FieldType type,
+                          float *values, size_t count) const {
+
+	if (count == 0)
+		return;
+
+	switch (type) {
+		case kFieldTypeFloat32:
+			{
+				std::vector<uint32> raw(count);
+				data.readUint32(&raw[0], count);
+
+				for (size_t i = 0; i < count; i++)
+					values[i] = convertIEEEFloat(raw[i]);
+			}
+			return;
+
+		case kFieldTypeFloat64:
+		case kFieldTypeNDSFixed:
+			{
+				std::vector<double> converted(count);
+				getDouble(data, type, &converted[0], count);
+
+				for (size_t i = 0; i < count; i++)
+					values[i] = (float) converted[i];
+			}
+			return;
+
+		default:
+			break;
+	}
+
+	throw Common::Exception("GFF4: Field is not a float type");
+}
+
 Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding) const {
 	/* When the string is encoded in UTF-8, then length field specifies the length in bytes.
 	 * Otherwise, it's the length in characters. */
@@ -842,8 +1074,12 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 	return Common::UString::format("GFF4: Invalid string encoding (0x%08X)", (uint) offset);
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding,
-                                      uint32 offset) const {
+const Common::UString &GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
+                                             Common::Encoding encoding, uint32 offset) const {
+
+	const Common::UString *cached = _parent->findString(offset, encoding);
+	if (cached)
+		return *cached;
 
 	const uint32 pos = data.seek(offset);
 
@@ -851,26 +1087,17 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 
 	data.seek(pos);
 
-	return str;
+	return _parent->addString(offset, encoding, str);
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, const Field &field,
-                                      Common::Encoding encoding) const {
+const Common::UString &GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, const Field &field,
+                                             Common::Encoding encoding) const {
 
 	if (field.type == kFieldTypeString) {
-		if (_parent->hasSharedStrings())
-			return _parent->getSharedString(data.readUint32());
-
-		uint32 offset = data.pos();
-		if (!field.isGeneric) {
-			offset = data.readUint32();
-			if (offset == 0xFFFFFFFF)
-				return "";
+		if (_parent->hasSharedStrings() || !field.isGeneric)
+			return getStringReference(data, encoding, data.readUint32());
 
-			offset += _parent->getDataOffset();
-		}
-
-		return getString(data, encoding, offset);
+		return getString(data, encoding, data.pos());
 	}
 
 	if (field.type == kFieldTypeASCIIString)
@@ -879,6 +1106,36 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 	throw Common::Exception("GFF4: Field is not a string type");
 }
 
+const Common::UString &GFF4Struct::getStringReference(Common::SeekableSubReadStreamEndian &data,
+                                                      Common::Encoding encoding, uint32 offset) const {
+
+	/* Resolve a string field that has already been read as a reference. It's either
+	 * an index into the shared string table, or an offset into the data section. */
+
+	if (_parent->hasSharedStrings())
+		return _parent->getSharedString(offset);
+
+	if (offset == 0xFFFFFFFF)
+		return kEmptyString;
+
+	return getString(data, encoding, _parent->getDataOffset() + offset);
+}
+
+const Common::UString &GFF4Struct::getTalkString(Common::SeekableSubReadStreamEndian &data,
+                                                 Common::Encoding encoding, uint32 offset) const {
+
+	if (offset == 0xFFFFFFFF)
+		return kEmptyString;
+
+	if (_parent->hasSharedStrings())
+		return _parent->getSharedString(offset);
+
+	if (offset == 0)
+		return kEmptyString;
+
+	return getString(data, encoding, _parent->getDataOffset() + offset);
+}
+
 // --- Single value readers ---
 
 uint64 GFF4Struct::getUint(uint32 field, uint64 def) const {
@@ -968,13 +1225,7 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 
 	const uint32 offset = getUint(*data, kFieldTypeUint32);
 
-	str.clear();
-	if (offset != 0xFFFFFFFF) {
-		if (_parent->hasSharedStrings())
-			str = _parent->getSharedString(offset);
-		else if (offset != 0)
-			str = getString(*data, encoding, _parent->getDataOffset() + offset);
-	}
+	str = getTalkString(*data, encoding, offset);
 
 	return true;
 }
@@ -1067,8 +1318,7 @@ bool GFF4Struct::getMatrix4x4(uint32 field, double (&m)[16]) const {
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
 	const uint32 length = getVectorMatrixLength(*f, 16, 16);
-	for (uint32 i = 0; i < length; i++)
-		m[i] = getDouble(*data, kFieldTypeFloat32);
+	getDouble(*data, kFieldTypeFloat32, m, length);
 
 	return true;
 }
@@ -1083,8 +1333,7 @@ bool GFF4Struct::getMatrix4x4(uint32 field, float (&m)[16]) const {
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
 	const uint32 length = getVectorMatrixLength(*f, 16, 16);
-	for (uint32 i = 0; i < length; i++)
-		m[i] = getFloat(*data, kFieldTypeFloat32);
+	getFloat(*data, kFieldTypeFloat32, m, length);
 
 	return true;
 }
@@ -1101,8 +1350,7 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
 
 	vectorMatrix.resize(length);
-	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getDouble(*data, kFieldTypeFloat32);
+	getDouble(*data, kFieldTypeFloat32, &vectorMatrix[0], length);
 
 	return true;
 }
@@ -1119,8 +1367,7 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix)
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
 
 	vectorMatrix.resize(length);
-	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getFloat(*data, kFieldTypeFloat32);
+	getFloat(*data, kFieldTypeFloat32, &vectorMatrix[0], length);
 
 	return true;
 }
@@ -1133,11 +1380,11 @@ bool GFF4Struct::getUint(uint32 field, std::vector<uint64> &list) const {
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
 
 	list.resize(count);
-	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type);
+	if (count > 0)
+		getUint(*data, f->type, &list[0], count);
 
 	return true;
 }
@@ -1148,11 +1395,15 @@ bool GFF4Struct::getSint(uint32 field, std::vector<int64> &list) const {
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
+
+	std::vector<uint64> values(count);
+	if (count > 0)
+		getUint(*data, f->type, &values[0], count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getSint(*data, f->type);
+		list[i] = (int64) values[i];
 
 	return true;
 }
@@ -1163,11 +1414,15 @@ bool GFF4Struct::getBool(uint32 field, std::vector<bool> &list) const {
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
+
+	std::vector<uint64> values(count);
+	if (count > 0)
+		getUint(*data, f->type, &values[0], count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type) != 0;
+		list[i] = values[i] != 0;
 
 	return true;
 }
@@ -1178,11 +1433,11 @@ bool GFF4Struct::getDouble(uint32 field, std::vector<double> &list) const {
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
 
 	list.resize(count);
-	for (uint32 i = 0; i < count; i++)
-		list[i] = getDouble(*data, f->type);
+	if (count > 0)
+		getDouble(*data, f->type, &list[0], count);
 
 	return true;
 }
@@ -1193,11 +1448,11 @@ bool GFF4Struct::getFloat(uint32 field, std::vector<float> &list) const {
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
 
 	list.resize(count);
-	for (uint32 i = 0; i < count; i++)
-		list[i] = getFloat(*data, f->type);
+	if (count > 0)
+		getFloat(*data, f->type, &list[0], count);
 
 	return true;
 }
@@ -1216,9 +1471,25 @@ bool GFF4Struct::getString(uint32 field, Common::Encoding encoding,
 		return false;
 	}
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
 
 	list.resize(count);
+
+	if ((f->type == kFieldTypeString) && (_parent->hasSharedStrings() || !f->isGeneric)) {
+		/* A list of string references. Read all the references in one go first,
+		 * and only then resolve them, so that we don't need to seek back and
+		 * forth between the list and the string data for every element. */
+
+		std::vector<uint32> offsets(count);
+		if (count > 0)
+			data->readUint32(&offsets[0], count);
+
+		for (uint32 i = 0; i < count; i++)
+			list[i] = getStringReference(*data, encoding, offsets[i]);
+
+		return true;
+	}
+
 	for (uint32 i = 0; i < count; i++)
 		list[i] = getString(*data, *f, encoding);
 
@@ -1241,25 +1512,19 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 	if (f->type != kFieldTypeTlkString)
 		throw Common::Exception("GFF4: Field is not of TalkString type");
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
 
 	strRefs.resize(count);
 	strs.resize(count);
 
-	std::vector<uint32> offsets;
-	offsets.resize(count);
+	// Pairs of string reference and string offset
+	std::vector<uint32> values(2 * (size_t) count);
+	if (count > 0)
+		data->readUint32(&values[0], values.size());
 
 	for (uint32 i = 0; i < count; i++) {
-		strRefs[i] = getUint(*data, kFieldTypeUint32);
-
-		const uint32 offset = getUint(*data, kFieldTypeUint32);
-
-		if (offset != 0xFFFFFFFF) {
-			if (_parent->hasSharedStrings())
-				strs[i] = _parent->getSharedString(offset);
-			else if (offset != 0)
-				strs[i] = getString(*data, encoding, _parent->getDataOffset() + offset);
-		}
+		strRefs[i] = values[i * 2 + 0];
+		strs[i]    = getTalkString(*data, encoding, values[i * 2 + 1]);
 	}
 
 	return true;
@@ -1278,15 +1543,16 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<double>
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
+	const uint32 count  = getListCount(*data, *f, getFieldSize(f->type));
 
-	list.resize(count);
-	for (uint32 i = 0; i < count; i++) {
+	// Read all the elements of all vectors/matrices in one go
+	std::vector<double> values((size_t) count * length);
+	if (!values.empty())
+		getDouble(*data, kFieldTypeFloat32, &values[0], values.size());
 
-		list[i].resize(length);
-		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getDouble(*data, kFieldTypeFloat32);
-	}
+	list.resize(count);
+	for (uint32 i = 0; i < count; i++)
+		list[i].assign(values.begin() + i * length, values.begin() + (i + 1) * length);
 
 	return true;
 }
@@ -1298,15 +1564,16 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<float> >
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
+	const uint32 count  = getListCount(*data, *f, getFieldSize(f->type));
 
-	list.resize(count);
-	for (uint32 i = 0; i < count; i++) {
+	// Read all the elements of all vectors/matrices in one go
+	std::vector<float> values((size_t) count * length);
+	if (!values.empty())
+		getFloat(*data, kFieldTypeFloat32, &values[0], values.size());
 
-		list[i].resize(length);
-		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getFloat(*data, kFieldTypeFloat32);
-	}
+	list.resize(count);
+	for (uint32 i = 0; i < count; i++)
+		list[i].assign(values.begin() + i * length, values.begin() + (i + 1) * length);
 
 	return true;
 }
@@ -1366,7 +1633,7 @@ Common::SeekableReadStream *GFF4Struct::getData(uint32 field) const {
 	if (!data)
 		return 0;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(*data, *f, getFieldSize(f->type));
 	const uint32 size  = getFieldSize(f->type);
 
 	if ((size == 0) || (count == 0))
@@ -34,6 +34,7 @@
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
 #include "src/common/encoding.h"
+#include "src/common/memoryarena.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/aurorafile.h"
@@ -84,6 +85,9 @@ class GFF4Struct;
  *    have strings in a language-specific encoding. For example, the English,
  *    French, Italian, German and Spanish (EFIGS) versions have the strings
  *    in TLK files encoded in Windows CP-1252.
+ *  - The structs are allocated out of a memory arena, same as in GFF3File.
+ *    An external arena, to be reused for many files, can be passed into the
+ *    constructor. It must outlive the GFF4File.
  *
  *  See also: GFF3File in gff3file.h for the earlier V3.2/V3.3 versions of
  *  the GFF format.
@@ -91,7 +95,7 @@ class GFF4Struct;
 class GFF4File : boost::noncopyable, public AuroraFile {
 public:
 	/** Take over this stream and read a GFF4 file out of it. */
-	GFF4File(Common::SeekableReadStream *gff4, uint32 type = 0xFFFFFFFF);
+	GFF4File(Common::SeekableReadStream *gff4, uint32 type = 0xFFFFFFFF, Common::MemoryArena *arena = 0);
 	~GFF4File();
 
 	/** Return the GFF4's specific type. */
@@ -149,9 +153,23 @@ private:
 		std::vector<Field> fields;
 	};
 
+	/** A lazily decoded string out of the V4.1 shared string table. */
+	struct SharedString {
+		uint32 offset; ///< Offset of the raw string data within the string table.
+		uint32 length; ///< Length of the raw string data in bytes.
+
+		bool decoded;           ///< Was the string already decoded?
+		Common::UString string; ///< The decoded string.
+
+		SharedString() : offset(0), length(0), decoded(false) { }
+	};
+
 	typedef std::vector<StructTemplate> StructTemplates;
-	typedef std::vector<Common::UString> SharedStrings;
-	typedef std::map<uint64, GFF4Struct *> StructMap;
+	typedef std::vector<SharedString> SharedStrings;
+	typedef std::pair<const uint64, GFF4Struct *> StructMapEntry;
+	typedef std::map<uint64, GFF4Struct *, std::less<uint64>,
+	                 Common::ArenaAllocator<StructMapEntry> > StructMap;
+	typedef std::map<uint64, Common::UString> StringMap;
 
 
 
@@ -163,8 +181,18 @@ private:
 	/** All struct templates in this GFF4. */
 	StructTemplates _structTemplates;
 
-	/** The shared strings used in V4.1. */
-	SharedStrings _sharedStrings;
+	/** The raw data of the shared string table used in V4.1. */
+	std::vector<byte> _sharedStringData;
+	/** The shared strings used in V4.1, decoded on first access. */
+	mutable SharedStrings _sharedStrings;
+
+	/** All strings (non-shared) that have been decoded so far, by offset and encoding. */
+	mutable StringMap _strings;
+
+	/** Our own memory arena, if none was given to us. */
+	Common::ScopedPtr<Common::MemoryArena> _ownArena;
+	/** The memory arena our structs are allocated from. */
+	Common::MemoryArena *_arena;
 
 	/** All actual structs in this GFF4. */
 	StructMap   _structs;
@@ -191,7 +219,10 @@ private:
 	uint32 getDataOffset() const;
 
 	bool hasSharedStrings() const;
-	Common::UString getSharedString(uint32 i) const;
+	const Common::UString &getSharedString(uint32 i) const;
+
+	const Common::UString *findString(uint32 offset, Common::Encoding encoding) const;
+	const Common::UString &addString(uint32 offset, Common::Encoding encoding, const Common::UString &str) const;
 	// '---
 
 	friend class GFF4Struct;
@@ -359,7 +390,8 @@ private:
 		~Field();
 	};
 
-	typedef std::map<uint32, Field> FieldMap;
+	typedef std::pair<const uint32, Field> FieldMapEntry;
+	typedef std::map<uint32, Field, std::less<uint32>, Common::ArenaAllocator<FieldMapEntry> > FieldMap;
 
 
 	const GFF4File *_parent;
@@ -391,6 +423,9 @@ private:
 	void load(GFF4File &parent, const Field &genericParent);
 
 	static uint64 generateID(uint32 offset, const GFF4File::StructTemplate *tmplt = 0);
+
+	static GFF4Struct *create(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt);
+	static GFF4Struct *create(GFF4File &parent, const Field &genericParent);
 	// '---
 
 	// .--- Field and field data accessors
@@ -404,7 +439,7 @@ private:
 	// '---
 
 	// .--- Field reader helpers
-	uint32 getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field) const;
+	uint32 getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field, uint32 elementSize) const;
 	uint32 getFieldSize(FieldType type) const;
 
 	uint64 getUint(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
@@ -413,17 +448,29 @@ private:
 	double getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
 	float  getFloat (Common::SeekableSubReadStreamEndian &data, FieldType type) const;
 
+	void getUint  (Common::SeekableSubReadStreamEndian &data, FieldType type, uint64 *values, size_t count) const;
+	void getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type, double *values, size_t count) const;
+	void getFloat (Common::SeekableSubReadStreamEndian &data, FieldType type, float  *values, size_t count) const;
+
 	Common::UString getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding) const;
-	Common::UString getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding,
-	                          uint32 offset) const;
-	Common::UString getString(Common::SeekableSubReadStreamEndian &data, const Field &field,
-	                          Common::Encoding encoding) const;
+	const Common::UString &getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding,
+	                                 uint32 offset) const;
+	const Common::UString &getString(Common::SeekableSubReadStreamEndian &data, const Field &field,
+	                                 Common::Encoding encoding) const;
+	const Common::UString &getStringReference(Common::SeekableSubReadStreamEndian &data,
+	                                          Common::Encoding encoding, uint32 offset) const;
+
+	const Common::UString &getTalkString(Common::SeekableSubReadStreamEndian &data,
+	                                     Common::Encoding encoding, uint32 offset) const;
 
 	uint32 getVectorMatrixLength(const Field &field, uint32 minLength, uint32 maxLength) const;
 	// '---
 
 
 	friend class GFF4File;
+
+	template<typename T>
+	friend void Common::DeallocatorDestruct::destroy(T *);
 };
 
 } // End of namespace Aurora
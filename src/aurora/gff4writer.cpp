@@ -0,0 +1,1015 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Writer for writing version V4.0/V4.1 of BioWare's GFFs (generic file format).
+ */
+
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <map>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/strutil.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/writestream.h"
+#include "src/common/trace.h"
+
+#include "src/aurora/gff4writer.h"
+
+static const uint32 kGFFID     = MKTAG('G', 'F', 'F', ' ');
+static const uint32 kVersion40 = MKTAG('V', '4', '.', '0');
+static const uint32 kVersion41 = MKTAG('V', '4', '.', '1');
+
+static const uint32 kGFF4PlatformPS3     = MKTAG('P', 'S', '3', ' ');
+static const uint32 kGFF4PlatformXbox360 = MKTAG('X', '3', '6', '0');
+
+static const uint32 kFlagList      = 0x8000;
+static const uint32 kFlagStruct    = 0x4000;
+static const uint32 kFlagReference = 0x2000;
+
+static const uint32 kNoClass  = 0xFFFFFFFF;
+static const uint32 kNoOffset = 0xFFFFFFFF;
+
+static const size_t kNoElement = (size_t) -1;
+
+namespace Aurora {
+
+/** Return the size of a single value of a simple field type. */
+static uint32 getTypeSize(GFF4Struct::FieldType type) {
+	switch (type) {
+		case GFF4Struct::kFieldTypeUint8:
+		case GFF4Struct::kFieldTypeSint8:
+			return 1;
+
+		case GFF4Struct::kFieldTypeUint16:
+		case GFF4Struct::kFieldTypeSint16:
+			return 2;
+
+		case GFF4Struct::kFieldTypeUint32:
+		case GFF4Struct::kFieldTypeSint32:
+		case GFF4Struct::kFieldTypeFloat32:
+		case GFF4Struct::kFieldTypeNDSFixed:
+		case GFF4Struct::kFieldTypeString:
+			return 4;
+
+		case GFF4Struct::kFieldTypeUint64:
+		case GFF4Struct::kFieldTypeSint64:
+		case GFF4Struct::kFieldTypeFloat64:
+		case GFF4Struct::kFieldTypeTlkString:
+			return 8;
+
+		case GFF4Struct::kFieldTypeVector3f:
+			return 3 * 4;
+
+		case GFF4Struct::kFieldTypeVector4f:
+		case GFF4Struct::kFieldTypeQuaternionf:
+		case GFF4Struct::kFieldTypeColor4f:
+			return 4 * 4;
+
+		case GFF4Struct::kFieldTypeMatrix4x4f:
+			return 16 * 4;
+
+		default:
+			break;
+	}
+
+	throw Common::Exception("GFF4: Can't write fields of type %d", (int) type);
+}
+
+static bool isIntType(GFF4Struct::FieldType type) {
+	return (type >= GFF4Struct::kFieldTypeUint8) && (type <= GFF4Struct::kFieldTypeSint64);
+}
+
+static bool isFloatType(GFF4Struct::FieldType type) {
+	return (type == GFF4Struct::kFieldTypeFloat32) || (type == GFF4Struct::kFieldTypeFloat64) ||
+	       (type == GFF4Struct::kFieldTypeNDSFixed);
+}
+
+static bool isVectorMatrixType(GFF4Struct::FieldType type) {
+	return (type == GFF4Struct::kFieldTypeVector3f)    || (type == GFF4Struct::kFieldTypeVector4f) ||
+	       (type == GFF4Struct::kFieldTypeQuaternionf) || (type == GFF4Struct::kFieldTypeColor4f)  ||
+	       (type == GFF4Struct::kFieldTypeMatrix4x4f);
+}
+
+
+GFF4Writer::GFF4Writer(uint32 type, uint32 typeVersion, uint32 platform, uint32 version) :
+	_type(type), _typeVersion(typeVersion), _platform(platform), _version(version) {
+
+	if ((_version != kVersion40) && (_version != kVersion41))
+		throw Common::Exception("Unsupported GFF4 file version %s", Common::debugTag(_version).c_str());
+
+	_bigEndian = (_platform == kGFF4PlatformPS3) || (_platform == kGFF4PlatformXbox360);
+	_encoding  = _bigEndian ? Common::kEncodingUTF16BE : Common::kEncodingUTF16LE;
+
+	// The top-level struct always uses the first template, and its label is the GFF4 type
+	_structs.push_back(new GFF4WriterStruct(*this, _type, false));
+}
+
+GFF4Writer::~GFF4Writer() {
+}
+
+GFF4WriterStruct &GFF4Writer::getTopLevel() {
+	return *_structs.front();
+}
+
+GFF4WriterStruct *GFF4Writer::createStruct(uint32 label) {
+	_structs.push_back(new GFF4WriterStruct(*this, label, false));
+
+	return _structs.back();
+}
+
+GFF4WriterStruct *GFF4Writer::createGeneric() {
+	_structs.push_back(new GFF4WriterStruct(*this, 0, true));
+
+	return _structs.back();
+}
+
+bool GFF4Writer::hasSharedStrings() const {
+	return _version == kVersion41;
+}
+
+void GFF4Writer::write(Common::WriteStream &stream) {
+	XOREOS_TRACE_SPAN("format", "GFF4Writer::write");
+
+	_order.clear();
+	_templates.clear();
+	_data.clear();
+	_sharedStrings.clear();
+	_strings.clear();
+
+	for (Common::PtrVector<GFF4WriterStruct>::iterator s = _structs.begin(); s != _structs.end(); ++s) {
+		(*s)->_refCount = 0;
+		(*s)->_visited  = false;
+		(*s)->_class    = kNoClass;
+		(*s)->_offset   = kNoOffset;
+
+		(*s)->_fieldFlags.clear();
+	}
+
+	GFF4WriterStruct &topLevel = getTopLevel();
+
+	topLevel._refCount++;
+	collectStructs(topLevel);
+
+	createClasses();
+	createTemplates();
+
+	// Lay out the data section, starting with the top-level struct
+	placeStruct(topLevel);
+
+	// Calculate where the parts of the file go
+
+	uint32 fieldCount = 0;
+	for (std::vector<StructTemplate>::const_iterator t = _templates.begin(); t != _templates.end(); ++t)
+		fieldCount += t->fields.size();
+
+	const uint32 headerSize   = hasSharedStrings() ? 36 : 28;
+	const uint32 fieldOffset  = headerSize + _templates.size() * 16;
+	const uint32 stringOffset = fieldOffset + fieldCount * 12;
+
+	uint32 stringSize = 0;
+	for (std::vector<Common::UString>::const_iterator s = _sharedStrings.begin(); s != _sharedStrings.end(); ++s)
+		stringSize += std::strlen(s->c_str()) + 1;
+
+	const uint32 dataOffset = ((stringOffset + stringSize + 3) / 4) * 4;
+
+	writeHeader(stream, stringOffset, dataOffset);
+	writeTemplates(stream, fieldOffset);
+	writeSharedStrings(stream);
+
+	stream.writeZeros(dataOffset - stringOffset - stringSize);
+
+	if (!_data.empty())
+		stream.write(&_data[0], _data.size());
+}
+
+// --- Struct templates ---
+
+void GFF4Writer::collectStructs(GFF4WriterStruct &strct) {
+	if (strct._visited)
+		return;
+
+	strct._visited = true;
+	if (!strct._isGeneric)
+		_order.push_back(&strct);
+
+	for (std::vector<GFF4WriterStruct::Field>::iterator f = strct._fields.begin(); f != strct._fields.end(); ++f) {
+		for (std::vector<GFF4WriterStruct *>::iterator s = f->structs.begin(); s != f->structs.end(); ++s) {
+			if (!*s)
+				continue;
+
+			(*s)->_refCount++;
+			collectStructs(**s);
+		}
+	}
+}
+
+bool GFF4Writer::needsReference(const GFF4WriterStruct &strct, size_t field) const {
+	/* A struct can only be stored directly within its parent if it exists
+	 * and nothing else references it. Otherwise, we need to reference it. */
+
+	const GFF4WriterStruct::Field &f = strct._fields[field];
+
+	for (std::vector<GFF4WriterStruct *>::const_iterator s = f.structs.begin(); s != f.structs.end(); ++s)
+		if (!*s || ((*s)->_refCount > 1))
+			return true;
+
+	return false;
+}
+
+uint32 GFF4Writer::getFieldFlags(const GFF4WriterStruct &strct, size_t field) const {
+	const GFF4WriterStruct::Field &f = strct._fields[field];
+
+	uint32 flags = f.isList ? kFlagList : 0;
+
+	if (f.type == GFF4Struct::kFieldTypeStruct) {
+		flags |= kFlagStruct;
+
+		if (needsReference(strct, field))
+			flags |= kFlagReference;
+	}
+
+	// We always store the values of generics by reference
+	if (f.type == GFF4Struct::kFieldTypeGeneric)
+		flags |= kFlagReference;
+
+	return flags;
+}
+
+uint32 GFF4Writer::getStructClass(const GFF4WriterStruct &strct, size_t field) const {
+	const GFF4WriterStruct::Field &f = strct._fields[field];
+	if (f.type != GFF4Struct::kFieldTypeStruct)
+		return kNoClass;
+
+	for (std::vector<GFF4WriterStruct *>::const_iterator s = f.structs.begin(); s != f.structs.end(); ++s)
+		if (*s)
+			return (*s)->_class;
+
+	return kNoClass;
+}
+
+void GFF4Writer::createClasses() {
+	/* Sort the structs into classes that can share a struct template.
+	 *
+	 * First, all structs with the same label and the same fields form a
+	 * class. Then, we repeatedly split classes whose structs contain struct
+	 * fields with structs of different classes, until nothing changes.
+	 *
+	 * Struct fields without any structs (NULL or empty lists) go along with
+	 * the rest of the class. And fields that need to be a reference in one
+	 * struct are a reference in all structs of the class.
+	 *
+	 * Classes are numbered in the order their first struct is found, so the
+	 * top-level struct is always in class 0. */
+
+	typedef std::map<std::vector<uint32>, uint32> ClassMap;
+
+	ClassMap classes;
+	for (std::vector<GFF4WriterStruct *>::iterator s = _order.begin(); s != _order.end(); ++s) {
+		std::vector<uint32> key;
+		key.reserve(1 + (*s)->_fields.size() * 3);
+
+		key.push_back((*s)->_label);
+		for (std::vector<GFF4WriterStruct::Field>::const_iterator f = (*s)->_fields.begin();
+		     f != (*s)->_fields.end(); ++f) {
+
+			key.push_back(f->label);
+			key.push_back((uint32) f->type);
+			key.push_back(f->isList ? 1 : 0);
+		}
+
+		(*s)->_class = classes.insert(std::make_pair(key, (uint32) classes.size())).first->second;
+	}
+
+	size_t classCount = classes.size();
+
+	std::vector< std::vector<uint32> > classFlags(classCount);
+	for (std::vector<GFF4WriterStruct *>::iterator s = _order.begin(); s != _order.end(); ++s) {
+		std::vector<uint32> &flags = classFlags[(*s)->_class];
+
+		flags.resize((*s)->_fields.size(), 0);
+		for (size_t i = 0; i < flags.size(); i++)
+			flags[i] |= getFieldFlags(**s, i);
+	}
+
+	for (std::vector<GFF4WriterStruct *>::iterator s = _order.begin(); s != _order.end(); ++s)
+		(*s)->_fieldFlags = classFlags[(*s)->_class];
+
+	std::vector<uint32> newClasses(_order.size());
+
+	while (true) {
+		std::vector< std::vector<uint32> > fieldClasses(classCount);
+		for (std::vector<GFF4WriterStruct *>::iterator s = _order.begin(); s != _order.end(); ++s) {
+			std::vector<uint32> &fields = fieldClasses[(*s)->_class];
+
+			fields.resize((*s)->_fields.size(), kNoClass);
+			for (size_t i = 0; i < fields.size(); i++)
+				if (fields[i] == kNoClass)
+					fields[i] = getStructClass(**s, i);
+		}
+
+		ClassMap refined;
+		for (size_t i = 0; i < _order.size(); i++) {
+			const GFF4WriterStruct &strct = *_order[i];
+
+			std::vector<uint32> key;
+			key.push_back(strct._class);
+
+			for (size_t j = 0; j < strct._fields.size(); j++) {
+				if (strct._fields[j].type != GFF4Struct::kFieldTypeStruct)
+					continue;
+
+				const uint32 structClass = getStructClass(strct, j);
+				key.push_back((structClass != kNoClass) ? structClass : fieldClasses[strct._class][j]);
+			}
+
+			newClasses[i] = refined.insert(std::make_pair(key, (uint32) refined.size())).first->second;
+		}
+
+		for (size_t i = 0; i < _order.size(); i++)
+			_order[i]->_class = newClasses[i];
+
+		if (refined.size() == classCount)
+			break;
+
+		classCount = refined.size();
+	}
+
+	if (classCount > 0xFFFF)
+		throw Common::Exception("GFF4: Too many struct templates (%u)", (uint) classCount);
+
+	_templates.resize(classCount);
+}
+
+void GFF4Writer::createTemplates() {
+	for (std::vector<GFF4WriterStruct *>::const_iterator s = _order.begin(); s != _order.end(); ++s)
+		if (!_templates[(*s)->_class].strct)
+			_templates[(*s)->_class].strct = *s;
+
+	for (uint32 i = 0; i < _templates.size(); i++)
+		createTemplate(i);
+
+	// Make sure all structs in a field fit the template
+
+	for (std::vector<GFF4WriterStruct *>::const_iterator s = _order.begin(); s != _order.end(); ++s) {
+		const StructTemplate &tmplt = _templates[(*s)->_class];
+
+		for (size_t i = 0; i < (*s)->_fields.size(); i++) {
+			const GFF4WriterStruct::Field &f = (*s)->_fields[i];
+			if (f.type != GFF4Struct::kFieldTypeStruct)
+				continue;
+
+			const uint32 structClass = tmplt.fields[i].typeAndFlags & 0xFFFF;
+
+			for (std::vector<GFF4WriterStruct *>::const_iterator c = f.structs.begin(); c != f.structs.end(); ++c)
+				if (*c && ((*c)->_class != structClass))
+					throw Common::Exception("GFF4: Structs in field %u of struct %s have different layouts",
+					                        f.label, Common::debugTag((*s)->_label).c_str());
+		}
+	}
+}
+
+void GFF4Writer::createTemplate(uint32 structClass) {
+	StructTemplate &tmplt = _templates[structClass];
+	if (tmplt.created)
+		return;
+
+	assert(tmplt.strct);
+	const GFF4WriterStruct &strct = *tmplt.strct;
+
+	// Still creating this template further up? Then the struct would contain itself.
+	if (!tmplt.fields.empty())
+		throw Common::Exception("GFF4: Struct %s contains itself", Common::debugTag(strct._label).c_str());
+
+	tmplt.label = strct._label;
+	tmplt.fields.resize(strct._fields.size());
+
+	// The class of structs in each struct field, taken from any struct of this class
+	std::vector<uint32> structClasses(strct._fields.size(), kNoClass);
+	for (std::vector<GFF4WriterStruct *>::const_iterator s = _order.begin(); s != _order.end(); ++s) {
+		if ((*s)->_class != structClass)
+			continue;
+
+		for (size_t i = 0; i < structClasses.size(); i++)
+			if (structClasses[i] == kNoClass)
+				structClasses[i] = getStructClass(**s, i);
+	}
+
+	uint32 size = 0;
+	for (size_t i = 0; i < strct._fields.size(); i++) {
+		const GFF4WriterStruct::Field &f = strct._fields[i];
+
+		uint32 type = (uint32) f.type;
+		if (f.type == GFF4Struct::kFieldTypeStruct)
+			type = (structClasses[i] == kNoClass) ? 0 : structClasses[i];
+
+		tmplt.fields[i].label        = f.label;
+		tmplt.fields[i].typeAndFlags = type | (strct._fieldFlags[i] << 16);
+		tmplt.fields[i].offset       = size;
+
+		size += getFieldSize(f.type, tmplt.fields[i].typeAndFlags);
+	}
+
+	tmplt.size    = size;
+	tmplt.created = true;
+}
+
+uint32 GFF4Writer::getFieldSize(GFF4Struct::FieldType type, uint32 typeAndFlags) const {
+	const uint32 flags = typeAndFlags >> 16;
+
+	// Lists are only a reference to the list data
+	if (flags & kFlagList)
+		return 4;
+
+	if (type == GFF4Struct::kFieldTypeGeneric)
+		return 8;
+
+	if (type == GFF4Struct::kFieldTypeStruct) {
+		if (flags & kFlagReference)
+			return 4;
+
+		const uint32 structClass = typeAndFlags & 0xFFFF;
+
+		// Structs stored directly within the field need their template first
+		const_cast<GFF4Writer *>(this)->createTemplate(structClass);
+
+		return _templates[structClass].size;
+	}
+
+	return getTypeSize(type);
+}
+
+// --- Data section ---
+
+uint32 GFF4Writer::allocate(size_t size) {
+	// Keep everything 4-byte aligned
+	const size_t offset = ((_data.size() + 3) / 4) * 4;
+
+	if ((offset + size) >= 0xFFFFFFFF)
+		throw Common::Exception("GFF4: Data section too big");
+
+	_data.resize(offset + size, 0);
+
+	return offset;
+}
+
+void GFF4Writer::writeUint8(uint32 offset, uint8 value) {
+	_data[offset] = value;
+}
+
+void GFF4Writer::writeUint16(uint32 offset, uint16 value) {
+	if (_bigEndian)
+		WRITE_BE_UINT16(&_data[offset], value);
+	else
+		WRITE_LE_UINT16(&_data[offset], value);
+}
+
+void GFF4Writer::writeUint32(uint32 offset, uint32 value) {
+	if (_bigEndian)
+		WRITE_BE_UINT32(&_data[offset], value);
+	else
+		WRITE_LE_UINT32(&_data[offset], value);
+}
+
+void GFF4Writer::writeUint64(uint32 offset, uint64 value) {
+	if (_bigEndian)
+		WRITE_BE_UINT64(&_data[offset], value);
+	else
+		WRITE_LE_UINT64(&_data[offset], value);
+}
+
+void GFF4Writer::writeValue(uint32 offset, GFF4Struct::FieldType type, uint64 intValue, double doubleValue) {
+	switch (type) {
+		case GFF4Struct::kFieldTypeUint8:
+		case GFF4Struct::kFieldTypeSint8:
+			writeUint8(offset, (uint8) intValue);
+			break;
+
+		case GFF4Struct::kFieldTypeUint16:
+		case GFF4Struct::kFieldTypeSint16:
+			writeUint16(offset, (uint16) intValue);
+			break;
+
+		case GFF4Struct::kFieldTypeUint32:
+		case GFF4Struct::kFieldTypeSint32:
+			writeUint32(offset, (uint32) intValue);
+			break;
+
+		case GFF4Struct::kFieldTypeUint64:
+		case GFF4Struct::kFieldTypeSint64:
+			writeUint64(offset, intValue);
+			break;
+
+		case GFF4Struct::kFieldTypeFloat32:
+			writeUint32(offset, convertIEEEFloat((float) doubleValue));
+			break;
+
+		case GFF4Struct::kFieldTypeFloat64:
+			writeUint64(offset, convertIEEEDouble(doubleValue));
+			break;
+
+		case GFF4Struct::kFieldTypeNDSFixed:
+			// Signed 19.12 fixed point
+			writeUint32(offset, (uint32) ((int32) std::floor(doubleValue * 4096.0 + 0.5)));
+			break;
+
+		default:
+			throw Common::Exception("GFF4: Field type %d is not a simple value", (int) type);
+	}
+}
+
+void GFF4Writer::encodeString(const Common::UString &str, std::vector<byte> &data) const {
+	/* A string in the data section is stored as a length in characters (or rather,
+	 * UTF-16 units), followed by the encoded string without a terminator. */
+
+	Common::ScopedPtr<Common::MemoryReadStream> encoded(Common::convertString(str, _encoding, false));
+
+	const size_t start = data.size();
+	data.resize(start + 4 + encoded->size());
+
+	const uint32 length = encoded->size() / 2;
+	if (_bigEndian)
+		WRITE_BE_UINT32(&data[start], length);
+	else
+		WRITE_LE_UINT32(&data[start], length);
+
+	if (encoded->size() > 0)
+		std::memcpy(&data[start + 4], encoded->getData(), encoded->size());
+}
+
+void GFF4Writer::writeString(uint32 offset, const std::vector<byte> &data) {
+	if (!data.empty())
+		std::memcpy(&_data[offset], &data[0], data.size());
+}
+
+uint32 GFF4Writer::addString(const Common::UString &str) {
+	/* Return the reference to a string: the index into the shared strings
+	 * for V4.1, or the offset of the string data for V4.0. Either way,
+	 * each distinct string is only stored once. */
+
+	if (str.empty())
+		return 0xFFFFFFFF;
+
+	StringMap::const_iterator s = _strings.find(str);
+	if (s != _strings.end())
+		return s->second;
+
+	uint32 reference;
+	if (hasSharedStrings()) {
+		reference = _sharedStrings.size();
+		_sharedStrings.push_back(str);
+	} else {
+		std::vector<byte> data;
+		encodeString(str, data);
+
+		reference = allocate(data.size());
+		writeString(reference, data);
+	}
+
+	_strings.insert(std::make_pair(str, reference));
+
+	return reference;
+}
+
+uint32 GFF4Writer::placeStruct(GFF4WriterStruct &strct) {
+	if (strct._offset != kNoOffset)
+		return strct._offset;
+
+	// Mark the struct as placed first, so that references back to it find it
+	strct._offset = allocate(_templates[strct._class].size);
+	writeStruct(strct, strct._offset);
+
+	return strct._offset;
+}
+
+void GFF4Writer::writeStruct(GFF4WriterStruct &strct, uint32 offset) {
+	const StructTemplate &tmplt = _templates[strct._class];
+
+	for (size_t i = 0; i < strct._fields.size(); i++)
+		writeField(strct, i, tmplt.fields[i].typeAndFlags, offset + tmplt.fields[i].offset);
+}
+
+void GFF4Writer::writeField(const GFF4WriterStruct &strct, size_t field, uint32 typeAndFlags, uint32 offset) {
+	const GFF4WriterStruct::Field &f = strct._fields[field];
+
+	if (f.type == GFF4Struct::kFieldTypeGeneric) {
+		writeGeneric(f.structs.front(), f.isList, offset);
+		return;
+	}
+
+	if (!f.isList) {
+		writeElement(strct, field, 0, typeAndFlags, offset);
+		return;
+	}
+
+	// Lists are stored separately, with the field holding a reference to the list
+
+	if (f.count == 0) {
+		writeUint32(offset, 0xFFFFFFFF);
+		return;
+	}
+
+	const uint32 size = getFieldSize(f.type, typeAndFlags & ~(kFlagList << 16));
+	const uint32 list = allocate(4 + f.count * size);
+
+	writeUint32(offset, list);
+	writeUint32(list, f.count);
+
+	for (size_t i = 0; i < f.count; i++)
+		writeElement(strct, field, i, typeAndFlags, list + 4 + i * size);
+}
+
+void GFF4Writer::writeElement(const GFF4WriterStruct &strct, size_t field, size_t index,
+                              uint32 typeAndFlags, uint32 offset) {
+
+	const GFF4WriterStruct::Field &f = strct._fields[field];
+
+	if (f.type == GFF4Struct::kFieldTypeStruct) {
+		GFF4WriterStruct *child = f.structs[index];
+
+		if ((typeAndFlags >> 16) & kFlagReference) {
+			writeUint32(offset, child ? placeStruct(*child) : 0xFFFFFFFF);
+			return;
+		}
+
+		assert(child);
+
+		child->_offset = offset;
+		writeStruct(*child, offset);
+		return;
+	}
+
+	if (f.type == GFF4Struct::kFieldTypeString) {
+		writeUint32(offset, addString(f.strings[index]));
+		return;
+	}
+
+	if (f.type == GFF4Struct::kFieldTypeTlkString) {
+		writeUint32(offset    , (uint32) f.ints[index]);
+		writeUint32(offset + 4, addString(f.strings[index]));
+		return;
+	}
+
+	if (isVectorMatrixType(f.type)) {
+		const size_t length = getTypeSize(f.type) / 4;
+
+		for (size_t i = 0; i < length; i++)
+			writeUint32(offset + i * 4, convertIEEEFloat((float) f.doubles[index * length + i]));
+		return;
+	}
+
+	if (isIntType(f.type)) {
+		writeValue(offset, f.type, f.ints[index], 0.0);
+		return;
+	}
+
+	writeValue(offset, f.type, 0, f.doubles[index]);
+}
+
+void GFF4Writer::writeGeneric(const GFF4WriterStruct *generic, bool isList, uint32 offset) {
+	/* A generic is a list of elements, each consisting of the type and flags of
+	 * the element, followed by a reference to the value. A non-list generic is
+	 * a single such element, directly within the field. */
+
+	if (!isList) {
+		if (!generic || generic->_fields.empty()) {
+			writeUint32(offset    , 0);
+			writeUint32(offset + 4, 0xFFFFFFFF);
+			return;
+		}
+
+		if ((generic->_fields.size() != 1) || (generic->_fields[0].label != 0))
+			throw Common::Exception("GFF4: Non-list generic with elements other than 0");
+
+		uint32 typeAndFlags;
+		const uint32 value = writeGenericElement(*generic, 0, typeAndFlags);
+
+		writeUint32(offset    , typeAndFlags);
+		writeUint32(offset + 4, value);
+		return;
+	}
+
+	if (!generic || generic->_fields.empty()) {
+		writeUint32(offset, 0xFFFFFFFF);
+		return;
+	}
+
+	// The elements are the fields of the generic, by label. Missing elements are NULL.
+
+	uint32 count = 0;
+	for (std::vector<GFF4WriterStruct::Field>::const_iterator f = generic->_fields.begin();
+	     f != generic->_fields.end(); ++f)
+		count = MAX<uint32>(count, f->label + 1);
+
+	std::vector<size_t> elements(count, kNoElement);
+	for (size_t i = 0; i < generic->_fields.size(); i++)
+		elements[generic->_fields[i].label] = i;
+
+	const uint32 list = allocate(4 + count * 8);
+
+	writeUint32(offset, list);
+	writeUint32(list, count);
+
+	for (uint32 i = 0; i < count; i++) {
+		uint32 typeAndFlags = 0, value = 0xFFFFFFFF;
+		if (elements[i] != kNoElement)
+			value = writeGenericElement(*generic, elements[i], typeAndFlags);
+
+		writeUint32(list + 4 + i * 8    , typeAndFlags);
+		writeUint32(list + 4 + i * 8 + 4, value);
+	}
+}
+
+uint32 GFF4Writer::writeGenericElement(const GFF4WriterStruct &generic, size_t field, uint32 &typeAndFlags) {
+	const GFF4WriterStruct::Field &f = generic._fields[field];
+
+	const uint32 flags = getFieldFlags(generic, field);
+
+	uint32 type = (uint32) f.type;
+	if (f.type == GFF4Struct::kFieldTypeStruct) {
+		const uint32 structClass = getStructClass(generic, field);
+		type = (structClass == kNoClass) ? 0 : structClass;
+
+		for (std::vector<GFF4WriterStruct *>::const_iterator s = f.structs.begin(); s != f.structs.end(); ++s)
+			if (*s && ((*s)->_class != type))
+				throw Common::Exception("GFF4: Structs in generic element %u have different layouts", f.label);
+	}
+
+	typeAndFlags = type | (flags << 16);
+
+	if ((f.type == GFF4Struct::kFieldTypeString) && !hasSharedStrings()) {
+		/* Without a shared string table, strings within generics are
+		 * stored directly as the value, instead of as a reference. */
+
+		std::vector<byte> data;
+		for (size_t i = 0; i < f.count; i++)
+			encodeString(f.strings[i], data);
+
+		if (!f.isList) {
+			const uint32 value = allocate(data.size());
+			writeString(value, data);
+
+			return value;
+		}
+
+		const uint32 value = allocate(4);
+		const uint32 list  = allocate(4 + data.size());
+
+		writeUint32(value, list);
+		writeUint32(list, f.count);
+		writeString(list + 4, data);
+
+		return value;
+	}
+
+	const uint32 value = allocate(getFieldSize(f.type, typeAndFlags));
+	writeField(generic, field, typeAndFlags, value);
+
+	return value;
+}
+
+// --- Header ---
+
+void GFF4Writer::writeUint32(Common::WriteStream &stream, uint32 value) const {
+	if (_bigEndian)
+		stream.writeUint32BE(value);
+	else
+		stream.writeUint32LE(value);
+}
+
+void GFF4Writer::writeHeader(Common::WriteStream &stream, uint32 stringOffset, uint32 dataOffset) const {
+	stream.writeUint32BE(kGFFID);
+	stream.writeUint32BE(_version);
+
+	stream.writeUint32BE(_platform);
+	stream.writeUint32BE(_type);
+	stream.writeUint32BE(_typeVersion);
+
+	writeUint32(stream, _templates.size());
+
+	if (hasSharedStrings()) {
+		writeUint32(stream, _sharedStrings.size());
+		writeUint32(stream, stringOffset);
+	}
+
+	writeUint32(stream, dataOffset);
+}
+
+void GFF4Writer::writeTemplates(Common::WriteStream &stream, uint32 fieldOffset) const {
+	for (std::vector<StructTemplate>::const_iterator t = _templates.begin(); t != _templates.end(); ++t) {
+		stream.writeUint32BE(t->label);
+
+		writeUint32(stream, t->fields.size());
+		writeUint32(stream, t->fields.empty() ? 0xFFFFFFFF : fieldOffset);
+		writeUint32(stream, t->size);
+
+		fieldOffset += t->fields.size() * 12;
+	}
+
+	for (std::vector<StructTemplate>::const_iterator t = _templates.begin(); t != _templates.end(); ++t) {
+		for (std::vector<StructTemplate::Field>::const_iterator f = t->fields.begin(); f != t->fields.end(); ++f) {
+			writeUint32(stream, f->label);
+			writeUint32(stream, f->typeAndFlags);
+			writeUint32(stream, f->offset);
+		}
+	}
+}
+
+void GFF4Writer::writeSharedStrings(Common::WriteStream &stream) const {
+	// The shared strings are UTF-8, each terminated by a 0 byte
+	for (std::vector<Common::UString>::const_iterator s = _sharedStrings.begin(); s != _sharedStrings.end(); ++s)
+		stream.write(s->c_str(), std::strlen(s->c_str()) + 1);
+}
+
+
+GFF4WriterStruct::Field::Field(uint32 l, GFF4Struct::FieldType t, bool list) :
+	label(l), type(t), isList(list), count(0) {
+
+}
+
+
+GFF4WriterStruct::GFF4WriterStruct(GFF4Writer &parent, uint32 label, bool isGeneric) :
+	_parent(&parent), _label(label), _isGeneric(isGeneric),
+	_refCount(0), _visited(false), _class(kNoClass), _offset(kNoOffset) {
+
+}
+
+GFF4WriterStruct::~GFF4WriterStruct() {
+}
+
+uint32 GFF4WriterStruct::getLabel() const {
+	return _label;
+}
+
+void GFF4WriterStruct::setLabel(uint32 label) {
+	_label = label;
+}
+
+bool GFF4WriterStruct::isGeneric() const {
+	return _isGeneric;
+}
+
+size_t GFF4WriterStruct::getFieldCount() const {
+	return _fields.size();
+}
+
+GFF4WriterStruct::Field &GFF4WriterStruct::addField(uint32 field, GFF4Struct::FieldType type, bool isList) {
+	for (std::vector<Field>::const_iterator f = _fields.begin(); f != _fields.end(); ++f)
+		if (f->label == field)
+			throw Common::Exception("GFF4: Duplicate field %u", field);
+
+	if (_isGeneric && (type == GFF4Struct::kFieldTypeGeneric))
+		throw Common::Exception("GFF4: Generics can't contain generics");
+
+	_fields.push_back(Field(field, type, isList));
+
+	return _fields.back();
+}
+
+void GFF4WriterStruct::addUint(uint32 field, GFF4Struct::FieldType type, uint64 value) {
+	addUint(field, type, std::vector<uint64>(1, value));
+	_fields.back().isList = false;
+}
+
+void GFF4WriterStruct::addSint(uint32 field, GFF4Struct::FieldType type, int64 value) {
+	addSint(field, type, std::vector<int64>(1, value));
+	_fields.back().isList = false;
+}
+
+void GFF4WriterStruct::addDouble(uint32 field, GFF4Struct::FieldType type, double value) {
+	addDouble(field, type, std::vector<double>(1, value));
+	_fields.back().isList = false;
+}
+
+void GFF4WriterStruct::addString(uint32 field, const Common::UString &value) {
+	addString(field, std::vector<Common::UString>(1, value));
+	_fields.back().isList = false;
+}
+
+void GFF4WriterStruct::addTalkString(uint32 field, uint32 strRef, const Common::UString &str) {
+	Field &f = addField(field, GFF4Struct::kFieldTypeTlkString, false);
+
+	f.ints.push_back(strRef);
+	f.strings.push_back(str);
+	f.count = 1;
+}
+
+void GFF4WriterStruct::addVectorMatrix(uint32 field, GFF4Struct::FieldType type,
+                                       const std::vector<double> &value) {
+
+	addVectorMatrix(field, type, std::vector< std::vector<double> >(1, value));
+	_fields.back().isList = false;
+}
+
+void GFF4WriterStruct::addUint(uint32 field, GFF4Struct::FieldType type, const std::vector<uint64> &list) {
+	if (!isIntType(type))
+		throw Common::Exception("GFF4: Field type %d is not an int type", (int) type);
+
+	Field &f = addField(field, type, true);
+
+	f.ints  = list;
+	f.count = list.size();
+}
+
+void GFF4WriterStruct::addSint(uint32 field, GFF4Struct::FieldType type, const std::vector<int64> &list) {
+	if (!isIntType(type))
+		throw Common::Exception("GFF4: Field type %d is not an int type", (int) type);
+
+	Field &f = addField(field, type, true);
+
+	f.ints.assign(list.begin(), list.end());
+	f.count = list.size();
+}
+
+void GFF4WriterStruct::addDouble(uint32 field, GFF4Struct::FieldType type, const std::vector<double> &list) {
+	if (!isFloatType(type))
+		throw Common::Exception("GFF4: Field type %d is not a float type", (int) type);
+
+	Field &f = addField(field, type, true);
+
+	f.doubles = list;
+	f.count   = list.size();
+}
+
+void GFF4WriterStruct::addString(uint32 field, const std::vector<Common::UString> &list) {
+	Field &f = addField(field, GFF4Struct::kFieldTypeString, true);
+
+	f.strings = list;
+	f.count   = list.size();
+}
+
+void GFF4WriterStruct::addVectorMatrix(uint32 field, GFF4Struct::FieldType type,
+                                       const std::vector< std::vector<double> > &list) {
+
+	if (!isVectorMatrixType(type))
+		throw Common::Exception("GFF4: Field type %d is not a vector or matrix type", (int) type);
+
+	const size_t length = getTypeSize(type) / 4;
+
+	for (std::vector< std::vector<double> >::const_iterator v = list.begin(); v != list.end(); ++v)
+		if (v->size() != length)
+			throw Common::Exception("GFF4: Invalid vector/matrix length (%u != %u)",
+			                        (uint) v->size(), (uint) length);
+
+	Field &f = addField(field, type, true);
+
+	f.doubles.reserve(list.size() * length);
+	for (std::vector< std::vector<double> >::const_iterator v = list.begin(); v != list.end(); ++v)
+		f.doubles.insert(f.doubles.end(), v->begin(), v->end());
+
+	f.count = list.size();
+}
+
+void GFF4WriterStruct::addStruct(uint32 field, GFF4WriterStruct *strct) {
+	addStruct(field, std::vector<GFF4WriterStruct *>(1, strct));
+	_fields.back().isList = false;
+}
+
+void GFF4WriterStruct::addStruct(uint32 field, const std::vector<GFF4WriterStruct *> &list) {
+	for (std::vector<GFF4WriterStruct *>::const_iterator s = list.begin(); s != list.end(); ++s)
+		if (*s && ((*s)->_isGeneric || ((*s)->_parent != _parent)))
+			throw Common::Exception("GFF4: Invalid struct in struct field %u", field);
+
+	Field &f = addField(field, GFF4Struct::kFieldTypeStruct, true);
+
+	f.structs = list;
+	f.count   = list.size();
+}
+
+void GFF4WriterStruct::addGeneric(uint32 field, GFF4WriterStruct *generic) {
+	if (generic && (!generic->_isGeneric || (generic->_parent != _parent)))
+		throw Common::Exception("GFF4: Invalid generic in generic field %u", field);
+
+	Field &f = addField(field, GFF4Struct::kFieldTypeGeneric, false);
+
+	f.structs.push_back(generic);
+	f.count = 1;
+}
+
+void GFF4WriterStruct::addGenericList(uint32 field, GFF4WriterStruct *generic) {
+	addGeneric(field, generic);
+	_fields.back().isList = true;
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,288 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Writer for writing version V4.0/V4.1 of BioWare's GFFs (generic file format).
+ */
+
+#ifndef AURORA_GFF4WRITER_H
+#define AURORA_GFF4WRITER_H
+
+#include <vector>
+#include <unordered_map>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/ptrvector.h"
+#include "src/common/encoding.h"
+
+#include "src/aurora/gff4file.h"
+
+namespace Common {
+	class WriteStream;
+}
+
+namespace Aurora {
+
+class GFF4WriterStruct;
+
+/** Writer for GFF V4.0/V4.1 files.
+ *
+ *  The contents of the GFF4 are built as a graph of GFF4WriterStruct
+ *  objects, all owned by the writer. The same struct can be added to
+ *  several fields (or even to fields of its own children), in which case
+ *  all these fields reference a single copy of the struct in the file.
+ *
+ *  Generics are represented by a GFF4WriterStruct as well, in the same
+ *  way GFF4File maps them: the field labels are the element indices.
+ *
+ *  On write(), structs with the same label and the same layout of fields
+ *  share one struct template. The data section is laid out in one go,
+ *  depth-first from the top-level struct, writing each reference into
+ *  the slot that was reserved for it.
+ *
+ *  A V4.1 GFF stores every string exactly once, in a global string table.
+ *  In a V4.0 GFF, identical strings share the same string data as well.
+ */
+class GFF4Writer : boost::noncopyable {
+public:
+	/** Create a GFF4 writer.
+	 *
+	 *  @param type The GFF4's specific type ('ARE ', 'DLG ', ...).
+	 *  @param typeVersion The version of the specific type.
+	 *  @param platform The platform this GFF4 is for, which also decides the endianness.
+	 *  @param version The GFF version to write, V4.0 or V4.1.
+	 */
+	GFF4Writer(uint32 type, uint32 typeVersion, uint32 platform = MKTAG('P', 'C', ' ', ' '),
+	           uint32 version = MKTAG('V', '4', '.', '0'));
+	~GFF4Writer();
+
+	/** Return the top-level struct. */
+	GFF4WriterStruct &getTopLevel();
+
+	/** Create a new struct, to be added to the fields of other structs. */
+	GFF4WriterStruct *createStruct(uint32 label);
+	/** Create a new generic, to be added to a generic field. */
+	GFF4WriterStruct *createGeneric();
+
+	/** Write the GFF4 to stream. */
+	void write(Common::WriteStream &stream);
+
+private:
+	/** A struct template, as written into the GFF4. */
+	struct StructTemplate {
+		struct Field {
+			uint32 label;
+			uint32 typeAndFlags;
+			uint32 offset;
+		};
+
+		uint32 label;
+		uint32 size;
+
+		std::vector<Field> fields;
+
+		const GFF4WriterStruct *strct; ///< The first struct using this template.
+		bool created;                 ///< Was the template completely created?
+
+		StructTemplate() : label(0), size(0), strct(0), created(false) { }
+	};
+
+	typedef std::unordered_map<Common::UString, uint32, Common::hashUStringCaseSensitive> StringMap;
+
+	uint32 _type;
+	uint32 _typeVersion;
+	uint32 _platform;
+	uint32 _version;
+
+	bool _bigEndian;
+	Common::Encoding _encoding;
+
+	/** All structs and generics, including the top-level struct. */
+	Common::PtrVector<GFF4WriterStruct> _structs;
+
+	// .--- Layout state, only valid during write()
+	/** All structs reachable from the top-level struct, in depth-first order. */
+	std::vector<GFF4WriterStruct *> _order;
+	/** The struct templates, one for each class of structs. */
+	std::vector<StructTemplate> _templates;
+
+	/** The data section. */
+	std::vector<byte> _data;
+
+	/** The V4.1 shared strings, in the order they were added. */
+	std::vector<Common::UString> _sharedStrings;
+	/** The index (V4.1) or data offset (V4.0) of all strings written so far. */
+	StringMap _strings;
+	// '---
+
+	bool hasSharedStrings() const;
+
+	// .--- Struct templates
+	void collectStructs(GFF4WriterStruct &strct);
+
+	bool needsReference(const GFF4WriterStruct &strct, size_t field) const;
+	uint32 getFieldFlags(const GFF4WriterStruct &strct, size_t field) const;
+	uint32 getStructClass(const GFF4WriterStruct &strct, size_t field) const;
+
+	void createClasses();
+	void createTemplates();
+	void createTemplate(uint32 structClass);
+
+	uint32 getFieldSize(GFF4Struct::FieldType type, uint32 typeAndFlags) const;
+	// '---
+
+	// .--- Data section
+	uint32 allocate(size_t size);
+
+	void writeUint8 (uint32 offset, uint8  value);
+	void writeUint16(uint32 offset, uint16 value);
+	void writeUint32(uint32 offset, uint32 value);
+	void writeUint64(uint32 offset, uint64 value);
+
+	void writeValue(uint32 offset, GFF4Struct::FieldType type, uint64 intValue, double doubleValue);
+
+	void encodeString(const Common::UString &str, std::vector<byte> &data) const;
+	void writeString(uint32 offset, const std::vector<byte> &data);
+	uint32 addString(const Common::UString &str);
+
+	uint32 placeStruct(GFF4WriterStruct &strct);
+	void writeStruct(GFF4WriterStruct &strct, uint32 offset);
+
+	void writeField(const GFF4WriterStruct &strct, size_t field, uint32 typeAndFlags, uint32 offset);
+	void writeElement(const GFF4WriterStruct &strct, size_t field, size_t index,
+	                  uint32 typeAndFlags, uint32 offset);
+
+	void writeGeneric(const GFF4WriterStruct *generic, bool isList, uint32 offset);
+	uint32 writeGenericElement(const GFF4WriterStruct &generic, size_t field, uint32 &typeAndFlags);
+	// '---
+
+	// .--- Header
+	void writeUint32(Common::WriteStream &stream, uint32 value) const;
+
+	void writeHeader(Common::WriteStream &stream, uint32 stringOffset, uint32 dataOffset) const;
+	void writeTemplates(Common::WriteStream &stream, uint32 fieldOffset) const;
+	void writeSharedStrings(Common::WriteStream &stream) const;
+	// '---
+
+	friend class GFF4WriterStruct;
+};
+
+/** A struct (or generic) within a GFF4 that's being written.
+ *
+ *  The field adders mirror the getters of GFF4Struct. Every field label
+ *  can only be added once.
+ */
+class GFF4WriterStruct : boost::noncopyable {
+public:
+	/** Return the struct's label. */
+	uint32 getLabel() const;
+	/** Change the struct's label. */
+	void setLabel(uint32 label);
+	/** Is this a generic, instead of a real struct? */
+	bool isGeneric() const;
+
+	/** Return the number of fields in this struct. */
+	size_t getFieldCount() const;
+
+	// .--- Single values
+	void addUint  (uint32 field, GFF4Struct::FieldType type, uint64 value);
+	void addSint  (uint32 field, GFF4Struct::FieldType type,  int64 value);
+	void addDouble(uint32 field, GFF4Struct::FieldType type, double value);
+
+	void addString(uint32 field, const Common::UString &value);
+	void addTalkString(uint32 field, uint32 strRef, const Common::UString &str);
+
+	/** Add a vector or matrix type, with the matching number of components. */
+	void addVectorMatrix(uint32 field, GFF4Struct::FieldType type, const std::vector<double> &value);
+	// '---
+
+	// .--- Lists of values
+	void addUint  (uint32 field, GFF4Struct::FieldType type, const std::vector<uint64> &list);
+	void addSint  (uint32 field, GFF4Struct::FieldType type, const std::vector< int64> &list);
+	void addDouble(uint32 field, GFF4Struct::FieldType type, const std::vector<double> &list);
+
+	void addString(uint32 field, const std::vector<Common::UString> &list);
+
+	void addVectorMatrix(uint32 field, GFF4Struct::FieldType type,
+	                     const std::vector< std::vector<double> > &list);
+	// '---
+
+	// .--- Structs, generics and lists of them
+	/** Add a struct field. A struct of 0 writes a NULL reference. */
+	void addStruct(uint32 field, GFF4WriterStruct *strct);
+	/** Add a list of structs. All structs need to have the same layout. */
+	void addStruct(uint32 field, const std::vector<GFF4WriterStruct *> &list);
+
+	/** Add a generic, whose element 0 is the value. */
+	void addGeneric(uint32 field, GFF4WriterStruct *generic);
+	/** Add a list of generics, whose elements are the list items. */
+	void addGenericList(uint32 field, GFF4WriterStruct *generic);
+	// '---
+
+private:
+	/** A field in the struct. */
+	struct Field {
+		uint32 label;
+		GFF4Struct::FieldType type;
+		bool isList;
+
+		std::vector<uint64> ints;               ///< Integer values, or the StrRefs of talk strings.
+		std::vector<double> doubles;            ///< Float values, or the vector/matrix components.
+		std::vector<Common::UString> strings;   ///< Strings.
+		std::vector<GFF4WriterStruct *> structs; ///< Structs or generics.
+
+		size_t count; ///< The number of values.
+
+		Field(uint32 l, GFF4Struct::FieldType t, bool list);
+	};
+
+	GFF4Writer *_parent;
+
+	uint32 _label;
+	bool   _isGeneric;
+
+	std::vector<Field> _fields;
+
+	// .--- Layout state, only valid during GFF4Writer::write()
+	uint32 _refCount; ///< Number of fields referencing this struct.
+	bool   _visited;  ///< Was this struct already collected?
+	uint32 _class;    ///< The struct's class, which becomes its template index.
+	uint32 _offset;   ///< The struct's offset within the data section.
+
+	std::vector<uint32> _fieldFlags; ///< The flags of each field.
+	// '---
+
+	GFF4WriterStruct(GFF4Writer &parent, uint32 label, bool isGeneric);
+	~GFF4WriterStruct();
+
+	Field &addField(uint32 field, GFF4Struct::FieldType type, bool isList);
+
+	friend class GFF4Writer;
+
+	template<typename T>
+	friend void Common::DeallocatorDefault::destroy(T *);
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_GFF4WRITER_H
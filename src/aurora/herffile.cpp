@@ -30,6 +30,7 @@
 #include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
 #include "src/common/hash.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/herffile.h"
 #include "src/aurora/util.h"
@@ -46,6 +47,8 @@ HERFFile::~HERFFile() {
 }
 
 void HERFFile::load(Common::SeekableReadStream &herf) {
+	XOREOS_TRACE_SPAN("archive", "HERFFile::load");
+
 	uint32 magic = herf.readUint32LE();
 	if (magic != 0x00F1A5C0)
 		throw Common::Exception("Invalid HERF file (0x%08X)", magic);
@@ -156,7 +159,20 @@ uint32 HERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool HERFFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	storage.offset      = res.offset;
+	storage.packedSize  = res.size;
+	storage.size        = res.size;
+	storage.compression = 0;
+
+	return true;
+}
+
 Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool tryNoCopy) const {
+	XOREOS_TRACE_SPAN("archive", "HERFFile::getResource");
+
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
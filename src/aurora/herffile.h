@@ -62,6 +62,9 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Find out how a resource is stored within the HERF. */
+	bool getResourceStorage(uint32 index, ResourceStorage &storage) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
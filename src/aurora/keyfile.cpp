@@ -31,6 +31,7 @@
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/encoding.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/keyfile.h"
 
@@ -48,6 +49,8 @@ KEYFile::~KEYFile() {
 }
 
 void KEYFile::load(Common::SeekableReadStream &key) {
+	XOREOS_TRACE_SPAN("archive", "KEYFile::load");
+
 	readHeader(key);
 
 	if (_id != kKEYID)
@@ -61,6 +64,7 @@ void KEYFile::load(Common::SeekableReadStream &key) {
 
 	_bifs.reserve(bifCount);
 	_resources.reserve(resCount);
+	_index.reserve(resCount);
 
 	// Version 1.1 has some NULL bytes here
 	if (_version == kVersion11)
@@ -120,7 +124,7 @@ void KEYFile::readResList(Common::SeekableReadStream &key, uint32 offset) {
 	key.seek(offset);
 
 	for (ResourceList::iterator res = _resources.begin(); res != _resources.end(); ++res) {
-		res->name = Common::readStringFixed(key, Common::kEncodingASCII, 16);
+		res->name = ResRef::read(key, 16);
 		res->type = (FileType) key.readUint16LE();
 
 		uint32 id = key.readUint32LE();
@@ -135,6 +139,9 @@ void KEYFile::readResList(Common::SeekableReadStream &key, uint32 offset) {
 
 		// TODO: Fixed resources?
 		res->resIndex = id & 0xFFFFF;
+
+		// Later entries for the same resource override earlier ones
+		_index[ResourceID(res->name, res->type)] = res - _resources.begin();
 	}
 }
 
@@ -146,4 +153,12 @@ const KEYFile::ResourceList &KEYFile::getResources() const {
 	return _resources;
 }
 
+uint32 KEYFile::findResource(const ResRef &name, FileType type) const {
+	ResourceIndex::const_iterator r = _index.find(ResourceID(name, type));
+	if (r == _index.end())
+		return 0xFFFFFFFF;
+
+	return r->second;
+}
+
 } // End of namespace Aurora
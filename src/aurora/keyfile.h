@@ -26,6 +26,8 @@
 #define AURORA_KEYFILE_H
 
 #include <vector>
+#include <utility>
+#include <unordered_map>
 
 #include <boost/noncopyable.hpp>
 
@@ -34,6 +36,7 @@
 
 #include "src/aurora/types.h"
 #include "src/aurora/aurorafile.h"
+#include "src/aurora/resref.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -71,8 +74,8 @@ class KEYFile : boost::noncopyable, public AuroraFile {
 public:
 	/** A key resource index. */
 	struct Resource {
-		Common::UString name; ///< The resource's name.
-		FileType        type; ///< The resource's type.
+		ResRef   name; ///< The resource's name.
+		FileType type; ///< The resource's type.
 
 		uint32 bifIndex; ///< Index into the bif list.
 		uint32 resIndex; ///< Index into the bif's resource table.
@@ -90,9 +93,27 @@ public:
 	/** Return a list of all containing resources. */
 	const ResourceList &getResources() const;
 
+	/** Return the index of the resource matching the name and type, or 0xFFFFFFFF if not found.
+	 *
+	 *  If the KEY lists the resource several times, the last entry wins.
+	 */
+	uint32 findResource(const ResRef &name, FileType type) const;
+
 private:
-	BIFList      _bifs;      ///< All managed bifs.
-	ResourceList _resources; ///< All containing resources.
+	typedef std::pair<ResRef, FileType> ResourceID;
+
+	struct hashResourceID {
+		size_t operator()(const ResourceID &id) const {
+			return hashResRef()(id.first) ^ ((size_t) id.second * 0x9E3779B9U);
+		}
+	};
+
+	/** Resource name and type -> index into the resource list. */
+	typedef std::unordered_map<ResourceID, uint32, hashResourceID> ResourceIndex;
+
+	BIFList       _bifs;      ///< All managed bifs.
+	ResourceList  _resources; ///< All containing resources.
+	ResourceIndex _index;     ///< Index of all resources, by name and type.
 
 	void load(Common::SeekableReadStream &key);
 
@@ -79,6 +79,8 @@ public:
 	void setString(Language language, LanguageGender gender, const Common::UString &str);
 	/** Set the string of that language (for all genders). */
 	void setString(Language language, const Common::UString &str);
+	/** Set the string of that raw, gendered language ID, as found in the game data. */
+	void setString(uint32 languageID, const Common::UString &str);
 
 	/** Get the string the StrRef points to. */
 	const Common::UString &getStrRefString() const;
@@ -117,8 +119,6 @@ private:
 	bool hasString(uint32 languageID) const;
 
 	const Common::UString &getString(uint32 languageID) const;
-
-	void setString(uint32 languageID, const Common::UString &str);
 };
 
 } // End of namespace Aurora
@@ -32,6 +32,7 @@
 #include "src/common/memreadstream.h"
 #include "src/common/readfile.h"
 #include "src/common/encoding.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/ndsrom.h"
 #include "src/aurora/util.h"
@@ -54,6 +55,8 @@ NDSFile::~NDSFile() {
 }
 
 void NDSFile::load(Common::SeekableReadStream &nds) {
+	XOREOS_TRACE_SPAN("archive", "NDSFile::load");
+
 	if (!isNDS(nds, _title, _code, _maker))
 		throw Common::Exception("Not a supported NDS ROM file");
 
@@ -163,7 +166,20 @@ uint32 NDSFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool NDSFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	storage.offset      = res.offset;
+	storage.packedSize  = res.size;
+	storage.size        = res.size;
+	storage.compression = 0;
+
+	return true;
+}
+
 Common::SeekableReadStream *NDSFile::getResource(uint32 index, bool tryNoCopy) const {
+	XOREOS_TRACE_SPAN("archive", "NDSFile::getResource");
+
 	const IResource &res = getIResource(index);
 
 	_nds->seek(res.offset);
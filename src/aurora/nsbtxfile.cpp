@@ -58,6 +58,7 @@
 #include "src/common/memreadstream.h"
 #include "src/common/memwritestream.h"
 #include "src/common/encoding.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/nsbtxfile.h"
 
@@ -325,6 +326,8 @@ void NSBTXFile::getTexture(const ReadContext &ctx) {
 }
 
 Common::SeekableReadStream *NSBTXFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
+	XOREOS_TRACE_SPAN("archive", "NSBTXFile::getResource");
+
 	if (index >= _textures.size())
 		throw Common::Exception("Texture index out of range (%u/%u)", index, (uint)_textures.size());
 
@@ -341,6 +344,8 @@ Common::SeekableReadStream *NSBTXFile::getResource(uint32 index, bool UNUSED(try
 }
 
 void NSBTXFile::load(Common::SeekableSubReadStreamEndian &nsbtx) {
+	XOREOS_TRACE_SPAN("archive", "NSBTXFile::load");
+
 	try {
 
 		readHeader(nsbtx);
@@ -30,6 +30,7 @@
 #include "src/common/error.h"
 #include "src/common/encoding.h"
 #include "src/common/deflate.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/obbfile.h"
 #include "src/aurora/util.h"
@@ -46,6 +47,8 @@ OBBFile::~OBBFile() {
 }
 
 void OBBFile::load(Common::SeekableReadStream &obb) {
+	XOREOS_TRACE_SPAN("archive", "OBBFile::load");
+
 	/* OBB files have no actual header. But they're made up of zlib compressed chunks,
 	 * so we just check if we find a zlib header at the start of the file. */
 	if (obb.readUint16BE() != 0x789C)
@@ -165,7 +168,46 @@ uint32 OBBFile::getResourceSize(uint32 index) const {
 	return getIResource(index).uncompressedSize;
 }
 
+bool OBBFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	// Note that the compressed size is unreliable, see getResource()
+	storage.offset      = res.offset;
+	storage.packedSize  = res.compressedSize;
+	storage.size        = res.uncompressedSize;
+	storage.compression = "deflate";
+
+	return true;
+}
+
 Common::SeekableReadStream *OBBFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
+	XOREOS_TRACE_SPAN("archive", "OBBFile::getResource");
+
+	return unpackResource(index, getPackedResource(index));
+}
+
+Common::MemoryReadStream *OBBFile::getPackedResource(uint32 index) const {
+	/* The compressed size includes more than the file's chunks (see
+	 * unpackResource()), but never less. So reading that much gives
+	 * us all the chunks, with maybe some extra data behind them. */
+
+	const IResource &res = getIResource(index);
+
+	if (res.offset > _obb->size())
+		throw Common::Exception("Resource offset out of range (%u/%u)", res.offset, (uint)_obb->size());
+
+	_obb->seek(res.offset);
+
+	return _obb->readStream(MIN<size_t>(res.compressedSize, _obb->size() - res.offset));
+}
+
+Common::SeekableReadStream *OBBFile::unpackResource(uint32 index, Common::MemoryReadStream *packed) const {
+	XOREOS_TRACE_SPAN("archive", "OBBFile::unpackResource");
+
+	assert(packed);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(packed);
+
 	/* Decompress a single file.
 	 *
 	 * Files in OBB virtual filesystems are split up in zlib compressed chunks.
@@ -191,8 +233,6 @@ Common::SeekableReadStream *OBBFile::getResource(uint32 index, bool UNUSED(tryNo
 
 	const IResource &res = getIResource(index);
 
-	_obb->seek(res.offset);
-
 	Common::ScopedArray<byte> data(new byte[res.uncompressedSize]);
 
 	size_t offset = 0;
@@ -200,7 +240,7 @@ Common::SeekableReadStream *OBBFile::getResource(uint32 index, bool UNUSED(tryNo
 
 	while (bytesLeft > 0) {
 		const size_t bytesChunk =
-			Common::decompressDeflateChunk(*_obb, Common::kWindowBitsMax,
+			Common::decompressDeflateChunk(*stream, Common::kWindowBitsMax,
 			                               data.get() + offset, bytesLeft, 4096);
 
 		offset    += bytesChunk;
@@ -36,6 +36,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
 }
 
 namespace Aurora {
@@ -65,9 +66,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Find out how a resource is stored within the OBB. */
+	bool getResourceStorage(uint32 index, ResourceStorage &storage) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return the compressed chunks of a resource, as they are stored in the OBB. */
+	Common::MemoryReadStream *getPackedResource(uint32 index) const;
+
+	/** Decompress the packed chunks of a resource. */
+	Common::SeekableReadStream *unpackResource(uint32 index, Common::MemoryReadStream *packed) const;
+
 private:
 	/** Internal resource information. */
 	struct IResource {
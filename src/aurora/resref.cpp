@@ -0,0 +1,144 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A fixed-size resource reference.
+ */
+
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/readstream.h"
+
+#include "src/aurora/resref.h"
+
+namespace Aurora {
+
+const size_t ResRef::kMaxLength;
+const size_t ResRef::kWordCount;
+
+ResRef::ResRef() : _upper(0) {
+	std::memset(_name, 0, sizeof(_name));
+}
+
+ResRef::ResRef(const Common::UString &name) {
+	const size_t size = std::strlen(name.c_str());
+	if (size > kMaxLength)
+		throw Common::Exception("ResRef \"%s\" is longer than %u bytes", name.c_str(), (uint) kMaxLength);
+
+	set(name.c_str(), size);
+}
+
+ResRef::ResRef(const char *name, size_t size) {
+	set(name, size);
+}
+
+ResRef ResRef::read(Common::ReadStream &stream, size_t size) {
+	if (size > kMaxLength)
+		throw Common::Exception("ResRef size %u is larger than %u bytes", (uint) size, (uint) kMaxLength);
+
+	char name[kMaxLength];
+	if (stream.read(name, size) != size)
+		throw Common::Exception(Common::kReadError);
+
+	return ResRef(name, size);
+}
+
+bool ResRef::fits(const Common::UString &name) {
+	return std::strlen(name.c_str()) <= kMaxLength;
+}
+
+void ResRef::set(const char *name, size_t size) {
+	std::memset(_name, 0, sizeof(_name));
+	_upper = 0;
+
+	size = MIN(size, kMaxLength);
+
+	byte *data = reinterpret_cast<byte *>(_name);
+	for (size_t i = 0; (i < size) && (name[i] != '\0'); i++) {
+		byte c = name[i];
+
+		if ((c >= 'A') && (c <= 'Z')) {
+			c += 'a' - 'A';
+			_upper |= 1U << i;
+		}
+
+		data[i] = c;
+	}
+}
+
+bool ResRef::empty() const {
+	return _name[0] == 0;
+}
+
+size_t ResRef::size() const {
+	const byte *data = reinterpret_cast<const byte *>(_name);
+
+	size_t size = 0;
+	while ((size < kMaxLength) && (data[size] != 0))
+		size++;
+
+	return size;
+}
+
+Common::UString ResRef::getString() const {
+	const byte *data = reinterpret_cast<const byte *>(_name);
+
+	const size_t length = size();
+	if (_upper == 0)
+		return Common::UString(reinterpret_cast<const char *>(data), length);
+
+	char name[kMaxLength];
+
+	for (size_t i = 0; i < length; i++)
+		name[i] = (_upper & (1U << i)) ? (data[i] - ('a' - 'A')) : data[i];
+
+	return Common::UString(name, length);
+}
+
+bool ResRef::operator==(const ResRef &right) const {
+	uint64 difference = 0;
+	for (size_t i = 0; i < kWordCount; i++)
+		difference |= _name[i] ^ right._name[i];
+
+	return difference == 0;
+}
+
+bool ResRef::operator!=(const ResRef &right) const {
+	return !(*this == right);
+}
+
+bool ResRef::operator<(const ResRef &right) const {
+	// The names are padded with zeros, so this orders shorter names first
+	return std::memcmp(_name, right._name, sizeof(_name)) < 0;
+}
+
+size_t ResRef::hash() const {
+	// FNV-1a, over whole words instead of bytes
+	uint64 hash = 0xCBF29CE484222325ULL;
+
+	for (size_t i = 0; i < kWordCount; i++)
+		hash = (hash ^ _name[i]) * 0x100000001B3ULL;
+
+	return (size_t) (hash ^ (hash >> 32));
+}
+
+} // End of namespace Aurora
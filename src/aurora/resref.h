@@ -0,0 +1,96 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A fixed-size resource reference.
+ */
+
+#ifndef AURORA_RESREF_H
+#define AURORA_RESREF_H
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+	class ReadStream;
+}
+
+namespace Aurora {
+
+/** A resource reference, the name of a resource without its type.
+ *
+ *  The names in KEY, RIM and ERF V1.0 archives are limited to 16 bytes,
+ *  and those in ERF V1.1 archives to 32 bytes. A ResRef stores up to 32
+ *  bytes inline, padded with zeros, so it never allocates.
+ *
+ *  Resource names are case-insensitive. A ResRef is lowercased once on
+ *  construction, so comparing and hashing it only needs a few operations
+ *  on 64-bit words. Which letters were uppercase is remembered in a bit
+ *  mask, so getString() still returns the name as it was written.
+ */
+class ResRef {
+public:
+	/** The maximum length of a ResRef, in bytes. */
+	static const size_t kMaxLength = 32;
+
+	/** Create an empty ResRef. */
+	ResRef();
+	/** Create a ResRef out of a string. Throws if it's longer than kMaxLength bytes. */
+	explicit ResRef(const Common::UString &name);
+	/** Create a ResRef out of raw name data, ending at the first 0 byte or after size bytes. */
+	ResRef(const char *name, size_t size);
+
+	/** Read a ResRef padded to size bytes from a stream. */
+	static ResRef read(Common::ReadStream &stream, size_t size);
+
+	/** Does this string fit into a ResRef? */
+	static bool fits(const Common::UString &name);
+
+	bool empty() const;
+	/** Return the length of the ResRef, in bytes. */
+	size_t size() const;
+
+	/** Return the name, in its original case. */
+	Common::UString getString() const;
+
+	bool operator==(const ResRef &right) const;
+	bool operator!=(const ResRef &right) const;
+	bool operator<(const ResRef &right) const;
+
+	size_t hash() const;
+
+private:
+	static const size_t kWordCount = kMaxLength / 8;
+
+	uint64 _name[kWordCount]; ///< The lowercased name, padded with zeros.
+	uint32 _upper;            ///< Bit n is set if byte n of the name was an uppercase letter.
+
+	void set(const char *name, size_t size);
+};
+
+struct hashResRef {
+	size_t operator()(const ResRef &resRef) const {
+		return resRef.hash();
+	}
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESREF_H
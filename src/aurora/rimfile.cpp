@@ -29,6 +29,7 @@
 #include "src/common/memreadstream.h"
 #include "src/common/error.h"
 #include "src/common/encoding.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/rimfile.h"
 
@@ -47,6 +48,8 @@ RIMFile::~RIMFile() {
 }
 
 void RIMFile::load(Common::SeekableReadStream &rim) {
+	XOREOS_TRACE_SPAN("archive", "RIMFile::load");
+
 	readHeader(rim);
 
 	if (_id != kRIMID)
@@ -105,7 +108,20 @@ uint32 RIMFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool RIMFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	const IResource &res = getIResource(index);
+
+	storage.offset      = res.offset;
+	storage.packedSize  = res.size;
+	storage.size        = res.size;
+	storage.compression = 0;
+
+	return true;
+}
+
 Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool tryNoCopy) const {
+	XOREOS_TRACE_SPAN("archive", "RIMFile::getResource");
+
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
@@ -24,6 +24,7 @@ src_aurora_libaurora_la_SOURCES =
 
 src_aurora_libaurora_la_SOURCES += \
     src/aurora/types.h \
+    src/aurora/resref.h \
     src/aurora/util.h \
     src/aurora/language.h \
     src/aurora/language_strings.h \
@@ -42,6 +43,7 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/locstring.h \
     src/aurora/gff3file.h \
     src/aurora/gff3writer.h \
+    src/aurora/gff4writer.h \
     src/aurora/gff4file.h \
     src/aurora/gff4fields.h \
     src/aurora/talktable.h \
@@ -62,6 +64,7 @@ src_aurora_libaurora_la_SOURCES += \
 
 src_aurora_libaurora_la_SOURCES += \
     src/aurora/util.cpp \
+    src/aurora/resref.cpp \
     src/aurora/language.cpp \
     src/aurora/archive.cpp \
     src/aurora/aurorafile.cpp \
@@ -77,6 +80,7 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/locstring.cpp \
     src/aurora/gff3file.cpp \
     src/aurora/gff3writer.cpp \
+    src/aurora/gff4writer.cpp \
     src/aurora/gff4file.cpp \
     src/aurora/talktable.cpp \
     src/aurora/talktable_tlk.cpp \
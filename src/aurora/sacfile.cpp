@@ -29,7 +29,9 @@
 
 namespace Aurora {
 
-SACFile::SACFile(Common::SeekableReadStream *stream) : GFF3File(load(stream)), _stream(stream) {
+SACFile::SACFile(Common::SeekableReadStream *stream, Common::MemoryArena *arena) :
+	GFF3File(load(stream), 0xFFFFFFFF, false, arena), _stream(stream) {
+
 	if (getType() != MKTAG('S', 'A', 'V', ' '))
 		throw Common::Exception("Invalid GFF ID");
 }
@@ -38,7 +38,7 @@ namespace Aurora {
  */
 class SACFile : public GFF3File {
 public:
-	SACFile(Common::SeekableReadStream *stream);
+	SACFile(Common::SeekableReadStream *stream, Common::MemoryArena *arena = 0);
 
 	Common::UString getLevelFile() const;
 
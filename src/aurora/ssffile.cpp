@@ -34,6 +34,7 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/encoding.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/ssffile.h"
 
@@ -58,6 +59,8 @@ SSFFile::~SSFFile() {
 }
 
 void SSFFile::load(Common::SeekableReadStream &ssf) {
+	XOREOS_TRACE_SPAN("format", "SSFFile::load");
+
 	try {
 		size_t entryCount, offEntryTable;
 		Version version = readSSFHeader(ssf, entryCount, offEntryTable);
@@ -31,6 +31,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/talktable_gff.h"
 #include "src/aurora/gff4file.h"
@@ -106,6 +107,8 @@ void TalkTable_GFF::setEntry(uint32 strRef, const Common::UString &string,
 }
 
 void TalkTable_GFF::load(Common::SeekableReadStream *tlk) {
+	XOREOS_TRACE_SPAN("format", "TalkTable_GFF::load");
+
 	assert(tlk);
 
 	try {
@@ -34,6 +34,7 @@
 #include "src/common/memwritestream.h"
 #include "src/common/readfile.h"
 #include "src/common/error.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/talktable_tlk.h"
 #include "src/aurora/language.h"
@@ -68,6 +69,8 @@ TalkTable_TLK::~TalkTable_TLK() {
 }
 
 void TalkTable_TLK::load() {
+	XOREOS_TRACE_SPAN("format", "TalkTable_TLK::load");
+
 	try {
 		readHeader(*_tlk);
 
@@ -22,6 +22,12 @@
  *  Handling TheWitcherSave Archives.
  */
 
+#include <algorithm>
+
+#include "src/common/scopedptr.h"
+#include "src/common/error.h"
+#include "src/common/trace.h"
+
 #include "src/aurora/thewitchersavefile.h"
 #include "src/aurora/util.h"
 
@@ -44,7 +50,9 @@ const Archive::ResourceList &TheWitcherSaveFile::getResources() const {
 }
 
 Common::SeekableReadStream *TheWitcherSaveFile::getResource(uint32 index, bool tryNoCopy) const {
-	IResource resource = _resources[index];
+	XOREOS_TRACE_SPAN("archive", "TheWitcherSaveFile::getResource");
+
+	const IResource &resource = _resources[index];
 
 	if (tryNoCopy)
 		return new Common::SeekableSubReadStream(_tws.get(), resource.offset, resource.offset + resource.length);
@@ -56,6 +64,8 @@ Common::SeekableReadStream *TheWitcherSaveFile::getResource(uint32 index, bool t
 }
 
 void TheWitcherSaveFile::load() {
+	XOREOS_TRACE_SPAN("archive", "TheWitcherSaveFile::load");
+
 	uint32 magicId = _tws->readUint32BE();
 	if (magicId != kRGMHID)
 		throw Common::Exception("Invalid TheWitcherSave file");
@@ -94,34 +104,80 @@ void TheWitcherSaveFile::load() {
 	uint32 resourceOffset = _tws->readUint32LE();
 	uint32 resourceCount = _tws->readUint32LE();
 
+	const size_t indexEnd = _tws->size() - 8;
+	if (resourceOffset > indexEnd)
+		throw Common::Exception("Invalid resource index offset");
+
+	// Read the whole index in one go and parse it in memory
+	const size_t indexSize = indexEnd - resourceOffset;
+	Common::ScopedArray<byte> index(new byte[indexSize]);
+
 	_tws->seek(resourceOffset);
+	if (_tws->read(index.get(), indexSize) != indexSize)
+		throw Common::Exception(Common::kReadError);
+
+	// Each index entry is at least 12 bytes long
+	if (resourceCount > (indexSize / 12))
+		throw Common::Exception("Invalid resource count %u", resourceCount);
+
+	const byte *indexPtr = index.get(), *indexPtrEnd = index.get() + indexSize;
+
+	_resourceList.resize(resourceCount);
 	_resources.resize(resourceCount);
-	for (uint32 i = 0; i < resourceCount; ++i) {
-		Resource resource;
 
-		uint32 nameLength = _tws->readUint32LE();
-		resource.name = Common::readStringFixed(*_tws, Common::kEncodingUTF8, nameLength);
-		resource.type = TypeMan.getFileType(resource.name);
-		resource.index = i;
+	ResourceList::iterator res = _resourceList.begin();
+	for (uint32 i = 0; i < resourceCount; ++i, ++res) {
+		if ((indexPtrEnd - indexPtr) < 4)
+			throw Common::Exception("Resource index too short");
 
-		// Remove the file type from the name
-		resource.name = TypeMan.setFileType(resource.name, Aurora::kFileTypeNone);
+		const uint32 nameLength = READ_LE_UINT32(indexPtr);
+		indexPtr += 4;
 
-		// Replace potential windows slashes
-		resource.name.replaceAll('\\', '/');
+		if ((size_t)(indexPtrEnd - indexPtr) < ((size_t) nameLength + 8))
+			throw Common::Exception("Resource index too short");
+
+		// The name might be padded with 0-bytes
+		const char *name = reinterpret_cast<const char *>(indexPtr);
+		const size_t nameSize = std::find(indexPtr, indexPtr + nameLength, 0) - indexPtr;
+		indexPtr += nameLength;
 
-		IResource iResource;
-		iResource.length = _tws->readUint32LE();
-		iResource.offset = _tws->readUint32LE();
+		IResource &iResource = _resources[i];
+
+		iResource.fileName = Common::UString(name, nameSize);
+		iResource.length   = READ_LE_UINT32(indexPtr    );
+		iResource.offset   = READ_LE_UINT32(indexPtr + 4);
+		indexPtr += 8;
 
 		if (iResource.offset < dataOffset)
 			throw Common::Exception("Invalid resource offset");
 
-		_resourceList.push_back(resource);
-		_resources[i] = iResource;
+		res->index = i;
+
+		// Split the file type off the name
+		res->name = iResource.fileName;
+		res->type = TypeMan.splitFileType(res->name);
+
+		// Replace potential windows slashes
+		res->name.replaceAll('\\', '/');
 	}
 }
 
+const Common::UString &TheWitcherSaveFile::getResourceFileName(uint32 index) const {
+	return _resources[index].fileName;
+}
+
+uint32 TheWitcherSaveFile::getResourceOffset(uint32 index) const {
+	return _resources[index].offset;
+}
+
+Common::SeekableReadStream *TheWitcherSaveFile::getData(size_t offset, size_t size) const {
+	if ((offset > _tws->size()) || (size > (_tws->size() - offset)))
+		throw Common::Exception("TheWitcherSaveFile::getData(): Range %u+%u out of bounds",
+		                        (uint)offset, (uint)size);
+
+	return new Common::SeekableSubReadStream(_tws.get(), offset, offset + size);
+}
+
 uint32 TheWitcherSaveFile::getResourceSize(uint32 index) const {
 	return _resources[index].length;
 }
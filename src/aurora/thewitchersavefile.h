@@ -54,10 +54,21 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return the resource's file name, exactly as stored in the archive's index. */
+	const Common::UString &getResourceFileName(uint32 index) const;
+
+	/** Return the offset of the resource's data within the archive. */
+	uint32 getResourceOffset(uint32 index) const;
+
+	/** Return a stream spanning a raw range of the archive's data, without copying it. */
+	Common::SeekableReadStream *getData(size_t offset, size_t size) const;
+
 private:
 	void load();
 
 	struct IResource {
+		Common::UString fileName;
+
 		uint32 offset;
 		uint32 length;
 	};
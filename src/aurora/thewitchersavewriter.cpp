@@ -22,17 +22,22 @@
  *  Writer for writing TheWitcherSave files.
  */
 
+#include <cstring>
+
+#include "src/common/scopedptr.h"
+#include "src/common/error.h"
 #include "src/common/encoding.h"
 
 #include "src/aurora/util.h"
 #include "src/aurora/thewitchersavewriter.h"
+#include "src/aurora/thewitchersavefile.h"
 
 namespace Aurora {
 
 static const uint32 kRGMHID = MKTAG('R', 'G', 'M', 'H');
 
 TheWitcherSaveWriter::TheWitcherSaveWriter(const Common::UString &areaName, Common::SeekableWriteStream &stream) :
-		_stream(stream), _finished(false) {
+		_stream(stream), _finished(false), _copySave(0), _copyOffset(0), _copySize(0) {
 	// Write the magic id
 	stream.writeUint32BE(kRGMHID);
 
@@ -66,6 +71,8 @@ void TheWitcherSaveWriter::add(const Common::UString &resRef, const Aurora::File
 	if (_finished)
 		throw Common::Exception("TheWitcherSave::add() Archive is already finished");
 
+	flushCopy();
+
 	Resource resource;
 	resource.name = TypeMan.setFileType(resRef, fileType);
 	resource.offset = _stream.pos();
@@ -74,16 +81,59 @@ void TheWitcherSaveWriter::add(const Common::UString &resRef, const Aurora::File
 	_resources.push_back(resource);
 }
 
+void TheWitcherSaveWriter::add(const TheWitcherSaveFile &save, uint32 index) {
+	if (_finished)
+		throw Common::Exception("TheWitcherSave::add() Archive is already finished");
+
+	const size_t offset = save.getResourceOffset(index);
+	const size_t size   = save.getResourceSize(index);
+
+	// Start a new run, unless this resource directly continues the pending one
+	if ((_copySave != &save) || (offset != (_copyOffset + _copySize))) {
+		flushCopy();
+
+		_copySave   = &save;
+		_copyOffset = offset;
+	}
+
+	Resource resource;
+	resource.name   = save.getResourceFileName(index);
+	resource.offset = _stream.pos() + _copySize;
+	resource.size   = size;
+
+	_resources.push_back(resource);
+
+	_copySize += size;
+}
+
+void TheWitcherSaveWriter::flushCopy() {
+	if (!_copySave)
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> data(_copySave->getData(_copyOffset, _copySize));
+	if (_stream.writeStream(*data, _copySize) != _copySize)
+		throw Common::Exception(Common::kWriteError);
+
+	_copySave   = 0;
+	_copyOffset = 0;
+	_copySize   = 0;
+}
+
 void TheWitcherSaveWriter::finish() {
 	if (_finished)
 		throw Common::Exception("TheWitcherSave::finish() Archive is already finished");
 
+	flushCopy();
+
 	const size_t resourceTableOffset = _stream.pos();
 
 	for (size_t i = 0; i < _resources.size(); ++i) {
 		const Resource &r = _resources[i];
-		_stream.writeUint32LE(r.name.size());
-		Common::writeString(_stream, r.name, Common::kEncodingASCII, false);
+		// The names are stored as UTF-8, prefixed by their length in bytes
+		const size_t nameSize = std::strlen(r.name.c_str());
+
+		_stream.writeUint32LE(nameSize);
+		_stream.write(r.name.c_str(), nameSize);
 		_stream.writeUint32LE(r.size);
 		_stream.writeUint32LE(r.offset);
 	}
@@ -31,6 +31,8 @@
 
 namespace Aurora {
 
+class TheWitcherSaveFile;
+
 class TheWitcherSaveWriter {
 public:
 	/** Create a new TheWitcherSave writer.
@@ -48,6 +50,20 @@ public:
 	 */
 	void add(const Common::UString &resRef, const Aurora::FileType fileType, Common::ReadStream &stream);
 
+	/** Add a resource by copying it verbatim out of an existing TheWitcherSave archive.
+	 *
+	 *  The data is not copied immediately. Instead, resources that lie back to
+	 *  back in the source archive are collected into runs, and each run is then
+	 *  written with a single sequential copy. This makes patching a save, i.e.
+	 *  copying all but a few resources, cheap.
+	 *
+	 *  The source archive has to stay valid until the next add() or finish().
+	 *
+	 *  @param save The archive to copy the resource from.
+	 *  @param index The index of the resource within that archive.
+	 */
+	void add(const TheWitcherSaveFile &save, uint32 index);
+
 	/** Finish the stream and write the file table at the
 	 *  end of the stream, and set the finished flag to prevent
 	 *  further adds.
@@ -64,6 +80,14 @@ private:
 
 	bool _finished;
 	std::vector<Resource> _resources;
+
+	/** The archive of the currently pending run of verbatim copies. */
+	const TheWitcherSaveFile *_copySave;
+	size_t _copyOffset; ///< Offset of the pending run within the source archive.
+	size_t _copySize;   ///< Size of the pending run.
+
+	/** Write the pending run of verbatim copies. */
+	void flushCopy();
 };
 
 } // End of namespace Aurora
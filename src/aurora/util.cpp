@@ -22,6 +22,8 @@
  *  Utility functions to handle files used in BioWare's Aurora engine.
  */
 
+#include <cstring>
+
 #include "src/common/util.h"
 #include "src/common/ustring.h"
 #include "src/common/filepath.h"
@@ -353,6 +355,12 @@ const FileTypeManager::Type FileTypeManager::types[] = {
 
 
 FileTypeManager::FileTypeManager() {
+	// Build all lookup tables up-front, so that they're only ever read afterwards
+	buildExtensionLookup();
+	buildTypeLookup();
+
+	for (int algo = 0; algo < Common::kHashMAX; algo++)
+		buildHashLookup((Common::HashAlgo) algo);
 }
 
 FileTypeManager::~FileTypeManager() {
@@ -484,8 +492,6 @@ FileType FileTypeManager::unaliasFileType(FileType type, GameID game) const {
 }
 
 FileType FileTypeManager::getFileType(const Common::UString &path) {
-	buildExtensionLookup();
-
 	Common::UString ext = Common::FilePath::getExtension(path).toLower();
 
 	ExtensionLookup::const_iterator t = _extensionLookup.find(ext);
@@ -500,8 +506,6 @@ Common::UString FileTypeManager::addFileType(const Common::UString &path, FileTy
 }
 
 Common::UString FileTypeManager::setFileType(const Common::UString &path, FileType type) {
-	buildTypeLookup();
-
 	Common::UString ext;
 	TypeLookup::const_iterator t = _typeLookup.find(type);
 	if (t != _typeLookup.end())
@@ -510,12 +514,51 @@ Common::UString FileTypeManager::setFileType(const Common::UString &path, FileTy
 	return Common::FilePath::changeExtension(path, ext);
 }
 
+const char *FileTypeManager::getExtension(FileType type) {
+	TypeLookup::const_iterator t = _typeLookup.find(type);
+	if (t != _typeLookup.end())
+		return t->second->extension;
+
+	return "";
+}
+
+void FileTypeManager::appendFileType(Common::UString &path, FileType type) {
+	TypeLookup::const_iterator t = _typeLookup.find(type);
+	if (t != _typeLookup.end())
+		path += t->second->extension;
+}
+
+FileType FileTypeManager::splitFileType(Common::UString &path) {
+	const char *str = path.c_str();
+
+	const char *file = str, *dot = 0;
+	for (const char *s = str; *s; s++) {
+		if ((*s == '/') || (*s == '\\')) {
+			file = s + 1;
+			dot  = 0;
+		} else if (*s == '.')
+			dot = s;
+	}
+
+	// "." and ".." are directories, not extensions
+	if (!dot || !std::strcmp(file, ".") || !std::strcmp(file, ".."))
+		return kFileTypeNone;
+
+	FileType type = kFileTypeNone;
+
+	ExtensionLookup::const_iterator t = _extensionLookup.find(Common::UString(dot).toLower());
+	if (t != _extensionLookup.end())
+		type = t->second->type;
+
+	path = Common::UString(str, dot - str);
+
+	return type;
+}
+
 FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtension) {
 	if ((algo < 0) || (algo >= Common::kHashMAX))
 		return kFileTypeNone;
 
-	buildHashLookup(algo);
-
 	HashLookup::const_iterator t = _hashLookup[algo].find(hashedExtension);
 	if (t != _hashLookup[algo].end())
 		return t->second->type;
@@ -524,25 +567,16 @@ FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtens
 }
 
 void FileTypeManager::buildExtensionLookup() {
-	if (!_extensionLookup.empty())
-		return;
-
 	for (size_t i = 0; i < ARRAYSIZE(types); i++)
 		_extensionLookup.insert(std::make_pair(Common::UString(types[i].extension), &types[i]));
 }
 
 void FileTypeManager::buildTypeLookup() {
-	if (!_typeLookup.empty())
-		return;
-
 	for (size_t i = 0; i < ARRAYSIZE(types); i++)
 		_typeLookup.insert(std::make_pair(types[i].type, &types[i]));
 }
 
 void FileTypeManager::buildHashLookup(Common::HashAlgo algo) {
-	if (!_hashLookup[algo].empty())
-		return;
-
 	for (size_t i = 0; i < ARRAYSIZE(types); i++) {
 		const char *ext = types[i].extension;
 		if (ext[0] == '.')
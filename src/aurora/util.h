@@ -39,6 +39,11 @@ namespace Aurora {
 Common::UString getPlatformDescription(Platform platform);
 
 
+/** Mapping between file types and their extensions.
+ *
+ *  All lookup tables are built on construction and never modified
+ *  afterwards, so the manager can be queried from several threads at once.
+ */
 class FileTypeManager : public Common::Singleton<FileTypeManager> {
 public:
 	FileTypeManager();
@@ -55,11 +60,27 @@ public:
 	/** Return the file type of a file name, detected by its hashed extension. */
 	FileType getFileType(Common::HashAlgo algo, uint64 hashedExtension);
 
+	/** Return the extension of a file type, including the dot, or "" if the type is unknown. */
+	const char *getExtension(FileType type);
+
 	/** Return the file name with an added extensions according to the specified file type. */
 	Common::UString addFileType(const Common::UString &path, FileType type);
 	/** Return the file name with a swapped extensions according to the specified file type. */
 	Common::UString setFileType(const Common::UString &path, FileType type);
 
+	/** Append the extension of the specified file type to the file name, in-place.
+	 *
+	 *  Unlike addFileType(), this does not construct any temporary strings.
+	 */
+	void appendFileType(Common::UString &path, FileType type);
+
+	/** Return the file type of a file name and strip its extension, in-place.
+	 *
+	 *  Equivalent to calling getFileType() and then setFileType() with
+	 *  kFileTypeNone, but without decomposing the whole path twice.
+	 */
+	FileType splitFileType(Common::UString &path);
+
 
 private:
 	/** File type <-> extension mapping. */
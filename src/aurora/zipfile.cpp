@@ -24,6 +24,7 @@
 
 #include "src/common/zipfile.h"
 #include "src/common/filepath.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/zipfile.h"
 #include "src/aurora/util.h"
@@ -49,11 +50,35 @@ uint32 ZIPFile::getResourceSize(uint32 index) const {
 	return _zipFile->getFileSize(index);
 }
 
+bool ZIPFile::getResourceStorage(uint32 index, ResourceStorage &storage) const {
+	bool compressed = false;
+	_zipFile->getFileStorage(index, storage.offset, storage.packedSize, compressed);
+
+	storage.size        = _zipFile->getFileSize(index);
+	storage.compression = compressed ? "deflate" : 0;
+
+	return true;
+}
+
 Common::SeekableReadStream *ZIPFile::getResource(uint32 index, bool tryNoCopy) const {
+	XOREOS_TRACE_SPAN("archive", "ZIPFile::getResource");
+
 	return _zipFile->getFile(index, tryNoCopy);
 }
 
+Common::MemoryReadStream *ZIPFile::getPackedResource(uint32 index) const {
+	return _zipFile->getPackedFile(index);
+}
+
+Common::SeekableReadStream *ZIPFile::unpackResource(uint32 index, Common::MemoryReadStream *packed) const {
+	XOREOS_TRACE_SPAN("archive", "ZIPFile::unpackResource");
+
+	return _zipFile->unpackFile(index, packed);
+}
+
 void ZIPFile::load() {
+	XOREOS_TRACE_SPAN("archive", "ZIPFile::load");
+
 	const Common::ZipFile::FileList &files = _zipFile->getFiles();
 	for (Common::ZipFile::FileList::const_iterator file = files.begin(); file != files.end(); ++file) {
 		Resource res;
@@ -33,6 +33,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
 	class ZipFile;
 }
 
@@ -51,9 +52,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Find out how a resource is stored within the ZIP. */
+	bool getResourceStorage(uint32 index, ResourceStorage &storage) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return the packed contents of a resource, as they are stored in the ZIP. */
+	Common::MemoryReadStream *getPackedResource(uint32 index) const;
+
+	/** Decompress and verify the packed contents of a resource. */
+	Common::SeekableReadStream *unpackResource(uint32 index, Common::MemoryReadStream *packed) const;
+
 private:
 	/** The actual zip file. */
 	Common::ScopedPtr<Common::ZipFile> _zipFile;
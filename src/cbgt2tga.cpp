@@ -67,6 +67,7 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
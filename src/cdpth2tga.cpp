@@ -68,6 +68,7 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
@@ -29,6 +29,7 @@
 #include "src/common/scopedptr.h"
 #include "src/common/memreadstream.h"
 #include "src/common/blowfish.h"
+#include "src/common/trace.h"
 
 namespace Common {
 
@@ -244,7 +245,7 @@ static uint32 F(const BlowfishContext &ctx, uint32 x) {
 	return ((ctx.S[0][a] + ctx.S[1][b]) ^ ctx.S[2][c]) + ctx.S[3][d];
 }
 
-static void blowfishEnc(BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
+static void blowfishEnc(const BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
 	for (size_t i = 0; i < kRoundCount; i++) {
 		xl = xl ^ ctx.P[i];
 		xr = F(ctx, xl) ^ xr;
@@ -258,7 +259,7 @@ static void blowfishEnc(BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
 	xl = xl ^ ctx.P[kRoundCount + 1];
 }
 
-static void blowfishDec(BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
+static void blowfishDec(const BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
 	for (size_t i = kRoundCount + 1; i > 1; i--) {
 		xl = xl ^ ctx.P[i];
 		xr = F(ctx, xl) ^ xr;
@@ -314,7 +315,7 @@ static void blowfishSetKey(BlowfishContext &ctx, const byte *key, size_t keyLeng
 	}
 }
 
-static void blowfishECB(BlowfishContext &ctx, Mode mode, const byte *input, byte *output) {
+static void blowfishECB(const BlowfishContext &ctx, Mode mode, const byte *input, byte *output) {
 	uint32 X0 = READ_BE_UINT32(input);
 	uint32 X1 = READ_BE_UINT32(input + 4);
 
@@ -335,10 +336,21 @@ static void blowfishECB(BlowfishContext &ctx, Mode mode, const byte *input, byte
 }
 // '--- Blowfish, based on the implementation from mbed TLS ---'
 
-MemoryReadStream *blowfishEBC(SeekableReadStream &input, const std::vector<byte> &key, Mode mode) {
-	BlowfishContext ctx;
+BlowfishKey::BlowfishKey(const std::vector<byte> &key) : _context(new BlowfishContext) {
+	blowfishSetKey(*_context, key.data(), key.size());
+}
+
+BlowfishKey::~BlowfishKey() {
+}
+
+const BlowfishContext &BlowfishKey::getContext() const {
+	return *_context;
+}
+
+static MemoryReadStream *blowfishEBC(SeekableReadStream &input, const BlowfishKey &key, Mode mode) {
+	XOREOS_TRACE_SPAN("crypto", "blowfishEBC");
 
-	blowfishSetKey(ctx, &key[0], key.size());
+	const BlowfishContext &ctx = key.getContext();
 
 	size_t inputSize = input.size() - input.pos();
 
@@ -367,15 +379,133 @@ MemoryReadStream *blowfishEBC(SeekableReadStream &input, const std::vector<byte>
 	return new MemoryReadStream(output.release(), outputSize, true);
 }
 
-MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key) {
+MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const BlowfishKey &key) {
 	return blowfishEBC(input, key, kModeEncrypt);
 }
 
-MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key) {
+MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const BlowfishKey &key) {
 	if ((input.size() % 8) != 0)
 		throw Exception("Blowfish operates on blocks of 8 bytes (%u)", (uint) input.size());
 
 	return blowfishEBC(input, key, kModeDecrypt);
 }
 
+MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key) {
+	const BlowfishKey blowfishKey(key);
+
+	return encryptBlowfishEBC(input, blowfishKey);
+}
+
+MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key) {
+	const BlowfishKey blowfishKey(key);
+
+	return decryptBlowfishEBC(input, blowfishKey);
+}
+
+
+static const size_t kCacheSize = 64 * kBlockSize;
+
+BlowfishEBCReadStream::BlowfishEBCReadStream(SeekableReadStream *parentStream, const std::vector<byte> &key,
+                                             bool disposeParentStream) :
+	_parentStream(parentStream, disposeParentStream), _key(key), _size(0), _pos(0), _eos(false),
+	_cache(new byte[kCacheSize]), _cacheStart(0), _cacheSize(0) {
+
+	assert(parentStream);
+
+	_size = _parentStream->size();
+	if ((_size % kBlockSize) != 0)
+		throw Exception("Blowfish operates on blocks of 8 bytes (%u)", (uint) _size);
+}
+
+BlowfishEBCReadStream::~BlowfishEBCReadStream() {
+}
+
+bool BlowfishEBCReadStream::eos() const {
+	return _eos;
+}
+
+size_t BlowfishEBCReadStream::pos() const {
+	return _pos;
+}
+
+size_t BlowfishEBCReadStream::size() const {
+	return _size;
+}
+
+size_t BlowfishEBCReadStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+
+	// Reset end-of-stream flag on a successful seek
+	_eos = false;
+
+	return oldPos;
+}
+
+void BlowfishEBCReadStream::decrypt(byte *data, size_t start, size_t size) {
+	assert(((start % kBlockSize) == 0) && ((size % kBlockSize) == 0));
+
+	_parentStream->seek(start);
+	if (_parentStream->read(data, size) != size)
+		throw Exception(kReadError);
+
+	const BlowfishContext &ctx = _key.getContext();
+	for (size_t i = 0; i < size; i += kBlockSize)
+		blowfishECB(ctx, kModeDecrypt, data + i, data + i);
+}
+
+void BlowfishEBCReadStream::fillCache() {
+	_cacheStart = _pos - (_pos % kCacheSize);
+	_cacheSize  = MIN<size_t>(kCacheSize, _size - _cacheStart);
+
+	decrypt(_cache.get(), _cacheStart, _cacheSize);
+}
+
+size_t BlowfishEBCReadStream::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	// Read at most as many bytes as are still available...
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *data = reinterpret_cast<byte *>(dataPtr);
+	size_t toRead = dataSize;
+
+	while (toRead > 0) {
+		const bool inCache = (_pos >= _cacheStart) && (_pos < (_cacheStart + _cacheSize));
+
+		if (!inCache && ((_pos % kBlockSize) == 0) && (toRead >= kCacheSize)) {
+			// Large, aligned read: decrypt directly into the output buffer
+
+			const size_t n = toRead - (toRead % kBlockSize);
+			decrypt(data, _pos, n);
+
+			data   += n;
+			_pos   += n;
+			toRead -= n;
+			continue;
+		}
+
+		if (!inCache)
+			fillCache();
+
+		const size_t offset = _pos - _cacheStart;
+		const size_t n      = MIN<size_t>(toRead, _cacheSize - offset);
+
+		std::memcpy(data, _cache.get() + offset, n);
+
+		data   += n;
+		_pos   += n;
+		toRead -= n;
+	}
+
+	return dataSize;
+}
+
 } // End of namespace Common
@@ -27,18 +27,92 @@
 
 #include <vector>
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/disposableptr.h"
+#include "src/common/readstream.h"
 
 namespace Common {
 
-class SeekableReadStream;
 class MemoryReadStream;
 
+struct BlowfishContext;
+
+/** A Blowfish key, expanded into the round keys and S-boxes.
+ *
+ *  Expanding a key costs about as much as encrypting 4KB of data, so when
+ *  many streams are encrypted or decrypted with the same key, the key should
+ *  only be expanded once. A BlowfishKey is never modified after its creation,
+ *  so it can be used by several threads at once.
+ */
+class BlowfishKey : boost::noncopyable {
+public:
+	BlowfishKey(const std::vector<byte> &key);
+	~BlowfishKey();
+
+	const BlowfishContext &getContext() const;
+
+private:
+	ScopedPtr<BlowfishContext> _context;
+};
+
 /** Encrypt the stream with the Blowfish algorithm in EBC mode. */
 MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
 /** Decrypt the stream with the Blowfish algorithm in EBC mode. */
 MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
 
+/** Encrypt the stream with the Blowfish algorithm in EBC mode, using an already expanded key. */
+MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const BlowfishKey &key);
+/** Decrypt the stream with the Blowfish algorithm in EBC mode, using an already expanded key. */
+MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const BlowfishKey &key);
+
+/** A stream decrypting a Blowfish EBC encrypted stream on the fly.
+ *
+ *  Since the blocks in EBC mode are encrypted independently of each other,
+ *  only the blocks that are actually read need to be decrypted. A small cache
+ *  of decrypted blocks around the current position keeps many small reads
+ *  cheap, while large reads are decrypted directly into the caller's buffer.
+ */
+class BlowfishEBCReadStream : public SeekableReadStream {
+public:
+	/** Create a decrypting stream over the whole parent stream.
+	 *
+	 *  The size of the parent stream needs to be a multiple of 8.
+	 */
+	BlowfishEBCReadStream(SeekableReadStream *parentStream, const std::vector<byte> &key,
+	                      bool disposeParentStream = true);
+	~BlowfishEBCReadStream();
+
+	bool eos() const;
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+private:
+	DisposablePtr<SeekableReadStream> _parentStream;
+
+	BlowfishKey _key;
+
+	size_t _size;
+	size_t _pos;
+	bool   _eos;
+
+	ScopedArray<byte> _cache; ///< The decrypted data around the current position.
+	size_t _cacheStart;       ///< The position of the cached data within the stream.
+	size_t _cacheSize;        ///< The number of bytes in the cache.
+
+	/** Read and decrypt size bytes, starting at the block-aligned position start. */
+	void decrypt(byte *data, size_t start, size_t size);
+	/** Fill the cache with the decrypted data around the current position. */
+	void fillCache();
+};
+
 } // End of namespace Common
 
 #endif // COMMON_BLOWFISH_H
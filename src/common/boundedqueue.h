@@ -0,0 +1,150 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A thread-safe queue with a limited capacity.
+ */
+
+#ifndef COMMON_BOUNDEDQUEUE_H
+#define COMMON_BOUNDEDQUEUE_H
+
+#include <cassert>
+#include <cstddef>
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+#include <boost/noncopyable.hpp>
+
+namespace Common {
+
+/** A queue passing items from producer threads to consumer threads.
+ *
+ *  The queue holds a limited amount of items. Each item has a cost,
+ *  for example its size in bytes, and pushing blocks while the total
+ *  cost of the queued items would exceed the capacity. This keeps a fast
+ *  producer from running too far ahead of its consumers, so that memory
+ *  heavy pipelines don't hold everything in memory at once.
+ *
+ *  A single item costing more than the whole capacity is still accepted
+ *  when the queue is empty.
+ *
+ *  Producers and consumers should run on separate threads, not as tasks
+ *  of the same TaskGroup: a blocked consumer task could otherwise wait
+ *  for a producer task that never gets to run.
+ */
+template<typename T>
+class BoundedQueue : boost::noncopyable {
+public:
+	/** Create a queue holding items with a total cost of up to this capacity. */
+	BoundedQueue(size_t capacity) : _capacity(capacity), _cost(0), _closed(false) {
+		assert(capacity > 0);
+	}
+
+	/** Add an item to the back of the queue, waiting while the queue is full.
+	 *
+	 *  @param  item The item to add.
+	 *  @param  cost The cost of the item, counted against the capacity.
+	 *  @return false if the queue has been closed and the item was not added.
+	 */
+	bool push(const T &item, size_t cost = 1) {
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		while (!_closed && !_items.empty() && ((_cost + cost) > _capacity))
+			_notFull.wait(lock);
+
+		if (_closed)
+			return false;
+
+		_items.push_back(Item(item, cost));
+		_cost += cost;
+
+		_notEmpty.notify_one();
+		return true;
+	}
+
+	/** Remove the item at the front of the queue, waiting while the queue is empty.
+	 *
+	 *  @param  item The removed item.
+	 *  @return false if the queue has been closed and no items are left.
+	 */
+	bool pop(T &item) {
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		while (!_closed && _items.empty())
+			_notEmpty.wait(lock);
+
+		if (_items.empty())
+			return false;
+
+		item   = _items.front().item;
+		_cost -= _items.front().cost;
+
+		_items.pop_front();
+
+		_notFull.notify_all();
+		return true;
+	}
+
+	/** Close the queue.
+	 *
+	 *  No further items can be pushed, and all waiting threads wake up.
+	 *  Items still in the queue can be popped.
+	 */
+	void close() {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_closed = true;
+
+		_notFull.notify_all();
+		_notEmpty.notify_all();
+	}
+
+	/** Return the number of items in the queue. */
+	size_t size() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _items.size();
+	}
+
+private:
+	struct Item {
+		T item;
+		size_t cost;
+
+		Item(const T &i, size_t c) : item(i), cost(c) { }
+	};
+
+	const size_t _capacity;
+
+	std::deque<Item> _items;
+	size_t _cost;
+
+	bool _closed;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _notFull;
+	std::condition_variable _notEmpty;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_BOUNDEDQUEUE_H
@@ -0,0 +1,121 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Byte-swapping whole arrays of integers in one go.
+ */
+
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+#include "src/common/byteswap.h"
+#include "src/common/endianness.h"
+
+namespace Common {
+
+/* With SSE2 available (which is always the case on x86-64), we swap 16 bytes
+ * at once. SSE2 has no byte shuffle, so we first reorder the 16-bit words
+ * within each value and then swap the two bytes of every word. The remaining
+ * values, if any, are swapped one by one. */
+
+#if defined(__SSE2__)
+static FORCEINLINE __m128i swapWordBytes(__m128i v) {
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+#endif
+
+void swapBytes16(uint16 *data, size_t count) {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; (i + 8) <= count; i += 8) {
+		__m128i *ptr = reinterpret_cast<__m128i *>(data + i);
+
+		_mm_storeu_si128(ptr, swapWordBytes(_mm_loadu_si128(ptr)));
+	}
+#endif
+
+	for (; i < count; i++)
+		data[i] = SWAP_BYTES_16(data[i]);
+}
+
+void swapBytes32(uint32 *data, size_t count) {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; (i + 4) <= count; i += 4) {
+		__m128i *ptr = reinterpret_cast<__m128i *>(data + i);
+
+		__m128i v = _mm_loadu_si128(ptr);
+
+		v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+
+		_mm_storeu_si128(ptr, swapWordBytes(v));
+	}
+#endif
+
+	for (; i < count; i++)
+		data[i] = SWAP_BYTES_32(data[i]);
+}
+
+void swapBytes64(uint64 *data, size_t count) {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; (i + 2) <= count; i += 2) {
+		__m128i *ptr = reinterpret_cast<__m128i *>(data + i);
+
+		__m128i v = _mm_loadu_si128(ptr);
+
+		v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+		v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+
+		_mm_storeu_si128(ptr, swapWordBytes(v));
+	}
+#endif
+
+	for (; i < count; i++)
+		data[i] = SWAP_BYTES_64(data[i]);
+}
+
+#if defined(XOREOS_LITTLE_ENDIAN)
+	static const bool kNativeBigEndian = false;
+#else
+	static const bool kNativeBigEndian = true;
+#endif
+
+void convertToNative16(uint16 *data, size_t count, bool bigEndian) {
+	if (bigEndian != kNativeBigEndian)
+		swapBytes16(data, count);
+}
+
+void convertToNative32(uint32 *data, size_t count, bool bigEndian) {
+	if (bigEndian != kNativeBigEndian)
+		swapBytes32(data, count);
+}
+
+void convertToNative64(uint64 *data, size_t count, bool bigEndian) {
+	if (bigEndian != kNativeBigEndian)
+		swapBytes64(data, count);
+}
+
+} // End of namespace Common
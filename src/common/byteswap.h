@@ -0,0 +1,48 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Byte-swapping whole arrays of integers in one go.
+ */
+
+#ifndef COMMON_BYTESWAP_H
+#define COMMON_BYTESWAP_H
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** Swap the byte order of count 16-bit values, in-place. */
+void swapBytes16(uint16 *data, size_t count);
+/** Swap the byte order of count 32-bit values, in-place. */
+void swapBytes32(uint32 *data, size_t count);
+/** Swap the byte order of count 64-bit values, in-place. */
+void swapBytes64(uint64 *data, size_t count);
+
+/** Convert count 16-bit values stored in the given endianness into native endianness, in-place. */
+void convertToNative16(uint16 *data, size_t count, bool bigEndian);
+/** Convert count 32-bit values stored in the given endianness into native endianness, in-place. */
+void convertToNative32(uint32 *data, size_t count, bool bigEndian);
+/** Convert count 64-bit values stored in the given endianness into native endianness, in-place. */
+void convertToNative64(uint64 *data, size_t count, bool bigEndian);
+
+} // End of namespace Common
+
+#endif // COMMON_BYTESWAP_H
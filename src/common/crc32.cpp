@@ -0,0 +1,100 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Calculating CRC-32 checksums of large blocks of data.
+ *
+ *  This uses the slicing-by-16 algorithm: 16 lookup tables let us fold
+ *  16 bytes of input into the CRC with 16 independent table lookups,
+ *  instead of a chain of 16 dependent lookups when going byte by byte.
+ *
+ *  See also Stephan Brumme's "Fast CRC32" (<http://create.stephan-brumme.com/crc32/>).
+ */
+
+#include "src/common/crc32.h"
+#include "src/common/endianness.h"
+
+namespace Common {
+
+/** The reversed CRC-32 polynomial. */
+static const uint32 kCRC32Polynomial = 0xEDB88320;
+
+static const size_t kSliceCount = 16;
+
+/** The slicing tables.
+ *
+ *  Table 0 is the classic byte-wise table (kCRC32Tab in hash.h). Table n
+ *  holds the CRC of a byte followed by n zero bytes.
+ */
+struct CRC32Tables {
+	uint32 table[kSliceCount][256];
+
+	CRC32Tables() {
+		for (uint32 i = 0; i < 256; i++) {
+			uint32 crc = i;
+			for (size_t j = 0; j < 8; j++)
+				crc = (crc >> 1) ^ ((crc & 1) ? kCRC32Polynomial : 0);
+
+			table[0][i] = crc;
+		}
+
+		for (size_t n = 1; n < kSliceCount; n++)
+			for (size_t i = 0; i < 256; i++)
+				table[n][i] = (table[n - 1][i] >> 8) ^ table[0][table[n - 1][i] & 0xFF];
+	}
+};
+
+static const CRC32Tables &getCRC32Tables() {
+	static const CRC32Tables kTables;
+
+	return kTables;
+}
+
+uint32 updateCRC32(uint32 crc, const byte *data, size_t size) {
+	const uint32 (&t)[kSliceCount][256] = getCRC32Tables().table;
+
+	crc = ~crc;
+
+	while (size >= kSliceCount) {
+		const uint32 a = READ_LE_UINT32(data     ) ^ crc;
+		const uint32 b = READ_LE_UINT32(data +  4);
+		const uint32 c = READ_LE_UINT32(data +  8);
+		const uint32 d = READ_LE_UINT32(data + 12);
+
+		crc = t[15][ a        & 0xFF] ^ t[14][(a >>  8) & 0xFF] ^ t[13][(a >> 16) & 0xFF] ^ t[12][a >> 24] ^
+		      t[11][ b        & 0xFF] ^ t[10][(b >>  8) & 0xFF] ^ t[ 9][(b >> 16) & 0xFF] ^ t[ 8][b >> 24] ^
+		      t[ 7][ c        & 0xFF] ^ t[ 6][(c >>  8) & 0xFF] ^ t[ 5][(c >> 16) & 0xFF] ^ t[ 4][c >> 24] ^
+		      t[ 3][ d        & 0xFF] ^ t[ 2][(d >>  8) & 0xFF] ^ t[ 1][(d >> 16) & 0xFF] ^ t[ 0][d >> 24];
+
+		data += kSliceCount;
+		size -= kSliceCount;
+	}
+
+	while (size-- > 0)
+		crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+uint32 calcCRC32(const byte *data, size_t size) {
+	return updateCRC32(0, data, size);
+}
+
+} // End of namespace Common
@@ -0,0 +1,45 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Calculating CRC-32 checksums of large blocks of data.
+ */
+
+#ifndef COMMON_CRC32_H
+#define COMMON_CRC32_H
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** Continue calculating the CRC-32 (ISO 3309, as used by ZIP, PNG and zlib) of data.
+ *
+ *  Start with a CRC of 0, then feed all the data, in as many pieces as
+ *  needed. The result is the same as calling zlib's crc32(), and as
+ *  hashStringCRC32() over the same bytes.
+ */
+uint32 updateCRC32(uint32 crc, const byte *data, size_t size);
+
+/** Calculate the CRC-32 of a block of data. */
+uint32 calcCRC32(const byte *data, size_t size);
+
+} // End of namespace Common
+
+#endif // COMMON_CRC32_H
@@ -56,6 +56,22 @@ struct DeallocatorArray {
 	}
 };
 
+/** Only destroy an object, without freeing its memory.
+ *
+ *  Useful for objects that have been constructed within a MemoryArena,
+ *  where the memory is released in one go together with the arena.
+ */
+struct DeallocatorDestruct {
+	template<typename T>
+	static void destroy(T *x) {
+		// intentionally complex - simplification causes regressions
+		typedef char type_must_be_complete[sizeof(T) ? 1 : -1];
+		(void) sizeof(type_must_be_complete);
+		if (x)
+			x->~T();
+	}
+};
+
 /** Deallocate a pointer using free(). */
 struct DeallocatorFree {
 	template<typename T>
@@ -31,6 +31,7 @@
 #include "src/common/scopedptr.h"
 #include "src/common/ptrvector.h"
 #include "src/common/memreadstream.h"
+#include "src/common/trace.h"
 
 namespace Common {
 
@@ -62,9 +63,15 @@ static void initZStream(z_stream &strm, int windowBits, size_t size, const byte
 
 byte *decompressDeflate(const byte *data, size_t inputSize,
                         size_t outputSize, int windowBits) {
+	XOREOS_TRACE_SPAN("compression", "decompressDeflate");
 
 	ScopedArray<byte> decompressedData(new byte[outputSize]);
 
+	/* We know the size of the output, so we can decompress everything in one go.
+	 * If that fails, fall back to zlib, which can also tell us what went wrong. */
+	if (decompressDeflateOneShot(data, inputSize, decompressedData.get(), outputSize, windowBits))
+		return decompressedData.release();
+
 	z_stream strm;
 	BOOST_SCOPE_EXIT( (&strm) ) {
 			inflateEnd(&strm);
@@ -95,6 +102,8 @@ byte *decompressDeflate(const byte *data, size_t inputSize,
 
 byte *decompressDeflateWithoutOutputSize(const byte *data, size_t inputSize, size_t &outputSize,
                                          int windowBits, unsigned int frameSize) {
+	XOREOS_TRACE_SPAN("compression", "decompressDeflateWithoutOutputSize");
+
 	z_stream strm;
 	BOOST_SCOPE_EXIT( (&strm) ) {
 			inflateEnd(&strm);
@@ -159,6 +168,7 @@ SeekableReadStream *decompressDeflateWithoutOutputSize(ReadStream &input, size_t
 
 size_t decompressDeflateChunk(SeekableReadStream &input, int windowBits,
                               byte *output, size_t outputSize, unsigned int frameSize) {
+	XOREOS_TRACE_SPAN("compression", "decompressDeflateChunk");
 
 	z_stream strm;
 	BOOST_SCOPE_EXIT( (&strm) ) {
@@ -57,6 +57,26 @@ static const int kWindowBitsMaxRaw = -kWindowBitsMax;
 byte *decompressDeflate(const byte *data, size_t inputSize,
                         size_t outputSize, int windowBits);
 
+/** Decompress (inflate) a complete DEFLATE stream into a buffer of known size, in one go.
+ *
+ *  This is a faster alternative to zlib's streaming decompressor, used by
+ *  decompressDeflate() whenever possible. It only handles raw DEFLATE data
+ *  and zlib streams, but not gzip.
+ *
+ *  @param  data       The compressed input data.
+ *  @param  inputSize  The size of the input data in bytes.
+ *  @param  output     The buffer to decompress into.
+ *  @param  outputSize The exact size of the decompressed output data.
+ *  @param windowBits  The base two logarithm of the window size, negative for
+ *                     raw DEFLATE data. See the zlib documentation on
+ *                     inflateInit2() for details.
+ *  @return true if the data was successfully decompressed. false if the data is
+ *          broken or the stream type is not supported, in which case the output
+ *          buffer contents are undefined.
+ */
+bool decompressDeflateOneShot(const byte *data, size_t inputSize, byte *output, size_t outputSize,
+                              int windowBits);
+
 /** Decompress (inflate) using zlib's DEFLATE algorithm without knowing the output size.
  *
  *  @param  data       The compressed input data.
@@ -29,6 +29,8 @@
 
 #include <vector>
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/encoding.h"
 #include "src/common/encoding_strings.h"
 #include "src/common/error.h"
@@ -57,25 +59,25 @@ static const size_t kTerminatorLength  [kEncodingMAX] = {
 	1, 1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1
 };
 
-/** A manager handling string encoding conversions. */
-class ConversionManager : public Singleton<ConversionManager> {
+/** The iconv contexts of one thread.
+ *
+ *  iconv contexts carry state, so they can't be shared between threads.
+ *  Each thread opens its own contexts on first use, and closes them when
+ *  the thread ends.
+ */
+class ConversionContexts : boost::noncopyable {
 public:
-	ConversionManager() {
+	ConversionContexts() {
 		for (size_t i = 0; i < kEncodingMAX; i++) {
 			_contextFrom[i] = (iconv_t) -1;
 			_contextTo  [i] = (iconv_t) -1;
-		}
-
-		for (size_t i = 0; i < kEncodingMAX; i++)
-			if ((_contextFrom[i] = iconv_open("UTF-8", kEncodingName[i])) == ((iconv_t) -1))
-				warning("Failed to initialize %s -> UTF-8 conversion: %s", kEncodingName[i], strerror(errno));
 
-		for (size_t i = 0; i < kEncodingMAX; i++)
-			if ((_contextTo  [i] = iconv_open(kEncodingName[i], "UTF-8")) == ((iconv_t) -1))
-				warning("Failed to initialize UTF-8 -> %s conversion: %s", kEncodingName[i], strerror(errno));
+			_openedFrom[i] = false;
+			_openedTo  [i] = false;
+		}
 	}
 
-	~ConversionManager() {
+	~ConversionContexts() {
 		for (size_t i = 0; i < kEncodingMAX; i++) {
 			if (_contextFrom[i] != ((iconv_t) -1))
 				iconv_close(_contextFrom[i]);
@@ -84,16 +86,61 @@ public:
 		}
 	}
 
+	/** Return this thread's context converting from this encoding to UTF-8. */
+	iconv_t &getFrom(Encoding encoding) {
+		if (!_openedFrom[encoding]) {
+			_contextFrom[encoding] = iconv_open("UTF-8", kEncodingName[encoding]);
+			_openedFrom [encoding] = true;
+		}
+
+		return _contextFrom[encoding];
+	}
+
+	/** Return this thread's context converting from UTF-8 to this encoding. */
+	iconv_t &getTo(Encoding encoding) {
+		if (!_openedTo[encoding]) {
+			_contextTo[encoding] = iconv_open(kEncodingName[encoding], "UTF-8");
+			_openedTo [encoding] = true;
+		}
+
+		return _contextTo[encoding];
+	}
+
+private:
+	iconv_t _contextFrom[kEncodingMAX];
+	iconv_t _contextTo  [kEncodingMAX];
+
+	bool _openedFrom[kEncodingMAX];
+	bool _openedTo  [kEncodingMAX];
+};
+
+/** Return the iconv contexts of the calling thread. */
+static ConversionContexts &getThreadContexts() {
+	static thread_local ConversionContexts contexts;
+
+	return contexts;
+}
+
+/** A manager handling string encoding conversions. */
+class ConversionManager : public Singleton<ConversionManager> {
+public:
+	ConversionManager() {
+		for (size_t i = 0; i < kEncodingMAX; i++) {
+			_supportFrom[i] = checkSupport("UTF-8", kEncodingName[i]);
+			_supportTo  [i] = checkSupport(kEncodingName[i], "UTF-8");
+		}
+	}
+
 	bool hasSupportTranscode(Encoding from, Encoding to) {
 		if ((((size_t) from) >= kEncodingMAX) ||
 		    (((size_t) to  ) >= kEncodingMAX))
 			return false;
 
 		if (from == kEncodingUTF8)
-			return _contextTo[to] != ((iconv_t) -1);
+			return _supportTo[to];
 
 		if (to == kEncodingUTF8)
-			return _contextFrom[from] != ((iconv_t) -1);
+			return _supportFrom[from];
 
 		return false;
 	}
@@ -102,20 +149,31 @@ public:
 		if (((size_t) encoding) >= kEncodingMAX)
 			throw Exception("Invalid encoding %d", encoding);
 
-		return convert(_contextFrom[encoding], data, n, kEncodingGrowthFrom[encoding], 1);
+		return convert(getThreadContexts().getFrom(encoding), data, n, kEncodingGrowthFrom[encoding], 1);
 	}
 
 	MemoryReadStream *convert(Encoding encoding, const UString &str, bool terminate = true) {
 		if (((size_t) encoding) >= kEncodingMAX)
 			throw Exception("Invalid encoding %d", encoding);
 
-		return convert(_contextTo[encoding], str, kEncodingGrowthTo[encoding],
+		return convert(getThreadContexts().getTo(encoding), str, kEncodingGrowthTo[encoding],
 		               terminate ? kTerminatorLength[encoding] : 0);
 	}
 
 private:
-	iconv_t _contextFrom[kEncodingMAX];
-	iconv_t _contextTo  [kEncodingMAX];
+	bool _supportFrom[kEncodingMAX];
+	bool _supportTo  [kEncodingMAX];
+
+	static bool checkSupport(const char *to, const char *from) {
+		iconv_t ctx = iconv_open(to, from);
+		if (ctx == ((iconv_t) -1)) {
+			warning("Failed to initialize %s -> %s conversion: %s", from, to, strerror(errno));
+			return false;
+		}
+
+		iconv_close(ctx);
+		return true;
+	}
 
 	byte *doConvert(iconv_t &ctx, byte *data, size_t nIn, size_t nOut, size_t &size) {
 		size_t inBytes  = nIn;
@@ -293,8 +351,15 @@ UString readString(SeekableReadStream &stream, Encoding encoding) {
 }
 
 UString readStringFixed(SeekableReadStream &stream, Encoding encoding, size_t length) {
+	UString str;
+	readStringFixed(stream, encoding, length, str);
+
+	return str;
+}
+
+void readStringFixed(SeekableReadStream &stream, Encoding encoding, size_t length, UString &str) {
 	if (length == 0)
-		return "";
+		return;
 
 	std::vector<byte> output;
 	output.resize(length);
@@ -302,7 +367,20 @@ UString readStringFixed(SeekableReadStream &stream, Encoding encoding, size_t le
 	length = stream.read(&output[0], length);
 	output.resize(length);
 
-	return createString(output, encoding);
+	if (output.empty())
+		return;
+
+	switch (encoding) {
+		case kEncodingASCII:
+		case kEncodingUTF8:
+			output.push_back('\0');
+			str += reinterpret_cast<const char *>(&output[0]);
+			break;
+
+		default:
+			str += createString(output, encoding);
+			break;
+	}
 }
 
 UString readStringLine(SeekableReadStream &stream, Encoding encoding) {
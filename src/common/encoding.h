@@ -82,6 +82,11 @@ UString readString(SeekableReadStream &stream, Encoding encoding);
  */
 UString readStringFixed(SeekableReadStream &stream, Encoding encoding, size_t length);
 
+/** Read length bytes as a string with the given encoding out of a stream,
+ *  and append it to an existing string.
+ */
+void readStringFixed(SeekableReadStream &stream, Encoding encoding, size_t length, UString &str);
+
 /** Read a line with the given encoding out of a stream.
  *
  *  Reading stops after an end-of-line sequence has been read. For single-
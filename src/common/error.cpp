@@ -28,6 +28,7 @@
 
 #include "src/common/error.h"
 #include "src/common/util.h"
+#include "src/common/parallel.h"
 
 namespace Common {
 
@@ -117,6 +118,8 @@ void printException(Exception &e, const UString &prefix) {
 }
 
 void exceptionDispatcherError(const UString &reason) {
+	int status = 1;
+
 	try {
 		try {
 			throw;
@@ -125,25 +128,27 @@ void exceptionDispatcherError(const UString &reason) {
 				e.add("%s", reason.c_str());
 
 			printException(e);
-			std::exit(1);
 		} catch (std::exception &e) {
 			Exception se(e);
 			if (!reason.empty())
 				se.add("%s", reason.c_str());
 
 			printException(se);
-			std::exit(1);
 		} catch (...) {
 			Exception se("Unknown exception caught");
 			if (!reason.empty())
 				se.add("%s", reason.c_str());
 
 			printException(se);
-			std::exit(1);
 		}
 	} catch (...) {
-		std::exit(2);
+		status = 2;
 	}
+
+	// Join the worker threads now, instead of leaving them to std::exit()
+	shutdownScheduler();
+
+	std::exit(status);
 }
 
 void exceptionDispatcherWarnAndIgnore(const UString &reason) {
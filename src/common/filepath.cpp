@@ -339,11 +339,26 @@ UString FilePath::findSubDirectory(const UString &directory, const UString &subD
 	return curDir;
 }
 
+/** How often to retry creating directories after a failure. */
+static const size_t kMaxCreateTries = 3;
+
 bool FilePath::createDirectories(const UString &path) {
-	try {
-		return create_directories(path.c_str());
-	} catch (std::exception &se) {
-		throw Exception(se);
+	/* Several threads might be creating overlapping paths at the same time.
+	 * Older versions of Boost then fail when a directory appears between
+	 * checking for it and creating it, so we try again, now that the
+	 * other thread has created some of the directories for us. */
+
+	for (size_t tries = 0; ; tries++) {
+		try {
+			return create_directories(path.c_str());
+		} catch (std::exception &se) {
+			boost::system::error_code error;
+			if (is_directory(path.c_str(), error))
+				return false;
+
+			if (tries >= kMaxCreateTries)
+				throw Exception(se);
+		}
 	}
 }
 
@@ -0,0 +1,322 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Reading and writing gzip (RFC 1952) compressed streams.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include <vector>
+#include <algorithm>
+
+#include <zlib.h>
+
+#include "src/common/gzip.h"
+#include "src/common/error.h"
+#include "src/common/crc32.h"
+#include "src/common/endianness.h"
+#include "src/common/parallel.h"
+
+namespace Common {
+
+static const size_t kDictionarySize = 32768;
+static const size_t kReadBufferSize = 65536;
+
+const size_t GzipWriteStream::kBlockSize;
+
+bool isGzip(const byte *data, size_t size) {
+	return (size >= 2) && (data[0] == 0x1F) && (data[1] == 0x8B);
+}
+
+
+/** Compress a batch of blocks into raw deflate data, one block per item. */
+class GzipBlockJob : public ParallelJob {
+public:
+	GzipBlockJob(const byte *data, size_t size, const byte *dictionary, size_t dictionarySize,
+	             int level, bool finish) : _data(data), _size(size), _dictionary(dictionary),
+	             _dictionarySize(dictionarySize), _level(level), _finish(finish) {
+
+		const size_t count = std::max<size_t>(1, (_size + GzipWriteStream::kBlockSize - 1) /
+		                                          GzipWriteStream::kBlockSize);
+
+		_output.resize(count);
+		_crcs.resize(count, 0);
+	}
+
+	size_t getCount() const {
+		return _output.size();
+	}
+
+	size_t getBlockSize(size_t index) const {
+		const size_t start = index * GzipWriteStream::kBlockSize;
+
+		return std::min(_size - start, GzipWriteStream::kBlockSize);
+	}
+
+	const std::vector<byte> &getOutput(size_t index) const {
+		return _output[index];
+	}
+
+	uint32 getCRC(size_t index) const {
+		return _crcs[index];
+	}
+
+	void run(size_t index) {
+		const byte  *data = _data + index * GzipWriteStream::kBlockSize;
+		const size_t size = getBlockSize(index);
+
+		const bool last = _finish && (index == (_output.size() - 1));
+
+		z_stream strm;
+		std::memset(&strm, 0, sizeof(strm));
+
+		if (deflateInit2(&strm, _level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw Exception("Could not initialize zlib deflate");
+
+		std::vector<byte> &output = _output[index];
+		output.resize(deflateBound(&strm, size) + 16);
+
+		// Prime the block with the data right before it, so that matches can cross block borders
+		const byte  *dictionary     = (index == 0) ? _dictionary     : (data - kDictionarySize);
+		const size_t dictionarySize = (index == 0) ? _dictionarySize : kDictionarySize;
+
+		int zResult = Z_OK;
+		if (dictionarySize > 0)
+			zResult = deflateSetDictionary(&strm, dictionary, dictionarySize);
+
+		if (zResult == Z_OK) {
+			strm.next_in   = const_cast<byte *>(data);
+			strm.avail_in  = size;
+			strm.next_out  = &output[0];
+			strm.avail_out = output.size();
+
+			zResult = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+			if ((zResult == Z_STREAM_END) ||
+			    ((zResult == Z_OK) && !last && (strm.avail_in == 0) && (strm.avail_out > 0)))
+				zResult = Z_OK;
+			else if (zResult == Z_OK)
+				zResult = Z_BUF_ERROR;
+		}
+
+		output.resize(output.size() - strm.avail_out);
+		deflateEnd(&strm);
+
+		if (zResult != Z_OK)
+			throw Exception("Failed to compress gzip data: %s (%d)", zError(zResult), zResult);
+
+		_crcs[index] = calcCRC32(data, size);
+	}
+
+private:
+	const byte *_data;
+	size_t _size;
+
+	const byte *_dictionary;
+	size_t _dictionarySize;
+
+	int  _level;
+	bool _finish;
+
+	std::vector< std::vector<byte> > _output;
+	std::vector<uint32> _crcs;
+};
+
+
+GzipWriteStream::GzipWriteStream(WriteStream *parentStream, bool disposeParentStream, int level) :
+	_parentStream(parentStream, disposeParentStream), _level(level), _bufferSize(0), _bufferPos(0),
+	_dictionarySize(0), _inMember(false), _crc(0), _size(0) {
+
+	assert(parentStream);
+
+	// Collect enough blocks to keep all threads busy
+	_bufferSize = 4 * getThreadCount() * kBlockSize;
+
+	_buffer.reset(new byte[_bufferSize]);
+	_dictionary.reset(new byte[kDictionarySize]);
+}
+
+GzipWriteStream::~GzipWriteStream() {
+	try {
+		finalize();
+	} catch (...) {
+	}
+}
+
+size_t GzipWriteStream::write(const void *dataPtr, size_t dataSize) {
+	const byte *data = static_cast<const byte *>(dataPtr);
+
+	size_t written = 0;
+	while (written < dataSize) {
+		if (_bufferPos == _bufferSize)
+			compressBuffer(false);
+
+		const size_t n = std::min(dataSize - written, _bufferSize - _bufferPos);
+
+		std::memcpy(_buffer.get() + _bufferPos, data + written, n);
+
+		_bufferPos += n;
+		written    += n;
+	}
+
+	return dataSize;
+}
+
+void GzipWriteStream::flush() {
+	if (_bufferPos > 0)
+		compressBuffer(false);
+
+	_parentStream->flush();
+}
+
+void GzipWriteStream::finalize() {
+	if (_inMember || (_bufferPos > 0)) {
+		compressBuffer(true);
+
+		byte trailer[8];
+		WRITE_LE_UINT32(trailer    , _crc);
+		WRITE_LE_UINT32(trailer + 4, _size);
+
+		if (_parentStream->write(trailer, sizeof(trailer)) != sizeof(trailer))
+			throw Exception(kWriteError);
+
+		_inMember       = false;
+		_dictionarySize = 0;
+		_crc            = 0;
+		_size           = 0;
+	}
+
+	_parentStream->flush();
+}
+
+void GzipWriteStream::compressBuffer(bool finish) {
+	if (!_inMember) {
+		// Deflate, no flags, no modification time, unknown OS
+		static const byte kHeader[10] = { 0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF };
+
+		if (_parentStream->write(kHeader, sizeof(kHeader)) != sizeof(kHeader))
+			throw Exception(kWriteError);
+
+		_inMember = true;
+	}
+
+	GzipBlockJob job(_buffer.get(), _bufferPos, _dictionary.get(), _dictionarySize, _level, finish);
+	parallelFor(job.getCount(), job);
+
+	for (size_t i = 0; i < job.getCount(); i++) {
+		const std::vector<byte> &output = job.getOutput(i);
+
+		if (!output.empty())
+			if (_parentStream->write(&output[0], output.size()) != output.size())
+				throw Exception(kWriteError);
+
+		const size_t blockSize = job.getBlockSize(i);
+
+		_crc   = crc32_combine(_crc, job.getCRC(i), blockSize);
+		_size += blockSize;
+	}
+
+	if (_bufferPos >= kDictionarySize) {
+		std::memcpy(_dictionary.get(), _buffer.get() + _bufferPos - kDictionarySize, kDictionarySize);
+		_dictionarySize = kDictionarySize;
+	} else {
+		// A flush() compressed only a little data: keep the tail of the old dictionary in front of it
+		const size_t keep = std::min(_dictionarySize, kDictionarySize - _bufferPos);
+
+		std::memmove(_dictionary.get(), _dictionary.get() + _dictionarySize - keep, keep);
+		std::memcpy(_dictionary.get() + keep, _buffer.get(), _bufferPos);
+		_dictionarySize = keep + _bufferPos;
+	}
+
+	_bufferPos = 0;
+}
+
+
+GzipReadStream::GzipReadStream(ReadStream *parentStream, bool disposeParentStream,
+                               const byte *prefix, size_t prefixSize) :
+	_parentStream(parentStream, disposeParentStream), _inMember(false), _eos(false) {
+
+	assert(parentStream);
+	assert(prefixSize <= kReadBufferSize);
+
+	_buffer.reset(new byte[kReadBufferSize]);
+
+	_strm.reset(new z_stream);
+	std::memset(_strm.get(), 0, sizeof(z_stream));
+
+	// Automatically detect and skip the gzip header
+	const int zResult = inflateInit2(_strm.get(), MAX_WBITS + 16);
+	if (zResult != Z_OK)
+		throw Exception("Could not initialize zlib inflate: %s (%d)", zError(zResult), zResult);
+
+	if (prefixSize > 0)
+		std::memcpy(_buffer.get(), prefix, prefixSize);
+
+	_strm->next_in  = _buffer.get();
+	_strm->avail_in = prefixSize;
+}
+
+GzipReadStream::~GzipReadStream() {
+	inflateEnd(_strm.get());
+}
+
+bool GzipReadStream::eos() const {
+	return _eos;
+}
+
+size_t GzipReadStream::read(void *dataPtr, size_t dataSize) {
+	if (_eos)
+		return 0;
+
+	_strm->next_out  = static_cast<byte *>(dataPtr);
+	_strm->avail_out = dataSize;
+
+	while (_strm->avail_out > 0) {
+		if (_strm->avail_in == 0) {
+			const size_t n = _parentStream->read(_buffer.get(), kReadBufferSize);
+			if (n == 0) {
+				if (_inMember)
+					throw Exception("Failed to decompress gzip data: Unexpected end of data");
+
+				_eos = true;
+				break;
+			}
+
+			_strm->next_in  = _buffer.get();
+			_strm->avail_in = n;
+		}
+
+		if (!_inMember) {
+			inflateReset(_strm.get());
+			_inMember = true;
+		}
+
+		const int zResult = inflate(_strm.get(), Z_NO_FLUSH);
+		if (zResult == Z_STREAM_END)
+			_inMember = false;
+		else if (zResult != Z_OK)
+			throw Exception("Failed to decompress gzip data: %s (%d)", zError(zResult), zResult);
+	}
+
+	return dataSize - _strm->avail_out;
+}
+
+} // End of namespace Common
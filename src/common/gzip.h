@@ -0,0 +1,133 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Reading and writing gzip (RFC 1952) compressed streams.
+ */
+
+#ifndef COMMON_GZIP_H
+#define COMMON_GZIP_H
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/disposableptr.h"
+#include "src/common/readstream.h"
+#include "src/common/writestream.h"
+
+struct z_stream_s;
+
+namespace Common {
+
+/** Is this the start of gzip compressed data? */
+bool isGzip(const byte *data, size_t size);
+
+/** A stream compressing everything written into it as gzip.
+ *
+ *  The data is split into blocks that are compressed in parallel, in the
+ *  way pigz does it: every block is primed with the last 32KB of data of
+ *  its predecessor and ends on a byte boundary, so the concatenation of
+ *  the blocks forms a single deflate stream.
+ *
+ *  flush() makes all data written so far decompressible, without ending
+ *  the deflate stream. The gzip trailer is only written by finalize().
+ *  Destroying the stream finalizes it as a fallback, but ignores any
+ *  errors, so callers that need to know whether the output is complete
+ *  have to call finalize() themselves.
+ */
+class GzipWriteStream : public WriteStream {
+public:
+	/** The size of the blocks that are compressed independently. */
+	static const size_t kBlockSize = 128 * 1024;
+
+	/** Create a gzip compressing stream.
+	 *
+	 *  @param parentStream The stream to write the compressed data into.
+	 *  @param disposeParentStream Should the parent stream be deleted together with this stream?
+	 *  @param level The zlib compression level, 0-9 or -1 for the default.
+	 */
+	GzipWriteStream(WriteStream *parentStream, bool disposeParentStream = false, int level = -1);
+	~GzipWriteStream();
+
+	size_t write(const void *dataPtr, size_t dataSize);
+
+	/** Compress all pending data, aligned to a byte boundary, and flush the parent stream. */
+	void flush();
+
+	/** Compress all pending data, write the gzip trailer and flush the parent stream.
+	 *
+	 *  Writing more data afterwards starts a new gzip member. Readers
+	 *  (including GzipReadStream and the gzip tool) treat concatenated
+	 *  members as one continuous stream.
+	 */
+	void finalize();
+
+private:
+	DisposablePtr<WriteStream> _parentStream;
+
+	int _level;
+
+	ScopedArray<byte> _buffer; ///< Uncompressed data of the current batch of blocks.
+	size_t _bufferSize;        ///< Capacity of the batch buffer.
+	size_t _bufferPos;         ///< Number of bytes in the batch buffer.
+
+	ScopedArray<byte> _dictionary; ///< The last 32KB of the previous batch.
+	size_t _dictionarySize;
+
+	bool   _inMember; ///< Have we written the header of a gzip member that's not finished yet?
+	uint32 _crc;      ///< CRC-32 of the uncompressed data of the current member.
+	uint32 _size;     ///< Size of the uncompressed data of the current member, modulo 2^32.
+
+	void compressBuffer(bool finish);
+};
+
+/** A stream decompressing gzip data read from another stream.
+ *
+ *  Concatenated gzip members are decompressed as one continuous stream.
+ */
+class GzipReadStream : public ReadStream {
+public:
+	/** Create a gzip decompressing stream.
+	 *
+	 *  @param parentStream The stream to read the compressed data from.
+	 *  @param disposeParentStream Should the parent stream be deleted together with this stream?
+	 *  @param prefix Compressed data already read from the parent stream, for example
+	 *                to check for the gzip magic bytes.
+	 *  @param prefixSize The number of bytes in prefix.
+	 */
+	GzipReadStream(ReadStream *parentStream, bool disposeParentStream = false,
+	               const byte *prefix = 0, size_t prefixSize = 0);
+	~GzipReadStream();
+
+	bool eos() const;
+	size_t read(void *dataPtr, size_t dataSize);
+
+private:
+	DisposablePtr<ReadStream> _parentStream;
+
+	ScopedPtr<z_stream_s> _strm;
+	ScopedArray<byte> _buffer;
+
+	bool _inMember;
+	bool _eos;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_GZIP_H
@@ -0,0 +1,651 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  One-shot DEFLATE decompressor for data of a known size.
+ *
+ *  This decompresses a complete DEFLATE stream (RFC 1951), optionally
+ *  wrapped in a zlib header (RFC 1950), directly into an output buffer
+ *  that fits the whole decompressed data.
+ *
+ *  Since it never has to stop in the middle of the stream, it doesn't need
+ *  to keep zlib's per-call state and sliding window. Instead, matches copy
+ *  directly from the output buffer, the input is read through a 64-bit
+ *  bit buffer that's refilled with one unaligned load per symbol, and the
+ *  Huffman codes are decoded with a single table lookup in the common case.
+ */
+
+#include <cstring>
+
+#include <zlib.h>
+
+#include "src/common/deflate.h"
+#include "src/common/util.h"
+#include "src/common/endianness.h"
+#include "src/common/scopedptr.h"
+#include "src/common/trace.h"
+
+namespace Common {
+
+/* Entries in the decode tables.
+ *
+ * Bits  0- 3: Number of bits in the code (or root bits for a subtable pointer)
+ * Bits  4- 7: Flags
+ * Bits  8-15: Number of extra bits (or number of bits in the subtable)
+ * Bits 16-31: Value (literal, length base, offset base, symbol or subtable start)
+ */
+
+static const uint32 kEntryLiteral  = 0x10;
+static const uint32 kEntryEndBlock = 0x20;
+static const uint32 kEntrySubtable = 0x40;
+static const uint32 kEntryInvalid  = 0x80;
+
+static const uint32 kLitLenTableBits  = 11;
+static const uint32 kOffsetTableBits  =  8;
+static const uint32 kPrecodeTableBits =  7;
+
+static const size_t kMaxCodeLength = 15;
+
+static const size_t kNumLitLenSymbols  = 288;
+static const size_t kNumOffsetSymbols  =  32;
+static const size_t kNumPrecodeSymbols =  19;
+
+/* Upper bounds for the table sizes, including all subtables. Each group of
+ * codes that share a root entry gets one subtable of at most 2^(15 - root)
+ * entries, and there can't be more groups than symbols. */
+static const size_t kLitLenTableSize  = (1 << kLitLenTableBits) + kNumLitLenSymbols * (1 << (15 - kLitLenTableBits));
+static const size_t kOffsetTableSize  = (1 << kOffsetTableBits) + kNumOffsetSymbols * (1 << (15 - kOffsetTableBits));
+static const size_t kPrecodeTableSize = (1 << kPrecodeTableBits);
+
+static const uint16 kLengthBase[29] = {
+	  3,   4,   5,   6,   7,   8,   9,  10,  11,  13,  15,  17,  19,  23,  27,  31,
+	 35,  43,  51,  59,  67,  83,  99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8 kLengthExtra[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16 kOffsetBase[30] = {
+	   1,    2,    3,    4,    5,    7,    9,   13,   17,   25,   33,   49,   65,   97,  129,  193,
+	 257,  385,  513,  769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const uint8 kOffsetExtra[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/** The order in which the precode lengths are stored. */
+static const uint8 kPrecodeOrder[kNumPrecodeSymbols] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/** The decode table entries (without the code length) for all symbols of each alphabet. */
+struct SymbolValues {
+	uint32 litLen [kNumLitLenSymbols];
+	uint32 offset [kNumOffsetSymbols];
+	uint32 precode[kNumPrecodeSymbols];
+
+	SymbolValues() {
+		for (size_t i = 0; i < 256; i++)
+			litLen[i] = (i << 16) | kEntryLiteral;
+
+		litLen[256] = kEntryEndBlock;
+
+		for (size_t i = 0; i < 29; i++)
+			litLen[257 + i] = (kLengthBase[i] << 16) | (kLengthExtra[i] << 8);
+
+		litLen[286] = litLen[287] = kEntryInvalid;
+
+		for (size_t i = 0; i < 30; i++)
+			offset[i] = (kOffsetBase[i] << 16) | (kOffsetExtra[i] << 8);
+
+		offset[30] = offset[31] = kEntryInvalid;
+
+		for (size_t i = 0; i < kNumPrecodeSymbols; i++)
+			precode[i] = i << 16;
+	}
+};
+
+static const SymbolValues &getSymbolValues() {
+	static const SymbolValues kValues;
+
+	return kValues;
+}
+
+static uint32 reverseBits(uint32 code, size_t length) {
+	uint32 reversed = 0;
+
+	for (size_t i = 0; i < length; i++, code >>= 1)
+		reversed = (reversed << 1) | (code & 1);
+
+	return reversed;
+}
+
+/** Build a decode table for a canonical Huffman code.
+ *
+ *  Like zlib, we reject over-subscribed codes, and incomplete codes unless
+ *  they consist of a single code of length 1 (or no codes at all).
+ *
+ *  @return false if the code lengths don't describe a usable code.
+ */
+static bool buildTable(uint32 *table, size_t tableSize, size_t tableBits,
+                       const uint8 *lengths, const uint32 *values, size_t count, bool allowIncomplete) {
+
+	uint16 lengthCount[kMaxCodeLength + 1] = { 0 };
+	for (size_t i = 0; i < count; i++)
+		lengthCount[lengths[i]]++;
+
+	lengthCount[0] = 0;
+
+	size_t maxLength = 0;
+	int32  left      = 1;
+	for (size_t i = 1; i <= kMaxCodeLength; i++) {
+		left = (left << 1) - lengthCount[i];
+		if (left < 0)
+			return false;
+
+		if (lengthCount[i] > 0)
+			maxLength = i;
+	}
+
+	if ((left > 0) && (!allowIncomplete || (maxLength > 1)))
+		return false;
+
+	// Sort the symbols by code length, keeping the symbol order within each length
+
+	uint16 offsets[kMaxCodeLength + 2];
+	offsets[1] = 0;
+	for (size_t i = 1; i <= kMaxCodeLength; i++)
+		offsets[i + 1] = offsets[i] + lengthCount[i];
+
+	const size_t codeCount = offsets[kMaxCodeLength + 1];
+
+	uint16 sorted[kNumLitLenSymbols];
+	for (size_t i = 0; i < count; i++)
+		if (lengths[i] > 0)
+			sorted[offsets[lengths[i]]++] = i;
+
+	// Unused entries (in incomplete codes) are invalid
+	const size_t rootSize = 1 << tableBits;
+	for (size_t i = 0; i < rootSize; i++)
+		table[i] = kEntryInvalid;
+
+	size_t next = rootSize;
+
+	uint32 code = 0;
+	size_t codeLength = 0;
+
+	for (size_t i = 0; i < codeCount; i++) {
+		const uint16 symbol = sorted[i];
+		const size_t length = lengths[symbol];
+
+		// Canonical codes of the same length are consecutive; longer codes continue shifted
+		if (i > 0)
+			code = (code + 1) << (length - codeLength);
+		codeLength = length;
+
+		// DEFLATE reads codes starting with the most significant bit, so the table index is reversed
+		const uint32 reversed = reverseBits(code, length);
+
+		if (length <= tableBits) {
+			for (size_t j = reversed; j < rootSize; j += (1 << length))
+				table[j] = values[symbol] | length;
+
+			continue;
+		}
+
+		/* Codes longer than the root table go into a subtable. Codes sharing the
+		 * same root prefix are consecutive, and the last one is the longest. */
+
+		const uint32 prefix = reversed & (rootSize - 1);
+		if (!(table[prefix] & kEntrySubtable)) {
+			const uint32 prefixCode = code >> (length - tableBits);
+
+			size_t subtableBits = length - tableBits;
+
+			uint32 groupCode   = code;
+			size_t groupLength = length;
+			for (size_t j = i + 1; j < codeCount; j++) {
+				const size_t nextLength = lengths[sorted[j]];
+
+				groupCode   = (groupCode + 1) << (nextLength - groupLength);
+				groupLength = nextLength;
+
+				if ((groupCode >> (groupLength - tableBits)) != prefixCode)
+					break;
+
+				subtableBits = groupLength - tableBits;
+			}
+
+			if ((next + (1 << subtableBits)) > tableSize)
+				return false;
+
+			table[prefix] = (next << 16) | (subtableBits << 8) | kEntrySubtable | tableBits;
+			next += 1 << subtableBits;
+		}
+
+		const uint32 start        = table[prefix] >> 16;
+		const size_t subtableBits = (table[prefix] >> 8) & 0xFF;
+		const size_t subLength    = length - tableBits;
+
+		for (size_t j = reversed >> tableBits; j < (1U << subtableBits); j += (1 << subLength))
+			table[start + j] = values[symbol] | subLength;
+	}
+
+	return true;
+}
+
+/** The state of decompressing one DEFLATE stream. */
+class Inflater {
+public:
+	Inflater(const byte *input, size_t inputSize, byte *output, size_t outputSize, size_t windowSize) :
+		_in(input), _inEnd(input + inputSize), _out(output), _outStart(output), _outEnd(output + outputSize),
+		_windowSize(windowSize), _bitBuffer(0), _bitsLeft(0), _overread(0) {
+
+	}
+
+	/** Decompress the stream. */
+	bool inflate() {
+		bool finalBlock = false;
+
+		while (!finalBlock) {
+			refill();
+
+			finalBlock = getBits(1) != 0;
+			const uint32 type = getBits(2);
+
+			bool result = false;
+			if      (type == 0)
+				result = inflateStored();
+			else if (type == 1)
+				result = inflateFixed();
+			else if (type == 2)
+				result = inflateDynamic();
+
+			if (!result)
+				return false;
+		}
+
+		return (_out == _outEnd) && !hasOverread();
+	}
+
+	/** Return the position of the first byte after the stream. */
+	const byte *getInputEnd() {
+		alignToByte();
+
+		return _in;
+	}
+
+private:
+	const byte *_in;
+	const byte *_inEnd;
+
+	byte *_out;
+	byte *_outStart;
+	byte *_outEnd;
+
+	size_t _windowSize;
+
+	uint64 _bitBuffer;
+	uint32 _bitsLeft;
+
+	/** The number of zero bytes we added to the bit buffer after the end of the input. */
+	uint32 _overread;
+
+	uint32 _litLenTable [kLitLenTableSize];
+	uint32 _offsetTable [kOffsetTableSize];
+	uint32 _precodeTable[kPrecodeTableSize];
+
+
+	/** Fill the bit buffer to at least 56 bits (and at most 63). */
+	inline void refill() {
+		if ((_inEnd - _in) >= 8) {
+			/* Load 8 bytes at once, but only count the whole bytes that fit.
+			 * The bits above _bitsLeft are always either 0 or the next bits
+			 * of the input, so loading them again does no harm. */
+
+			_bitBuffer |= READ_LE_UINT64(_in) << _bitsLeft;
+			_in        += (63 - _bitsLeft) >> 3;
+			_bitsLeft  |= 56;
+			return;
+		}
+
+		while (_bitsLeft < 56) {
+			if (_in < _inEnd)
+				_bitBuffer |= static_cast<uint64>(*_in++) << _bitsLeft;
+			else
+				_overread++;
+
+			_bitsLeft += 8;
+		}
+	}
+
+	inline uint32 peekBits(uint32 count) const {
+		return _bitBuffer & ((static_cast<uint64>(1) << count) - 1);
+	}
+
+	inline void removeBits(uint32 count) {
+		_bitBuffer >>= count;
+		_bitsLeft   -= count;
+	}
+
+	inline uint32 getBits(uint32 count) {
+		const uint32 bits = peekBits(count);
+		removeBits(count);
+
+		return bits;
+	}
+
+	/** Did we read more bits than there is input? */
+	bool hasOverread() const {
+		return (_overread * 8) > _bitsLeft;
+	}
+
+	/** Discard the bits up to the next byte and give back all whole bytes left in the bit buffer. */
+	void alignToByte() {
+		removeBits(_bitsLeft & 7);
+
+		_in -= (_bitsLeft >> 3) - _overread;
+
+		_bitBuffer = 0;
+		_bitsLeft  = 0;
+		_overread  = 0;
+	}
+
+	inline uint32 decodeEntry(const uint32 *table, uint32 tableBits) {
+		uint32 entry = table[peekBits(tableBits)];
+
+		if (entry & kEntrySubtable) {
+			removeBits(tableBits);
+			entry = table[(entry >> 16) + peekBits((entry >> 8) & 0xFF)];
+		}
+
+		removeBits(entry & 0x0F);
+
+		return entry;
+	}
+
+	bool inflateStored() {
+		if (hasOverread())
+			return false;
+
+		alignToByte();
+
+		if ((_inEnd - _in) < 4)
+			return false;
+
+		const uint16 length  = READ_LE_UINT16(_in);
+		const uint16 nlength = READ_LE_UINT16(_in + 2);
+		_in += 4;
+
+		if ((length != static_cast<uint16>(~nlength)) ||
+		    (static_cast<size_t>(_inEnd  - _in ) < length) ||
+		    (static_cast<size_t>(_outEnd - _out) < length))
+			return false;
+
+		std::memcpy(_out, _in, length);
+
+		_in  += length;
+		_out += length;
+
+		return true;
+	}
+
+	bool inflateFixed() {
+		uint8 lengths[kNumLitLenSymbols + kNumOffsetSymbols];
+
+		std::memset(lengths      , 8, 144);
+		std::memset(lengths + 144, 9, 112);
+		std::memset(lengths + 256, 7,  24);
+		std::memset(lengths + 280, 8,   8);
+		std::memset(lengths + kNumLitLenSymbols, 5, kNumOffsetSymbols);
+
+		return buildTables(lengths, kNumLitLenSymbols, kNumOffsetSymbols) && inflateCompressed();
+	}
+
+	bool inflateDynamic() {
+		const size_t litLenCount  = getBits(5) + 257;
+		const size_t offsetCount  = getBits(5) +   1;
+		const size_t precodeCount = getBits(4) +   4;
+
+		if ((litLenCount > 286) || (offsetCount > 30))
+			return false;
+
+		uint8 precodeLengths[kNumPrecodeSymbols] = { 0 };
+		for (size_t i = 0; i < precodeCount; i++) {
+			refill();
+			precodeLengths[kPrecodeOrder[i]] = getBits(3);
+		}
+
+		if (!buildTable(_precodeTable, kPrecodeTableSize, kPrecodeTableBits,
+		                precodeLengths, getSymbolValues().precode, kNumPrecodeSymbols, false))
+			return false;
+
+		uint8 lengths[kNumLitLenSymbols + kNumOffsetSymbols];
+
+		const size_t count = litLenCount + offsetCount;
+		for (size_t i = 0; i < count; ) {
+			refill();
+
+			const uint32 symbol = decodeEntry(_precodeTable, kPrecodeTableBits) >> 16;
+			if (symbol < 16) {
+				lengths[i++] = symbol;
+				continue;
+			}
+
+			uint8  value  = 0;
+			size_t repeat = 0;
+
+			if        (symbol == 16) {
+				if (i == 0)
+					return false;
+
+				value  = lengths[i - 1];
+				repeat = 3 + getBits(2);
+			} else if (symbol == 17) {
+				repeat = 3 + getBits(3);
+			} else {
+				repeat = 11 + getBits(7);
+			}
+
+			if ((i + repeat) > count)
+				return false;
+
+			std::memset(lengths + i, value, repeat);
+			i += repeat;
+		}
+
+		if (hasOverread())
+			return false;
+
+		// Without an end-of-block code, the block could never end
+		if (lengths[256] == 0)
+			return false;
+
+		// Move the offset lengths behind the full literal/length alphabet
+		uint8 allLengths[kNumLitLenSymbols + kNumOffsetSymbols] = { 0 };
+		std::memcpy(allLengths, lengths, litLenCount);
+		std::memcpy(allLengths + kNumLitLenSymbols, lengths + litLenCount, offsetCount);
+
+		return buildTables(allLengths, kNumLitLenSymbols, kNumOffsetSymbols) && inflateCompressed();
+	}
+
+	bool buildTables(const uint8 *lengths, size_t litLenCount, size_t offsetCount) {
+		const SymbolValues &values = getSymbolValues();
+
+		return buildTable(_litLenTable, kLitLenTableSize, kLitLenTableBits,
+		                  lengths, values.litLen, litLenCount, true) &&
+		       buildTable(_offsetTable, kOffsetTableSize, kOffsetTableBits,
+		                  lengths + litLenCount, values.offset, offsetCount, true);
+	}
+
+	/** Decompress the symbols of a Huffman-compressed block. */
+	bool inflateCompressed() {
+		while (true) {
+			/* One refill gives us at least 56 bits, which is enough for the
+			 * longest length code (15 bits) with its extra bits (5 bits) and
+			 * the longest offset code (15 bits) with its extra bits (13 bits). */
+			refill();
+
+			const uint32 entry = decodeEntry(_litLenTable, kLitLenTableBits);
+
+			if (entry & kEntryLiteral) {
+				if (_out == _outEnd)
+					return false;
+
+				*_out++ = entry >> 16;
+				continue;
+			}
+
+			if (entry & (kEntryEndBlock | kEntryInvalid))
+				return (entry & kEntryEndBlock) && !hasOverread();
+
+			const size_t length = (entry >> 16) + getBits((entry >> 8) & 0xFF);
+
+			const uint32 offsetEntry = decodeEntry(_offsetTable, kOffsetTableBits);
+			if (offsetEntry & kEntryInvalid)
+				return false;
+
+			const size_t offset = (offsetEntry >> 16) + getBits((offsetEntry >> 8) & 0xFF);
+
+			if ((offset > static_cast<size_t>(_out - _outStart)) || (offset > _windowSize) ||
+			    (length > static_cast<size_t>(_outEnd - _out)))
+				return false;
+
+			copyMatch(length, offset);
+		}
+	}
+
+	inline void copyMatch(size_t length, size_t offset) {
+		const byte *src = _out - offset;
+		byte *end = _out + length;
+
+		if ((offset >= 8) && (static_cast<size_t>(_outEnd - _out) >= (length + 32))) {
+			/* The source is at least 8 bytes behind, so we can copy whole words,
+			 * overshooting the end. Most matches are short, so do the first 16
+			 * bytes unconditionally. */
+			std::memcpy(_out    , src    , 8);
+			std::memcpy(_out + 8, src + 8, 8);
+
+			if (length > 16) {
+				_out += 16;
+				src  += 16;
+
+				if (offset >= 16) {
+					do {
+						std::memcpy(_out, src, 16);
+						_out += 16;
+						src  += 16;
+					} while (_out < end);
+				} else {
+					do {
+						std::memcpy(_out, src, 8);
+						_out += 8;
+						src  += 8;
+					} while (_out < end);
+				}
+			}
+
+		} else if (offset == 1) {
+			std::memset(_out, *src, length);
+
+		} else {
+			/* Overlapping copy. Everything between the source and the current
+			 * output position repeats, so the distance we can copy at once
+			 * doubles with every step. */
+			while (_out < end) {
+				const size_t size = MIN<size_t>(end - _out, _out - src);
+
+				std::memcpy(_out, src, size);
+				_out += size;
+			}
+		}
+
+		_out = end;
+	}
+};
+
+bool decompressDeflateOneShot(const byte *data, size_t inputSize, byte *output, size_t outputSize,
+                              int windowBits) {
+
+	XOREOS_TRACE_SPAN("compression", "decompressDeflateOneShot");
+
+	// We handle raw DEFLATE (negative window bits) and the zlib wrapper, but not gzip
+	if ((windowBits > kWindowBitsMax) || (windowBits < kWindowBitsMaxRaw) ||
+	    ((windowBits > -8) && (windowBits < 8)))
+		return false;
+
+	const bool hasHeader = windowBits > 0;
+
+	size_t windowSize = static_cast<size_t>(1) << (hasHeader ? windowBits : -windowBits);
+
+	if (hasHeader) {
+		/* The zlib header: compression method 8 (DEFLATE), the window size,
+		 * a check value, and no preset dictionary. */
+
+		if (inputSize < 6)
+			return false;
+
+		const uint8 cmf = data[0];
+		const uint8 flg = data[1];
+
+		if (((cmf & 0x0F) != 8) || ((((cmf << 8) | flg) % 31) != 0) || (flg & 0x20))
+			return false;
+
+		const size_t headerWindowBits = (cmf >> 4) + 8;
+		if (headerWindowBits > static_cast<size_t>(windowBits))
+			return false;
+
+		windowSize = static_cast<size_t>(1) << headerWindowBits;
+
+		data      += 2;
+		inputSize -= 2;
+	}
+
+	/* The decode tables are a bit too big for the stack of some threads,
+	 * so the whole decompression state lives on the heap. */
+	ScopedPtr<Inflater> inflater(new Inflater(data, inputSize, output, outputSize, windowSize));
+
+	if (!inflater->inflate())
+		return false;
+
+	if (!hasHeader)
+		return true;
+
+	// The zlib trailer: the Adler-32 checksum of the decompressed data
+	const byte *trailer = inflater->getInputEnd();
+	if ((data + inputSize - trailer) < 4)
+		return false;
+
+	uLong checksum = adler32(0, Z_NULL, 0);
+
+	// adler32() only takes an unsigned int length
+	for (size_t offset = 0; offset < outputSize; ) {
+		const size_t size = MIN<size_t>(outputSize - offset, 0x40000000);
+
+		checksum = adler32(checksum, output + offset, size);
+		offset  += size;
+	}
+
+	return READ_BE_UINT32(trailer) == checksum;
+}
+
+} // End of namespace Common
@@ -32,6 +32,7 @@
 #include "src/common/scopedptr.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/trace.h"
 
 namespace Common {
 
@@ -63,6 +64,8 @@ static lzma_allocator kLZMAAllocator = {
 };
 
 byte *decompressLZMA1(const byte *data, size_t inputSize, size_t outputSize, bool noEndMarker) {
+	XOREOS_TRACE_SPAN("compression", "decompressLZMA1");
+
 	lzma_filter filters[2] = {
 		{ LZMA_FILTER_LZMA1, 0 },
 		{ LZMA_VLI_UNKNOWN , 0 }
@@ -0,0 +1,111 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A simple monotonic memory arena.
+ */
+
+#include <cassert>
+
+#include "src/common/memoryarena.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+const size_t MemoryArena::kDefaultBlockSize;
+
+MemoryArena::MemoryArena(size_t blockSize) : _blockSize(MAX<size_t>(blockSize, 1024)),
+	_currentBlock(0), _currentOffset(0), _usedSize(0) {
+
+}
+
+MemoryArena::~MemoryArena() {
+	for (std::vector<Block>::iterator b = _blocks.begin(); b != _blocks.end(); ++b)
+		delete[] b->data;
+}
+
+bool MemoryArena::fitsInBlock(const Block &block, size_t offset, size_t size, size_t alignment) const {
+	const uintptr_t start   = reinterpret_cast<uintptr_t>(block.data) + offset;
+	const size_t    padding = (alignment - (start % alignment)) % alignment;
+
+	return (offset + padding <= block.size) && (size <= (block.size - offset - padding));
+}
+
+void *MemoryArena::allocate(size_t size, size_t alignment) {
+	assert((alignment > 0) && ((alignment & (alignment - 1)) == 0));
+
+	if (size == 0)
+		size = 1;
+
+	// Find the next block with enough space left, starting at the current one
+	while ((_currentBlock < _blocks.size()) &&
+	       !fitsInBlock(_blocks[_currentBlock], _currentOffset, size, alignment)) {
+
+		_currentBlock++;
+		_currentOffset = 0;
+	}
+
+	if (_currentBlock >= _blocks.size()) {
+		// No block has enough space left, we need to allocate a new one
+
+		_blocks.reserve(_blocks.size() + 1);
+
+		Block block;
+		block.size = MAX<size_t>(_blockSize, size + alignment);
+		block.data = new byte[block.size];
+
+		_blocks.push_back(block);
+
+		_currentBlock  = _blocks.size() - 1;
+		_currentOffset = 0;
+	}
+
+	Block &block = _blocks[_currentBlock];
+
+	const uintptr_t start   = reinterpret_cast<uintptr_t>(block.data) + _currentOffset;
+	const size_t    padding = (alignment - (start % alignment)) % alignment;
+
+	byte *result = block.data + _currentOffset + padding;
+
+	_currentOffset += padding + size;
+	_usedSize      += size;
+
+	return result;
+}
+
+void MemoryArena::reset() {
+	_currentBlock  = 0;
+	_currentOffset = 0;
+	_usedSize      = 0;
+}
+
+size_t MemoryArena::getUsedSize() const {
+	return _usedSize;
+}
+
+size_t MemoryArena::getCapacity() const {
+	size_t capacity = 0;
+	for (std::vector<Block>::const_iterator b = _blocks.begin(); b != _blocks.end(); ++b)
+		capacity += b->size;
+
+	return capacity;
+}
+
+} // End of namespace Common
@@ -0,0 +1,155 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A simple monotonic memory arena.
+ */
+
+#ifndef COMMON_MEMORYARENA_H
+#define COMMON_MEMORYARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <limits>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/system.h"
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A monotonic memory arena (a "bump allocator").
+ *
+ *  Memory is handed out linearly from big blocks, and can't be freed
+ *  individually. Instead, all memory is released in one go, either when
+ *  the arena is destroyed or when reset() is called. This makes building
+ *  (and tearing down) a large graph of small objects, like the structs of
+ *  a GFF file, a lot cheaper than allocating every node on the heap.
+ *
+ *  Note that the arena only manages the memory. It does not keep track of
+ *  the objects constructed within, so their destructors have to be called
+ *  manually. See DeallocatorDestruct in deallocator.h.
+ *
+ *  After a reset(), the already allocated blocks are kept and reused, so
+ *  that an arena can be passed along to the next file when converting many
+ *  files in a row, without hitting the system allocator again.
+ */
+class MemoryArena : boost::noncopyable {
+public:
+	static const size_t kDefaultBlockSize = 64 * 1024;
+
+	MemoryArena(size_t blockSize = kDefaultBlockSize);
+	~MemoryArena();
+
+	/** Allocate size bytes of memory with the given alignment. */
+	void *allocate(size_t size, size_t alignment = sizeof(double));
+
+	/** Allocate memory for count objects of type T. The objects are not constructed. */
+	template<typename T>
+	T *allocate(size_t count = 1) {
+		return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+	}
+
+	/** Release all memory handed out by this arena, but keep the blocks around for reuse. */
+	void reset();
+
+	/** Return the number of bytes currently handed out by this arena. */
+	size_t getUsedSize() const;
+	/** Return the number of bytes this arena has allocated from the system. */
+	size_t getCapacity() const;
+
+private:
+	struct Block {
+		byte  *data;
+		size_t size;
+	};
+
+	size_t _blockSize;
+
+	std::vector<Block> _blocks;
+
+	size_t _currentBlock;  ///< The block we're currently allocating from.
+	size_t _currentOffset; ///< The offset of the first free byte within the current block.
+
+	size_t _usedSize;
+
+	bool fitsInBlock(const Block &block, size_t offset, size_t size, size_t alignment) const;
+};
+
+/** An STL allocator that takes its memory out of a MemoryArena.
+ *
+ *  Deallocation is a no-op. The memory is only released together with
+ *  the whole arena.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+	typedef T *pointer;
+	typedef const T *const_pointer;
+	typedef T &reference;
+	typedef const T &const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef ArenaAllocator<U> other;
+	};
+
+	ArenaAllocator(MemoryArena &arena) : _arena(&arena) { }
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &allocator) : _arena(allocator.getArena()) { }
+
+	T *allocate(size_t n) {
+		return _arena->allocate<T>(n);
+	}
+
+	void deallocate(T *UNUSED(p), size_t UNUSED(n)) {
+	}
+
+	size_t max_size() const {
+		return std::numeric_limits<size_t>::max() / sizeof(T);
+	}
+
+	MemoryArena *getArena() const {
+		return _arena;
+	}
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U> &allocator) const {
+		return _arena == allocator.getArena();
+	}
+
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U> &allocator) const {
+		return _arena != allocator.getArena();
+	}
+
+private:
+	MemoryArena *_arena;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MEMORYARENA_H
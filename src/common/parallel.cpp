@@ -0,0 +1,453 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A shared task scheduler and helpers for running work in parallel.
+ */
+
+#include <cassert>
+
+#include <thread>
+#include <vector>
+#include <deque>
+
+#include "src/common/util.h"
+#include "src/common/ptrvector.h"
+#include "src/common/parallel.h"
+
+namespace Common {
+
+/** A task queued in the scheduler, together with the group it belongs to. */
+struct QueuedTask {
+	Task *task;
+	TaskGroup *group;
+
+	QueuedTask(Task *t = 0, TaskGroup *g = 0) : task(t), group(g) { }
+};
+
+/** A queue of tasks. The owning thread works at the back, other threads steal from the front. */
+struct TaskQueue {
+	std::mutex mutex;
+	std::deque<QueuedTask> tasks;
+};
+
+/** The pool of worker threads running the tasks of all task groups. */
+class TaskScheduler : boost::noncopyable {
+public:
+	/** Create a scheduler using this many threads, including the threads waiting for tasks. */
+	TaskScheduler(size_t threadCount);
+	~TaskScheduler();
+
+	/** Queue a task, into the current worker's queue if called from a worker thread. */
+	void push(Task &task, TaskGroup &group);
+
+	/** Run one queued task on the calling thread. Return false if there was none. */
+	bool runOne();
+
+private:
+	/** The queues of all workers. Queue 0 takes tasks queued by threads outside the pool. */
+	PtrVector<TaskQueue> _queues;
+
+	std::vector<std::thread> _threads;
+
+	std::atomic<size_t> _queued; ///< Number of tasks in all queues.
+
+	std::mutex _sleepMutex;
+	std::condition_variable _wakeUp;
+	bool _shutdown;
+
+	/** Take a task to run, from the thread's own queue or stolen from another. */
+	bool pop(size_t self, QueuedTask &queuedTask);
+
+	void run(const QueuedTask &queuedTask);
+
+	void work(size_t self);
+
+	static void runWorker(TaskScheduler *scheduler, size_t self);
+};
+
+/** The scheduler the current thread is a worker of, if any. */
+static thread_local TaskScheduler *currentScheduler = 0;
+/** The index of the current thread's queue within its scheduler. */
+static thread_local size_t currentQueue = 0;
+
+TaskScheduler::TaskScheduler(size_t threadCount) : _queued(0), _shutdown(false) {
+	for (size_t i = 0; i < threadCount; i++)
+		_queues.push_back(new TaskQueue);
+
+	try {
+		// The threads waiting on a task group work on tasks too, so one worker less is needed
+		for (size_t i = 1; i < threadCount; i++)
+			_threads.push_back(std::thread(runWorker, this, i));
+	} catch (...) {
+		// Failing to start more threads is no reason to fail; we just work with what we have
+	}
+}
+
+TaskScheduler::~TaskScheduler() {
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_shutdown = true;
+	}
+
+	_wakeUp.notify_all();
+
+	for (std::vector<std::thread>::iterator t = _threads.begin(); t != _threads.end(); ++t)
+		t->join();
+}
+
+void TaskScheduler::push(Task &task, TaskGroup &group) {
+	TaskQueue &queue = *_queues[(currentScheduler == this) ? currentQueue : 0];
+
+	// Count the task first, so that the count never drops below the number of queued tasks
+	_queued++;
+
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(QueuedTask(&task, &group));
+	}
+
+	{
+		// Taking the lock makes sure a worker about to sleep sees the new task
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+	}
+
+	_wakeUp.notify_one();
+}
+
+bool TaskScheduler::pop(size_t self, QueuedTask &queuedTask) {
+	if (_queued.load() == 0)
+		return false;
+
+	{
+		// Our own queue, newest first, to work on what's still hot in the cache
+		TaskQueue &queue = *_queues[self];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.tasks.empty()) {
+			queuedTask = queue.tasks.back();
+			queue.tasks.pop_back();
+
+			_queued--;
+			return true;
+		}
+	}
+
+	// Steal the oldest task from the other queues
+	for (size_t i = 1; i < _queues.size(); i++) {
+		TaskQueue &queue = *_queues[(self + i) % _queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.tasks.empty()) {
+			queuedTask = queue.tasks.front();
+			queue.tasks.pop_front();
+
+			_queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TaskScheduler::run(const QueuedTask &queuedTask) {
+	std::exception_ptr error;
+
+	try {
+		queuedTask.task->run();
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	queuedTask.group->finishTask(error);
+}
+
+bool TaskScheduler::runOne() {
+	QueuedTask queuedTask;
+	if (!pop((currentScheduler == this) ? currentQueue : 0, queuedTask))
+		return false;
+
+	run(queuedTask);
+	return true;
+}
+
+void TaskScheduler::work(size_t self) {
+	currentScheduler = this;
+	currentQueue     = self;
+
+	while (true) {
+		QueuedTask queuedTask;
+		if (pop(self, queuedTask)) {
+			run(queuedTask);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		while (!_shutdown && (_queued.load() == 0))
+			_wakeUp.wait(lock);
+
+		if (_shutdown)
+			break;
+	}
+
+	currentScheduler = 0;
+}
+
+void TaskScheduler::runWorker(TaskScheduler *scheduler, size_t self) {
+	scheduler->work(self);
+}
+
+
+/** The configured number of threads, 0 for one per hardware thread. */
+static size_t threadCountSetting = 0;
+
+static std::mutex schedulerMutex;
+
+/** The shared scheduler. Deliberately not a ScopedPtr: its threads are
+ *  joined by shutdownScheduler(), never during static destruction. */
+static TaskScheduler *scheduler = 0;
+
+/** Return the shared scheduler, creating it on first use. */
+static TaskScheduler &getScheduler() {
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+
+	if (!scheduler)
+		scheduler = new TaskScheduler(getThreadCount());
+
+	return *scheduler;
+}
+
+void shutdownScheduler() {
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+
+	delete scheduler;
+	scheduler = 0;
+}
+
+size_t getHardwareThreadCount() {
+	return MAX<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+size_t getThreadCount() {
+	if (threadCountSetting > 0)
+		return threadCountSetting;
+
+	return getHardwareThreadCount();
+}
+
+void setThreadCount(size_t count) {
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+
+	threadCountSetting = count;
+
+	// The next task starts a scheduler with the new number of threads
+	delete scheduler;
+	scheduler = 0;
+}
+
+
+TaskGroup::TaskGroup() : _pending(0), _failed(false) {
+}
+
+TaskGroup::~TaskGroup() {
+	try {
+		wait();
+	} catch (...) {
+	}
+}
+
+void TaskGroup::run(Task &task) {
+	_pending++;
+
+	try {
+		getScheduler().push(task, *this);
+	} catch (...) {
+		_pending--;
+		throw;
+	}
+}
+
+void TaskGroup::wait() {
+	if (_pending.load() > 0) {
+		TaskScheduler &taskScheduler = getScheduler();
+
+		while (_pending.load() > 0) {
+			if (taskScheduler.runOne())
+				continue;
+
+			// Nothing left to help with, our remaining tasks are running on other threads
+			std::unique_lock<std::mutex> lock(_mutex);
+			while (_pending.load() > 0)
+				_finished.wait(lock);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::exception_ptr error = _error;
+
+	_error = std::exception_ptr();
+	_failed.store(false);
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+bool TaskGroup::hasFailed() const {
+	return _failed.load();
+}
+
+void TaskGroup::finishTask(std::exception_ptr error) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (error && !_error) {
+		_error = error;
+		_failed.store(true);
+	}
+
+	_pending--;
+	if (_pending.load() == 0)
+		_finished.notify_all();
+}
+
+
+/** State shared between all the threads of one parallelFor() call. */
+class ParallelRunner {
+public:
+	ParallelRunner(size_t count, ParallelJob &job) : _count(count), _job(job), _next(0),
+		_failed(false), _errorIndex(SIZE_MAX) {
+
+	}
+
+	/** Grab items and process them, until there are none left. */
+	void work() {
+		size_t index;
+		while (!_failed.load(std::memory_order_relaxed) && ((index = _next.fetch_add(1)) < _count)) {
+			try {
+				_job.run(index);
+			} catch (...) {
+				setError(index, std::current_exception());
+			}
+		}
+	}
+
+	/** Rethrow the first exception, if any job failed. */
+	void finish() {
+		if (_error)
+			std::rethrow_exception(_error);
+	}
+
+private:
+	const size_t _count;
+	ParallelJob &_job;
+
+	std::atomic<size_t> _next;
+	std::atomic<bool>   _failed;
+
+	std::mutex _errorMutex;
+	size_t _errorIndex;
+	std::exception_ptr _error;
+
+	void setError(size_t index, std::exception_ptr error) {
+		std::lock_guard<std::mutex> lock(_errorMutex);
+
+		if (index < _errorIndex) {
+			_errorIndex = index;
+			_error      = error;
+		}
+
+		_failed.store(true);
+	}
+};
+
+/** A task helping a ParallelRunner process its items. */
+class ParallelRunnerTask : public Task {
+public:
+	ParallelRunnerTask(ParallelRunner &runner) : _runner(&runner) {
+	}
+
+	void run() {
+		_runner->work();
+	}
+
+private:
+	ParallelRunner *_runner;
+};
+
+void parallelFor(size_t count, ParallelJob &job, size_t threadCount) {
+	if (count == 0)
+		return;
+
+	if (threadCount == 0)
+		threadCount = getThreadCount();
+
+	threadCount = MIN(threadCount, count);
+
+	ParallelRunner runner(count, job);
+
+	if (threadCount > 1) {
+		// The calling thread is the first worker
+		std::vector<ParallelRunnerTask> tasks(threadCount - 1, ParallelRunnerTask(runner));
+
+		TaskGroup group;
+		for (std::vector<ParallelRunnerTask>::iterator t = tasks.begin(); t != tasks.end(); ++t)
+			group.run(*t);
+
+		runner.work();
+		group.wait();
+
+	} else
+		runner.work();
+
+	runner.finish();
+}
+
+
+/** Adapter running a ParallelRangeJob as a ParallelJob over ranges. */
+class ParallelRangeAdapter : public ParallelJob {
+public:
+	ParallelRangeAdapter(size_t count, size_t grainSize, ParallelRangeJob &job) :
+		_count(count), _grainSize(grainSize), _job(job) {
+	}
+
+	void run(size_t index) {
+		const size_t begin = index * _grainSize;
+
+		_job.run(begin, MIN(begin + _grainSize, _count));
+	}
+
+private:
+	size_t _count;
+	size_t _grainSize;
+	ParallelRangeJob &_job;
+};
+
+void parallelForRange(size_t count, ParallelRangeJob &job, size_t grainSize) {
+	if (count == 0)
+		return;
+
+	if (grainSize == 0)
+		grainSize = MAX<size_t>(count / (4 * getThreadCount()), 1);
+
+	ParallelRangeAdapter adapter(count, grainSize, job);
+	parallelFor((count + grainSize - 1) / grainSize, adapter);
+}
+
+} // End of namespace Common
@@ -0,0 +1,174 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A shared task scheduler and helpers for running work in parallel.
+ */
+
+#ifndef COMMON_PARALLEL_H
+#define COMMON_PARALLEL_H
+
+#include <cstddef>
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include <boost/noncopyable.hpp>
+
+namespace Common {
+
+/** Return the number of threads the hardware can run concurrently, at least 1. */
+size_t getHardwareThreadCount();
+
+/** Return the number of threads parallel work is spread over, at least 1.
+ *
+ *  Unless changed with setThreadCount(), this is getHardwareThreadCount().
+ */
+size_t getThreadCount();
+
+/** Set the number of threads parallel work is spread over, including the calling thread.
+ *
+ *  0 means getHardwareThreadCount(). This must not be called while tasks are running.
+ */
+void setThreadCount(size_t count);
+
+/** Stop and join the worker threads of the shared task scheduler.
+ *
+ *  This must not be called while tasks are running. Running tasks
+ *  afterwards starts the worker threads again.
+ */
+void shutdownScheduler();
+
+
+/** A piece of work that can be run by the shared task scheduler. */
+class Task {
+public:
+	virtual ~Task() { }
+
+	virtual void run() = 0;
+};
+
+/** A group of tasks that can be waited on together.
+ *
+ *  Tasks are run by a pool of worker threads shared by the whole process.
+ *  Each worker has its own queue of tasks; tasks created from within a
+ *  task go into the worker's own queue, and idle workers steal tasks from
+ *  the queues of busy ones.
+ */
+class TaskGroup : boost::noncopyable {
+public:
+	TaskGroup();
+	/** Wait for all tasks of the group to finish, ignoring their errors. */
+	~TaskGroup();
+
+	/** Queue a task to be run.
+	 *
+	 *  The group doesn't take over the task, which has to stay valid until
+	 *  it has finished running.
+	 */
+	void run(Task &task);
+
+	/** Wait for all tasks of the group to finish.
+	 *
+	 *  While waiting, the calling thread helps running queued tasks. If
+	 *  any task of the group threw an exception, the first exception is
+	 *  rethrown here.
+	 */
+	void wait();
+
+	/** Has any task of the group thrown an exception? */
+	bool hasFailed() const;
+
+private:
+	std::atomic<size_t> _pending;
+	std::atomic<bool>   _failed;
+
+	std::mutex _mutex;
+	std::condition_variable _finished;
+
+	std::exception_ptr _error;
+
+	void finishTask(std::exception_ptr error);
+
+	friend class TaskScheduler;
+};
+
+
+/** A job that can be run for many independent items in parallel. */
+class ParallelJob {
+public:
+	virtual ~ParallelJob() { }
+
+	/** Process the item with this index.
+	 *
+	 *  This is called from several threads at once, but never twice
+	 *  for the same index.
+	 */
+	virtual void run(size_t index) = 0;
+};
+
+/** A job that processes independent items in parallel, a range of indices at a time. */
+class ParallelRangeJob {
+public:
+	virtual ~ParallelRangeJob() { }
+
+	/** Process the items with the indices [begin, end). */
+	virtual void run(size_t begin, size_t end) = 0;
+};
+
+/** Call job.run() for all indices in [0, count), spread over several threads.
+ *
+ *  Items are handed out one by one to the worker threads, so that items
+ *  that take a long time to process don't stall the others. The calling
+ *  thread works on items as well, and parallelFor() only returns once all
+ *  items have been processed.
+ *
+ *  If a job throws an exception, no further items are started and the
+ *  exception of the item with the lowest index is rethrown in the calling
+ *  thread.
+ *
+ *  parallelFor() can be called from within a running job. The nested
+ *  items are run by the same shared worker threads.
+ *
+ *  @param count The number of items to process.
+ *  @param job The job to run on each item.
+ *  @param threadCount The maximum number of threads to use, including the
+ *                     calling thread. 0 means getThreadCount().
+ */
+void parallelFor(size_t count, ParallelJob &job, size_t threadCount = 0);
+
+/** Call job.run() for ranges of indices covering [0, count), spread over several threads.
+ *
+ *  This works like parallelFor(), but hands out the items in ranges of
+ *  grainSize indices, for items that are too small to be worth handing
+ *  out one by one.
+ *
+ *  @param count The number of items to process.
+ *  @param job The job to run on each range of items.
+ *  @param grainSize The number of items in each range. 0 means to pick a
+ *                   size that gives every thread a few ranges.
+ */
+void parallelForRange(size_t count, ParallelRangeJob &job, size_t grainSize = 0);
+
+} // End of namespace Common
+
+#endif // COMMON_PARALLEL_H
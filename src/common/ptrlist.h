@@ -26,6 +26,7 @@
 #define COMMON_PTRLIST_H
 
 #include <list>
+#include <utility>
 
 #include <boost/noncopyable.hpp>
 
@@ -40,10 +41,27 @@ namespace Common {
 template<typename T, class Deallocator = DeallocatorDefault>
 class PtrList : boost::noncopyable, public std::list<T *> {
 public:
+	PtrList() {
+	}
+
+	/** Take over the contents of another PtrList. */
+	PtrList(PtrList<T, Deallocator> &&right) : std::list<T *>(std::move(right)) {
+	}
+
 	~PtrList() {
 		clear();
 	}
 
+	/** Take over the contents of another PtrList. The old contents will be destroyed. */
+	PtrList &operator=(PtrList<T, Deallocator> &&right) {
+		if (this != &right) {
+			clear();
+			std::list<T *>::swap(right);
+		}
+
+		return *this;
+	}
+
 	void clear() {
 		for (typename std::list<T *>::iterator it = std::list<T *>::begin(); it != std::list<T *>::end(); ++it)
 			Deallocator::destroy(*it);
@@ -69,7 +87,7 @@ public:
 	typename std::list<T *>::iterator erase(typename std::list<T *>::iterator first,
 	                                        typename std::list<T *>::iterator last) {
 
-		for (typename std::list<T *>::iterator it = std::list<T *>::begin(); it != std::list<T *>::end(); ++it)
+		for (typename std::list<T *>::iterator it = first; it != last; ++it)
 			Deallocator::destroy(*it);
 
 		return std::list<T *>::erase(first, last);
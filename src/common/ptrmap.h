@@ -27,6 +27,7 @@
 
 #include <functional>
 #include <map>
+#include <utility>
 
 #include <boost/noncopyable.hpp>
 
@@ -41,10 +42,27 @@ namespace Common {
 template<typename Key, typename T, class Compare = std::less<Key>, class Deallocator = DeallocatorDefault>
 class PtrMap : boost::noncopyable, public std::map<Key, T *, Compare> {
 public:
+	PtrMap() {
+	}
+
+	/** Take over the contents of another PtrMap. */
+	PtrMap(PtrMap<Key, T, Compare, Deallocator> &&right) : std::map<Key, T *, Compare>(std::move(right)) {
+	}
+
 	~PtrMap() {
 		clear();
 	}
 
+	/** Take over the contents of another PtrMap. The old contents will be destroyed. */
+	PtrMap &operator=(PtrMap<Key, T, Compare, Deallocator> &&right) {
+		if (this != &right) {
+			clear();
+			std::map<Key, T *, Compare>::swap(right);
+		}
+
+		return *this;
+	}
+
 	void clear() {
 		for (typename std::map<Key, T *, Compare>::iterator it = std::map<Key, T *, Compare>::begin();
 		     it != std::map<Key, T *, Compare>::end(); ++it)
@@ -72,8 +90,7 @@ public:
 	void erase(typename std::map<Key, T *, Compare>::iterator first,
 	           typename std::map<Key, T *, Compare>::iterator last) {
 
-		for (typename std::map<Key, T *, Compare>::iterator it = std::map<Key, T *, Compare>::begin();
-		     it != std::map<Key, T *, Compare>::end(); ++it)
+		for (typename std::map<Key, T *, Compare>::iterator it = first; it != last; ++it)
 			Deallocator::destroy(it->second);
 
 		std::map<Key, T *, Compare>::erase(first, last);
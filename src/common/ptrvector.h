@@ -26,6 +26,7 @@
 #define COMMON_PTRVECTOR_H
 
 #include <vector>
+#include <utility>
 
 #include <boost/noncopyable.hpp>
 
@@ -43,10 +44,27 @@ namespace Common {
 template<typename T, class Deallocator = DeallocatorDefault>
 class PtrVector : boost::noncopyable, public std::vector<T *> {
 public:
+	PtrVector() {
+	}
+
+	/** Take over the contents of another PtrVector. */
+	PtrVector(PtrVector<T, Deallocator> &&right) : std::vector<T *>(std::move(right)) {
+	}
+
 	~PtrVector() {
 		clear();
 	}
 
+	/** Take over the contents of another PtrVector. The old contents will be destroyed. */
+	PtrVector &operator=(PtrVector<T, Deallocator> &&right) {
+		if (this != &right) {
+			clear();
+			std::vector<T *>::swap(right);
+		}
+
+		return *this;
+	}
+
 	void clear() {
 		for (typename std::vector<T *>::iterator it = std::vector<T *>::begin(); it != std::vector<T *>::end(); ++it)
 			Deallocator::destroy(*it);
@@ -67,7 +85,7 @@ public:
 	typename std::vector<T *>::iterator erase(typename std::vector<T *>::iterator first,
 	                                        typename std::vector<T *>::iterator last) {
 
-		for (typename std::vector<T *>::iterator it = std::vector<T *>::begin(); it != std::vector<T *>::end(); ++it)
+		for (typename std::vector<T *>::iterator it = first; it != last; ++it)
 			Deallocator::destroy(*it);
 
 		return std::vector<T *>::erase(first, last);
@@ -53,6 +53,7 @@
 #include "src/common/memreadstream.h"
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
+#include "src/common/byteswap.h"
 
 namespace Common {
 
@@ -172,4 +173,25 @@ SeekableSubReadStreamEndian::SeekableSubReadStreamEndian(SeekableReadStream *par
 SeekableSubReadStreamEndian::~SeekableSubReadStreamEndian() {
 }
 
+void SeekableSubReadStreamEndian::readUint16(uint16 *data, size_t count) {
+	if (read(data, count * 2) != (count * 2))
+		throw Exception(kReadError);
+
+	convertToNative16(data, count, _bigEndian);
+}
+
+void SeekableSubReadStreamEndian::readUint32(uint32 *data, size_t count) {
+	if (read(data, count * 4) != (count * 4))
+		throw Exception(kReadError);
+
+	convertToNative32(data, count, _bigEndian);
+}
+
+void SeekableSubReadStreamEndian::readUint64(uint64 *data, size_t count) {
+	if (read(data, count * 8) != (count * 8))
+		throw Exception(kReadError);
+
+	convertToNative64(data, count, _bigEndian);
+}
+
 } // End of namespace Common
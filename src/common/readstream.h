@@ -420,6 +420,13 @@ public:
 	double readIEEEDouble() {
 		return _bigEndian ? readIEEEDoubleBE() : readIEEEDoubleLE();
 	}
+
+	/** Read count unsigned 16-bit words in one go, converted into native endianness. */
+	void readUint16(uint16 *data, size_t count);
+	/** Read count unsigned 32-bit words in one go, converted into native endianness. */
+	void readUint32(uint32 *data, size_t count);
+	/** Read count unsigned 64-bit words in one go, converted into native endianness. */
+	void readUint64(uint64 *data, size_t count);
 };
 
 } // End of namespace Common
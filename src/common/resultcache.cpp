@@ -0,0 +1,273 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An on-disk cache of conversion results.
+ */
+
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "src/common/resultcache.h"
+#include "src/common/error.h"
+#include "src/common/util.h"
+#include "src/common/md5.h"
+#include "src/common/scopedptr.h"
+#include "src/common/readstream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/filepath.h"
+
+namespace Common {
+
+static const uint32 kResultID      = MKTAG('X', 'R', 'E', 'S');
+static const uint32 kResultVersion = 1;
+static const size_t kHeaderSize    = 16;
+
+static const char *kTrimStamp = "trim.stamp";
+
+/** Only trim once within this many seconds. */
+static const std::time_t kTrimInterval = 60;
+/** Temporary files older than this many seconds were left behind by a crashed process. */
+static const std::time_t kTempFileAge  = 3600;
+
+const uint64 ResultCache::kDefaultMaxSize;
+
+
+void ResultCacheKey::add(const UString &str) {
+	const size_t size = std::strlen(str.c_str());
+
+	// Prefix each part with its length, so that the parts can't run into each other
+	for (size_t i = 0; i < 8; i++)
+		_data.push_back((byte) (((uint64) size) >> (i * 8)));
+
+	_data.insert(_data.end(), str.c_str(), str.c_str() + size);
+}
+
+void ResultCacheKey::add(SeekableReadStream &stream) {
+	const size_t pos = stream.seek(0);
+
+	std::vector<byte> digest;
+	hashMD5(stream, digest);
+
+	stream.seek(pos);
+
+	_data.push_back(0xFF);
+	_data.insert(_data.end(), digest.begin(), digest.end());
+}
+
+UString ResultCacheKey::get() const {
+	std::vector<byte> digest;
+	hashMD5(_data, digest);
+
+	UString key;
+	for (std::vector<byte>::const_iterator d = digest.begin(); d != digest.end(); ++d)
+		key += UString::format("%02x", *d);
+
+	return key;
+}
+
+
+/** A stored result, for trimming. */
+struct ResultFile {
+	boost::filesystem::path path;
+
+	std::time_t time;
+	uint64 size;
+
+	bool operator<(const ResultFile &right) const {
+		return time < right.time;
+	}
+};
+
+
+ResultCache::ResultCache(const UString &directory, uint64 maxSize) :
+	_directory(directory), _maxSize(maxSize) {
+
+	try {
+		FilePath::createDirectories(_directory);
+	} catch (...) {
+	}
+
+	if (!FilePath::isDirectory(_directory))
+		throw Exception("Can't create cache directory \"%s\"", _directory.c_str());
+}
+
+ResultCache::~ResultCache() {
+}
+
+const UString &ResultCache::getDirectory() const {
+	return _directory;
+}
+
+uint64 ResultCache::getMaxSize() const {
+	return _maxSize;
+}
+
+UString ResultCache::getPath(const UString &key) const {
+	if (key.size() < 3)
+		throw Exception("Invalid cache key \"%s\"", key.c_str());
+
+	for (UString::iterator c = key.begin(); c != key.end(); ++c)
+		if (!UString::isAlNum(*c))
+			throw Exception("Invalid cache key \"%s\"", key.c_str());
+
+	// Spread the results over subdirectories, to keep the directories small
+	return _directory + "/" + key.substr(key.begin(), key.getPosition(2)) + "/" + key;
+}
+
+SeekableReadStream *ResultCache::find(const UString &key) const {
+	const UString path = getPath(key);
+
+	ScopedPtr<ReadFile> file(new ReadFile);
+	if (!file->open(path))
+		return 0;
+
+	const size_t size = file->size();
+
+	try {
+		if ((size < kHeaderSize) ||
+		    (file->readUint32BE() != kResultID) || (file->readUint32LE() != kResultVersion) ||
+		    (file->readUint64LE() != (size - kHeaderSize)))
+			return 0;
+
+	} catch (...) {
+		return 0;
+	}
+
+	// Mark the result as recently used
+	boost::system::error_code ec;
+	boost::filesystem::last_write_time(path.c_str(), std::time(0), ec);
+
+	return new SeekableSubReadStream(file.release(), kHeaderSize, size, true);
+}
+
+void ResultCache::store(const UString &key, const byte *data, size_t size) {
+	if (size > (_maxSize / 4))
+		return;
+
+	const UString path = getPath(key);
+	const UString unique = boost::filesystem::unique_path("%%%%%%%%%%%%%%%%").generic_string();
+	const UString temp   = path + "." + unique + ".tmp";
+
+	try {
+		WriteFile file;
+		if (!file.open(temp))
+			throw Exception("Can't open file \"%s\" for writing", temp.c_str());
+
+		file.writeUint32BE(kResultID);
+		file.writeUint32LE(kResultVersion);
+		file.writeUint64LE(size);
+
+		if ((size > 0) && (file.write(data, size) != size))
+			throw Exception(kWriteError);
+
+		file.close();
+
+		// Renaming is atomic: other processes see either the complete result or none at all
+		boost::system::error_code ec;
+		boost::filesystem::rename(temp.c_str(), path.c_str(), ec);
+		if (ec)
+			throw Exception("Can't rename \"%s\": %s", temp.c_str(), ec.message().c_str());
+
+	} catch (Exception &e) {
+		boost::system::error_code ec;
+		boost::filesystem::remove(temp.c_str(), ec);
+
+		e.add("Failed to store cache entry \"%s\"", key.c_str());
+		throw;
+	}
+
+	trim();
+}
+
+void ResultCache::trim(bool force) {
+	namespace fs = boost::filesystem;
+
+	boost::system::error_code ec;
+
+	const fs::path directory(_directory.c_str());
+	const fs::path stamp = directory / kTrimStamp;
+
+	const std::time_t now = std::time(0);
+
+	if (!force) {
+		const std::time_t lastTrim = fs::last_write_time(stamp, ec);
+		if (!ec && (lastTrim <= now) && ((now - lastTrim) < kTrimInterval))
+			return;
+	}
+
+	// Claim this trim for the next interval, so that other processes don't trim as well
+	try {
+		WriteFile stampFile(stamp.generic_string());
+	} catch (...) {
+	}
+
+	std::vector<ResultFile> files;
+	uint64 totalSize = 0;
+
+	/* All errors are ignored. Another process may be trimming at the same
+	 * time, so files might vanish between finding and removing them. */
+
+	fs::recursive_directory_iterator end;
+	for (fs::recursive_directory_iterator it(directory, ec); !ec && (it != end); it.increment(ec)) {
+		boost::system::error_code fileEC;
+		if (!fs::is_regular_file(it->status(fileEC)) || (it->path() == stamp))
+			continue;
+
+		ResultFile file;
+		file.path = it->path();
+		file.time = fs::last_write_time(file.path, fileEC);
+		file.size = fs::file_size(file.path, fileEC);
+		if (fileEC)
+			continue;
+
+		if (file.path.extension() == ".tmp") {
+			if ((file.time < now) && ((now - file.time) > kTempFileAge))
+				fs::remove(file.path, fileEC);
+
+			continue;
+		}
+
+		files.push_back(file);
+		totalSize += file.size;
+	}
+
+	if (totalSize <= _maxSize)
+		return;
+
+	// Remove the least recently used results, leaving some room for new ones
+	const uint64 targetSize = _maxSize - _maxSize / 10;
+
+	std::sort(files.begin(), files.end());
+	for (std::vector<ResultFile>::const_iterator f = files.begin();
+	     (f != files.end()) && (totalSize > targetSize); ++f) {
+
+		boost::system::error_code fileEC;
+		if (fs::remove(f->path, fileEC))
+			totalSize -= f->size;
+	}
+}
+
+} // End of namespace Common
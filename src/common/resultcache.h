@@ -0,0 +1,109 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An on-disk cache of conversion results.
+ */
+
+#ifndef COMMON_RESULTCACHE_H
+#define COMMON_RESULTCACHE_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+
+class SeekableReadStream;
+
+/** Builds the key of a cached result out of everything the result depends on.
+ *
+ *  Strings are added verbatim, streams by the MD5 digest of their contents.
+ *  The order in which the parts are added matters.
+ */
+class ResultCacheKey {
+public:
+	/** Add a string, for example the name of the tool or an option. */
+	void add(const UString &str);
+	/** Add the contents of a stream. The stream is rewound to its start afterwards. */
+	void add(SeekableReadStream &stream);
+
+	/** Return the key, as a string of 32 hexadecimal digits. */
+	UString get() const;
+
+private:
+	std::vector<byte> _data;
+};
+
+/** A cache of conversion results, stored in files within a directory.
+ *
+ *  Every result is stored in its own file, named after its key. Results are
+ *  written into a temporary file first, which is then renamed, so several
+ *  processes can share the same cache directory without ever seeing a
+ *  partially written result.
+ *
+ *  Finding a result updates its modification time. When the results grow
+ *  larger than the maximum size, the ones that were least recently used
+ *  are removed.
+ */
+class ResultCache : boost::noncopyable {
+public:
+	static const uint64 kDefaultMaxSize = 1024ULL * 1024ULL * 1024ULL;
+
+	/** Open a cache directory, creating it if necessary.
+	 *
+	 *  @param directory The directory the results are stored in.
+	 *  @param maxSize The size, in bytes, the results are trimmed to.
+	 */
+	ResultCache(const UString &directory, uint64 maxSize = kDefaultMaxSize);
+	~ResultCache();
+
+	const UString &getDirectory() const;
+	uint64 getMaxSize() const;
+
+	/** Open the result stored under this key, or return 0 if there is none. */
+	SeekableReadStream *find(const UString &key) const;
+
+	/** Store a result under this key, replacing any previous one.
+	 *
+	 *  Results larger than a quarter of the maximum size are not stored.
+	 */
+	void store(const UString &key, const byte *data, size_t size);
+
+	/** Remove the least recently used results until the cache fits its maximum size.
+	 *
+	 *  Unless forced, this only happens once a minute, no matter how many
+	 *  processes are storing results.
+	 */
+	void trim(bool force = false);
+
+private:
+	UString _directory;
+	uint64  _maxSize;
+
+	UString getPath(const UString &key) const;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_RESULTCACHE_H
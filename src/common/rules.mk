@@ -28,7 +28,9 @@ src_common_libcommon_la_SOURCES += \
     src/common/fallthrough.h \
     src/common/types.h \
     src/common/endianness.h \
+    src/common/byteswap.h \
     src/common/deallocator.h \
+    src/common/memoryarena.h \
     src/common/scopedptr.h \
     src/common/disposableptr.h \
     src/common/ptrlist.h \
@@ -39,8 +41,10 @@ src_common_libcommon_la_SOURCES += \
     src/common/ustring.h \
     src/common/hash.h \
     src/common/md5.h \
+    src/common/crc32.h \
     src/common/blowfish.h \
     src/common/deflate.h \
+    src/common/gzip.h \
     src/common/lzma.h \
     src/common/base64.h \
     src/common/error.h \
@@ -59,17 +63,26 @@ src_common_libcommon_la_SOURCES += \
     src/common/readfile.h \
     src/common/writefile.h \
     src/common/filepath.h \
+    src/common/resultcache.h \
     src/common/zipfile.h \
     src/common/binsearch.h \
     src/common/cli.h \
+    src/common/parallel.h \
+    src/common/boundedqueue.h \
+    src/common/trace.h \
     $(EMPTY)
 
 src_common_libcommon_la_SOURCES += \
+    src/common/byteswap.cpp \
+    src/common/memoryarena.cpp \
     src/common/maths.cpp \
     src/common/ustring.cpp \
     src/common/md5.cpp \
+    src/common/crc32.cpp \
     src/common/blowfish.cpp \
     src/common/deflate.cpp \
+    src/common/gzip.cpp \
+    src/common/inflate.cpp \
     src/common/lzma.cpp \
     src/common/base64.cpp \
     src/common/error.cpp \
@@ -87,6 +100,9 @@ src_common_libcommon_la_SOURCES += \
     src/common/readfile.cpp \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
+    src/common/resultcache.cpp \
     src/common/zipfile.cpp \
     src/common/cli.cpp \
+    src/common/parallel.cpp \
+    src/common/trace.cpp \
     $(EMPTY)
@@ -51,7 +51,7 @@
 #ifndef COMMON_SCOPEDPTR_H
 #define COMMON_SCOPEDPTR_H
 
-#include <boost/noncopyable.hpp>
+#include <utility>
 
 #include "src/common/system.h"
 #include "src/common/types.h"
@@ -64,9 +64,12 @@ namespace Common {
  *
  *  Manages the pointer and allows for automatic deletion throw a
  *  deallocator template parameter.
+ *
+ *  A scoped pointer can't be copied, but its ownership can be moved
+ *  into another scoped pointer.
  */
 template<typename T, class Deallocator>
-class ScopedPtrBase : boost::noncopyable {
+class ScopedPtrBase {
 public:
 	typedef T ValueType;
 	typedef T *PointerType;
@@ -74,6 +77,19 @@ public:
 
 	explicit ScopedPtrBase(PointerType o = 0) : _pointer(o) {}
 
+	ScopedPtrBase(ScopedPtrBase<T, Deallocator> &&right) : _pointer(right.release()) {}
+
+	ScopedPtrBase(const ScopedPtrBase<T, Deallocator> &) = delete;
+	ScopedPtrBase &operator=(const ScopedPtrBase<T, Deallocator> &) = delete;
+
+	/** Take over the pointer managed by another ScopedPtr. The old object will be destroyed. */
+	ScopedPtrBase &operator=(ScopedPtrBase<T, Deallocator> &&right) {
+		if (this != &right)
+			reset(right.release());
+
+		return *this;
+	}
+
 	/** Implicit conversion operator to bool for convenience, to make
 	 *  checks like "if (scopedPtr) ..." possible.
 	 */
@@ -123,6 +139,14 @@ public:
 		ScopedPtrBase<T, Deallocator>(o) {
 	}
 
+	ScopedPtr(ScopedPtr<T, Deallocator> &&right) : ScopedPtrBase<T, Deallocator>(std::move(right)) {
+	}
+
+	ScopedPtr &operator=(ScopedPtr<T, Deallocator> &&right) {
+		ScopedPtrBase<T, Deallocator>::operator=(std::move(right));
+		return *this;
+	}
+
 	typename ScopedPtrBase<T, Deallocator>::ReferenceType operator*() const {
 		return *ScopedPtrBase<T, Deallocator>::get();
 	}
@@ -140,6 +164,14 @@ public:
 		ScopedPtrBase<T, Deallocator>(o) {
 	}
 
+	ScopedArray(ScopedArray<T, Deallocator> &&right) : ScopedPtrBase<T, Deallocator>(std::move(right)) {
+	}
+
+	ScopedArray &operator=(ScopedArray<T, Deallocator> &&right) {
+		ScopedPtrBase<T, Deallocator>::operator=(std::move(right));
+		return *this;
+	}
+
 	typename ScopedPtrBase<T, Deallocator>::ReferenceType operator[](size_t i) const {
 		return ScopedPtrBase<T, Deallocator>::get()[i];
 	}
@@ -348,12 +348,20 @@ template<> UString composeString(bool value) {
 	return value ? "true" : "false";
 }
 
-template<> UString composeString(float value) {
-	return UString::format("%f", value);
+template<> UString composeString(double value) {
+	/* Print into a buffer on the stack, big enough for any double in
+	 * fixed-point notation, instead of going through UString::format(). */
+	char buf[512];
+	const int length = std::snprintf(buf, sizeof(buf), "%lf", value);
+
+	if ((length < 0) || ((size_t) length >= sizeof(buf)))
+		throw Exception("Buffer overrun in composeString()");
+
+	return UString(buf, length);
 }
 
-template<> UString composeString(double value) {
-	return UString::format("%lf", value);
+template<> UString composeString(float value) {
+	return composeString((double) value);
 }
 
 template UString composeString<  signed char     >(  signed char      value);
@@ -0,0 +1,163 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Lightweight tracing of time spans, written as Chrome trace events.
+ */
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "src/common/trace.h"
+#include "src/common/ustring.h"
+#include "src/common/ptrvector.h"
+#include "src/common/writestream.h"
+
+namespace Common {
+
+/** A recorded span. */
+struct TraceEvent {
+	const char *category;
+	const char *name;
+
+	uint64 start;
+	uint64 duration;
+};
+
+/** All spans recorded by one thread. */
+struct TraceThread {
+	size_t id;
+
+	std::vector<TraceEvent> events;
+};
+
+std::atomic<bool> Tracer::_enabled(false);
+
+/** Protects the list of threads and the start time. */
+static std::mutex traceMutex;
+
+static PtrVector<TraceThread> traceThreads;
+
+static std::chrono::steady_clock::time_point traceStart;
+static bool traceStarted = false;
+
+/** The buffer of the current thread. Owned by traceThreads. */
+static thread_local TraceThread *traceThread = 0;
+
+void Tracer::start() {
+	std::lock_guard<std::mutex> lock(traceMutex);
+
+	if (!traceStarted) {
+		traceStart   = std::chrono::steady_clock::now();
+		traceStarted = true;
+	}
+
+	_enabled.store(true);
+}
+
+void Tracer::stop() {
+	_enabled.store(false);
+}
+
+void Tracer::clear() {
+	std::lock_guard<std::mutex> lock(traceMutex);
+
+	for (PtrVector<TraceThread>::iterator t = traceThreads.begin(); t != traceThreads.end(); ++t)
+		(*t)->events.clear();
+}
+
+size_t Tracer::getSpanCount() {
+	std::lock_guard<std::mutex> lock(traceMutex);
+
+	size_t count = 0;
+	for (PtrVector<TraceThread>::const_iterator t = traceThreads.begin(); t != traceThreads.end(); ++t)
+		count += (*t)->events.size();
+
+	return count;
+}
+
+uint64 Tracer::getTime() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - traceStart).count();
+}
+
+void Tracer::addSpan(const char *category, const char *name, uint64 start, uint64 end) {
+	if (!traceThread) {
+		std::lock_guard<std::mutex> lock(traceMutex);
+
+		traceThreads.push_back(new TraceThread);
+		traceThreads.back()->id = traceThreads.size() - 1;
+
+		traceThread = traceThreads.back();
+	}
+
+	TraceEvent event;
+	event.category = category;
+	event.name     = name;
+	event.start    = start;
+	event.duration = (end > start) ? (end - start) : 0;
+
+	traceThread->events.push_back(event);
+}
+
+/** Write a string as a JSON string literal. */
+static void writeJSONString(WriteStream &stream, const char *str) {
+	stream.writeByte('"');
+
+	for (; *str; str++) {
+		if ((*str == '"') || (*str == '\\'))
+			stream.writeByte('\\');
+
+		if ((byte) *str >= 0x20)
+			stream.writeByte(*str);
+	}
+
+	stream.writeByte('"');
+}
+
+void Tracer::write(WriteStream &stream) {
+	std::lock_guard<std::mutex> lock(traceMutex);
+
+	stream.writeString("{\"traceEvents\":[\n");
+
+	bool first = true;
+	for (PtrVector<TraceThread>::const_iterator t = traceThreads.begin(); t != traceThreads.end(); ++t) {
+		if (!first)
+			stream.writeString(",\n");
+		first = false;
+
+		// Metadata event, naming the thread
+		stream.writeString(UString::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+		                                   "\"args\":{\"name\":\"Thread %u\"}}", (uint) (*t)->id, (uint) (*t)->id));
+
+		for (std::vector<TraceEvent>::const_iterator e = (*t)->events.begin(); e != (*t)->events.end(); ++e) {
+			stream.writeString(",\n{\"name\":");
+			writeJSONString(stream, e->name);
+			stream.writeString(",\"cat\":");
+			writeJSONString(stream, e->category);
+			stream.writeString(UString::format(",\"ph\":\"X\",\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 ",\"pid\":1,\"tid\":%u}",
+			                                   e->start, e->duration, (uint) (*t)->id));
+		}
+	}
+
+	stream.writeString("\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+} // End of namespace Common
@@ -0,0 +1,124 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Lightweight tracing of time spans, written as Chrome trace events.
+ */
+
+#ifndef COMMON_TRACE_H
+#define COMMON_TRACE_H
+
+#include <atomic>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+class WriteStream;
+
+/** Records spans of time spent in named parts of the code.
+ *
+ *  Tracing is disabled by default. While it is disabled, a TraceSpan costs
+ *  a single check of a flag, without reading the clock or allocating memory.
+ *
+ *  Spans are recorded into a separate buffer for each thread, so recording
+ *  them from several threads at once doesn't need any locking. The recorded
+ *  spans can be written in the JSON format of Chrome's trace-event profiling
+ *  tool, which can be opened in chrome://tracing or Perfetto.
+ */
+class Tracer {
+public:
+	/** Start recording trace spans. */
+	static void start();
+	/** Stop recording trace spans. Already recorded spans are kept. */
+	static void stop();
+
+	/** Are trace spans currently being recorded? */
+	static bool isEnabled() {
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	/** Throw away all recorded spans.
+	 *
+	 *  Must not be called while other threads are still recording spans.
+	 */
+	static void clear();
+
+	/** Return the number of recorded spans, over all threads. */
+	static size_t getSpanCount();
+
+	/** Write all recorded spans as a Chrome trace-event JSON file.
+	 *
+	 *  Must not be called while other threads are still recording spans.
+	 */
+	static void write(WriteStream &stream);
+
+	/** Return the current time, in microseconds since tracing was first started. */
+	static uint64 getTime();
+
+	/** Record a finished span of the current thread.
+	 *
+	 *  Category and name are not copied, they need to stay valid until
+	 *  the spans have been written. Usually, they are string literals.
+	 */
+	static void addSpan(const char *category, const char *name, uint64 start, uint64 end);
+
+private:
+	static std::atomic<bool> _enabled;
+};
+
+/** A span of time, recorded from its construction until its destruction.
+ *
+ *  Use the XOREOS_TRACE_SPAN() macro to trace the rest of the current scope.
+ */
+class TraceSpan : boost::noncopyable {
+public:
+	TraceSpan(const char *category, const char *name) : _category(category), _name(name), _active(false), _start(0) {
+		if (Tracer::isEnabled()) {
+			_active = true;
+			_start  = Tracer::getTime();
+		}
+	}
+
+	~TraceSpan() {
+		if (_active)
+			Tracer::addSpan(_category, _name, _start, Tracer::getTime());
+	}
+
+private:
+	const char *_category;
+	const char *_name;
+
+	bool _active;
+	uint64 _start;
+};
+
+} // End of namespace Common
+
+#define XOREOS_TRACE_SPAN_CONCAT2(x, y) x ## y
+#define XOREOS_TRACE_SPAN_CONCAT(x, y) XOREOS_TRACE_SPAN_CONCAT2(x, y)
+
+/** Trace the time spent in the rest of the current scope, under a category and a name. */
+#define XOREOS_TRACE_SPAN(category, name) \
+	Common::TraceSpan XOREOS_TRACE_SPAN_CONCAT(xoreosTraceSpan, __LINE__)(category, name)
+
+#endif // COMMON_TRACE_H
@@ -35,20 +35,27 @@ namespace Common {
 UString::UString() : _size(0) {
 }
 
-UString::UString(const UString &str) {
-	*this = str;
+UString::UString(const UString &str) : _string(str._string), _size(str._size) {
 }
 
-UString::UString(const std::string &str) {
-	*this = str;
+UString::UString(UString &&str) : _string(std::move(str._string)), _size(str._size) {
+	str.clear();
 }
 
-UString::UString(const char *str) {
-	*this = str;
+UString::UString(const std::string &str) : _string(str) {
+	recalculateSize();
 }
 
-UString::UString(const char *str, size_t n) {
-	*this = std::string(str, n);
+UString::UString(std::string &&str) : _string(std::move(str)) {
+	recalculateSize();
+}
+
+UString::UString(const char *str) : _string(str) {
+	recalculateSize();
+}
+
+UString::UString(const char *str, size_t n) : _string(str, n) {
+	recalculateSize();
 }
 
 UString::UString(uint32 c, size_t n) : _size(0) {
@@ -71,6 +78,17 @@ UString &UString::operator=(const UString &str) {
 	return *this;
 }
 
+UString &UString::operator=(UString &&str) {
+	if (this != &str) {
+		_string = std::move(str._string);
+		_size   = str._size;
+
+		str.clear();
+	}
+
+	return *this;
+}
+
 UString &UString::operator=(const std::string &str) {
 	_string = str;
 
@@ -79,8 +97,18 @@ UString &UString::operator=(const std::string &str) {
 	return *this;
 }
 
+UString &UString::operator=(std::string &&str) {
+	_string = std::move(str);
+
+	recalculateSize();
+
+	return *this;
+}
+
 UString &UString::operator=(const char *str) {
-	*this = std::string(str);
+	_string = str;
+
+	recalculateSize();
 
 	return *this;
 }
@@ -236,6 +264,10 @@ void UString::clear() {
 	_size = 0;
 }
 
+void UString::reserve(size_t n) {
+	_string.reserve(n);
+}
+
 size_t UString::size() const {
 	return _size;
 }
@@ -720,6 +752,17 @@ UString UString::format(const char *s, ...) {
 	return UString(buf);
 }
 
+UString &UString::appendFormat(const char *s, ...) {
+	char buf[STRINGBUFLEN];
+	va_list va;
+
+	va_start(va, s);
+	vsnprintf(buf, STRINGBUFLEN, s, va);
+	va_end(va);
+
+	return *this += buf;
+}
+
 size_t UString::split(const UString &text, uint32 delim, std::vector<UString> &texts) {
 	size_t length = 0;
 
@@ -28,6 +28,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <utility>
 
 #include <boost/functional/hash.hpp>
 
@@ -67,8 +68,12 @@ public:
 	UString();
 	/** Copy constructor. */
 	UString(const UString &str);
+	/** Move constructor. */
+	UString(UString &&str);
 	/** Construct UString from an UTF-8 string. */
 	UString(const std::string &str);
+	/** Construct UString from an UTF-8 string, taking over its data. */
+	UString(std::string &&str);
 	/** Construct UString from an UTF-8 string. */
 	UString(const char *str);
 	/** Construct UString from the first n bytes of an UTF-8 string. */
@@ -80,7 +85,9 @@ public:
 	~UString();
 
 	UString &operator=(const UString &str);
+	UString &operator=(UString &&str);
 	UString &operator=(const std::string &str);
+	UString &operator=(std::string &&str);
 	UString &operator=(const char *str);
 
 	bool operator==(const UString &str) const;
@@ -113,6 +120,9 @@ public:
 	/** Clear the string's contents. */
 	void clear();
 
+	/** Reserve enough memory to hold n bytes of UTF-8 data without reallocating. */
+	void reserve(size_t n);
+
 	/** Return the size of the string, in characters. */
 	size_t size() const;
 
@@ -180,6 +190,9 @@ public:
 	/** Print formatted data into an UString object, similar to sprintf(). */
 	static UString format(const char *s, ...) GCC_PRINTF(1, 2);
 
+	/** Print formatted data to the end of this string, similar to sprintf(). */
+	UString &appendFormat(const char *s, ...) GCC_PRINTF(2, 3);
+
 	static size_t split(const UString &text, uint32 delim, std::vector<UString> &texts);
 
 	static void splitTextTokens(const UString &text, std::vector<UString> &tokens);
@@ -206,6 +219,22 @@ private:
 };
 
 
+// Concatenation operators appending to a temporary, to avoid copying it
+static inline UString operator+(UString &&left, const UString &right) {
+	left += right;
+	return std::move(left);
+}
+
+static inline UString operator+(UString &&left, const char *right) {
+	left += right;
+	return std::move(left);
+}
+
+static inline UString operator+(UString &&left, uint32 right) {
+	left += right;
+	return std::move(left);
+}
+
 // Right-binding concatenation operators
 static inline UString operator+(const std::string &left, const UString &right) {
 	return UString(left) + right;
@@ -31,6 +31,7 @@
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
 #include "src/common/deflate.h"
+#include "src/common/crc32.h"
 
 namespace Common {
 
@@ -77,9 +78,15 @@ void ZipFile::load(SeekableReadStream &zip) {
 		 File  file;
 		IFile iFile;
 
-		zip.skip(20);
+		zip.skip(6); // Versions and flags
 
-		iFile.size = zip.readUint32LE();
+		iFile.method = zip.readUint16LE();
+
+		zip.skip(4); // Modification time and date
+
+		iFile.crc      = zip.readUint32LE();
+		iFile.compSize = zip.readUint32LE();
+		iFile.size     = zip.readUint32LE();
 
 		uint16 nameLength    = zip.readUint16LE();
 		uint16 extraLength   = zip.readUint16LE();
@@ -129,23 +136,18 @@ const ZipFile::IFile &ZipFile::getIFile(uint32 index) const {
 	return _iFiles[index];
 }
 
-void ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file,
-		uint16 &compMethod, uint32 &compSize, uint32 &realSize) const {
-
+void ZipFile::seekToFileData(SeekableReadStream &zip, const IFile &file) const {
 	zip.seek(file.offset);
 
 	uint32 tag = zip.readUint32LE();
 	if (tag != 0x04034B50)
 		throw Exception("Unknown ZIP record %08X", tag);
 
-	zip.skip(4);
-
-	compMethod = zip.readUint16LE();
-
-	zip.skip(8);
+	/* The local header repeats the information of the central directory, but
+	 * the sizes and CRC might be deferred into a data descriptor after the
+	 * file's data. So we only take the lengths of the variable fields. */
 
-	compSize = zip.readUint32LE();
-	realSize = zip.readUint32LE();
+	zip.skip(22);
 
 	uint16 nameLength  = zip.readUint16LE();
 	uint16 extraLength = zip.readUint16LE();
@@ -158,34 +160,63 @@ size_t ZipFile::getFileSize(uint32 index) const {
 	return getIFile(index).size;
 }
 
+void ZipFile::getFileStorage(uint32 index, uint64 &offset, uint32 &compSize, bool &compressed) const {
+	const IFile &file = getIFile(index);
+
+	offset     = file.offset;
+	compSize   = file.compSize;
+	compressed = (file.method != 0);
+}
+
 SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	const IFile &file = getIFile(index);
 
-	uint16 compMethod;
-	uint32 compSize;
-	uint32 realSize;
+	if (tryNoCopy && (file.method == 0)) {
+		seekToFileData(*_zip, file);
+
+		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + file.compSize);
+	}
 
-	getFileProperties(*_zip, file, compMethod, compSize, realSize);
+	return unpackFile(index, getPackedFile(index));
+}
 
-	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+MemoryReadStream *ZipFile::getPackedFile(uint32 index) const {
+	const IFile &file = getIFile(index);
 
-	return decompressFile(*_zip, compMethod, compSize, realSize);
+	seekToFileData(*_zip, file);
+
+	return _zip->readStream(file.compSize);
 }
 
-SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 method,
-		uint32 compSize, uint32 realSize) {
+SeekableReadStream *ZipFile::unpackFile(uint32 index, MemoryReadStream *packed) const {
+	ScopedPtr<MemoryReadStream> packedStream(packed);
+
+	const IFile &file = getIFile(index);
+
+	if (file.method == 0) {
+		// Uncompressed. We can hand out the packed data directly
+
+		if (packedStream->size() != file.size)
+			throw Exception("Uncompressed file size mismatch (%u != %u)", (uint)packedStream->size(), file.size);
 
-	if (method == 0) {
-		// Uncompressed
+		const uint32 crc = calcCRC32(packedStream->getData(), packedStream->size());
+		if (crc != file.crc)
+			throw Exception("Checksum mismatch (%08X != %08X)", crc, file.crc);
 
-		return zip.readStream(compSize);
+		return packedStream.release();
 	}
 
-	if (method != 8)
-		throw Exception("Unhandled Zip compression %d", method);
+	if (file.method != 8)
+		throw Exception("Unhandled Zip compression %d", file.method);
+
+	ScopedArray<byte> data(decompressDeflate(packedStream->getData(), packedStream->size(),
+	                                         file.size, kWindowBitsMaxRaw));
+
+	const uint32 crc = calcCRC32(data.get(), file.size);
+	if (crc != file.crc)
+		throw Exception("Checksum mismatch (%08X != %08X)", crc, file.crc);
 
-	return decompressDeflate(zip, compSize, realSize, kWindowBitsMaxRaw);
+	return new MemoryReadStream(data.release(), file.size, true);
 }
 
 } // End of namespace Common
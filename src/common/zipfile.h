@@ -37,6 +37,7 @@
 namespace Common {
 
 class SeekableReadStream;
+class MemoryReadStream;
 
 /** A class encapsulating ZIP file access. */
 class ZipFile : boost::noncopyable {
@@ -58,14 +59,40 @@ public:
 	/** Return the size of a file. */
 	size_t getFileSize(uint32 index) const;
 
-	/** Return a stream of the file's contents. */
+	/** Return where the file's local header is, and how the file is stored.
+	 *
+	 *  @param index The index of the file.
+	 *  @param offset The offset of the file's local header within the ZIP.
+	 *  @param compSize The size of the file's data within the ZIP.
+	 *  @param compressed Whether the file is compressed.
+	 */
+	void getFileStorage(uint32 index, uint64 &offset, uint32 &compSize, bool &compressed) const;
+
+	/** Return a stream of the file's contents.
+	 *
+	 *  The contents are checked against the CRC-32 stored in the ZIP, except
+	 *  for uncompressed files returned without copying (tryNoCopy).
+	 */
 	SeekableReadStream *getFile(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return the packed (compressed) contents of a file, as stored in the ZIP. */
+	MemoryReadStream *getPackedFile(uint32 index) const;
+
+	/** Decompress and verify the contents returned by getPackedFile().
+	 *
+	 *  Takes over the packed stream. Unlike all other methods, this may be
+	 *  called from several threads at once.
+	 */
+	SeekableReadStream *unpackFile(uint32 index, MemoryReadStream *packed) const;
+
 private:
 	/** Internal file information. */
 	struct IFile {
-		uint32 offset; ///< The offset of the file within the ZIP.
-		uint32 size;   ///< The file's size.
+		uint32 offset;   ///< The offset of the file's local header within the ZIP.
+		uint16 method;   ///< The compression method.
+		uint32 compSize; ///< The file's compressed size.
+		uint32 size;     ///< The file's size.
+		uint32 crc;      ///< The CRC-32 of the file's contents.
 	};
 
 	typedef std::vector<IFile> IFileList;
@@ -80,12 +107,10 @@ private:
 
 	void load(SeekableReadStream &zip);
 
-	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 method,
-			uint32 compSize, uint32 realSize);
-
 	const IFile &getIFile(uint32 index) const;
-	void getFileProperties(SeekableReadStream &zip, const IFile &file,
-			uint16 &compMethod, uint32 &compSize, uint32 &realSize) const;
+
+	/** Seek to the start of the file's data, behind its local header. */
+	void seekToFileData(SeekableReadStream &zip, const IFile &file) const;
 };
 
 } // End of namespace Common
@@ -24,10 +24,12 @@
 
 #include <cstring>
 #include <cstdio>
+#include <vector>
 
 #include "src/version/version.h"
 
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/ustring.h"
 #include "src/common/util.h"
 #include "src/common/strutil.h"
@@ -38,11 +40,15 @@
 #include "src/common/encoding.h"
 #include "src/common/platform.h"
 #include "src/common/cli.h"
+#include "src/common/streamtokenizer.h"
+#include "src/common/parallel.h"
 
 #include "src/aurora/aurorafile.h"
 #include "src/aurora/2dafile.h"
 #include "src/aurora/gdafile.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 enum Format {
@@ -51,14 +57,26 @@ enum Format {
 	kFormatCSV
 };
 
+/** A group of input files, to be converted into one output file. */
+struct Group {
+	Common::UString outFile;
+	std::vector<Common::UString> files;
+};
+
+typedef std::vector<Group> Groups;
+
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      std::vector<Common::UString> &files, Common::UString &outFile, Format &format);
+                      std::vector<Common::UString> &files, Common::UString &outFile, Format &format,
+                      Common::UString &groupFile);
+
+void readGroups(const Common::UString &groupFile, Groups &groups);
 
-void write2DA(Aurora::TwoDAFile &twoDA, Format format);
+void write2DA(Aurora::TwoDAFile &twoDA, Common::WriteStream &out, Format format);
 
 Aurora::TwoDAFile *get2DAGDA(Common::SeekableReadStream *stream);
-void convert2DA(const Common::UString &file, const Common::UString &outFile, Format format);
+Aurora::TwoDAFile *read2DA(Common::PtrVector<Common::SeekableReadStream> &streams);
 void convert2DA(const std::vector<Common::UString> &files, const Common::UString &outFile, Format format);
+void convert2DA(const Groups &groups, Format format);
 
 int main(int argc, char **argv) {
 	initPlatform();
@@ -71,22 +89,29 @@ int main(int argc, char **argv) {
 
 		int returnValue = 1;
 		std::vector<Common::UString> files;
-		Common::UString outFile;
+		Common::UString outFile, groupFile;
 
-		if (!parseCommandLine(args, returnValue, files, outFile, format))
+		if (!parseCommandLine(args, returnValue, files, outFile, format, groupFile))
 			return returnValue;
 
-		convert2DA(files, outFile, format);
+		if (!groupFile.empty()) {
+			Groups groups;
+			readGroups(groupFile, groups);
+
+			convert2DA(groups, format);
+		} else
+			convert2DA(files, outFile, format);
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       std::vector<Common::UString> &files, Common::UString &outFile,
-                      Format &format) {
+                      Format &format, Common::UString &groupFile) {
 	using Common::CLI::NoOption;
 	using Common::CLI::kContinueParsing;
 	using Common::CLI::Parser;
@@ -96,11 +121,13 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	using Common::CLI::makeEndArgs;
 	using Common::CLI::makeAssigners;
 
-	NoOption filesOpt(false, new ValGetter<std::vector<Common::UString> &>(files, "files[...]"));
+	NoOption filesOpt(true, new ValGetter<std::vector<Common::UString> &>(files, "files[...]"));
 	Parser parser(argv[0], "BioWare 2DA/GDA to 2DA/CSV converter\n",
 	              "If several files are given, they must all be GDA and use the same\n"
 	              "column layout. They will be pasted together and printed as one GDA.\n\n"
-	              "If no output file is given, the output is written to stdout.",
+	              "If no output file is given, the output is written to stdout.\n\n"
+	              "A group file converts many of these groups at once. Each line\n"
+	              "names an output file, followed by the files of its group.",
 	              returnValue,
 	              makeEndArgs(&filesOpt));
 
@@ -108,6 +135,9 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	parser.addOption("output", 'o', "Write the output to this file",
 	                 kContinueParsing,
 	                 new ValGetter<Common::UString &>(outFile, "file"));
+	parser.addOption("groups", 'g', "Convert all the groups listed in this file",
+	                 kContinueParsing,
+	                 new ValGetter<Common::UString &>(groupFile, "file"));
 	parser.addSpace();
 	parser.addOption("2da", "Convert to ASCII 2DA (default)",
 	                 kContinueParsing,
@@ -119,24 +149,66 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	parser.addOption("cvs", "Convert to CSV", kContinueParsing,
 	                 makeAssigners(new ValAssigner<Format>(kFormatCSV,
 	                 format)));
-	return parser.process(argv);
+
+	addThreadCountOption(parser);
+
+	if (!parser.process(argv))
+		return false;
+
+	// We need either a group file or files, but not both
+	if (groupFile.empty() == files.empty()) {
+		parser.usage();
+		returnValue = 1;
+
+		return false;
+	}
+
+	return true;
+}
+
+void readGroups(const Common::UString &groupFile, Groups &groups) {
+	Common::ReadFile file(groupFile);
+
+	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleIgnoreAll);
+
+	tokenize.addSeparator(' ');
+	tokenize.addSeparator('\t');
+	tokenize.addQuote('\"');
+	tokenize.addChunkEnd('\n');
+	tokenize.addIgnore('\r');
+
+	std::vector<Common::UString> tokens;
+	while (!file.eos()) {
+		tokens.clear();
+		tokenize.getTokens(file, tokens);
+		tokenize.nextChunk(file);
+
+		// Skip empty lines and comments
+		if (tokens.empty() || tokens[0].beginsWith("#"))
+			continue;
+
+		if (tokens.size() < 2)
+			throw Common::Exception("Group \"%s\" in \"%s\" has no input files",
+			                        tokens[0].c_str(), groupFile.c_str());
+
+		groups.push_back(Group());
+
+		groups.back().outFile = std::move(tokens[0]);
+		groups.back().files.assign(tokens.begin() + 1, tokens.end());
+	}
 }
 
 static const uint32 k2DAID     = MKTAG('2', 'D', 'A', ' ');
 static const uint32 k2DAIDTab  = MKTAG('2', 'D', 'A', '\t');
 static const uint32 kGFFID     = MKTAG('G', 'F', 'F', ' ');
 
-void write2DA(Aurora::TwoDAFile &twoDA, const Common::UString &outFile, Format format) {
-	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
-
+void write2DA(Aurora::TwoDAFile &twoDA, Common::WriteStream &out, Format format) {
 	if      (format == kFormat2DA)
-		twoDA.writeASCII(*out);
+		twoDA.writeASCII(out);
 	else if (format == kFormat2DAb)
-		twoDA.writeBinary(*out);
+		twoDA.writeBinary(out);
 	else
-		twoDA.writeCSV(*out);
-
-	out->flush();
+		twoDA.writeCSV(out);
 }
 
 Aurora::TwoDAFile *get2DAGDA(Common::SeekableReadStream *stream) {
@@ -157,24 +229,66 @@ Aurora::TwoDAFile *get2DAGDA(Common::SeekableReadStream *stream) {
 	throw Common::Exception("Not a 2DA or GDA file");
 }
 
-void convert2DA(const Common::UString &file, const Common::UString &outFile, Format format) {
-	Common::ScopedPtr<Aurora::TwoDAFile> twoDA(get2DAGDA(new Common::ReadFile(file)));
+Aurora::TwoDAFile *read2DA(Common::PtrVector<Common::SeekableReadStream> &streams) {
+	// Hand the streams over to the parsers
+	std::vector<Common::SeekableReadStream *> gdas;
+	gdas.swap(streams);
+
+	if (gdas.size() == 1)
+		return get2DAGDA(gdas[0]);
+
+	// Several GDAs are parsed in parallel and merged
+	Aurora::GDAFile gda(gdas);
 
-	write2DA(*twoDA, outFile, format);
+	return new Aurora::TwoDAFile(gda);
 }
 
 void convert2DA(const std::vector<Common::UString> &files, const Common::UString &outFile, Format format) {
-	if (files.size() == 1) {
-		convert2DA(files[0], outFile, format);
-		return;
+	Common::PtrVector<Common::SeekableReadStream> streams;
+	for (std::vector<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f)
+		streams.push_back(Archives::openInputFile(*f));
+
+	ConversionCache cache("convert2da");
+	cache.addOption(Common::composeString((uint) format));
+	for (Common::PtrVector<Common::SeekableReadStream>::iterator s = streams.begin(); s != streams.end(); ++s)
+		cache.addInput(**s);
+
+	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
+
+	if (!cache.restore(*out)) {
+		Common::ScopedPtr<Aurora::TwoDAFile> twoDA(read2DA(streams));
+
+		write2DA(*twoDA, cache.record(*out), format);
+		cache.store();
+	}
+
+	finishFileOrStdOut(*out);
+}
+
+/** Convert all groups of a group file, in parallel. */
+class ConvertGroupJob : public Common::ParallelJob {
+public:
+	ConvertGroupJob(const Groups &groups, Format format) : _groups(groups), _format(format) {
 	}
 
-	Aurora::GDAFile gda(new Common::ReadFile(files[0]));
+	void run(size_t index) {
+		const Group &group = _groups[index];
 
-	for (size_t i = 1; i < files.size(); i++)
-		gda.add(new Common::ReadFile(files[i]));
+		try {
+			convert2DA(group.files, group.outFile, _format);
+		} catch (Common::Exception &e) {
+			e.add("Failed converting \"%s\"", group.outFile.c_str());
+			throw;
+		}
+	}
+
+private:
+	const Groups &_groups;
+	Format _format;
+};
 
-	Aurora::TwoDAFile twoDA(gda);
+void convert2DA(const Groups &groups, Format format) {
+	ConvertGroupJob job(groups, format);
 
-	write2DA(twoDA, outFile, format);
+	Common::parallelFor(groups.size(), job);
 }
@@ -63,6 +63,7 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
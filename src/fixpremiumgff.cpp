@@ -37,12 +37,14 @@
 #include "src/common/platform.h"
 #include "src/common/filepath.h"
 #include "src/common/memreadstream.h"
-#include "src/common/readfile.h"
+#include "src/common/readstream.h"
 #include "src/common/writefile.h"
 #include "src/common/cli.h"
 
 #include "src/aurora/types.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
@@ -68,6 +70,7 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
@@ -112,7 +115,12 @@ void fixPremiumGFF(Common::UString &inFile, Common::UString &outFile, Common::US
 	if (id.size() > 4)
 		throw Common::Exception("\"%s\" is not a valid GFF id", id.c_str());
 
-	Common::ScopedPtr<Common::SeekableReadStream> in(Common::ReadFile::readIntoMemory(inFile));
+	// Read the whole input into memory, since the output might overwrite it
+	Common::ScopedPtr<Common::SeekableReadStream> in;
+	{
+		Common::ScopedPtr<Common::SeekableReadStream> file(Archives::openInputFile(inFile));
+		in.reset(file->readStream(file->size()));
+	}
 
 	const uint32 inID      = in->readUint32BE();
 	const uint32 inVersion = in->readUint32BE();
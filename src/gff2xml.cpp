@@ -33,7 +33,7 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/platform.h"
-#include "src/common/readfile.h"
+#include "src/common/readstream.h"
 #include "src/common/writefile.h"
 #include "src/common/stdoutstream.h"
 #include "src/common/encoding.h"
@@ -44,6 +44,8 @@
 
 #include "src/xml/gffdumper.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 typedef std::map<uint32, Common::Encoding> EncodingOverrides;
@@ -51,12 +53,13 @@ typedef std::map<uint32, Common::Encoding> EncodingOverrides;
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Common::UString &inFile, Common::UString &outFile,
                       Common::Encoding &encoding, Aurora::GameID &game,
-                      EncodingOverrides &encOverrides, bool &nwnPremium, bool &sacFile);
+                      EncodingOverrides &encOverrides, bool &nwnPremium, bool &sacFile,
+                      bool &gzip);
 
 bool parseEncodingOverride(const Common::UString &arg, EncodingOverrides &encOverrides);
 
-void dumpGFF(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding, bool nwnPremium,
-             bool sacFile);
+void dumpGFF(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding,
+             Aurora::GameID game, const EncodingOverrides &encOverrides, bool nwnPremium, bool sacFile, bool gzip);
 
 int main(int argc, char **argv) {
 	initPlatform();
@@ -72,11 +75,12 @@ int main(int argc, char **argv) {
 
 		bool nwnPremium = false;
 		bool sacFile = false;
+		bool gzip = false;
 
 		int returnValue = 1;
 		Common::UString inFile, outFile;
 
-		if (!parseCommandLine(args, returnValue, inFile, outFile, encoding, game, encOverrides, nwnPremium, sacFile))
+		if (!parseCommandLine(args, returnValue, inFile, outFile, encoding, game, encOverrides, nwnPremium, sacFile, gzip))
 			return returnValue;
 
 		LangMan.declareLanguages(game);
@@ -84,11 +88,12 @@ int main(int argc, char **argv) {
 		for (EncodingOverrides::const_iterator e = encOverrides.begin(); e != encOverrides.end(); ++e)
 			LangMan.overrideEncoding(e->first, e->second);
 
-		dumpGFF(inFile, outFile, encoding, nwnPremium, sacFile);
+		dumpGFF(inFile, outFile, encoding, game, encOverrides, nwnPremium, sacFile, gzip);
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
@@ -119,7 +124,8 @@ bool parseEncodingOverride(const Common::UString &arg, EncodingOverrides &encOve
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Common::UString &inFile, Common::UString &outFile,
                       Common::Encoding &encoding, Aurora::GameID &game,
-                      EncodingOverrides &encOverrides, bool &nwnPremium, bool &sacFile) {
+                      EncodingOverrides &encOverrides, bool &nwnPremium, bool &sacFile,
+                      bool &gzip) {
 	using Common::CLI::NoOption;
 	using Common::CLI::kContinueParsing;
 	using Common::CLI::Parser;
@@ -142,7 +148,9 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	              "for a specific language ID. The string has to be of the form n=encoding,\n"
 	              "for example 0=cp-1252 to override the encoding of the (ungendered) language\n"
 	              "ID 0 to be Windows codepage 1252. To override several encodings, specify\n"
-	              "the --encoding parameter multiple times.\n",
+	              "the --encoding parameter multiple times.\n\n"
+	              "If the output file name ends in .gz, or --gzip is given, the XML is\n"
+	              "gzip compressed.\n",
 	              returnValue,
 	              makeEndArgs(&inFileOpt, &outFileOpt));
 
@@ -177,23 +185,40 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	                 new Callback<EncodingOverrides &>("str", parseEncodingOverride, encOverrides));
 	parser.addOption("sac", "Read the extra sac file header", kContinueParsing,
 	                 makeAssigners(new ValAssigner<bool>(true, sacFile)));
+	parser.addSpace();
+	parser.addOption("gzip", "Compress the output with gzip", kContinueParsing,
+	                 makeAssigners(new ValAssigner<bool>(true, gzip)));
+
+	addThreadCountOption(parser);
 
 	return parser.process(argv);
 }
 
 
-void dumpGFF(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding, bool nwnPremium,
-             bool sacFile) {
+void dumpGFF(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding,
+             Aurora::GameID game, const EncodingOverrides &encOverrides, bool nwnPremium, bool sacFile, bool gzip) {
 
-	Common::ScopedPtr<Common::SeekableReadStream> gff(new Common::ReadFile(inFile));
+	Common::ScopedPtr<Common::SeekableReadStream> gff(Archives::openInputFile(inFile));
+
+	ConversionCache cache("gff2xml");
+	cache.addOption(Common::composeString((int) encoding));
+	cache.addOption(Common::composeString((int) game));
+	for (EncodingOverrides::const_iterator e = encOverrides.begin(); e != encOverrides.end(); ++e)
+		cache.addOption(Common::composeString(e->first) + "=" + Common::composeString((int) e->second));
+	cache.addOption(Common::composeString(nwnPremium));
+	cache.addOption(Common::composeString(sacFile));
+	cache.addInput(*gff);
 
 	Common::ScopedPtr<XML::GFFDumper> dumper(XML::GFFDumper::identify(*gff, nwnPremium, sacFile));
 
-	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
+	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile, gzip));
 
-	dumper->dump(*out, gff.release(), encoding, nwnPremium);
+	if (!cache.restore(*out)) {
+		dumper->dump(cache.record(*out), gff.release(), encoding, nwnPremium);
+		cache.store();
+	}
 
-	out->flush();
+	finishFileOrStdOut(*out);
 
 	if (!outFile.empty())
 		status("Converted \"%s\" to \"%s\"", inFile.c_str(), outFile.c_str());
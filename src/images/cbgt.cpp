@@ -28,6 +28,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/2dafile.h"
 #include "src/aurora/smallfile.h"
@@ -60,6 +61,8 @@ CBGT::~CBGT() {
 }
 
 void CBGT::load(ReadContext &ctx) {
+	XOREOS_TRACE_SPAN("image", "CBGT::load");
+
 	readPalettes(ctx);
 	readPaletteIndices(ctx);
 	readCells(ctx);
@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/smallfile.h"
 
@@ -61,6 +62,8 @@ CDPTH::~CDPTH() {
 }
 
 void CDPTH::load(ReadContext &ctx) {
+	XOREOS_TRACE_SPAN("image", "CDPTH::load");
+
 	readCells(ctx);
 
 	checkConsistency(ctx);
@@ -26,6 +26,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/trace.h"
 
 #include "src/images/dds.h"
 #include "src/images/util.h"
@@ -66,6 +67,8 @@ bool DDS::detect(Common::SeekableReadStream &dds) {
 }
 
 void DDS::load(Common::SeekableReadStream &dds) {
+	XOREOS_TRACE_SPAN("image", "DDS::load");
+
 	try {
 
 		DataType dataType;
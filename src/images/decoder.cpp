@@ -28,6 +28,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/trace.h"
 
 #include "src/images/decoder.h"
 #include "src/images/util.h"
@@ -164,6 +165,8 @@ void Decoder::decompress(MipMap &out, const MipMap &in, PixelFormat format) {
 }
 
 void Decoder::decompress() {
+	XOREOS_TRACE_SPAN("image", "Decoder::decompress");
+
 	if (!isCompressed())
 		return;
 
@@ -193,6 +196,21 @@ void Decoder::dumpTGA(const Common::UString &fileName) const {
 	Images::dumpTGA(fileName, decoder);
 }
 
+void Decoder::dumpTGA(Common::WriteStream &stream) const {
+	if (_mipMaps.size() < 1)
+		throw Common::Exception("Image contains no mip maps");
+
+	if (!isCompressed()) {
+		Images::dumpTGA(stream, *this);
+		return;
+	}
+
+	Decoder decoder(*this);
+	decoder.decompress();
+
+	Images::dumpTGA(stream, decoder);
+}
+
 void Decoder::flipHorizontally() {
 	decompress();
 
@@ -37,6 +37,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class WriteStream;
 	class UString;
 }
 
@@ -87,6 +88,8 @@ public:
 
 	/** Dump the image into a TGA. */
 	void dumpTGA(const Common::UString &fileName) const;
+	/** Dump the image as a TGA into a stream. */
+	void dumpTGA(Common::WriteStream &stream) const;
 
 	/** Flip the whole image horizontally. */
 	void flipHorizontally();
@@ -24,10 +24,10 @@
 
 #include <cstdio>
 
-#include "src/common/scopedptr.h"
 #include "src/common/error.h"
 #include "src/common/ustring.h"
 #include "src/common/writefile.h"
+#include "src/common/trace.h"
 
 #include "src/images/decoder.h"
 
@@ -85,25 +85,21 @@ static void writePixel(Common::WriteStream &file, const byte *&data, PixelFormat
 
 }
 
-static Common::WriteStream *openTGA(const Common::UString &fileName, int width, int height) {
-	Common::WriteFile *file = new Common::WriteFile(fileName);
+static void writeTGAHeader(Common::WriteStream &stream, int width, int height) {
+	stream.writeByte(0);     // ID Length
+	stream.writeByte(0);     // Palette size
+	stream.writeByte(2);     // Unmapped RGB
+	stream.writeUint32LE(0); // Color map
+	stream.writeByte(0);     // Color map
+	stream.writeUint16LE(0); // X
+	stream.writeUint16LE(0); // Y
 
-	file->writeByte(0);     // ID Length
-	file->writeByte(0);     // Palette size
-	file->writeByte(2);     // Unmapped RGB
-	file->writeUint32LE(0); // Color map
-	file->writeByte(0);     // Color map
-	file->writeUint16LE(0); // X
-	file->writeUint16LE(0); // Y
+	stream.writeUint16LE(width);
+	stream.writeUint16LE(height);
 
-	file->writeUint16LE(width);
-	file->writeUint16LE(height);
+	stream.writeByte(32); // Pixel depths
 
-	file->writeByte(32); // Pixel depths
-
-	file->writeByte(0);
-
-	return file;
+	stream.writeByte(0);
 }
 
 static void writeMipMap(Common::WriteStream &stream, const Decoder::MipMap &mipMap, PixelFormat format) {
@@ -114,12 +110,12 @@ static void writeMipMap(Common::WriteStream &stream, const Decoder::MipMap &mipM
 		writePixel(stream, data, format);
 }
 
-void dumpTGA(const Common::UString &fileName, const Decoder &image) {
+static void getTGASize(const Decoder &image, int32 &width, int32 &height) {
 	if ((image.getLayerCount() < 1) || (image.getMipMapCount() < 1))
 		throw Common::Exception("No image");
 
-	int32 width  = image.getMipMap(0, 0).width;
-	int32 height = 0;
+	width  = image.getMipMap(0, 0).width;
+	height = 0;
 
 	for (size_t i = 0; i < image.getLayerCount(); i++) {
 		const Decoder::MipMap &mipMap = image.getMipMap(0, i);
@@ -129,13 +125,30 @@ void dumpTGA(const Common::UString &fileName, const Decoder &image) {
 
 		height += mipMap.height;
 	}
+}
+
+void dumpTGA(Common::WriteStream &stream, const Decoder &image) {
+	XOREOS_TRACE_SPAN("image", "dumpTGA");
+
+	int32 width, height;
+	getTGASize(image, width, height);
 
-	Common::ScopedPtr<Common::WriteStream> file(openTGA(fileName, width, height));
+	writeTGAHeader(stream, width, height);
 
 	for (size_t i = 0; i < image.getLayerCount(); i++)
-		writeMipMap(*file, image.getMipMap(0, i), image.getFormat());
+		writeMipMap(stream, image.getMipMap(0, i), image.getFormat());
+}
+
+void dumpTGA(const Common::UString &fileName, const Decoder &image) {
+	// Make sure we can dump the image before creating the file
+	int32 width, height;
+	getTGASize(image, width, height);
+
+	Common::WriteFile file(fileName);
+
+	dumpTGA(file, image);
 
-	file->flush();
+	file.flush();
 }
 
 } // End of namespace Images
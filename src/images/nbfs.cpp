@@ -28,6 +28,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/trace.h"
 
 #include "src/images/nbfs.h"
 
@@ -53,6 +54,7 @@ static uint32 guessDimension(uint32 size, uint32 dim1) {
 
 void NBFS::load(Common::SeekableReadStream &nbfs, Common::SeekableReadStream &nbfp,
                 uint32 width, uint32 height) {
+	XOREOS_TRACE_SPAN("image", "NBFS::load");
 
 	try {
 
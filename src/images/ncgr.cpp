@@ -52,6 +52,7 @@
 #include "src/common/strutil.h"
 #include "src/common/readstream.h"
 #include "src/common/error.h"
+#include "src/common/trace.h"
 
 #include "src/images/ncgr.h"
 #include "src/images/nclr.h"
@@ -95,6 +96,7 @@ NCGR::NCGR(Common::SeekableReadStream &ncgr, Common::SeekableReadStream &nclr) {
 
 void NCGR::load(const std::vector<Common::SeekableReadStream *> &ncgrs, uint32 width, uint32 height,
                 Common::SeekableReadStream &nclr) {
+	XOREOS_TRACE_SPAN("image", "NCGR::load");
 
 	if ((width * height) != ncgrs.size())
 		throw Common::Exception("%u NCGRs won't fill a grid of %ux%u", (uint)ncgrs.size(), width, height);
@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/readstream.h"
 #include "src/common/error.h"
+#include "src/common/trace.h"
 
 #include "src/images/sbm.h"
 #include "src/images/util.h"
@@ -43,6 +44,8 @@ SBM::~SBM() {
 }
 
 void SBM::load(Common::SeekableReadStream &sbm, bool deswizzle) {
+	XOREOS_TRACE_SPAN("image", "SBM::load");
+
 	try {
 
 		readData(sbm, deswizzle);
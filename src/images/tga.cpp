@@ -52,6 +52,7 @@
 #include "src/common/util.h"
 #include "src/common/readstream.h"
 #include "src/common/error.h"
+#include "src/common/trace.h"
 
 #include "src/images/util.h"
 #include "src/images/tga.h"
@@ -66,6 +67,8 @@ TGA::~TGA() {
 }
 
 void TGA::load(Common::SeekableReadStream &tga) {
+	XOREOS_TRACE_SPAN("image", "TGA::load");
+
 	try {
 
 		ImageType imageType;
@@ -28,6 +28,7 @@
 #include "src/common/maths.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/trace.h"
 
 #include "src/images/tpc.h"
 #include "src/images/util.h"
@@ -47,6 +48,8 @@ TPC::~TPC() {
 }
 
 void TPC::load(Common::SeekableReadStream &tpc) {
+	XOREOS_TRACE_SPAN("image", "TPC::load");
+
 	try {
 
 		byte encoding;
@@ -249,19 +252,6 @@ bool TPC::checkCubeMap(uint32 &width, uint32 &height) {
 	return true;
 }
 
-void TPC::deSwizzle(byte *dst, const byte *src, uint32 width, uint32 height) {
-	for (uint32 y = 0; y < height; y++) {
-		for (uint32 x = 0; x < width; x++) {
-			const uint32 offset = deSwizzleOffset(x, y, width, height) * 4;
-
-			*dst++ = src[offset + 0];
-			*dst++ = src[offset + 1];
-			*dst++ = src[offset + 2];
-			*dst++ = src[offset + 3];
-		}
-	}
-}
-
 void TPC::readData(Common::SeekableReadStream &tpc, byte encoding) {
 	for (MipMaps::iterator mipMap = _mipMaps.begin(); mipMap != _mipMaps.end(); ++mipMap) {
 
@@ -277,7 +267,7 @@ void TPC::readData(Common::SeekableReadStream &tpc, byte encoding) {
 			if (tpc.read(&tmp[0], (*mipMap)->size) != (*mipMap)->size)
 				throw Common::Exception(Common::kReadError);
 
-			deSwizzle((*mipMap)->data.get(), &tmp[0], (*mipMap)->width, (*mipMap)->height);
+			deSwizzle((*mipMap)->data.get(), &tmp[0], (*mipMap)->width, (*mipMap)->height, 4);
 
 		} else {
 			if (tpc.read((*mipMap)->data.get(), (*mipMap)->size) != (*mipMap)->size)
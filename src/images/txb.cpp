@@ -25,6 +25,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/trace.h"
 
 #include "src/images/txb.h"
 #include "src/images/util.h"
@@ -47,6 +48,8 @@ TXB::~TXB() {
 }
 
 void TXB::load(Common::SeekableReadStream &txb) {
+	XOREOS_TRACE_SPAN("image", "TXB::load");
+
 	try {
 
 		byte encoding;
@@ -159,17 +162,6 @@ void TXB::readHeader(Common::SeekableReadStream &txb, byte &encoding) {
 		throw Common::Exception("Couldn't read any mip maps");
 }
 
-void TXB::deSwizzle(byte *dst, const byte *src, uint32 width, uint32 height, uint8 bpp) {
-	for (uint32 y = 0; y < height; y++) {
-		for (uint32 x = 0; x < width; x++) {
-			const uint32 offset = deSwizzleOffset(x, y, width, height) * bpp;
-
-			for (uint8 p = 0; p < bpp; p++)
-				*dst++ = src[offset + p];
-		}
-	}
-}
-
 void TXB::readData(Common::SeekableReadStream &txb, byte encoding) {
 	for (MipMaps::iterator mipMap = _mipMaps.begin(); mipMap != _mipMaps.end(); ++mipMap) {
 		const bool needDeSwizzle = (encoding == kEncodingBGRA) || (encoding == kEncodingGray);
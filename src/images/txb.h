@@ -62,8 +62,6 @@ private:
 	void readHeader(Common::SeekableReadStream &txb, byte &encoding);
 	void readData(Common::SeekableReadStream &txb, byte encoding);
 	void readTXIData(Common::SeekableReadStream &txb);
-
-	static void deSwizzle(byte *dst, const byte *src, uint32 width, uint32 height, uint8 bpp);
 };
 
 } // End of namespace Images
@@ -233,6 +233,18 @@ static inline uint32 deSwizzleOffset(uint32 x, uint32 y, uint32 width, uint32 he
 	return offset;
 }
 
+/** De-"swizzle" a whole texture with power-of-two dimensions into a linear pixel layout. */
+static inline void deSwizzle(byte *dst, const byte *src, uint32 width, uint32 height, uint8 bpp) {
+	for (uint32 y = 0; y < height; y++) {
+		for (uint32 x = 0; x < width; x++) {
+			const uint32 offset = deSwizzleOffset(x, y, width, height) * bpp;
+
+			for (uint8 p = 0; p < bpp; p++)
+				*dst++ = src[offset + p];
+		}
+	}
+}
+
 } // End of namespace Images
 
 #endif // IMAGES_UTIL_H
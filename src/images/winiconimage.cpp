@@ -26,6 +26,7 @@
 #include "src/common/util.h"
 #include "src/common/readstream.h"
 #include "src/common/error.h"
+#include "src/common/trace.h"
 
 #include "src/images/winiconimage.h"
 
@@ -39,6 +40,8 @@ WinIconImage::~WinIconImage() {
 }
 
 void WinIconImage::load(Common::SeekableReadStream &cur) {
+	XOREOS_TRACE_SPAN("image", "WinIconImage::load");
+
 	try {
 
 		readHeader(cur);
@@ -27,6 +27,7 @@
 #include "src/common/strutil.h"
 #include "src/common/readstream.h"
 #include "src/common/error.h"
+#include "src/common/trace.h"
 
 #include "src/images/xoreositex.h"
 
@@ -43,6 +44,8 @@ XEOSITEX::~XEOSITEX() {
 }
 
 void XEOSITEX::load(Common::SeekableReadStream &xeositex) {
+	XOREOS_TRACE_SPAN("image", "XEOSITEX::load");
+
 	try {
 
 		readHeader(xeositex);
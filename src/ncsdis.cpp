@@ -33,9 +33,10 @@
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
 #include "src/common/util.h"
+#include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/platform.h"
-#include "src/common/readfile.h"
+#include "src/common/readstream.h"
 #include "src/common/writefile.h"
 #include "src/common/stdoutstream.h"
 #include "src/common/cli.h"
@@ -44,6 +45,8 @@
 
 #include "src/nwscript/disassembler.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 enum Command {
@@ -85,6 +88,7 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
@@ -146,14 +150,11 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	return parser.process(argv);
 }
 
-void disNCS(const Common::UString &inFile, const Common::UString &outFile,
-            Aurora::GameID &game, Command &command, bool printStack, bool printControlTypes) {
-
-	Common::ScopedPtr<Common::SeekableReadStream> ncs(new Common::ReadFile(inFile));
-	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
+static void disassemble(Common::SeekableReadStream &ncs, Common::WriteStream &out,
+                        Aurora::GameID game, Command command, bool printStack, bool printControlTypes) {
 
 	status("Disassembling script...");
-	NWScript::Disassembler disassembler(*ncs, game);
+	NWScript::Disassembler disassembler(ncs, game);
 
 	if (game != Aurora::kGameIDUnknown) {
 		try {
@@ -173,25 +174,44 @@ void disNCS(const Common::UString &inFile, const Common::UString &outFile,
 
 	switch (command) {
 		case kCommandListing:
-			disassembler.createListing(*out, printStack);
+			disassembler.createListing(out, printStack);
 			break;
 
 		case kCommandAssembly:
-			disassembler.createAssembly(*out, printStack);
+			disassembler.createAssembly(out, printStack);
 			break;
 
 		case kCommandDot:
-			disassembler.createDot(*out, printControlTypes);
+			disassembler.createDot(out, printControlTypes);
 			break;
 
 		case kCommandNone:
-			disassembler.createListing(*out, printStack);
+			disassembler.createListing(out, printStack);
 			break;
 		default:
 			throw Common::Exception("Invalid command %u", (uint)command);
 	}
+}
+
+void disNCS(const Common::UString &inFile, const Common::UString &outFile,
+            Aurora::GameID &game, Command &command, bool printStack, bool printControlTypes) {
+
+	Common::ScopedPtr<Common::SeekableReadStream> ncs(Archives::openInputFile(inFile));
+	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
+
+	ConversionCache cache("ncsdis");
+	cache.addOption(Common::composeString((int) game));
+	cache.addOption(Common::composeString((uint) command));
+	cache.addOption(Common::composeString(printStack));
+	cache.addOption(Common::composeString(printControlTypes));
+	cache.addInput(*ncs);
+
+	if (!cache.restore(*out)) {
+		disassemble(*ncs, cache.record(*out), game, command, printStack, printControlTypes);
+		cache.store();
+	}
 
-	out->flush();
+	finishFileOrStdOut(*out);
 
 	if (!outFile.empty())
 		status("Disassembled \"%s\" into \"%s\"", inFile.c_str(), outFile.c_str());
@@ -33,6 +33,7 @@ src_gff2xml_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_gff2xml_LDADD = \
+    src/archives/libarchives.la \
     src/xml/libxml.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
@@ -46,6 +47,7 @@ src_tlk2xml_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_tlk2xml_LDADD = \
+    src/archives/libarchives.la \
     src/xml/libxml.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
@@ -59,6 +61,7 @@ src_ssf2xml_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_ssf2xml_LDADD = \
+    src/archives/libarchives.la \
     src/xml/libxml.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
@@ -98,6 +101,7 @@ src_convert2da_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_convert2da_LDADD = \
+    src/archives/libarchives.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
     src/version/libversion.la \
@@ -110,6 +114,7 @@ src_fixpremiumgff_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_fixpremiumgff_LDADD = \
+    src/archives/libarchives.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
     src/version/libversion.la \
@@ -175,6 +180,7 @@ src_unnds_SOURCES = \
     $(EMPTY)
 src_unnds_LDADD = \
     src/archives/libarchives.la \
+    src/images/libimages.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
     src/version/libversion.la \
@@ -226,6 +232,7 @@ src_xoreostex2tga_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_xoreostex2tga_LDADD = \
+    src/archives/libarchives.la \
     src/images/libimages.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
@@ -291,6 +298,7 @@ src_ncsdis_SOURCES = \
     src/util.cpp \
     $(EMPTY)
 src_ncsdis_LDADD = \
+    src/archives/libarchives.la \
     src/nwscript/libnwscript.la \
     src/aurora/libaurora.la \
     src/common/libcommon.la \
@@ -310,6 +318,19 @@ src_erf_LDADD = \
     $(LDADD) \
     $(EMPTY)
 
+bin_PROGRAMS += src/arcdiff
+src_arcdiff_SOURCES = \
+    src/arcdiff.cpp \
+    src/util.cpp \
+    $(EMPTY)
+src_arcdiff_LDADD = \
+    src/archives/libarchives.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD) \
+    $(EMPTY)
+
 bin_PROGRAMS += src/untws
 src_untws_SOURCES = \
     src/untws.cpp \
@@ -33,19 +33,21 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/platform.h"
-#include "src/common/readfile.h"
+#include "src/common/readstream.h"
 #include "src/common/writefile.h"
 #include "src/common/stdoutstream.h"
 #include "src/common/cli.h"
 
 #include "src/xml/ssfdumper.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Common::UString &inFile, Common::UString &outFile);
+                      Common::UString &inFile, Common::UString &outFile, bool &gzip);
 
-void dumpSSF(const Common::UString &inFile, const Common::UString &outFile);
+void dumpSSF(const Common::UString &inFile, const Common::UString &outFile, bool gzip);
 
 int main(int argc, char **argv) {
 	initPlatform();
@@ -56,40 +58,52 @@ int main(int argc, char **argv) {
 
 		int returnValue = 1;
 		Common::UString inFile, outFile;
+		bool gzip = false;
 
-		if (!parseCommandLine(args, returnValue, inFile, outFile))
+		if (!parseCommandLine(args, returnValue, inFile, outFile, gzip))
 			return returnValue;
 
-		dumpSSF(inFile, outFile);
+		dumpSSF(inFile, outFile, gzip);
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Common::UString &inFile, Common::UString &outFile) {
+                      Common::UString &inFile, Common::UString &outFile, bool &gzip) {
 	using Common::CLI::Parser;
 	using Common::CLI::ValGetter;
 	using Common::CLI::NoOption;
 	using Common::CLI::makeEndArgs;
+	using Common::CLI::makeAssigners;
+	using Common::CLI::ValAssigner;
+	using Common::CLI::kContinueParsing;
 	NoOption inFileOpt(false, new ValGetter<Common::UString &>(inFile, "input file"));
 	NoOption outFileOpt(true, new ValGetter<Common::UString &>(outFile, "output file"));
 	Parser parser(argv[0], "BioWare SSF to XML converter",
-	              "\nIf no output file is given, the output is written to stdout.",
+	              "\nIf no output file is given, the output is written to stdout.\n\n"
+	              "If the output file name ends in .gz, or --gzip is given, the XML is\n"
+	              "gzip compressed.",
 	              returnValue, makeEndArgs(&inFileOpt, &outFileOpt));
 
+	parser.addOption("gzip", "Compress the output with gzip", kContinueParsing,
+	                 makeAssigners(new ValAssigner<bool>(true, gzip)));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
 
-void dumpSSF(const Common::UString &inFile, const Common::UString &outFile) {
-	Common::ReadFile ssf(inFile);
-	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
+void dumpSSF(const Common::UString &inFile, const Common::UString &outFile, bool gzip) {
+	Common::ScopedPtr<Common::SeekableReadStream> ssf(Archives::openInputFile(inFile));
+	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile, gzip));
 
-	XML::SSFDumper::dump(*out, ssf);
+	XML::SSFDumper::dump(*out, *ssf);
 
-	out->flush();
+	finishFileOrStdOut(*out);
 
 	if (!outFile.empty())
 		status("Converted \"%s\" to \"%s\"", inFile.c_str(), outFile.c_str());
@@ -33,7 +33,7 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/platform.h"
-#include "src/common/readfile.h"
+#include "src/common/readstream.h"
 #include "src/common/writefile.h"
 #include "src/common/stdoutstream.h"
 #include "src/common/encoding.h"
@@ -44,13 +44,16 @@
 
 #include "src/xml/tlkdumper.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Common::UString &inFile, Common::UString &outFile,
-                      Common::Encoding &encoding, Aurora::GameID &game);
+                      Common::Encoding &encoding, Aurora::GameID &game, bool &gzip);
 
-void dumpTLK(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding);
+void dumpTLK(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding,
+             Aurora::GameID game, bool gzip);
 
 int main(int argc, char **argv) {
 	initPlatform();
@@ -64,23 +67,25 @@ int main(int argc, char **argv) {
 
 		int returnValue = 1;
 		Common::UString inFile, outFile;
+		bool gzip = false;
 
-		if (!parseCommandLine(args, returnValue, inFile, outFile, encoding, game))
+		if (!parseCommandLine(args, returnValue, inFile, outFile, encoding, game, gzip))
 			return returnValue;
 
 		LangMan.declareLanguages(game);
 
-		dumpTLK(inFile, outFile, encoding);
+		dumpTLK(inFile, outFile, encoding, game, gzip);
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Common::UString &inFile, Common::UString &outFile,
-                      Common::Encoding &encoding, Aurora::GameID &game) {
+                      Common::Encoding &encoding, Aurora::GameID &game, bool &gzip) {
 	using Common::CLI::NoOption;
 	using Common::CLI::kContinueParsing;
 	using Common::CLI::Parser;
@@ -98,7 +103,9 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	              "There is no way to autodetect the encoding of strings in TLK files,\n"
 	              "so an encoding must be specified. Alternatively, the game this TLK\n"
 	              "is from can be given, and an appropriate encoding according to that\n"
-	              "game and the language ID found in the TLK is used.\n",
+	              "game and the language ID found in the TLK is used.\n\n"
+	              "If the output file name ends in .gz, or --gzip is given, the XML is\n"
+	              "gzip compressed.\n",
 	              returnValue,
 	              makeEndArgs(&inFileOpt, &outFileOpt));
 
@@ -159,16 +166,32 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	                 makeAssigners(new ValAssigner<Encoding>(Common::kEncodingInvalid, encoding),
 	                 new ValAssigner<GameID>(Aurora::kGameIDDragonAge2, game)));
 
+	parser.addSpace();
+	parser.addOption("gzip", "Compress the output with gzip", kContinueParsing,
+	                 makeAssigners(new ValAssigner<bool>(true, gzip)));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
 
-void dumpTLK(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding) {
-	Common::ScopedPtr<Common::SeekableReadStream> tlk(new Common::ReadFile(inFile));
-	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile));
+void dumpTLK(const Common::UString &inFile, const Common::UString &outFile, Common::Encoding encoding,
+             Aurora::GameID game, bool gzip) {
+	Common::ScopedPtr<Common::SeekableReadStream> tlk(Archives::openInputFile(inFile));
 
-	XML::TLKDumper::dump(*out, tlk.release(), encoding);
+	ConversionCache cache("tlk2xml");
+	cache.addOption(Common::composeString((int) encoding));
+	cache.addOption(Common::composeString((int) game));
+	cache.addInput(*tlk);
+
+	Common::ScopedPtr<Common::WriteStream> out(openFileOrStdOut(outFile, gzip));
+
+	if (!cache.restore(*out)) {
+		XML::TLKDumper::dump(cache.record(*out), tlk.release(), encoding);
+		cache.store();
+	}
 
-	out->flush();
+	finishFileOrStdOut(*out);
 
 	if (!outFile.empty())
 		status("Converted \"%s\" to \"%s\"", inFile.c_str(), outFile.c_str());
@@ -22,6 +22,11 @@
  *  Tool to pack TheWitcherSave archives.
  */
 
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <set>
+
 #include "src/common/error.h"
 #include "src/common/platform.h"
 #include "src/common/cli.h"
@@ -29,13 +34,20 @@
 #include "src/common/writefile.h"
 #include "src/common/filepath.h"
 
+#include "src/aurora/thewitchersavefile.h"
 #include "src/aurora/thewitchersavewriter.h"
 #include "src/aurora/util.h"
 
 #include "src/util.h"
 
+typedef std::map<Common::UString, Common::UString, Common::UString::iless> FileMap;
+
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue, Common::UString &area,
-                      Common::UString &archive, std::set<Common::UString> &files);
+                      Common::UString &archive, std::set<Common::UString> &files, Common::UString &patch);
+
+void packFiles(Aurora::TheWitcherSaveWriter &twsWriter, const std::set<Common::UString> &files);
+void patchSave(Aurora::TheWitcherSaveWriter &twsWriter, const Aurora::TheWitcherSaveFile &save,
+               const std::set<Common::UString> &files);
 
 int main(int argc, char **argv) {
 	initPlatform();
@@ -45,41 +57,109 @@ int main(int argc, char **argv) {
 		Common::Platform::getParameters(argc, argv, args);
 
 		int returnValue = 1;
-		Common::UString area, archive;
+		Common::UString area, archive, patch;
 		std::set<Common::UString> files;
 
-		if (!parseCommandLine(args, returnValue, area, archive, files))
+		if (!parseCommandLine(args, returnValue, area, archive, files, patch))
 			return returnValue;
 
-		Common::WriteFile writeFile(archive);
+		if (patch.empty()) {
+			Common::WriteFile writeFile(archive);
+
+			Aurora::TheWitcherSaveWriter twsWriter(area, writeFile);
+			packFiles(twsWriter, files);
+			twsWriter.finish();
 
-		size_t i = 1;
-		Aurora::TheWitcherSaveWriter twsWriter(area, writeFile);
-		for (std::set<Common::UString>::const_iterator iter = files.begin(); iter != files.end(); ++iter, ++i) {
-			std::printf("Packing %u/%u: %s ... ", (uint)i, (uint)files.size(), iter->c_str());
-			std::fflush(stdout);
+		} else {
+			if (Common::FilePath::canonicalize(patch) == Common::FilePath::canonicalize(archive))
+				throw Common::Exception("Can't patch \"%s\" in-place", patch.c_str());
 
-			Common::UString file = *iter;
-			Common::ReadFile fileStream(file);
+			const Aurora::TheWitcherSaveFile save(new Common::ReadFile(patch));
 
-			twsWriter.add(
-					TypeMan.setFileType(file, Aurora::kFileTypeNone),
-					TypeMan.getFileType(file),
-					fileStream
-			);
-			std::printf("Done\n");
+			Common::WriteFile writeFile(archive);
+
+			Aurora::TheWitcherSaveWriter twsWriter(save.getAreaName(), writeFile);
+			patchSave(twsWriter, save, files);
+			twsWriter.finish();
 		}
 
-		twsWriter.finish();
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
+static Aurora::FileType addFile(Aurora::TheWitcherSaveWriter &twsWriter, const Common::UString &file,
+                                size_t i, size_t count) {
+
+	std::printf("Packing %u/%u: %s ... ", (uint)i, (uint)count, file.c_str());
+	std::fflush(stdout);
+
+	Common::ReadFile fileStream(file);
+
+	Common::UString name = file;
+	const Aurora::FileType type = TypeMan.splitFileType(name);
+
+	twsWriter.add(name, type, fileStream);
+
+	std::printf("Done\n");
+	return type;
+}
+
+void packFiles(Aurora::TheWitcherSaveWriter &twsWriter, const std::set<Common::UString> &files) {
+	size_t i = 1;
+	for (std::set<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f, ++i)
+		addFile(twsWriter, *f, i, files.size());
+}
+
+void patchSave(Aurora::TheWitcherSaveWriter &twsWriter, const Aurora::TheWitcherSaveFile &save,
+               const std::set<Common::UString> &files) {
+
+	// Map resource names (with extension) onto the files replacing them
+	FileMap replacements;
+	for (std::set<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f) {
+		Common::UString name = *f;
+		name.replaceAll('\\', '/');
+
+		replacements.insert(std::make_pair(name, *f));
+	}
+
+	size_t i = 1;
+
+	/* Walk through the original save, in order. Unchanged resources are copied
+	 * verbatim, in runs, while changed resources are read from their files. */
+	const Aurora::Archive::ResourceList &resources = save.getResources();
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		Common::UString name = r->name;
+		TypeMan.appendFileType(name, r->type);
+
+		FileMap::iterator replacement = replacements.find(name);
+		if (replacement == replacements.end()) {
+			twsWriter.add(save, r->index);
+			continue;
+		}
+
+		addFile(twsWriter, replacement->second, i++, files.size());
+		replacements.erase(replacement);
+	}
+
+	// Files not found in the original save are appended
+	for (FileMap::const_iterator f = replacements.begin(); f != replacements.end(); ++f)
+		addFile(twsWriter, f->second, i++, files.size());
+}
+
+static bool isPatchMode(const std::vector<Common::UString> &argv) {
+	for (size_t i = 1; i < argv.size(); i++)
+		if ((argv[i] == "-p") || (argv[i] == "--patch"))
+			return true;
+
+	return false;
+}
+
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue, Common::UString &area,
-                      Common::UString &archive, std::set<Common::UString> &files) {
+                      Common::UString &archive, std::set<Common::UString> &files, Common::UString &patch) {
 	using Common::CLI::NoOption;
 	using Common::CLI::kContinueParsing;
 	using Common::CLI::Parser;
@@ -90,14 +170,27 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	using Common::CLI::makeAssigners;
 	using Aurora::GameID;
 
-	NoOption areaOpt(false, new ValGetter<Common::UString &>(area, "area"));
+	/* In patch mode, there is no area argument. The parser needs to know its
+	 * positional arguments up front, so that the usage and the argument count
+	 * checks match the mode. */
+	const bool patchMode = isPatchMode(argv);
+
 	NoOption archiveOpt(false, new ValGetter<Common::UString &>(archive, "output archive"));
 	NoOption filesOpt(true, new ValGetter<std::set<Common::UString> &>(files, "files[...]"));
 
+	std::vector<NoOption> endArgs = makeEndArgs(&archiveOpt, &filesOpt);
+	if (!patchMode)
+		endArgs.insert(endArgs.begin(), NoOption(false, new ValGetter<Common::UString &>(area, "area")));
+
 	Parser parser(argv[0], "CDProjektRed TheWitcherSave archive packer",
-	              "",
+	              "In patch mode, the area argument is omitted and the area is taken\n"
+	              "from the source save. Resources of the source save are copied as-is,\n"
+	              "unless one of the given files replaces them.\n",
 	              returnValue,
-	              makeEndArgs(&areaOpt, &archiveOpt, &filesOpt));
+	              endArgs);
+
+	parser.addOption("patch", 'p', "Patch this existing save instead of packing a new one",
+	                 kContinueParsing, new ValGetter<Common::UString &>(patch, "save"));
 
 	return parser.process(argv);
 }
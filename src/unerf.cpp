@@ -52,14 +52,16 @@ enum Command {
 	kCommandListVerbose     ,
 	kCommandExtract         ,
 	kCommandExtractDir      ,
+	kCommandTest            ,
 	kCommandMAX
 };
 
-const char *kCommandChar[kCommandMAX] = { "i", "l", "v", "e", "x" };
+const char *kCommandChar[kCommandMAX] = { "i", "l", "v", "e", "x", "t" };
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Command &command, Common::UString &archive, std::set<Common::UString> &files,
-                      Aurora::GameID &game, std::vector<byte> &password);
+                      Aurora::GameID &game, std::vector<byte> &password,
+                      Archives::ListFormat &format);
 
 bool parsePassword(const Common::UString &arg, std::vector<byte> &password);
 bool readNWMMD5   (const Common::UString &arg, std::vector<byte> &password);
@@ -69,6 +71,8 @@ void displayInfo(Aurora::ERFFile &erf);
 int main(int argc, char **argv) {
 	initPlatform();
 
+	int status = 0;
+
 	try {
 		std::vector<Common::UString> args;
 		Common::Platform::getParameters(argc, argv, args);
@@ -76,12 +80,13 @@ int main(int argc, char **argv) {
 		Aurora::GameID game = Aurora::kGameIDUnknown;
 
 		int returnValue = 1;
+		Archives::ListFormat format = Archives::kListFormatTable;
 		Command command = kCommandNone;
 		Common::UString archive;
 		std::set<Common::UString> files;
 		std::vector<byte> password;
 
-		if (!parseCommandLine(args, returnValue, command, archive, files, game, password))
+		if (!parseCommandLine(args, returnValue, command, archive, files, game, password, format))
 			return returnValue;
 
 		Aurora::ERFFile erf(new Common::ReadFile(archive), password);
@@ -90,19 +95,22 @@ int main(int argc, char **argv) {
 		if      (command == kCommandInfo)
 			displayInfo(erf);
 		else if (command == kCommandList)
-			Archives::listFiles(erf, game, false);
+			Archives::listFiles(erf, game, false, format);
 		else if (command == kCommandListVerbose)
-			Archives::listFiles(erf, game, true);
+			Archives::listFiles(erf, game, true, format);
 		else if (command == kCommandExtract)
 			Archives::extractFiles(erf, game, false, files);
 		else if (command == kCommandExtractDir)
 			Archives::extractFiles(erf, game, true, files);
+		else if (command == kCommandTest)
+			status = Archives::verifyFiles(erf, game) ? 0 : 1;
 
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
-	return 0;
+	deinitPlatform();
+	return status;
 }
 
 bool parsePassword(const Common::UString &arg, std::vector<byte> &password) {
@@ -162,7 +170,8 @@ int ValGetter<Command &>::get(const std::vector<Common::UString> &args, int i, i
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Command &command, Common::UString &archive, std::set<Common::UString> &files,
-                      Aurora::GameID &game, std::vector<byte> &password) {
+                      Aurora::GameID &game, std::vector<byte> &password,
+                      Archives::ListFormat &format) {
 
 	using Common::CLI::NoOption;
 	using Common::CLI::kContinueParsing;
@@ -183,7 +192,8 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	              "  l          List files (stripping directories)\n"
 	              "  v          List files verbosely (with directories)\n"
 	              "  e          Extract files to current directory, stripping directories\n"
-	              "  x          Extract files to current directory, creating subdirectories\n",
+	              "  x          Extract files to current directory, creating subdirectories\n"
+	              "  t          Test all files, reading them without extracting\n",
 	              returnValue,
 	              makeEndArgs(&cmdOpt, &archiveOpt, &filesOpt));
 
@@ -203,6 +213,13 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	                 kContinueParsing,
 	                 new Callback<std::vector<byte> &>("file", readNWMMD5, password));
 
+	parser.addSpace();
+	parser.addOption("format", "List files in this format: table (default), tsv or jsonl",
+	                 kContinueParsing,
+	                 new Callback<Archives::ListFormat &>("format", Archives::parseListFormat, format));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
 
@@ -45,42 +45,50 @@ enum Command {
 	kCommandNone    = -1,
 	kCommandList    =  0,
 	kCommandExtract     ,
+	kCommandTest        ,
 	kCommandMAX
 };
 
-const char *kCommandChar[kCommandMAX] = { "l", "e" };
+const char *kCommandChar[kCommandMAX] = { "l", "e", "t" };
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, Common::UString &archive, std::set<Common::UString> &files);
+                      Command &command, Common::UString &archive, std::set<Common::UString> &files,
+                      Archives::ListFormat &format);
 
 int main(int argc, char **argv) {
 	initPlatform();
 
+	int status = 0;
+
 	try {
 		std::vector<Common::UString> args;
 		Common::Platform::getParameters(argc, argv, args);
 
 		int returnValue = 1;
+		Archives::ListFormat format = Archives::kListFormatTable;
 		Command command = kCommandNone;
 		Common::UString archive;
 		std::set<Common::UString> files;
 
-		if (!parseCommandLine(args, returnValue, command, archive, files))
+		if (!parseCommandLine(args, returnValue, command, archive, files, format))
 			return returnValue;
 
 		Aurora::HERFFile herf(new Common::ReadFile(archive));
 		files = Archives::fixPathSeparator(files);
 
 		if      (command == kCommandList)
-			Archives::listFiles(herf, Aurora::kGameIDUnknown, false);
+			Archives::listFiles(herf, Aurora::kGameIDUnknown, false, format);
 		else if (command == kCommandExtract)
 			Archives::extractFiles(herf, Aurora::kGameIDUnknown, false, files);
+		else if (command == kCommandTest)
+			status = Archives::verifyFiles(herf, Aurora::kGameIDUnknown) ? 0 : 1;
 
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
-	return 0;
+	deinitPlatform();
+	return status;
 }
 
 namespace Common {
@@ -100,8 +108,11 @@ int ValGetter<Command &>::get(const std::vector<Common::UString> &args, int i, i
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, Common::UString &archive, std::set<Common::UString> &files) {
+                      Command &command, Common::UString &archive, std::set<Common::UString> &files,
+                      Archives::ListFormat &format) {
 
+	using Common::CLI::kContinueParsing;
+	using Common::CLI::Callback;
 	using Common::CLI::NoOption;
 	using Common::CLI::Parser;
 	using Common::CLI::ValGetter;
@@ -113,9 +124,17 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	Parser parser(argv[0], "BioWare HERF archive extractor",
 	              "Commands:\n"
 	              "  l          List archive\n"
-	              "  e          Extract files to current directory\n",
+	              "  e          Extract files to current directory\n"
+	              "  t          Test all files, reading them without extracting\n",
 	              returnValue,
 	              makeEndArgs(&cmdOpt, &archiveOpt, &filesOpt));
 
+	parser.addSpace();
+	parser.addOption("format", "List files in this format: table (default), tsv or jsonl",
+	                 kContinueParsing,
+	                 new Callback<Archives::ListFormat &>("format", Archives::parseListFormat, format));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
@@ -54,13 +54,15 @@ enum Command {
 	kCommandNone    = -1,
 	kCommandList    =  0,
 	kCommandExtract     ,
+	kCommandTest        ,
 	kCommandMAX
 };
 
-const char *kCommandChar[kCommandMAX] = { "l", "e" };
+const char *kCommandChar[kCommandMAX] = { "l", "e", "t" };
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, std::list<Common::UString> &files, Aurora::GameID &game);
+                      Command &command, std::list<Common::UString> &files, Aurora::GameID &game,
+                      Archives::ListFormat &format);
 
 uint32 getFileID(const Common::UString &fileName);
 void identifyFiles(const std::list<Common::UString> &files, std::vector<Common::UString> &keyFiles,
@@ -72,12 +74,16 @@ void openKEYDataFiles(const std::vector<Common::UString> &dataFiles, Common::Ptr
 void mergeKEYDataFiles(Common::PtrVector<Aurora::KEYFile> &keys, Common::PtrVector<Aurora::KEYDataFile> &keyData,
                        const std::vector<Common::UString> &dataFiles);
 
-void listFiles(const Common::PtrVector<Aurora::KEYFile> &keys, const std::vector<Common::UString> &keyFiles, Aurora::GameID game);
+void listFiles(const Common::PtrVector<Aurora::KEYFile> &keys, const std::vector<Common::UString> &keyFiles,
+               Aurora::GameID game, Archives::ListFormat format);
 void extractFiles(const Common::PtrVector<Aurora::KEYDataFile> &keyData, const std::vector<Common::UString> &dataFiles, Aurora::GameID game);
+bool verifyFiles(const Common::PtrVector<Aurora::KEYDataFile> &keyData, const std::vector<Common::UString> &dataFiles, Aurora::GameID game);
 
 int main(int argc, char **argv) {
 	initPlatform();
 
+	int status = 0;
+
 	try {
 		std::vector<Common::UString> args;
 		Common::Platform::getParameters(argc, argv, args);
@@ -85,10 +91,11 @@ int main(int argc, char **argv) {
 		Aurora::GameID game = Aurora::kGameIDUnknown;
 
 		int returnValue = 1;
+		Archives::ListFormat format = Archives::kListFormatTable;
 		Command command = kCommandNone;
 		std::list<Common::UString> files;
 
-		if (!parseCommandLine(args, returnValue, command, files, game))
+		if (!parseCommandLine(args, returnValue, command, files, game, format))
 			return returnValue;
 
 		std::vector<Common::UString> keyFiles, dataFiles;
@@ -103,15 +110,18 @@ int main(int argc, char **argv) {
 		mergeKEYDataFiles(keys, keyData, dataFiles);
 
 		if      (command == kCommandList)
-			listFiles(keys, keyFiles, game);
+			listFiles(keys, keyFiles, game, format);
 		else if (command == kCommandExtract)
 			extractFiles(keyData, dataFiles, game);
+		else if (command == kCommandTest)
+			status = verifyFiles(keyData, dataFiles, game) ? 0 : 1;
 
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
-	return 0;
+	deinitPlatform();
+	return status;
 }
 
 namespace Common {
@@ -131,7 +141,8 @@ int ValGetter<Command &>::get(const std::vector<Common::UString> &args, int i, i
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, std::list<Common::UString> &files, Aurora::GameID &game) {
+                      Command &command, std::list<Common::UString> &files, Aurora::GameID &game,
+                      Archives::ListFormat &format) {
 
 	using Common::CLI::NoOption;
 	using Common::CLI::Parser;
@@ -145,13 +156,16 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	Parser parser(argv[0], "BioWare KEY/BIF archive extractor",
 	              "Commands:\n"
 	              "  l          List files indexed in KEY archive(s)\n"
-	              "  e          Extract BIF archive(s). Needs KEY file(s) indexing these BIF.\n\n"
+	              "  e          Extract BIF archive(s). Needs KEY file(s) indexing these BIF.\n"
+	              "  t          Test BIF archive(s), reading all files without extracting.\n"
+	              "             Needs KEY file(s) indexing these BIF.\n\n"
 	              "Examples:\n"
 	              "unkeybif l foo.key\n"
 	              "unkeybif l foo.key bar.key\n"
 	              "unkeybif e foo.bif bar.key\n"
 	              "unkeybif e foo.bif quux.bif bar.key\n"
-	              "unkeybif e foo.bif quux.bif bar.key foobar.key",
+	              "unkeybif e foo.bif quux.bif bar.key foobar.key\n"
+	              "unkeybif t foo.bif quux.bif bar.key",
 	              returnValue, makeEndArgs(&cmdOpt, &filesOpt));
 
 	parser.addSpace();
@@ -161,6 +175,12 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	parser.addOption("jade", "Alias file types according to Jade Empire rules",
 	                 Common::CLI::kContinueParsing,
 	                 makeAssigners(new ValAssigner<Aurora::GameID>(Aurora::kGameIDJade, game)));
+	parser.addSpace();
+	parser.addOption("format", "List files in this format: table (default), tsv or jsonl",
+	                 Common::CLI::kContinueParsing,
+	                 new Common::CLI::Callback<Archives::ListFormat &>("format", Archives::parseListFormat, format));
+
+	addThreadCountOption(parser);
 
 	return parser.process(argv);
 }
@@ -235,8 +255,13 @@ void mergeKEYDataFiles(Common::PtrVector<Aurora::KEYFile> &keys, Common::PtrVect
 
 }
 
-void listFiles(const Common::PtrVector<Aurora::KEYFile> &keys,
-               const std::vector<Common::UString> &keyFiles, Aurora::GameID game) {
+void listFiles(const Common::PtrVector<Aurora::KEYFile> &keys, const std::vector<Common::UString> &keyFiles,
+               Aurora::GameID game, Archives::ListFormat format) {
+
+	if (format != Archives::kListFormatTable) {
+		Archives::listFiles(keys, keyFiles, game, format);
+		return;
+	}
 
 	for (size_t i = 0; i < keys.size(); i++) {
 		Archives::listFiles(*keys[i], keyFiles[i], game);
@@ -260,3 +285,22 @@ void extractFiles(const Common::PtrVector<Aurora::KEYDataFile> &keyData,
 			std::printf("\n");
 	}
 }
+
+bool verifyFiles(const Common::PtrVector<Aurora::KEYDataFile> &keyData,
+                 const std::vector<Common::UString> &dataFiles, Aurora::GameID game) {
+
+	bool verified = true;
+
+	for (size_t i = 0; i < keyData.size(); i++) {
+		std::printf("%s: %s indexed files (of %u)\n\n", dataFiles[i].c_str(),
+		            Common::composeString(keyData[i]->getResources().size()).c_str(),
+		            keyData[i]->getInternalResourceCount());
+
+		verified = Archives::verifyFiles(*keyData[i], game) && verified;
+
+		if (i < (keyData.size() - 1))
+			std::printf("\n");
+	}
+
+	return verified;
+}
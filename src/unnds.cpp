@@ -26,17 +26,30 @@
 #include <cstdio>
 
 #include <set>
+#include <vector>
+#include <utility>
+#include <exception>
 
 #include "src/version/version.h"
 
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/util.h"
 #include "src/common/ustring.h"
+#include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/platform.h"
 #include "src/common/readfile.h"
+#include "src/common/filepath.h"
 #include "src/common/cli.h"
 
 #include "src/aurora/util.h"
 #include "src/aurora/ndsrom.h"
+#include "src/aurora/smallfile.h"
+#include "src/aurora/herffile.h"
+#include "src/aurora/nsbtxfile.h"
+
+#include "src/images/xoreositex.h"
 
 #include "src/archives/util.h"
 
@@ -47,29 +60,36 @@ enum Command {
 	kCommandInfo    =  0,
 	kCommandList        ,
 	kCommandExtract     ,
+	kCommandTest        ,
+	kCommandRecursive   ,
 	kCommandMAX
 };
 
-const char *kCommandChar[kCommandMAX] = { "i", "l", "e" };
+const char *kCommandChar[kCommandMAX] = { "i", "l", "e", "t", "r" };
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, Common::UString &archive, std::set<Common::UString> &files);
+                      Command &command, Common::UString &archive, std::set<Common::UString> &files,
+                      Archives::ListFormat &format);
 
 void displayInfo(Aurora::NDSFile &nds);
+void extractRecursive(const Aurora::NDSFile &nds, const std::set<Common::UString> &files);
 
 int main(int argc, char **argv) {
 	initPlatform();
 
+	int status = 0;
+
 	try {
 		std::vector<Common::UString> args;
 		Common::Platform::getParameters(argc, argv, args);
 
 		int returnValue = 1;
+		Archives::ListFormat format = Archives::kListFormatTable;
 		Command command = kCommandNone;
 		Common::UString archive;
 		std::set<Common::UString> files;
 
-		if (!parseCommandLine(args, returnValue, command, archive, files))
+		if (!parseCommandLine(args, returnValue, command, archive, files, format))
 			return returnValue;
 
 		Aurora::NDSFile nds(new Common::ReadFile(archive));
@@ -78,15 +98,20 @@ int main(int argc, char **argv) {
 		if      (command == kCommandInfo)
 			displayInfo(nds);
 		else if (command == kCommandList)
-			Archives::listFiles(nds, Aurora::kGameIDUnknown, false);
+			Archives::listFiles(nds, Aurora::kGameIDUnknown, false, format);
 		else if (command == kCommandExtract)
 			Archives::extractFiles(nds, Aurora::kGameIDUnknown, false, files);
+		else if (command == kCommandTest)
+			status = Archives::verifyFiles(nds, Aurora::kGameIDUnknown) ? 0 : 1;
+		else if (command == kCommandRecursive)
+			extractRecursive(nds, files);
 
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
-	return 0;
+	deinitPlatform();
+	return status;
 }
 
 namespace Common {
@@ -106,8 +131,11 @@ int ValGetter<Command &>::get(const std::vector<Common::UString> &args, int i, i
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, Common::UString &archive, std::set<Common::UString> &files) {
+                      Command &command, Common::UString &archive, std::set<Common::UString> &files,
+                      Archives::ListFormat &format) {
 
+	using Common::CLI::kContinueParsing;
+	using Common::CLI::Callback;
 	using Common::CLI::NoOption;
 	using Common::CLI::Parser;
 	using Common::CLI::ValGetter;
@@ -120,10 +148,20 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	              "Commands:\n"
 	              "  i          Display meta-information\n"
 	              "  l          List archive\n"
-	              "  e          Extract files to current directory\n",
+	              "  e          Extract files to current directory\n"
+	              "  t          Test all files, reading them without extracting\n"
+	              "  r          Extract files to current directory, decompressing\n"
+	              "             small files and unpacking HERF and NSBTX archives\n",
 	              returnValue,
 	              makeEndArgs(&cmdOpt, &archiveOpt, &filesOpt));
 
+	parser.addSpace();
+	parser.addOption("format", "List files in this format: table (default), tsv or jsonl",
+	                 kContinueParsing,
+	                 new Callback<Archives::ListFormat &>("format", Archives::parseListFormat, format));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
 
@@ -132,3 +170,216 @@ void displayInfo(Aurora::NDSFile &nds) {
 	std::printf("Game code: \"%s\"\n", nds.getCode().c_str());
 	std::printf("Game maker: \"%s\"\n", nds.getMaker().c_str());
 }
+
+/** A file from the ROM that's being extracted recursively. */
+struct RecursiveEntry {
+	uint32 index;         ///< The file's index within the ROM.
+	size_t number;        ///< The file's position in the ROM, for display.
+	Common::UString name; ///< The file's name.
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream; ///< The file's contents.
+
+	size_t fileCount; ///< Number of files written.
+
+	/** The nested files that failed to extract, with their errors. */
+	std::vector<std::pair<Common::UString, std::exception_ptr> > failures;
+
+	RecursiveEntry(uint32 i, size_t n, const Common::UString &f) : index(i), number(n), name(f), fileCount(0) { }
+};
+
+static const size_t kMaxNestingDepth = 8;
+
+static void dumpImage(Common::SeekableReadStream &stream, const Common::UString &fileName) {
+	Images::XEOSITEX itex(stream);
+
+	itex.flipVertically();
+
+	itex.dumpTGA(fileName);
+}
+
+static void unpackRecursive(RecursiveEntry &entry, const Common::UString &name,
+                            Common::SeekableReadStream *stream, size_t depth);
+
+/** Extract all files in a nested HERF archive into a directory named after it. */
+static void unpackHERF(RecursiveEntry &entry, const Common::UString &name,
+                       Common::SeekableReadStream *stream, size_t depth) {
+
+	Aurora::HERFFile herf(stream);
+
+	const Aurora::Archive::ResourceList &resources = herf.getResources();
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		const Common::UString path = name + "/" +
+			Archives::findPath(r->name, r->type, r->hash, herf.getNameHashAlgo());
+
+		try {
+			unpackRecursive(entry, path, herf.getResource(r->index), depth + 1);
+		} catch (...) {
+			entry.failures.push_back(std::make_pair(path, std::current_exception()));
+		}
+	}
+}
+
+/** Convert all textures in a nested NSBTX into TGA images, in a directory named after it. */
+static void unpackNSBTX(RecursiveEntry &entry, const Common::UString &name, Common::SeekableReadStream *stream) {
+	Aurora::NSBTXFile nsbtx(stream);
+
+	Common::FilePath::createDirectories(name);
+
+	const Aurora::Archive::ResourceList &resources = nsbtx.getResources();
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		const Common::UString path = name + "/" + r->name + ".tga";
+
+		try {
+			Common::ScopedPtr<Common::SeekableReadStream> texture(nsbtx.getResource(r->index));
+
+			dumpImage(*texture, path);
+			entry.fileCount++;
+		} catch (...) {
+			entry.failures.push_back(std::make_pair(path, std::current_exception()));
+		}
+	}
+}
+
+/** Extract a file, unpacking it further if it's compressed or an archive itself.
+ *
+ *  All of this happens in memory: a small file is decompressed and then
+ *  looked at again under its name without the ".small", while HERF and
+ *  NSBTX archives are opened directly from the stream they're stored in.
+ */
+static void unpackRecursive(RecursiveEntry &entry, const Common::UString &name,
+                            Common::SeekableReadStream *stream, size_t depth) {
+
+	Common::ScopedPtr<Common::SeekableReadStream> file(stream);
+
+	if (depth > kMaxNestingDepth)
+		throw Common::Exception("Files nested too deeply");
+
+	const Aurora::FileType type = TypeMan.getFileType(name);
+
+	if (type == Aurora::kFileTypeSMALL) {
+		file.reset(Aurora::Small::decompress(file.release()));
+
+		unpackRecursive(entry, TypeMan.setFileType(name, Aurora::kFileTypeNone), file.release(), depth + 1);
+		return;
+	}
+
+	uint32 id = 0;
+	if (file->size() >= 4) {
+		id = file->readUint32BE();
+		file->seek(0);
+	}
+
+	// HERF dictionaries share the magic ID with HERF archives
+	if        ((id == 0xC0A5F100) && (type != Aurora::kFileTypeDICT)) {
+		unpackHERF(entry, name, file.release(), depth);
+	} else if (id == MKTAG('B', 'T', 'X', '0')) {
+		unpackNSBTX(entry, name, file.release());
+	} else {
+		const Common::UString dir = Common::FilePath::getDirectory(name);
+		if (!dir.empty())
+			Common::FilePath::createDirectories(dir);
+
+		dumpStream(*file, name);
+		entry.fileCount++;
+	}
+}
+
+static void printRecursiveEntry(RecursiveEntry &entry, size_t fileCount) {
+	std::printf("Extracting %s/%s: %s ... ", Common::composeString(entry.number).c_str(),
+	                                         Common::composeString(fileCount).c_str(),
+	                                         entry.name.c_str());
+
+	if (entry.failures.empty()) {
+		if (entry.fileCount == 1)
+			std::printf("Done\n");
+		else
+			std::printf("Done (%s files)\n", Common::composeString(entry.fileCount).c_str());
+
+		return;
+	}
+
+	std::printf("%s files extracted, %s failed\n", Common::composeString(entry.fileCount).c_str(),
+	                                               Common::composeString(entry.failures.size()).c_str());
+	std::fflush(stdout);
+
+	for (size_t i = 0; i < entry.failures.size(); i++) {
+		try {
+			std::rethrow_exception(entry.failures[i].second);
+		} catch (Common::Exception &e) {
+			e.add("Failed to extract \"%s\"", entry.failures[i].first.c_str());
+			Common::printException(e, "  ");
+		}
+	}
+}
+
+/** Read files from the ROM, and unpack each together with the files nested inside. */
+class RecursivePipeline : public Archives::ResourcePipeline {
+public:
+	RecursivePipeline(const Aurora::NDSFile &nds, Common::PtrVector<RecursiveEntry> &entries, size_t fileCount) :
+		_nds(nds), _entries(entries), _fileCount(fileCount) {
+	}
+
+	size_t read(size_t index) {
+		RecursiveEntry &entry = *_entries[index];
+
+		try {
+			entry.stream.reset(_nds.getResource(entry.index));
+			return entry.stream->size();
+		} catch (...) {
+			entry.failures.push_back(std::make_pair(entry.name, std::current_exception()));
+		}
+
+		return 0;
+	}
+
+	void unpack(size_t index) {
+		RecursiveEntry &entry = *_entries[index];
+		if (!entry.stream)
+			return;
+
+		try {
+			unpackRecursive(entry, entry.name, entry.stream.release(), 0);
+		} catch (...) {
+			entry.failures.push_back(std::make_pair(entry.name, std::current_exception()));
+		}
+	}
+
+	void finish(size_t index) {
+		printRecursiveEntry(*_entries[index], _fileCount);
+	}
+
+private:
+	const Aurora::NDSFile &_nds;
+	Common::PtrVector<RecursiveEntry> &_entries;
+
+	size_t _fileCount;
+};
+
+/** Extract files from the ROM, unpacking the compressed files and archives within.
+ *
+ *  The ROM itself is read one file at a time, by the pipeline's reader
+ *  thread. The files are then unpacked in parallel, each worker handling
+ *  a file together with all the files nested inside of it.
+ */
+void extractRecursive(const Aurora::NDSFile &nds, const std::set<Common::UString> &files) {
+	const Aurora::Archive::ResourceList &resources = nds.getResources();
+	const size_t fileCount = resources.size();
+
+	std::printf("Number of files: %s\n\n", Common::composeString(fileCount).c_str());
+
+	Common::PtrVector<RecursiveEntry> entries;
+
+	size_t i = 1;
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r, ++i) {
+		const Common::UString name = Common::FilePath::getFile(
+			Archives::findPath(r->name, r->type, r->hash, nds.getNameHashAlgo()));
+
+		if (!files.empty() && (files.find(name) == files.end()))
+			continue;
+
+		entries.push_back(new RecursiveEntry(r->index, i, name));
+	}
+
+	RecursivePipeline pipeline(nds, entries, fileCount);
+	Archives::runPipeline(entries.size(), pipeline);
+}
@@ -48,29 +48,34 @@ enum Command {
 	kCommandListVerbose     ,
 	kCommandExtract         ,
 	kCommandExtractDir      ,
+	kCommandTest            ,
 	kCommandMAX
 };
 
-const char *kCommandChar[kCommandMAX] = { "l", "v", "e", "x" };
+const char *kCommandChar[kCommandMAX] = { "l", "v", "e", "x", "t" };
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, Common::UString &archive, std::set<Common::UString> &files);
+                      Command &command, Common::UString &archive, std::set<Common::UString> &files,
+                      Archives::ListFormat &format);
 
 bool isPKZIP(Common::SeekableReadStream &stream);
 
 int main(int argc, char **argv) {
 	initPlatform();
 
+	int status = 0;
+
 	try {
 		std::vector<Common::UString> args;
 		Common::Platform::getParameters(argc, argv, args);
 
 		int returnValue = 1;
+		Archives::ListFormat format = Archives::kListFormatTable;
 		Command command = kCommandNone;
 		Common::UString archive;
 		std::set<Common::UString> files;
 
-		if (!parseCommandLine(args, returnValue, command, archive, files))
+		if (!parseCommandLine(args, returnValue, command, archive, files, format))
 			return returnValue;
 
 		Common::ScopedPtr<Common::SeekableReadStream> stream(new Common::ReadFile(archive));
@@ -84,19 +89,22 @@ int main(int argc, char **argv) {
 		files = Archives::fixPathSeparator(files);
 
 		if      (command == kCommandList)
-			Archives::listFiles(*arc, Aurora::kGameIDUnknown, false);
+			Archives::listFiles(*arc, Aurora::kGameIDUnknown, false, format);
 		else if (command == kCommandListVerbose)
-			Archives::listFiles(*arc, Aurora::kGameIDUnknown, true);
+			Archives::listFiles(*arc, Aurora::kGameIDUnknown, true, format);
 		else if (command == kCommandExtract)
 			Archives::extractFiles(*arc, Aurora::kGameIDUnknown, false, files);
 		else if (command == kCommandExtractDir)
 			Archives::extractFiles(*arc, Aurora::kGameIDUnknown, true, files);
+		else if (command == kCommandTest)
+			status = Archives::verifyFiles(*arc, Aurora::kGameIDUnknown) ? 0 : 1;
 
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
-	return 0;
+	deinitPlatform();
+	return status;
 }
 
 namespace Common {
@@ -116,8 +124,11 @@ int ValGetter<Command &>::get(const std::vector<Common::UString> &args, int i, i
 }
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
-                      Command &command, Common::UString &archive, std::set<Common::UString> &files) {
+                      Command &command, Common::UString &archive, std::set<Common::UString> &files,
+                      Archives::ListFormat &format) {
 
+	using Common::CLI::kContinueParsing;
+	using Common::CLI::Callback;
 	using Common::CLI::NoOption;
 	using Common::CLI::Parser;
 	using Common::CLI::ValGetter;
@@ -131,10 +142,18 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	              "  l          List files (stripping directories)\n"
 	              "  v          List files verbosely (with directories)\n"
 	              "  e          Extract files to current directory, stripping directories\n"
-	              "  x          Extract files to current directory, creating subdirectories\n",
+	              "  x          Extract files to current directory, creating subdirectories\n"
+	              "  t          Test all files, checking their checksums, without extracting them\n",
 	              returnValue,
 	              makeEndArgs(&cmdOpt, &archiveOpt, &filesOpt));
 
+	parser.addSpace();
+	parser.addOption("format", "List files in this format: table (default), tsv or jsonl",
+	                 kContinueParsing,
+	                 new Callback<Archives::ListFormat &>("format", Archives::parseListFormat, format));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
 
@@ -43,18 +43,22 @@ enum Command {
 	kCommandNone    = -1,
 	kCommandList    =  0,
 	kCommandExtract     ,
+	kCommandTest        ,
 	kCommandMAX
 };
 
-const char *kCommandChar[kCommandMAX] = { "l", "e" };
+const char *kCommandChar[kCommandMAX] = { "l", "e", "t" };
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Command &command, Common::UString &archive,
-                      Aurora::GameID &game, std::set<Common::UString> &files);
+                      Aurora::GameID &game, std::set<Common::UString> &files,
+                      Archives::ListFormat &format);
 
 int main(int argc, char **argv) {
 	initPlatform();
 
+	int status = 0;
+
 	try {
 		std::vector<Common::UString> args;
 		Common::Platform::getParameters(argc, argv, args);
@@ -62,26 +66,30 @@ int main(int argc, char **argv) {
 		Aurora::GameID game = Aurora::kGameIDUnknown;
 
 		int returnValue = 1;
+		Archives::ListFormat format = Archives::kListFormatTable;
 		Command command = kCommandNone;
 		Common::UString archive;
 		std::set<Common::UString> files;
 
-		if (!parseCommandLine(args, returnValue, command, archive, game, files))
+		if (!parseCommandLine(args, returnValue, command, archive, game, files, format))
 			return returnValue;
 
 		Aurora::RIMFile rim(new Common::ReadFile(archive));
 		files = Archives::fixPathSeparator(files);
 
 		if      (command == kCommandList)
-			Archives::listFiles(rim, game, false);
+			Archives::listFiles(rim, game, false, format);
 		else if (command == kCommandExtract)
 			Archives::extractFiles(rim, game, false, files);
+		else if (command == kCommandTest)
+			status = Archives::verifyFiles(rim, game) ? 0 : 1;
 
 	} catch (...) {
 		Common::exceptionDispatcherError();
 	}
 
-	return 0;
+	deinitPlatform();
+	return status;
 }
 
 namespace Common {
@@ -102,8 +110,10 @@ int ValGetter<Command &>::get(const std::vector<Common::UString> &args, int i, i
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
                       Command &command, Common::UString &archive,
-                      Aurora::GameID &game, std::set<Common::UString> &files) {
+                      Aurora::GameID &game, std::set<Common::UString> &files,
+                      Archives::ListFormat &format) {
 
+	using Common::CLI::Callback;
 	using Common::CLI::NoOption;
 	using Common::CLI::kContinueParsing;
 	using Common::CLI::Parser;
@@ -118,7 +128,8 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	Parser parser(argv[0], "BioWare RIM archive extractor",
 	              "Commands:\n"
 	              "  l          List archive\n"
-	              "  e          Extract files to current directory\n",
+	              "  e          Extract files to current directory\n"
+	              "  t          Test all files, reading them without extracting\n",
 	              returnValue,
 	              makeEndArgs(&cmdOpt, &archiveOpt, &filesOpt));
 
@@ -130,5 +141,12 @@ bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue
 	                 kContinueParsing,
 	                 makeAssigners(new ValAssigner<Aurora::GameID>(Aurora::kGameIDJade, game)));
 
+	parser.addSpace();
+	parser.addOption("format", "List files in this format: table (default), tsv or jsonl",
+	                 kContinueParsing,
+	                 new Callback<Archives::ListFormat &>("format", Archives::parseListFormat, format));
+
+	addThreadCountOption(parser);
+
 	return parser.process(argv);
 }
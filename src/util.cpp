@@ -22,23 +22,130 @@
  *  General tool utility functions.
  */
 
+#include <cstdlib>
+
 #include "src/common/error.h"
 #include "src/common/ustring.h"
+#include "src/common/util.h"
 #include "src/common/platform.h"
+#include "src/common/trace.h"
+#include "src/common/strutil.h"
+#include "src/common/parallel.h"
+#include "src/common/cli.h"
 #include "src/common/readstream.h"
 #include "src/common/readfile.h"
 #include "src/common/writefile.h"
 #include "src/common/stdinstream.h"
 #include "src/common/stdoutstream.h"
+#include "src/common/scopedptr.h"
+#include "src/common/gzip.h"
+#include "src/common/memwritestream.h"
+#include "src/common/resultcache.h"
+
+#include "src/version/version.h"
 
 #include "src/util.h"
 
+/** The file to write the recorded trace spans into, when the tool exits. */
+static Common::UString traceFile;
+
+static void writeTraceFile() {
+	Common::Tracer::stop();
+
+	try {
+		Common::WriteFile file(traceFile);
+
+		Common::Tracer::write(file);
+		file.flush();
+
+		status("Wrote %u trace spans into \"%s\"", (uint) Common::Tracer::getSpanCount(), traceFile.c_str());
+	} catch (...) {
+		Common::exceptionDispatcherWarnAndIgnore("Failed to write the trace file");
+	}
+}
+
+/** Start tracing if the environment variable XOREOS_TOOLS_TRACE names a trace file. */
+static void initTracing() {
+	const char *file = std::getenv("XOREOS_TOOLS_TRACE");
+	if (!file || !*file)
+		return;
+
+	traceFile = file;
+
+	Common::Tracer::start();
+	std::atexit(writeTraceFile);
+}
+
+static bool parseThreadCount(const Common::UString &str, void *UNUSED(unused)) {
+	uint32 count = 0;
+	Common::parseString(str, count);
+
+	Common::setThreadCount(count);
+	return true;
+}
+
+/** Set the number of threads if the environment variable XOREOS_TOOLS_THREADS is set. */
+static void initThreads() {
+	const char *count = std::getenv("XOREOS_TOOLS_THREADS");
+	if (!count || !*count)
+		return;
+
+	try {
+		parseThreadCount(count, 0);
+	} catch (...) {
+		Common::exceptionDispatcherWarnAndIgnore(Common::UString::format("Invalid XOREOS_TOOLS_THREADS value \"%s\"", count));
+	}
+}
+
+/** The cache of conversion results, if XOREOS_TOOLS_CACHE is set. */
+static Common::ScopedPtr<Common::ResultCache> resultCache;
+
+static void initCache() {
+	const char *directory = std::getenv("XOREOS_TOOLS_CACHE");
+	if (!directory || !*directory)
+		return;
+
+	uint64 maxSize = Common::ResultCache::kDefaultMaxSize;
+
+	const char *size = std::getenv("XOREOS_TOOLS_CACHE_SIZE");
+	if (size && *size) {
+		try {
+			uint64 megabytes = 0;
+			Common::parseString(size, megabytes);
+
+			maxSize = megabytes * 1024 * 1024;
+		} catch (...) {
+			Common::exceptionDispatcherWarnAndIgnore(Common::UString::format("Invalid XOREOS_TOOLS_CACHE_SIZE value \"%s\"", size));
+		}
+	}
+
+	try {
+		resultCache.reset(new Common::ResultCache(directory, maxSize));
+	} catch (...) {
+		Common::exceptionDispatcherWarnAndIgnore("Not using the result cache");
+	}
+}
+
+void addThreadCountOption(Common::CLI::Parser &parser) {
+	parser.addOption("threads", 'j', "Spread the work over n threads (0: one per CPU core)",
+	                 Common::CLI::kContinueParsing,
+	                 new Common::CLI::Callback<void *>("n", parseThreadCount, 0));
+}
+
 void initPlatform() {
 	try {
 		Common::Platform::init();
 	} catch (...) {
 		Common::exceptionDispatcherError("Failed to initialize the low-level platform-specific subsytem");
 	}
+
+	initTracing();
+	initThreads();
+	initCache();
+}
+
+void deinitPlatform() {
+	Common::shutdownScheduler();
 }
 
 void dumpStream(Common::SeekableReadStream &stream, const Common::UString &fileName) {
@@ -52,11 +159,17 @@ void dumpStream(Common::SeekableReadStream &stream, const Common::UString &fileN
 	file.close();
 }
 
-Common::WriteStream *openFileOrStdOut(const Common::UString &file) {
+Common::WriteStream *openFileOrStdOut(const Common::UString &file, bool gzip) {
+	Common::ScopedPtr<Common::WriteStream> stream;
 	if (!file.empty())
-		return new Common::WriteFile(file);
+		stream.reset(new Common::WriteFile(file));
+	else
+		stream.reset(new Common::StdOutStream);
 
-	return new Common::StdOutStream;
+	if (gzip || file.toLower().endsWith(".gz"))
+		return new Common::GzipWriteStream(stream.release(), true);
+
+	return stream.release();
 }
 
 Common::ReadStream *openFileOrStdIn(const Common::UString &file) {
@@ -65,3 +178,98 @@ Common::ReadStream *openFileOrStdIn(const Common::UString &file) {
 
 	return new Common::StdInStream;
 }
+
+void finishFileOrStdOut(Common::WriteStream &stream) {
+	Common::GzipWriteStream *gzip = dynamic_cast<Common::GzipWriteStream *>(&stream);
+	if (gzip)
+		gzip->finalize();
+	else
+		stream.flush();
+}
+
+
+/** Passes everything written through to another stream, keeping a copy. */
+class ConversionCache::RecordingStream : public Common::WriteStream {
+public:
+	RecordingStream(Common::WriteStream &out) : _out(&out), _data(true) {
+	}
+
+	size_t write(const void *dataPtr, size_t dataSize) {
+		const size_t written = _out->write(dataPtr, dataSize);
+
+		_data.write(dataPtr, written);
+		return written;
+	}
+
+	void flush() {
+		_out->flush();
+	}
+
+	const byte *getData() {
+		return _data.getData();
+	}
+
+	size_t size() const {
+		return _data.size();
+	}
+
+private:
+	Common::WriteStream *_out;
+	Common::MemoryWriteStreamDynamic _data;
+};
+
+ConversionCache::ConversionCache(const Common::UString &tool) {
+	if (!resultCache)
+		return;
+
+	_key.add(Version::getProjectNameVersionFull());
+	_key.add(tool);
+}
+
+ConversionCache::~ConversionCache() {
+}
+
+void ConversionCache::addOption(const Common::UString &option) {
+	if (resultCache)
+		_key.add(option);
+}
+
+void ConversionCache::addInput(Common::SeekableReadStream &input) {
+	if (resultCache)
+		_key.add(input);
+}
+
+bool ConversionCache::restore(Common::WriteStream &out) {
+	if (!resultCache)
+		return false;
+
+	Common::ScopedPtr<Common::SeekableReadStream> result(resultCache->find(_key.get()));
+	if (!result)
+		return false;
+
+	if (out.writeStream(*result) != result->size())
+		throw Common::Exception(Common::kWriteError);
+
+	return true;
+}
+
+Common::WriteStream &ConversionCache::record(Common::WriteStream &out) {
+	if (!resultCache)
+		return out;
+
+	_recorder.reset(new RecordingStream(out));
+	return *_recorder;
+}
+
+void ConversionCache::store() {
+	if (!resultCache || !_recorder)
+		return;
+
+	try {
+		resultCache->store(_key.get(), _recorder->getData(), _recorder->size());
+	} catch (...) {
+		Common::exceptionDispatcherWarnAndIgnore("Failed to cache the result");
+	}
+
+	_recorder.reset();
+}
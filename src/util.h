@@ -25,18 +25,86 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <boost/noncopyable.hpp>
+
+#include "src/common/scopedptr.h"
+#include "src/common/resultcache.h"
+
 namespace Common {
 	class UString;
 	class ReadStream;
 	class SeekableReadStream;
 	class WriteStream;
+	class MemoryWriteStreamDynamic;
+
+	namespace CLI {
+		class Parser;
+	}
 }
 
 void initPlatform();
 
+/** Shut down the worker threads and whatever else initPlatform() set up.
+ *
+ *  Called right before main() returns, so that none of it is left for the
+ *  static destructors to tear down.
+ */
+void deinitPlatform();
+
+/** Add the -j/--threads option, setting the number of threads parallel work is spread over.
+ *
+ *  Without it, the environment variable XOREOS_TOOLS_THREADS is used, if set.
+ */
+void addThreadCountOption(Common::CLI::Parser &parser);
+
 void dumpStream(Common::SeekableReadStream &stream, const Common::UString &fileName);
 
-Common::WriteStream *openFileOrStdOut(const Common::UString &file);
+/** Open a file for writing, or stdout if the file name is empty.
+ *
+ *  If gzip is true or the file name ends in ".gz", the output is gzip compressed.
+ */
+Common::WriteStream *openFileOrStdOut(const Common::UString &file, bool gzip = false);
 Common::ReadStream  *openFileOrStdIn (const Common::UString &file);
 
+/** Finish writing a stream opened with openFileOrStdOut().
+ *
+ *  Flushes the stream and, if it is gzip compressed, writes the gzip trailer.
+ *  Throws if that fails, so this needs to be called before reporting success.
+ */
+void finishFileOrStdOut(Common::WriteStream &stream);
+
+/** Caches the output of a conversion, keyed by the tool, its options and its input.
+ *
+ *  The cache is only used if the environment variable XOREOS_TOOLS_CACHE names
+ *  a directory, with XOREOS_TOOLS_CACHE_SIZE optionally limiting its size in
+ *  MiB. Without it, restore() always fails and nothing is recorded.
+ *
+ *  The recorded output is what the tool writes before any compression, so a
+ *  cached result can be restored into a compressed stream as well.
+ */
+class ConversionCache : boost::noncopyable {
+public:
+	ConversionCache(const Common::UString &tool);
+	~ConversionCache();
+
+	/** Add an option that changes the output. */
+	void addOption(const Common::UString &option);
+	/** Add the contents of an input stream. The stream is rewound afterwards. */
+	void addInput(Common::SeekableReadStream &input);
+
+	/** If the output is cached, write it into this stream and return true. */
+	bool restore(Common::WriteStream &out);
+
+	/** Return a stream that writes into out, recording the output for the cache. */
+	Common::WriteStream &record(Common::WriteStream &out);
+	/** The conversion succeeded: store the recorded output in the cache. */
+	void store();
+
+private:
+	class RecordingStream;
+
+	Common::ResultCacheKey _key;
+	Common::ScopedPtr<RecordingStream> _recorder;
+};
+
 #endif // UTIL_H
@@ -48,6 +48,15 @@ void GFF3Creator::create(const XML::XMLNode &root, uint32 id, Common::WriteStrea
 	gff3.write(file);
 }
 
+/** Return the text content of a node, or an empty string if it has none. */
+static Common::UString getNodeText(const XMLNode &node) {
+	const XMLNode *text = node.findChild("text");
+	if (!text)
+		return "";
+
+	return text->getContent();
+}
+
 void GFF3Creator::readStructContents(const XMLNode::Children &strctNodes, Aurora::GFF3WriterStructPtr strctPtr) {
 	for (const auto &strctNode : strctNodes) {
 		if (strctNode->getName() == "byte") {
@@ -65,7 +74,7 @@ void GFF3Creator::readStructContents(const XMLNode::Children &strctNodes, Aurora
 			float value;
 			Common::parseString(strctNode->findChild("text")->getContent(), value);
 			strctPtr->addFloat(strctNode->getProperty("label"), value);
-		} else if (strctNode->getName() == "float") {
+		} else if (strctNode->getName() == "double") {
 			double value;
 			Common::parseString(strctNode->findChild("text")->getContent(), value);
 			strctPtr->addDouble(strctNode->getProperty("label"), value);
@@ -116,11 +125,11 @@ void GFF3Creator::readStructContents(const XMLNode::Children &strctNodes, Aurora
 				throw Common::Exception("GFF3Creator::readStructContents() Invalid size of vector components");
 
 			XMLNode::Children::const_iterator iter = strctNode->getChildren().begin();
-			Common::UString xValue = (*iter)->getContent();
+			Common::UString xValue = getNodeText(**iter);
 			++iter;
-			Common::UString yValue = (*iter)->getContent();
+			Common::UString yValue = getNodeText(**iter);
 			++iter;
-			Common::UString zValue = (*iter)->getContent();
+			Common::UString zValue = getNodeText(**iter);
 
 			Common::parseString(xValue, x);
 			Common::parseString(yValue, y);
@@ -134,13 +143,13 @@ void GFF3Creator::readStructContents(const XMLNode::Children &strctNodes, Aurora
 				throw Common::Exception("GFF3Creator::readStructContents() Invalid size of orientation components");
 
 			XMLNode::Children::const_iterator iter = strctNode->getChildren().begin();
-			Common::UString xValue = (*iter)->getContent();
+			Common::UString xValue = getNodeText(**iter);
 			++iter;
-			Common::UString yValue = (*iter)->getContent();
+			Common::UString yValue = getNodeText(**iter);
 			++iter;
-			Common::UString zValue = (*iter)->getContent();
+			Common::UString zValue = getNodeText(**iter);
 			++iter;
-			Common::UString wValue = (*iter)->getContent();
+			Common::UString wValue = getNodeText(**iter);
 
 			Common::parseString(xValue, x);
 			Common::parseString(yValue, y);
@@ -162,11 +171,7 @@ void GFF3Creator::readStructContents(const XMLNode::Children &strctNodes, Aurora
 
 					uint32 id;
 					Common::parseString(child->getProperty("language"), id);
-					locString.setString(
-						LangMan.getLanguage(id),
-						LangMan.getLanguageGender(id),
-						strctNode->findChild("text")->getContent()
-					);
+					locString.setString(id, getNodeText(*child));
 				}
 			}
 
@@ -29,6 +29,7 @@
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/writestream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/locstring.h"
 #include "src/aurora/sacfile.h"
@@ -47,16 +48,19 @@ GFF3Dumper::~GFF3Dumper() {
 
 void GFF3Dumper::dump(Common::WriteStream &output, Common::SeekableReadStream *input,
                       Common::Encoding UNUSED(encoding), bool allowNWNPremium) {
+	XOREOS_TRACE_SPAN("xml", "GFF3Dumper::dump");
 
-	BOOST_SCOPE_EXIT( (&_gff3) (&_xml) ) {
+	BOOST_SCOPE_EXIT( (&_gff3) (&_xml) (&_arena) ) {
 		_gff3.reset();
 		_xml.reset();
+
+		_arena.reset();
 	} BOOST_SCOPE_EXIT_END
 
 	if (_sacFile) {
-		_gff3.reset(new Aurora::SACFile(input));
+		_gff3.reset(new Aurora::SACFile(input, &_arena));
 	} else {
-		_gff3.reset(new Aurora::GFF3File(input, 0xFFFFFFFF, allowNWNPremium));
+		_gff3.reset(new Aurora::GFF3File(input, 0xFFFFFFFF, allowNWNPremium, &_arena));
 	}
 
 	_xml.reset(new XMLWriter(output));
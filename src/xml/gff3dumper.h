@@ -27,6 +27,7 @@
 
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/memoryarena.h"
 
 #include "src/aurora/types.h"
 
@@ -53,6 +54,9 @@ public:
 private:
 	bool _sacFile;
 
+	/** Memory arena for the GFF3's structs, reused across dumps. */
+	Common::MemoryArena _arena;
+
 	Common::ScopedPtr<Aurora::GFF3File> _gff3;
 	Common::ScopedPtr<XMLWriter> _xml;
 
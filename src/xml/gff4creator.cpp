@@ -0,0 +1,359 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Creates V4.0/V4.1 GFFs out of XML files.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/error.h"
+
+#include "src/xml/gff4creator.h"
+
+namespace XML {
+
+struct GFF4FieldType {
+	const char *name;
+	Aurora::GFF4Struct::FieldType type;
+};
+
+/** The names of the field types, as written by the GFF4Dumper. */
+static const GFF4FieldType kGFF4FieldTypes[] = {
+	{ "uint8"      , Aurora::GFF4Struct::kFieldTypeUint8       },
+	{ "sint8"      , Aurora::GFF4Struct::kFieldTypeSint8       },
+	{ "uint16"     , Aurora::GFF4Struct::kFieldTypeUint16      },
+	{ "sint16"     , Aurora::GFF4Struct::kFieldTypeSint16      },
+	{ "uint32"     , Aurora::GFF4Struct::kFieldTypeUint32      },
+	{ "sint32"     , Aurora::GFF4Struct::kFieldTypeSint32      },
+	{ "uint64"     , Aurora::GFF4Struct::kFieldTypeUint64      },
+	{ "sint64"     , Aurora::GFF4Struct::kFieldTypeSint64      },
+	{ "float"      , Aurora::GFF4Struct::kFieldTypeFloat32     },
+	{ "double"     , Aurora::GFF4Struct::kFieldTypeFloat64     },
+	{ "vector3f"   , Aurora::GFF4Struct::kFieldTypeVector3f    },
+	{ "vector4f"   , Aurora::GFF4Struct::kFieldTypeVector4f    },
+	{ "quaternionf", Aurora::GFF4Struct::kFieldTypeQuaternionf },
+	{ "string"     , Aurora::GFF4Struct::kFieldTypeString      },
+	{ "color4f"    , Aurora::GFF4Struct::kFieldTypeColor4f     },
+	{ "matrix4x4f" , Aurora::GFF4Struct::kFieldTypeMatrix4x4f  },
+	{ "tlkstring"  , Aurora::GFF4Struct::kFieldTypeTlkString   },
+	{ "ndsfixed"   , Aurora::GFF4Struct::kFieldTypeNDSFixed    },
+	{ "struct"     , Aurora::GFF4Struct::kFieldTypeStruct      },
+	{ "generic"    , Aurora::GFF4Struct::kFieldTypeGeneric     }
+};
+
+static Aurora::GFF4Struct::FieldType getFieldType(const Common::UString &name) {
+	for (size_t i = 0; i < ARRAYSIZE(kGFF4FieldTypes); i++)
+		if (name == kGFF4FieldTypes[i].name)
+			return kGFF4FieldTypes[i].type;
+
+	throw Common::Exception("GFF4Creator: Unsupported field type \"%s\"", name.c_str());
+}
+
+/** Parse a tag, either as written by Common::tagToString(), or as a hexadecimal number. */
+static uint32 parseTag(const Common::UString &str) {
+	if (str.beginsWith("0x")) {
+		uint32 tag;
+		Common::parseString(str, tag);
+
+		return FROM_BE_32(tag);
+	}
+
+	if (str.size() > 4)
+		throw Common::Exception("GFF4Creator: Invalid tag \"%s\"", str.c_str());
+
+	const Common::UString tag = str + "    ";
+
+	return MKTAG(*tag.getPosition(0), *tag.getPosition(1), *tag.getPosition(2), *tag.getPosition(3));
+}
+
+/** Return the text content of a node, or an empty string if it has none. */
+static Common::UString getNodeText(const XMLNode &node) {
+	const XMLNode *text = node.findChild("text");
+	if (!text)
+		return "";
+
+	return text->getContent();
+}
+
+/** Return all child elements of a node, ignoring text. */
+static std::vector<const XMLNode *> getElements(const XMLNode &node) {
+	std::vector<const XMLNode *> elements;
+
+	for (const auto &child : node.getChildren())
+		if (child->getName() != "text")
+			elements.push_back(child);
+
+	return elements;
+}
+
+void GFF4Creator::create(const XML::XMLNode &root, Common::WriteStream &file) {
+	const uint32 type        = parseTag(root.getProperty("type"));
+	const uint32 typeVersion = parseTag(root.getProperty("version"));
+	const uint32 platform    = parseTag(root.getProperty("platform", "PC"));
+	const uint32 version     = parseTag(root.getProperty("gffversion", "V4.0"));
+
+	Aurora::GFF4Writer gff4(type, typeVersion, platform, version);
+
+	const std::vector<const XMLNode *> rootStructs = getElements(root);
+	if (rootStructs.size() > 1)
+		throw Common::Exception("GFF4Creator::create() More than one root struct");
+	if (rootStructs.empty() || (rootStructs.front()->getName() != "struct"))
+		throw Common::Exception("GFF4Creator::create() No root struct");
+
+	const XMLNode &rootStruct = *rootStructs.front();
+
+	Context ctx(gff4);
+
+	Aurora::GFF4WriterStruct &topLevel = gff4.getTopLevel();
+	topLevel.setLabel(parseTag(rootStruct.getProperty("name")));
+
+	const Common::UString id = rootStruct.getProperty("id");
+	if (!id.empty()) {
+		uint64 structID;
+		Common::parseString(id, structID);
+
+		ctx.structs[structID] = &topLevel;
+		ctx.defined.insert(structID);
+	}
+
+	readStructContents(rootStruct.getChildren(), topLevel, ctx);
+
+	for (std::map<uint64, Aurora::GFF4WriterStruct *>::const_iterator s = ctx.structs.begin();
+	     s != ctx.structs.end(); ++s)
+		if (ctx.defined.find(s->first) == ctx.defined.end())
+			throw Common::Exception("GFF4Creator::create() Struct %s is referenced, but never defined",
+			                        Common::composeString(s->first).c_str());
+
+	gff4.write(file);
+}
+
+void GFF4Creator::readStructContents(const XMLNode::Children &strctNodes, Aurora::GFF4WriterStruct &strct,
+                                     Context &ctx) {
+
+	for (const auto &strctNode : strctNodes)
+		if (strctNode->getName() != "text")
+			readField(*strctNode, strct, ctx);
+}
+
+void GFF4Creator::readField(const XMLNode &node, Aurora::GFF4WriterStruct &strct, Context &ctx) {
+	Common::UString typeName = node.getName();
+
+	const bool isList = typeName.endsWith("_list");
+	if (isList)
+		typeName.truncate(typeName.size() - 5);
+
+	const Aurora::GFF4Struct::FieldType type = getFieldType(typeName);
+
+	uint32 label;
+	Common::parseString(node.getProperty("label"), label);
+
+	if (type == Aurora::GFF4Struct::kFieldTypeGeneric) {
+		// Generics are read like structs, with the element index as the field label
+		Aurora::GFF4WriterStruct *generic = ctx.gff4->createGeneric();
+		readStructContents(node.getChildren(), *generic, ctx);
+
+		if (isList)
+			strct.addGenericList(label, generic);
+		else
+			strct.addGeneric(label, generic);
+
+		return;
+	}
+
+	// The values of this field: either the list elements, or the node itself
+	std::vector<const XMLNode *> items;
+	if (isList) {
+		items = getElements(node);
+
+		for (std::vector<const XMLNode *>::const_iterator i = items.begin(); i != items.end(); ++i)
+			if ((*i)->getName() != typeName)
+				throw Common::Exception("GFF4Creator::readField() Invalid element \"%s\" in %s list",
+				                        (*i)->getName().c_str(), typeName.c_str());
+	} else
+		items.push_back(&node);
+
+	switch (type) {
+		case Aurora::GFF4Struct::kFieldTypeUint8:
+		case Aurora::GFF4Struct::kFieldTypeUint16:
+		case Aurora::GFF4Struct::kFieldTypeUint32:
+		case Aurora::GFF4Struct::kFieldTypeUint64:
+			{
+				std::vector<uint64> values(items.size());
+				for (size_t i = 0; i < items.size(); i++)
+					Common::parseString(getNodeText(*items[i]), values[i]);
+
+				if (isList)
+					strct.addUint(label, type, values);
+				else
+					strct.addUint(label, type, values.front());
+			}
+			break;
+
+		case Aurora::GFF4Struct::kFieldTypeSint8:
+		case Aurora::GFF4Struct::kFieldTypeSint16:
+		case Aurora::GFF4Struct::kFieldTypeSint32:
+		case Aurora::GFF4Struct::kFieldTypeSint64:
+			{
+				std::vector<int64> values(items.size());
+				for (size_t i = 0; i < items.size(); i++)
+					Common::parseString(getNodeText(*items[i]), values[i]);
+
+				if (isList)
+					strct.addSint(label, type, values);
+				else
+					strct.addSint(label, type, values.front());
+			}
+			break;
+
+		case Aurora::GFF4Struct::kFieldTypeFloat32:
+		case Aurora::GFF4Struct::kFieldTypeFloat64:
+		case Aurora::GFF4Struct::kFieldTypeNDSFixed:
+			{
+				std::vector<double> values(items.size());
+				for (size_t i = 0; i < items.size(); i++)
+					Common::parseString(getNodeText(*items[i]), values[i]);
+
+				if (isList)
+					strct.addDouble(label, type, values);
+				else
+					strct.addDouble(label, type, values.front());
+			}
+			break;
+
+		case Aurora::GFF4Struct::kFieldTypeString:
+			{
+				std::vector<Common::UString> values(items.size());
+				for (size_t i = 0; i < items.size(); i++)
+					values[i] = getNodeText(*items[i]);
+
+				if (isList)
+					strct.addString(label, values);
+				else
+					strct.addString(label, values.front());
+			}
+			break;
+
+		case Aurora::GFF4Struct::kFieldTypeTlkString:
+			{
+				if (isList)
+					throw Common::Exception("GFF4Creator::readField() Lists of talk strings are not supported");
+
+				const XMLNode *strRefNode = node.findChild("uint32");
+				const XMLNode *strNode    = node.findChild("string");
+				if (!strRefNode || !strNode)
+					throw Common::Exception("GFF4Creator::readField() Invalid talk string");
+
+				uint32 strRef;
+				Common::parseString(getNodeText(*strRefNode), strRef);
+
+				strct.addTalkString(label, strRef, getNodeText(*strNode));
+			}
+			break;
+
+		case Aurora::GFF4Struct::kFieldTypeVector3f:
+		case Aurora::GFF4Struct::kFieldTypeVector4f:
+		case Aurora::GFF4Struct::kFieldTypeQuaternionf:
+		case Aurora::GFF4Struct::kFieldTypeColor4f:
+		case Aurora::GFF4Struct::kFieldTypeMatrix4x4f:
+			{
+				std::vector< std::vector<double> > values(items.size());
+				for (size_t i = 0; i < items.size(); i++) {
+					const std::vector<const XMLNode *> components = getElements(*items[i]);
+
+					values[i].resize(components.size());
+					for (size_t j = 0; j < components.size(); j++)
+						Common::parseString(getNodeText(*components[j]), values[i][j]);
+				}
+
+				if (isList)
+					strct.addVectorMatrix(label, type, values);
+				else
+					strct.addVectorMatrix(label, type, values.front());
+			}
+			break;
+
+		case Aurora::GFF4Struct::kFieldTypeStruct:
+			{
+				std::vector<Aurora::GFF4WriterStruct *> values(items.size());
+				for (size_t i = 0; i < items.size(); i++)
+					values[i] = readStruct(*items[i], ctx);
+
+				if (isList)
+					strct.addStruct(label, values);
+				else
+					strct.addStruct(label, values.front());
+			}
+			break;
+
+		default:
+			throw Common::Exception("GFF4Creator::readField() Unsupported field type \"%s\"", typeName.c_str());
+	}
+}
+
+Aurora::GFF4WriterStruct *GFF4Creator::readStruct(const XMLNode &node, Context &ctx) {
+	// A struct without a name is a NULL reference
+	const Common::UString name = node.getProperty("name");
+	if (name.empty())
+		return 0;
+
+	const uint32 label = parseTag(name);
+
+	// A reference to a struct that's defined elsewhere
+	const Common::UString refID = node.getProperty("ref_id");
+	if (!refID.empty())
+		return findStruct(refID, label, ctx);
+
+	Aurora::GFF4WriterStruct *strct = 0;
+
+	const Common::UString id = node.getProperty("id");
+	if (!id.empty()) {
+		strct = findStruct(id, label, ctx);
+
+		uint64 structID;
+		Common::parseString(id, structID);
+
+		if (!ctx.defined.insert(structID).second)
+			throw Common::Exception("GFF4Creator::readStruct() Duplicate struct id %s", id.c_str());
+	} else
+		strct = ctx.gff4->createStruct(label);
+
+	readStructContents(node.getChildren(), *strct, ctx);
+
+	return strct;
+}
+
+Aurora::GFF4WriterStruct *GFF4Creator::findStruct(const Common::UString &id, uint32 label, Context &ctx) {
+	uint64 structID;
+	Common::parseString(id, structID);
+
+	std::map<uint64, Aurora::GFF4WriterStruct *>::iterator s = ctx.structs.find(structID);
+	if (s == ctx.structs.end())
+		s = ctx.structs.insert(std::make_pair(structID, ctx.gff4->createStruct(label))).first;
+
+	if (s->second->getLabel() != label)
+		throw Common::Exception("GFF4Creator::findStruct() Struct %s has conflicting names", id.c_str());
+
+	return s->second;
+}
+
+} // End of namespace XML
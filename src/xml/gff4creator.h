@@ -0,0 +1,64 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Creates V4.0/V4.1 GFFs out of XML files.
+ */
+
+#ifndef XML_GFF4CREATOR_H
+#define XML_GFF4CREATOR_H
+
+#include <map>
+#include <set>
+
+#include "src/aurora/gff4writer.h"
+
+#include "src/xml/xmlparser.h"
+
+namespace XML {
+
+class GFF4Creator {
+public:
+	static void create(const XML::XMLNode &root, Common::WriteStream &file);
+
+private:
+	/** The state while reading the XML. */
+	struct Context {
+		Aurora::GFF4Writer *gff4;
+
+		/** All structs with an ID, so that other fields can reference them. */
+		std::map<uint64, Aurora::GFF4WriterStruct *> structs;
+		/** The IDs of all structs whose contents we've already read. */
+		std::set<uint64> defined;
+
+		Context(Aurora::GFF4Writer &g) : gff4(&g) { }
+	};
+
+	static void readStructContents(const XMLNode::Children &strctNodes, Aurora::GFF4WriterStruct &strct,
+	                               Context &ctx);
+	static void readField(const XMLNode &node, Aurora::GFF4WriterStruct &strct, Context &ctx);
+
+	static Aurora::GFF4WriterStruct *readStruct(const XMLNode &node, Context &ctx);
+	static Aurora::GFF4WriterStruct *findStruct(const Common::UString &id, uint32 label, Context &ctx);
+};
+
+} // End of namespace XML
+
+#endif // XML_GFF4CREATOR_H
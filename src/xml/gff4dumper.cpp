@@ -29,6 +29,7 @@
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/writestream.h"
+#include "src/common/trace.h"
 
 #include "src/xml/xmlwriter.h"
 #include "src/xml/gff4dumper.h"
@@ -62,15 +63,18 @@ Common::UString GFF4Dumper::findFieldName(uint32 label) const {
 
 void GFF4Dumper::dump(Common::WriteStream &output, Common::SeekableReadStream *input,
                       Common::Encoding encoding, bool UNUSED(allowNWNPremium)) {
+	XOREOS_TRACE_SPAN("xml", "GFF4Dumper::dump");
 
 	_encoding = encoding;
 
-	BOOST_SCOPE_EXIT( (&_gff4) (&_xml) ) {
+	BOOST_SCOPE_EXIT( (&_gff4) (&_xml) (&_arena) ) {
 		_gff4.reset();
 		_xml.reset();
+
+		_arena.reset();
 	} BOOST_SCOPE_EXIT_END
 
-	_gff4.reset(new Aurora::GFF4File(input));
+	_gff4.reset(new Aurora::GFF4File(input, 0xFFFFFFFF, &_arena));
 	_xml.reset(new XMLWriter(output));
 
 	if (_encoding == Common::kEncodingInvalid)
@@ -80,6 +84,11 @@ void GFF4Dumper::dump(Common::WriteStream &output, Common::SeekableReadStream *i
 	_xml->addProperty("type"    , Common::tagToString(_gff4->getType()       , true));
 	_xml->addProperty("version" , Common::tagToString(_gff4->getTypeVersion(), true));
 	_xml->addProperty("platform", Common::tagToString(_gff4->getPlatform()   , true));
+
+	// V4.0 is the default, only V4.1 needs to be explicitly marked for xml2gff
+	if (_gff4->getVersion() != MKTAG('V', '4', '.', '0'))
+		_xml->addProperty("gffversion", Common::tagToString(_gff4->getVersion(), true));
+
 	_xml->breakLine();
 
 	dumpStruct(&_gff4->getTopLevel(), false, 0, false, 0, false);
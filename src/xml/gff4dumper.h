@@ -30,6 +30,7 @@
 
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/memoryarena.h"
 
 #include "src/aurora/gff4file.h"
 
@@ -68,6 +69,9 @@ private:
 
 	FieldNames _fieldNames;
 
+	/** Memory arena for the GFF4's structs, reused across dumps. */
+	Common::MemoryArena _arena;
+
 	Common::ScopedPtr<Aurora::GFF4File> _gff4;
 	Common::ScopedPtr<XMLWriter> _xml;
 
@@ -27,6 +27,7 @@
 #include "src/xml/xmlparser.h"
 #include "src/xml/gffcreator.h"
 #include "src/xml/gff3creator.h"
+#include "src/xml/gff4creator.h"
 
 namespace XML {
 
@@ -41,7 +42,7 @@ void GFFCreator::create(Common::WriteStream &output, Common::ReadStream &input,
 	if (xmlRoot.getName() == "gff3") {
 		XML::GFF3Creator::create(xmlRoot, typeId, output);
 	} else if (xmlRoot.getName() == "gff4") {
-		throw Common::Exception("TODO: Add GFF4 writer support");
+		XML::GFF4Creator::create(xmlRoot, output);
 	} else {
 		throw Common::Exception("GFFCreator::create() invalid root tag");
 	}
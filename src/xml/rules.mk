@@ -35,6 +35,7 @@ src_xml_libxml_la_SOURCES += \
     src/xml/ssfcreator.h \
     src/xml/gffcreator.h \
     src/xml/gff3creator.h \
+    src/xml/gff4creator.h \
     $(EMPTY)
 
 src_xml_libxml_la_SOURCES += \
@@ -49,4 +50,5 @@ src_xml_libxml_la_SOURCES += \
     src/xml/ssfcreator.cpp \
     src/xml/gffcreator.cpp \
     src/xml/gff3creator.cpp \
+    src/xml/gff4creator.cpp \
     $(EMPTY)
@@ -25,6 +25,7 @@
 #include "src/common/strutil.h"
 #include "src/common/readstream.h"
 #include "src/common/writestream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/ssffile.h"
 
@@ -131,6 +132,8 @@ static const char * const kLabelsShort[] = {
 };
 
 void SSFDumper::dump(Common::WriteStream &output, Common::SeekableReadStream &input) {
+	XOREOS_TRACE_SPAN("xml", "SSFDumper::dump");
+
 	Aurora::SSFFile ssf(input);
 
 	XMLWriter xml(output);
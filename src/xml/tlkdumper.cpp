@@ -26,6 +26,7 @@
 #include "src/common/strutil.h"
 #include "src/common/readstream.h"
 #include "src/common/writestream.h"
+#include "src/common/trace.h"
 
 #include "src/aurora/language.h"
 #include "src/aurora/talktable.h"
@@ -37,6 +38,7 @@ namespace XML {
 
 void TLKDumper::dump(Common::WriteStream &output, Common::SeekableReadStream *input,
                      Common::Encoding encoding) {
+	XOREOS_TRACE_SPAN("xml", "TLKDumper::dump");
 
 	Common::ScopedPtr<Aurora::TalkTable> tlk(Aurora::TalkTable::load(input, encoding));
 	if (!tlk)
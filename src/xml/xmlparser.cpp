@@ -25,6 +25,8 @@
 #include <cstdarg>
 #include <cstdio>
 
+#include <exception>
+
 #include <libxml/parser.h>
 #include <libxml/xmlerror.h>
 
@@ -33,6 +35,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/gzip.h"
 
 #include "src/xml/xmlparser.h"
 
@@ -52,12 +55,59 @@ static void errorFuncUString(void *ctx, const char *msg, ...) {
 	*str += buf;
 }
 
+/** The stream libxml2 reads the XML document from. */
+struct XMLInput {
+	Common::ReadStream *stream; ///< The stream the document is read from.
+
+	/** The decompressing stream, if the document is gzip compressed. */
+	Common::ScopedPtr<Common::GzipReadStream> gzip;
+
+	bool detected;    ///< Have we already checked for gzip compression?
+	byte magic[2];    ///< The first bytes of an uncompressed document.
+	size_t magicSize; ///< The number of bytes in magic.
+	size_t magicPos;  ///< The number of bytes of magic already returned.
+
+	/** An exception thrown while reading, rethrown after libxml2 returns. */
+	std::exception_ptr error;
+
+	XMLInput(Common::ReadStream &s) : stream(&s), detected(false), magicSize(0), magicPos(0) {
+	}
+
+	size_t read(char *buffer, size_t len) {
+		if (!detected) {
+			detected = true;
+
+			magicSize = stream->read(magic, sizeof(magic));
+			if (Common::isGzip(magic, magicSize)) {
+				gzip.reset(new Common::GzipReadStream(stream, false, magic, magicSize));
+				magicSize = 0;
+			}
+		}
+
+		if (gzip)
+			return gzip->read(buffer, len);
+
+		size_t n = 0;
+		while ((magicPos < magicSize) && (n < len))
+			buffer[n++] = magic[magicPos++];
+
+		return n + stream->read(buffer + n, len - n);
+	}
+};
+
 static int readStream(void *context, char *buffer, int len) {
-	Common::ReadStream *stream = static_cast<Common::ReadStream *>(context);
-	if (!stream)
+	XMLInput *input = static_cast<XMLInput *>(context);
+	if (!input || (len < 0))
 		return -1;
 
-	return stream->read(buffer, len);
+	// Exceptions must not unwind through libxml2
+	try {
+		return input->read(buffer, len);
+	} catch (...) {
+		input->error = std::current_exception();
+	}
+
+	return -1;
 }
 
 static int closeStream(void *UNUSED(context)) {
@@ -83,9 +133,14 @@ XMLParser::XMLParser(Common::ReadStream &stream, bool makeLower, const Common::U
 	const int options = XML_PARSE_NOWARNING | XML_PARSE_NOBLANKS | XML_PARSE_NONET |
 	                    XML_PARSE_NSCLEAN   | XML_PARSE_NOCDATA;
 
-	xmlDocPtr xml = xmlReadIO(readStream, closeStream, static_cast<void *>(&stream),
+	XMLInput input(stream);
+
+	xmlDocPtr xml = xmlReadIO(readStream, closeStream, static_cast<void *>(&input),
 	                          fileName.c_str(), 0, options);
 	if (!xml) {
+		if (input.error)
+			std::rethrow_exception(input.error);
+
 		Common::Exception e;
 
 		if (!parseError.empty())
@@ -48,6 +48,8 @@ class XMLNode;
 class XMLParser : boost::noncopyable {
 public:
 	/** Parse an XML file out of a stream.
+	 *
+	 *  gzip compressed XML is detected and decompressed transparently.
 	 *
 	 *  @param stream The stream to read the XML from.
 	 *  @param makeLower Should all tags be converted to lowercase, to ease case-insensitive comparison?
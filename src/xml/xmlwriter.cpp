@@ -26,6 +26,7 @@
 #include "src/common/memreadstream.h"
 #include "src/common/writestream.h"
 #include "src/common/base64.h"
+#include "src/common/trace.h"
 
 #include "src/xml/xmlwriter.h"
 
@@ -40,6 +41,8 @@ XMLWriter::~XMLWriter() {
 }
 
 void XMLWriter::flush() {
+	XOREOS_TRACE_SPAN("xml", "XMLWriter::flush");
+
 	while (!_openTags.empty())
 		closeTag();
 
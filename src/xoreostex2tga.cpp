@@ -34,7 +34,8 @@
 #include "src/common/error.h"
 #include "src/common/platform.h"
 #include "src/common/readstream.h"
-#include "src/common/readfile.h"
+#include "src/common/memwritestream.h"
+#include "src/common/writefile.h"
 #include "src/common/cli.h"
 
 #include "src/aurora/types.h"
@@ -47,6 +48,8 @@
 #include "src/images/tpc.h"
 #include "src/images/txb.h"
 
+#include "src/archives/input.h"
+
 #include "src/util.h"
 
 bool parseCommandLine(const std::vector<Common::UString> &argv, int &returnValue,
@@ -76,6 +79,7 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
+	deinitPlatform();
 	return 0;
 }
 
@@ -173,11 +177,11 @@ static Images::Decoder *openImage(Common::SeekableReadStream &stream, Aurora::Fi
 void convert(const Common::UString &inFile, const Common::UString &outFile,
              Aurora::FileType type, bool flip, bool deswizzle) {
 
-	Common::ReadFile in(inFile);
+	Common::ScopedPtr<Common::SeekableReadStream> in(Archives::openInputFile(inFile));
 
 	if (type == Aurora::kFileTypeNone) {
 		// Detect by file contents
-		type = detectType(in);
+		type = detectType(*in);
 
 		if (type == Aurora::kFileTypeNone) {
 			// Detect by file name
@@ -188,9 +192,29 @@ void convert(const Common::UString &inFile, const Common::UString &outFile,
 		}
 	}
 
-	Common::ScopedPtr<Images::Decoder> image(openImage(in, type, deswizzle));
-	if (flip)
-		image->flipVertically();
+	ConversionCache cache("xoreostex2tga");
+	cache.addOption(Common::composeString((int) type));
+	cache.addOption(Common::composeString(flip));
+	cache.addOption(Common::composeString(deswizzle));
+	cache.addInput(*in);
+
+	Common::MemoryWriteStreamDynamic tga(true);
+
+	if (!cache.restore(tga)) {
+		// Convert into memory first, so that a failure doesn't leave a broken TGA behind
+		Common::ScopedPtr<Images::Decoder> image(openImage(*in, type, deswizzle));
+		if (flip)
+			image->flipVertically();
+
+		image->dumpTGA(cache.record(tga));
+	}
+
+	Common::WriteFile out(outFile);
+
+	if (out.write(tga.getData(), tga.size()) != tga.size())
+		throw Common::Exception(Common::kWriteError);
+
+	out.flush();
 
-	image->dumpTGA(outFile);
+	cache.store();
 }
@@ -115,6 +115,21 @@ GTEST_TEST(BZFFile, getResourceSize) {
 	EXPECT_THROW(bzf.getResourceSize(1), Common::Exception);
 }
 
+GTEST_TEST(BZFFile, getResourceStorage) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kBZFFile);
+	const Aurora::BZFFile bzf(stream);
+
+	Aurora::BZFFile::ResourceStorage storage;
+	ASSERT_TRUE(bzf.getResourceStorage(0, storage));
+
+	EXPECT_EQ(storage.offset, 36);
+	EXPECT_EQ(storage.packedSize, sizeof(kBZFFile) - 36);
+	EXPECT_EQ(storage.size, strlen(kFileData));
+	EXPECT_STREQ(storage.compression, "lzma");
+
+	EXPECT_THROW(bzf.getResourceStorage(1, storage), Common::Exception);
+}
+
 GTEST_TEST(BZFFile, findResourceHash) {
 	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kBZFFile);
 	const Aurora::BZFFile bzf(stream);
@@ -147,6 +162,28 @@ GTEST_TEST(BZFFile, getResource) {
 	delete file;
 }
 
+GTEST_TEST(BZFFile, unpackResource) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kBZFFile);
+	const Aurora::BZFFile bzf(stream);
+
+	Common::MemoryReadStream *packed = bzf.getPackedResource(0);
+	ASSERT_NE(packed, static_cast<Common::MemoryReadStream *>(0));
+
+	EXPECT_EQ(packed->size(), sizeof(kBZFFile) - 36);
+
+	Common::SeekableReadStream *file = bzf.unpackResource(0, packed);
+	ASSERT_NE(file, static_cast<Common::SeekableReadStream *>(0));
+
+	ASSERT_EQ(file->size(), strlen(kFileData));
+
+	for (size_t i = 0; i < strlen(kFileData); i++)
+		EXPECT_EQ(file->readByte(), kFileData[i]) << "At index " << i;
+
+	delete file;
+
+	EXPECT_THROW(bzf.getPackedResource(1), Common::Exception);
+}
+
 GTEST_TEST(BZFFile, mergeKEY) {
 	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kBZFFile);
 	Aurora::BZFFile bzf(stream);
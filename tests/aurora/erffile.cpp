@@ -182,6 +182,20 @@ GTEST_TEST(ERFFile10, getResourceSize) {
 	EXPECT_THROW(erf.getResourceSize(1), Common::Exception);
 }
 
+GTEST_TEST(ERFFile10, getResourceStorage) {
+	const Aurora::ERFFile erf(new Common::MemoryReadStream(kERFFile10));
+
+	Aurora::ERFFile::ResourceStorage storage;
+	ASSERT_TRUE(erf.getResourceStorage(0, storage));
+
+	EXPECT_EQ(storage.offset, 216);
+	EXPECT_EQ(storage.packedSize, strlen(kFileData));
+	EXPECT_EQ(storage.size, strlen(kFileData));
+	EXPECT_EQ(storage.compression, (const char *) 0);
+
+	EXPECT_THROW(erf.getResourceStorage(1, storage), Common::Exception);
+}
+
 GTEST_TEST(ERFFile10, findResourceHash) {
 	const Aurora::ERFFile erf(new Common::MemoryReadStream(kERFFile10));
 
@@ -212,6 +226,13 @@ GTEST_TEST(ERFFile10, getResource) {
 	delete file;
 }
 
+GTEST_TEST(ERFFile10, getPackedResource) {
+	const Aurora::ERFFile erf(new Common::MemoryReadStream(kERFFile10));
+
+	// Neither encrypted nor compressed, so there's nothing to unpack
+	EXPECT_EQ(erf.getPackedResource(0), static_cast<Common::MemoryReadStream *>(0));
+}
+
 GTEST_TEST(ERFFile10, typeMOD) {
 	static const byte kERF[] = {
 		0x4D,0x4F,0x44,0x20,0x56,0x31,0x2E,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
@@ -1209,6 +1230,23 @@ GTEST_TEST(ERFFile22DeflateHeader, getResource) {
 	delete file;
 }
 
+GTEST_TEST(ERFFile22DeflateHeader, unpackResource) {
+	const Aurora::ERFFile erf(new Common::MemoryReadStream(kERFFile22DH));
+
+	Common::MemoryReadStream *packed = erf.getPackedResource(0);
+	ASSERT_NE(packed, static_cast<Common::MemoryReadStream *>(0));
+
+	Common::SeekableReadStream *file = erf.unpackResource(0, packed);
+	ASSERT_NE(file, static_cast<Common::SeekableReadStream *>(0));
+
+	ASSERT_EQ(file->size(), strlen(kFileData));
+
+	for (size_t i = 0; i < strlen(kFileData); i++)
+		EXPECT_EQ(file->readByte(), kFileData[i]) << "At index " << i;
+
+	delete file;
+}
+
 // --- ERF V2.2 (DEFLATE, raw) ---
 
 // Percy Bysshe Shelley's "Ozymandias", within an ERF V2.2 (DEFLATE, raw) file
@@ -33,11 +33,13 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 #include "src/common/util.h"
+#include "src/common/endianness.h"
 #include "src/common/error.h"
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
@@ -330,6 +332,18 @@ GTEST_TEST(GFF4StructSingle, getStringEncoding) {
 	EXPECT_THROW(strct.getString(512, Common::kEncodingUTF8), Common::Exception);
 }
 
+GTEST_TEST(GFF4StructSingle, getStringRepeated) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	EXPECT_STREQ(strct.getString(1024, Common::kEncodingUTF16LE).c_str(), "Barfoo");
+	EXPECT_STREQ(strct.getString(1024, Common::kEncodingUTF16LE).c_str(), "Barfoo");
+
+	// The same string data read with a different encoding must not use the earlier result
+	EXPECT_STREQ(strct.getString(1024, Common::kEncodingASCII).c_str(), "B");
+	EXPECT_STREQ(strct.getString(1024, Common::kEncodingUTF16LE).c_str(), "Barfoo");
+}
+
 GTEST_TEST(GFF4StructSingle, getTalkString) {
 	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
 	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
@@ -1251,6 +1265,23 @@ GTEST_TEST(GFF4StructList, getUint) {
 	EXPECT_THROW(strct.getUint(1024, list), Common::Exception);
 }
 
+GTEST_TEST(GFF4StructList, getUintCorruptCount) {
+	byte data[sizeof(kGFF4ListValues)];
+	std::memcpy(data, kGFF4ListValues, sizeof(data));
+
+	// Claim that the first list holds far more elements than there is data for
+	WRITE_LE_UINT32(data + 0x13C, 0x40000000);
+
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(data));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	std::vector<uint64> list;
+	EXPECT_THROW(strct.getUint(256, list), Common::Exception);
+
+	EXPECT_TRUE(strct.getUint(257, list));
+	EXPECT_EQ(list.size(), 3);
+}
+
 GTEST_TEST(GFF4StructList, getSint) {
 	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4ListValues));
 	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
@@ -3040,4 +3071,6 @@ GTEST_TEST(GFF4StructShared, getString) {
 
 	EXPECT_EQ(strRef, 23);
 	EXPECT_STREQ(tlkString.c_str(), "Foobar");
+
+	EXPECT_STREQ(strct0.getString(256).c_str(), "Foobar");
 }
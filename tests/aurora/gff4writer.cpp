@@ -0,0 +1,390 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our GFF4 writer class.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/gff4writer.h"
+#include "src/aurora/gff4file.h"
+
+static const uint32 kType    = MKTAG('T', 'E', 'S', 'T');
+static const uint32 kVersion = MKTAG('V', '1', '.', '0');
+
+static const uint32 kPlatformPC  = MKTAG('P', 'C', ' ', ' ');
+static const uint32 kPlatformPS3 = MKTAG('P', 'S', '3', ' ');
+
+static const uint32 kVersion40 = MKTAG('V', '4', '.', '0');
+static const uint32 kVersion41 = MKTAG('V', '4', '.', '1');
+
+static const uint32 kLabelItem  = MKTAG('I', 'T', 'E', 'M');
+static const uint32 kLabelOther = MKTAG('O', 'T', 'H', 'R');
+
+static Common::MemoryReadStream *writeGFF4(Aurora::GFF4Writer &writer) {
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	writer.write(stream);
+	stream.setDisposable(false);
+
+	return new Common::MemoryReadStream(stream.getData(), stream.size(), true);
+}
+
+static Aurora::GFF4File *readGFF4(Aurora::GFF4Writer &writer) {
+	return new Aurora::GFF4File(writeGFF4(writer));
+}
+
+GTEST_TEST(GFF4Writer, header) {
+	Aurora::GFF4Writer writer(kType, kVersion, kPlatformPC, kVersion41);
+
+	Common::ScopedPtr<Aurora::GFF4File> gff4(readGFF4(writer));
+
+	EXPECT_EQ(gff4->getType(), kType);
+	EXPECT_EQ(gff4->getTypeVersion(), kVersion);
+	EXPECT_EQ(gff4->getPlatform(), kPlatformPC);
+	EXPECT_EQ(gff4->getVersion(), kVersion41);
+
+	EXPECT_EQ(gff4->getTopLevel().getLabel(), kType);
+	EXPECT_EQ(gff4->getTopLevel().getFieldCount(), 0);
+}
+
+GTEST_TEST(GFF4Writer, invalidVersion) {
+	EXPECT_THROW(Aurora::GFF4Writer(kType, kVersion, kPlatformPC, MKTAG('V', '3', '.', '2')), Common::Exception);
+}
+
+GTEST_TEST(GFF4Writer, singleValues) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	top.addUint  (1, Aurora::GFF4Struct::kFieldTypeUint8   , 23);
+	top.addSint  (2, Aurora::GFF4Struct::kFieldTypeSint16  , -24);
+	top.addUint  (3, Aurora::GFF4Struct::kFieldTypeUint64  , UINT64_C(0x1234567890));
+	top.addDouble(4, Aurora::GFF4Struct::kFieldTypeFloat32 , 27.5);
+	top.addDouble(5, Aurora::GFF4Struct::kFieldTypeFloat64 , 28.25);
+	top.addDouble(6, Aurora::GFF4Struct::kFieldTypeNDSFixed, -2.5);
+	top.addString(7, "Foobar");
+	top.addTalkString(8, 21, "Barfoo");
+
+	std::vector<double> vector3(3);
+	vector3[0] = 1.0;
+	vector3[1] = 2.0;
+	vector3[2] = 3.0;
+
+	top.addVectorMatrix(9, Aurora::GFF4Struct::kFieldTypeVector3f, vector3);
+
+	Common::ScopedPtr<Aurora::GFF4File> gff4(readGFF4(writer));
+	const Aurora::GFF4Struct &strct = gff4->getTopLevel();
+
+	EXPECT_EQ(strct.getFieldCount(), 9);
+
+	EXPECT_EQ(strct.getFieldType(1), Aurora::GFF4Struct::kFieldTypeUint8);
+	EXPECT_EQ(strct.getFieldType(6), Aurora::GFF4Struct::kFieldTypeNDSFixed);
+
+	EXPECT_EQ(strct.getUint(1), 23);
+	EXPECT_EQ(strct.getSint(2), -24);
+	EXPECT_EQ(strct.getUint(3), UINT64_C(0x1234567890));
+	EXPECT_DOUBLE_EQ(strct.getDouble(4), 27.5);
+	EXPECT_DOUBLE_EQ(strct.getDouble(5), 28.25);
+	EXPECT_DOUBLE_EQ(strct.getDouble(6), -2.5);
+	EXPECT_STREQ(strct.getString(7).c_str(), "Foobar");
+
+	uint32 strRef;
+	Common::UString str;
+	EXPECT_TRUE(strct.getTalkString(8, strRef, str));
+	EXPECT_EQ(strRef, 21);
+	EXPECT_STREQ(str.c_str(), "Barfoo");
+
+	std::vector<double> vector;
+	EXPECT_TRUE(strct.getVectorMatrix(9, vector));
+	EXPECT_EQ(vector, vector3);
+}
+
+GTEST_TEST(GFF4Writer, invalidFields) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	top.addUint(1, Aurora::GFF4Struct::kFieldTypeUint32, 23);
+
+	EXPECT_THROW(top.addUint(1, Aurora::GFF4Struct::kFieldTypeUint32, 24), Common::Exception);
+	EXPECT_THROW(top.addUint(2, Aurora::GFF4Struct::kFieldTypeFloat32, 24), Common::Exception);
+	EXPECT_THROW(top.addDouble(3, Aurora::GFF4Struct::kFieldTypeUint8, 1.0), Common::Exception);
+	EXPECT_THROW(top.addVectorMatrix(4, Aurora::GFF4Struct::kFieldTypeVector4f, std::vector<double>(3)),
+	             Common::Exception);
+	EXPECT_THROW(top.addStruct(5, writer.createGeneric()), Common::Exception);
+	EXPECT_THROW(top.addGeneric(6, writer.createStruct(kLabelItem)), Common::Exception);
+
+	Aurora::GFF4WriterStruct *generic = writer.createGeneric();
+	EXPECT_THROW(generic->addGeneric(0, writer.createGeneric()), Common::Exception);
+}
+
+GTEST_TEST(GFF4Writer, lists) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	std::vector<uint64> ints;
+	ints.push_back(1);
+	ints.push_back(2);
+	ints.push_back(65535);
+
+	std::vector<Common::UString> strings;
+	strings.push_back("Foo");
+	strings.push_back("");
+	strings.push_back("Foo");
+
+	top.addUint  (1, Aurora::GFF4Struct::kFieldTypeUint16, ints);
+	top.addString(2, strings);
+	top.addUint  (3, Aurora::GFF4Struct::kFieldTypeUint32, std::vector<uint64>());
+
+	Common::ScopedPtr<Aurora::GFF4File> gff4(readGFF4(writer));
+	const Aurora::GFF4Struct &strct = gff4->getTopLevel();
+
+	bool isList = false;
+	EXPECT_EQ(strct.getFieldType(1, isList), Aurora::GFF4Struct::kFieldTypeUint16);
+	EXPECT_TRUE(isList);
+
+	std::vector<uint64> readInts;
+	EXPECT_TRUE(strct.getUint(1, readInts));
+	EXPECT_EQ(readInts, ints);
+
+	std::vector<Common::UString> readStrings;
+	EXPECT_TRUE(strct.getString(2, readStrings));
+	ASSERT_EQ(readStrings.size(), 3);
+	EXPECT_STREQ(readStrings[0].c_str(), "Foo");
+	EXPECT_STREQ(readStrings[1].c_str(), "");
+	EXPECT_STREQ(readStrings[2].c_str(), "Foo");
+
+	readInts.clear();
+	EXPECT_TRUE(strct.getUint(3, readInts));
+	EXPECT_TRUE(readInts.empty());
+}
+
+GTEST_TEST(GFF4Writer, structTemplates) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	std::vector<Aurora::GFF4WriterStruct *> items;
+	for (uint32 i = 0; i < 3; i++) {
+		items.push_back(writer.createStruct(kLabelItem));
+		items.back()->addUint(1, Aurora::GFF4Struct::kFieldTypeUint32, i);
+	}
+
+	Aurora::GFF4WriterStruct *other = writer.createStruct(kLabelOther);
+	other->addString(1, "Foobar");
+
+	top.addStruct(1, items);
+	top.addStruct(2, other);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(writeGFF4(writer));
+
+	// All three items share one template, so we have the top-level, the item and the other
+	stream->seek(20);
+	EXPECT_EQ(stream->readUint32LE(), 3);
+
+	stream->seek(0);
+	Aurora::GFF4File gff4(stream.release());
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	const Aurora::GFF4List &list = strct.getList(1);
+	ASSERT_EQ(list.size(), 3);
+
+	for (uint32 i = 0; i < 3; i++) {
+		ASSERT_NE(list[i], static_cast<const Aurora::GFF4Struct *>(0));
+
+		EXPECT_EQ(list[i]->getLabel(), kLabelItem);
+		EXPECT_EQ(list[i]->getUint(1), i);
+	}
+
+	const Aurora::GFF4Struct *readOther = strct.getStruct(2);
+	ASSERT_NE(readOther, static_cast<const Aurora::GFF4Struct *>(0));
+
+	EXPECT_EQ(readOther->getLabel(), kLabelOther);
+	EXPECT_STREQ(readOther->getString(1).c_str(), "Foobar");
+}
+
+GTEST_TEST(GFF4Writer, structTemplatesMismatch) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+
+	std::vector<Aurora::GFF4WriterStruct *> items;
+	items.push_back(writer.createStruct(kLabelItem));
+	items.push_back(writer.createStruct(kLabelItem));
+
+	items[0]->addUint(1, Aurora::GFF4Struct::kFieldTypeUint32, 23);
+	items[1]->addUint(1, Aurora::GFF4Struct::kFieldTypeUint16, 23);
+
+	writer.getTopLevel().addStruct(1, items);
+
+	Common::MemoryWriteStreamDynamic stream(true);
+	EXPECT_THROW(writer.write(stream), Common::Exception);
+}
+
+GTEST_TEST(GFF4Writer, references) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	Aurora::GFF4WriterStruct *shared = writer.createStruct(kLabelItem);
+	shared->addUint(1, Aurora::GFF4Struct::kFieldTypeUint32, 23);
+
+	// Referencing the parent creates a cycle
+	Aurora::GFF4WriterStruct *child = writer.createStruct(kLabelOther);
+	child->addStruct(1, &top);
+
+	top.addStruct(1, shared);
+	top.addStruct(2, shared);
+	top.addStruct(3, static_cast<Aurora::GFF4WriterStruct *>(0));
+	top.addStruct(4, child);
+
+	Common::ScopedPtr<Aurora::GFF4File> gff4(readGFF4(writer));
+	const Aurora::GFF4Struct &strct = gff4->getTopLevel();
+
+	const Aurora::GFF4Struct *shared1 = strct.getStruct(1);
+	const Aurora::GFF4Struct *shared2 = strct.getStruct(2);
+
+	ASSERT_NE(shared1, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_EQ(shared1, shared2);
+	EXPECT_EQ(shared1->getRefCount(), 2);
+	EXPECT_EQ(shared1->getUint(1), 23);
+
+	EXPECT_TRUE(strct.hasField(3));
+	EXPECT_EQ(strct.getStruct(3), static_cast<const Aurora::GFF4Struct *>(0));
+
+	const Aurora::GFF4Struct *readChild = strct.getStruct(4);
+	ASSERT_NE(readChild, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_EQ(readChild->getStruct(1), &strct);
+}
+
+GTEST_TEST(GFF4Writer, generics) {
+	Aurora::GFF4Writer writer(kType, kVersion);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	Aurora::GFF4WriterStruct *item = writer.createStruct(kLabelItem);
+	item->addUint(1, Aurora::GFF4Struct::kFieldTypeUint8, 42);
+
+	Aurora::GFF4WriterStruct *generic = writer.createGeneric();
+	generic->addUint(0, Aurora::GFF4Struct::kFieldTypeUint32, 23);
+
+	Aurora::GFF4WriterStruct *genericList = writer.createGeneric();
+	genericList->addString(0, "Foobar");
+	genericList->addStruct(2, item);
+
+	top.addGeneric(1, generic);
+	top.addGenericList(2, genericList);
+
+	Common::ScopedPtr<Aurora::GFF4File> gff4(readGFF4(writer));
+	const Aurora::GFF4Struct &strct = gff4->getTopLevel();
+
+	const Aurora::GFF4Struct *readGeneric = strct.getGeneric(1);
+	ASSERT_NE(readGeneric, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_EQ(readGeneric->getFieldType(0), Aurora::GFF4Struct::kFieldTypeUint32);
+	EXPECT_EQ(readGeneric->getUint(0), 23);
+
+	const Aurora::GFF4Struct *readList = strct.getGeneric(2);
+	ASSERT_NE(readList, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_EQ(readList->getFieldCount(), 3);
+
+	EXPECT_STREQ(readList->getString(0).c_str(), "Foobar");
+	EXPECT_FALSE(readList->hasField(1));
+
+	const Aurora::GFF4Struct *readItem = readList->getStruct(2);
+	ASSERT_NE(readItem, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_EQ(readItem->getLabel(), kLabelItem);
+	EXPECT_EQ(readItem->getUint(1), 42);
+}
+
+GTEST_TEST(GFF4Writer, sharedStrings) {
+	Aurora::GFF4Writer writer(kType, kVersion, kPlatformPC, kVersion41);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	std::vector<Common::UString> strings;
+	strings.push_back("Foo");
+	strings.push_back("Bar");
+	strings.push_back("Foo");
+
+	top.addString(1, strings);
+	top.addString(2, "Bar");
+	top.addTalkString(3, 21, "Foo");
+
+	Aurora::GFF4WriterStruct *generic = writer.createGeneric();
+	generic->addString(0, "Quux");
+
+	top.addGeneric(4, generic);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(writeGFF4(writer));
+
+	// Only distinct strings end up in the string table
+	stream->seek(24);
+	EXPECT_EQ(stream->readUint32LE(), 3);
+
+	stream->seek(0);
+	Aurora::GFF4File gff4(stream.release());
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	std::vector<Common::UString> readStrings;
+	EXPECT_TRUE(strct.getString(1, readStrings));
+	ASSERT_EQ(readStrings.size(), 3);
+	EXPECT_STREQ(readStrings[0].c_str(), "Foo");
+	EXPECT_STREQ(readStrings[1].c_str(), "Bar");
+	EXPECT_STREQ(readStrings[2].c_str(), "Foo");
+
+	EXPECT_STREQ(strct.getString(2).c_str(), "Bar");
+
+	uint32 strRef;
+	Common::UString str;
+	EXPECT_TRUE(strct.getTalkString(3, strRef, str));
+	EXPECT_EQ(strRef, 21);
+	EXPECT_STREQ(str.c_str(), "Foo");
+
+	const Aurora::GFF4Struct *readGeneric = strct.getGeneric(4);
+	ASSERT_NE(readGeneric, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_STREQ(readGeneric->getString(0).c_str(), "Quux");
+}
+
+GTEST_TEST(GFF4Writer, bigEndian) {
+	Aurora::GFF4Writer writer(kType, kVersion, kPlatformPS3, kVersion40);
+	Aurora::GFF4WriterStruct &top = writer.getTopLevel();
+
+	top.addUint(1, Aurora::GFF4Struct::kFieldTypeUint32, 0x12345678);
+	top.addString(2, "Foobar");
+
+	Aurora::GFF4WriterStruct *generic = writer.createGeneric();
+	generic->addString(0, "Barfoo");
+
+	top.addGeneric(3, generic);
+
+	Common::ScopedPtr<Aurora::GFF4File> gff4(readGFF4(writer));
+	const Aurora::GFF4Struct &strct = gff4->getTopLevel();
+
+	EXPECT_EQ(gff4->getNativeEncoding(), Common::kEncodingUTF16BE);
+
+	EXPECT_EQ(strct.getUint(1), 0x12345678);
+	EXPECT_STREQ(strct.getString(2).c_str(), "Foobar");
+
+	const Aurora::GFF4Struct *readGeneric = strct.getGeneric(3);
+	ASSERT_NE(readGeneric, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_STREQ(readGeneric->getString(0).c_str(), "Barfoo");
+}
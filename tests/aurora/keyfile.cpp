@@ -59,12 +59,23 @@ GTEST_TEST(KEYFile10, getResources) {
 	const Aurora::KEYFile::ResourceList &res = key.getResources();
 	ASSERT_EQ(res.size(), 1);
 
-	EXPECT_STREQ(res[0].name.c_str(), "ozymandias");
+	EXPECT_STREQ(res[0].name.getString().c_str(), "ozymandias");
 	EXPECT_EQ(res[0].type, Aurora::kFileTypeTXT);
 	EXPECT_EQ(res[0].bifIndex, 0);
 	EXPECT_EQ(res[0].resIndex, 1);
 }
 
+GTEST_TEST(KEYFile10, findResource) {
+	Common::MemoryReadStream stream(kKEY10File);
+	Aurora::KEYFile key(stream);
+
+	EXPECT_EQ(key.findResource(Aurora::ResRef("ozymandias"), Aurora::kFileTypeTXT), 0);
+	EXPECT_EQ(key.findResource(Aurora::ResRef("Ozymandias"), Aurora::kFileTypeTXT), 0);
+
+	EXPECT_EQ(key.findResource(Aurora::ResRef("ozymandias"), Aurora::kFileTypeBMP), 0xFFFFFFFF);
+	EXPECT_EQ(key.findResource(Aurora::ResRef("nobody"), Aurora::kFileTypeTXT), 0xFFFFFFFF);
+}
+
 // --- KEY V1.1 ---
 
 static const byte kKEY11File[] = {
@@ -95,7 +106,7 @@ GTEST_TEST(KEYFile11, getResources) {
 	const Aurora::KEYFile::ResourceList &res = key.getResources();
 	ASSERT_EQ(res.size(), 1);
 
-	EXPECT_STREQ(res[0].name.c_str(), "ozymandias");
+	EXPECT_STREQ(res[0].name.getString().c_str(), "ozymandias");
 	EXPECT_EQ(res[0].type, Aurora::kFileTypeTXT);
 	EXPECT_EQ(res[0].bifIndex, 0);
 	EXPECT_EQ(res[0].resIndex, 1);
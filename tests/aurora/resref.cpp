@@ -0,0 +1,107 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our fixed-size resource references.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+#include "src/aurora/resref.h"
+
+GTEST_TEST(ResRef, empty) {
+	const Aurora::ResRef resRef;
+
+	EXPECT_TRUE(resRef.empty());
+	EXPECT_EQ(resRef.size(), 0);
+	EXPECT_STREQ(resRef.getString().c_str(), "");
+
+	EXPECT_TRUE(resRef == Aurora::ResRef(""));
+}
+
+GTEST_TEST(ResRef, getString) {
+	const Aurora::ResRef resRef("NW_Chicken01");
+
+	EXPECT_FALSE(resRef.empty());
+	EXPECT_EQ(resRef.size(), 12);
+
+	// The original case is kept
+	EXPECT_STREQ(resRef.getString().c_str(), "NW_Chicken01");
+}
+
+GTEST_TEST(ResRef, maxLength) {
+	const Common::UString name("abcdefghijklmnopqrstuvwxyzABCDEF");
+	ASSERT_EQ(name.size(), Aurora::ResRef::kMaxLength);
+
+	EXPECT_TRUE(Aurora::ResRef::fits(name));
+	EXPECT_STREQ(Aurora::ResRef(name).getString().c_str(), name.c_str());
+
+	EXPECT_FALSE(Aurora::ResRef::fits(name + "g"));
+	EXPECT_THROW(Aurora::ResRef(name + "g"), Common::Exception);
+}
+
+GTEST_TEST(ResRef, rawData) {
+	static const char kName[16] = { 'f', 'o', 'o', 'B', 'a', 'r', 0 };
+
+	EXPECT_STREQ(Aurora::ResRef(kName, sizeof(kName)).getString().c_str(), "fooBar");
+	EXPECT_STREQ(Aurora::ResRef(kName, 4).getString().c_str(), "fooB");
+}
+
+GTEST_TEST(ResRef, read) {
+	static const byte kData[] = { 'f', 'o', 'o', 0, 0, 0, 0, 0, 'B', 'a', 'r' };
+	Common::MemoryReadStream stream(kData);
+
+	EXPECT_STREQ(Aurora::ResRef::read(stream, 8).getString().c_str(), "foo");
+	EXPECT_EQ(stream.pos(), 8);
+
+	EXPECT_THROW(Aurora::ResRef::read(stream, 8), Common::Exception);
+}
+
+GTEST_TEST(ResRef, compare) {
+	const Aurora::ResRef resRef1("foobar");
+	const Aurora::ResRef resRef2("FooBar");
+	const Aurora::ResRef resRef3("foobaz");
+	const Aurora::ResRef resRef4("foo");
+
+	// Comparisons are case-insensitive
+	EXPECT_TRUE (resRef1 == resRef2);
+	EXPECT_FALSE(resRef1 != resRef2);
+	EXPECT_FALSE(resRef1 <  resRef2);
+	EXPECT_FALSE(resRef2 <  resRef1);
+
+	EXPECT_FALSE(resRef1 == resRef3);
+	EXPECT_TRUE (resRef1 != resRef3);
+	EXPECT_TRUE (resRef1 <  resRef3);
+	EXPECT_FALSE(resRef3 <  resRef1);
+
+	// Shorter names come first
+	EXPECT_TRUE (resRef4 <  resRef1);
+	EXPECT_FALSE(resRef1 <  resRef4);
+}
+
+GTEST_TEST(ResRef, hash) {
+	const Aurora::hashResRef hash;
+
+	EXPECT_EQ(hash(Aurora::ResRef("foobar")), hash(Aurora::ResRef("FOOBAR")));
+	EXPECT_NE(hash(Aurora::ResRef("foobar")), hash(Aurora::ResRef("foobaz")));
+}
@@ -71,6 +71,11 @@ tests_aurora_test_ndsrom_SOURCES  = tests/aurora/ndsrom.cpp
 tests_aurora_test_ndsrom_LDADD    = $(aurora_LIBS)
 tests_aurora_test_ndsrom_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                   += tests/aurora/test_resref
+tests_aurora_test_resref_SOURCES  = tests/aurora/resref.cpp
+tests_aurora_test_resref_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resref_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/aurora/test_keyfile
 tests_aurora_test_keyfile_SOURCES  = tests/aurora/keyfile.cpp
 tests_aurora_test_keyfile_LDADD    = $(aurora_LIBS)
@@ -86,6 +91,11 @@ tests_aurora_test_bzffile_SOURCES  = tests/aurora/bzffile.cpp
 tests_aurora_test_bzffile_LDADD    = $(aurora_LIBS)
 tests_aurora_test_bzffile_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                    += tests/aurora/test_obbfile
+tests_aurora_test_obbfile_SOURCES  = tests/aurora/obbfile.cpp
+tests_aurora_test_obbfile_LDADD    = $(aurora_LIBS)
+tests_aurora_test_obbfile_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/aurora/test_erffile
 tests_aurora_test_erffile_SOURCES  = tests/aurora/erffile.cpp
 tests_aurora_test_erffile_LDADD    = $(aurora_LIBS)
@@ -101,6 +111,11 @@ tests_aurora_test_gff4file_SOURCES  = tests/aurora/gff4file.cpp
 tests_aurora_test_gff4file_LDADD    = $(aurora_LIBS)
 tests_aurora_test_gff4file_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                       += tests/aurora/test_gff4writer
+tests_aurora_test_gff4writer_SOURCES  = tests/aurora/gff4writer.cpp
+tests_aurora_test_gff4writer_LDADD    = $(aurora_LIBS)
+tests_aurora_test_gff4writer_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/aurora/test_2dafile
 tests_aurora_test_2dafile_SOURCES  = tests/aurora/2dafile.cpp
 tests_aurora_test_2dafile_LDADD    = $(aurora_LIBS)
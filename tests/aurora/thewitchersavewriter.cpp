@@ -499,3 +499,85 @@ GTEST_TEST(TheWitcherSaveWriter, WriteMultipleFiles) {
 	delete readStream2;
 	delete readStream3;
 }
+
+GTEST_TEST(TheWitcherSaveWriter, PatchFile) {
+	Common::MemoryReadStream dataStream1(kFileData, true);
+	const size_t kFileDataSize = dataStream1.size();
+
+	const size_t kLogoDataSize = sizeof(kLogoData);
+	Common::MemoryReadStream dataStream2(kLogoData, kLogoDataSize);
+
+	Common::MemoryWriteStreamDynamic writeStream1;
+	Aurora::TheWitcherSaveWriter twsWriter1("Test Area", writeStream1);
+	twsWriter1.add("ozymandias_1", Aurora::kFileTypeTXT, dataStream1);
+	dataStream1.seek(0);
+	twsWriter1.add("ozymandias_2", Aurora::kFileTypeTXT, dataStream1);
+	dataStream1.seek(0);
+	twsWriter1.add("ozymandias_3", Aurora::kFileTypeTXT, dataStream1);
+	twsWriter1.finish();
+
+	const Aurora::TheWitcherSaveFile tws1(new Common::MemoryReadStream(writeStream1.getData(), writeStream1.size(), true));
+
+	// Copy the first and last resource verbatim, but replace the second one
+	Common::MemoryWriteStreamDynamic writeStream2;
+	Aurora::TheWitcherSaveWriter twsWriter2(tws1.getAreaName(), writeStream2);
+	twsWriter2.add(tws1, 0);
+	twsWriter2.add("ozymandias_2", Aurora::kFileTypeBMP, dataStream2);
+	twsWriter2.add(tws1, 2);
+	twsWriter2.finish();
+
+	const Aurora::TheWitcherSaveFile tws2(new Common::MemoryReadStream(writeStream2.getData(), writeStream2.size(), true));
+
+	EXPECT_STREQ(tws2.getAreaName().c_str(), "Test Area");
+	ASSERT_EQ(tws2.getResources().size(), 3);
+
+	EXPECT_EQ(tws2.findResource("ozymandias_1", Aurora::kFileTypeTXT), 0);
+	EXPECT_EQ(tws2.findResource("ozymandias_2", Aurora::kFileTypeBMP), 1);
+	EXPECT_EQ(tws2.findResource("ozymandias_2", Aurora::kFileTypeTXT), 0xFFFFFFFF);
+	EXPECT_EQ(tws2.findResource("ozymandias_3", Aurora::kFileTypeTXT), 2);
+
+	EXPECT_EQ(tws2.getResourceSize(0), kFileDataSize);
+	EXPECT_EQ(tws2.getResourceSize(1), kLogoDataSize);
+	EXPECT_EQ(tws2.getResourceSize(2), kFileDataSize);
+
+	Common::ScopedPtr<Common::SeekableReadStream> readStream1(tws2.getResource(0));
+	Common::ScopedPtr<Common::SeekableReadStream> readStream2(tws2.getResource(1));
+	Common::ScopedPtr<Common::SeekableReadStream> readStream3(tws2.getResource(2));
+
+	for (size_t i = 0; i < kFileDataSize; ++i) {
+		EXPECT_EQ(readStream1->readByte(), (byte) kFileData[i]);
+	}
+	for (size_t i = 0; i < kLogoDataSize; ++i) {
+		EXPECT_EQ(readStream2->readByte(), kLogoData[i]);
+	}
+	for (size_t i = 0; i < kFileDataSize; ++i) {
+		EXPECT_EQ(readStream3->readByte(), (byte) kFileData[i]);
+	}
+}
+
+GTEST_TEST(TheWitcherSaveWriter, CopyRun) {
+	Common::MemoryReadStream dataStream(kFileData, true);
+	const size_t kFileDataSize = dataStream.size();
+
+	Common::MemoryWriteStreamDynamic writeStream1;
+	Aurora::TheWitcherSaveWriter twsWriter1("Test Area", writeStream1);
+	twsWriter1.add("ozymandias_1", Aurora::kFileTypeTXT, dataStream);
+	dataStream.seek(0);
+	twsWriter1.add("ozymandias_2", Aurora::kFileTypeTXT, dataStream);
+	twsWriter1.finish();
+
+	const Aurora::TheWitcherSaveFile tws1(new Common::MemoryReadStream(writeStream1.getData(), writeStream1.size(), true));
+
+	// Copying all resources should reproduce the archive exactly
+	Common::MemoryWriteStreamDynamic writeStream2;
+	Aurora::TheWitcherSaveWriter twsWriter2(tws1.getAreaName(), writeStream2);
+	twsWriter2.add(tws1, 0);
+	twsWriter2.add(tws1, 1);
+	twsWriter2.finish();
+
+	ASSERT_EQ(writeStream2.size(), writeStream1.size());
+	for (size_t i = 0; i < writeStream1.size(); ++i)
+		EXPECT_EQ(writeStream2.getData()[i], writeStream1.getData()[i]) << "At index " << i;
+
+	EXPECT_EQ(tws1.getResourceSize(1), kFileDataSize);
+}
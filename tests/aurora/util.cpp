@@ -39,3 +39,36 @@ GTEST_TEST(AuroraUtil, getFileType) {
 
 	destroyTypeMan();
 }
+
+GTEST_TEST(AuroraUtil, getExtension) {
+	EXPECT_STREQ(TypeMan.getExtension(Aurora::kFileTypeTGA), ".tga");
+	EXPECT_STREQ(TypeMan.getExtension(Aurora::kFileTypeKEY), ".key");
+
+	EXPECT_STREQ(TypeMan.getExtension(Aurora::kFileTypeNone), "");
+
+	destroyTypeMan();
+}
+
+GTEST_TEST(AuroraUtil, splitFileType) {
+	Common::UString path1("/path/to/file.tga");
+	EXPECT_EQ(TypeMan.splitFileType(path1), Aurora::kFileTypeTGA);
+	EXPECT_STREQ(path1.c_str(), "/path/to/file");
+
+	Common::UString path2("path\\to\\file.KEY");
+	EXPECT_EQ(TypeMan.splitFileType(path2), Aurora::kFileTypeKEY);
+	EXPECT_STREQ(path2.c_str(), "path\\to\\file");
+
+	Common::UString path3("/path/to/file.nope");
+	EXPECT_EQ(TypeMan.splitFileType(path3), Aurora::kFileTypeNone);
+	EXPECT_STREQ(path3.c_str(), "/path/to/file");
+
+	Common::UString path4("/path.to/file");
+	EXPECT_EQ(TypeMan.splitFileType(path4), Aurora::kFileTypeNone);
+	EXPECT_STREQ(path4.c_str(), "/path.to/file");
+
+	Common::UString path5("/path/to/..");
+	EXPECT_EQ(TypeMan.splitFileType(path5), Aurora::kFileTypeNone);
+	EXPECT_STREQ(path5.c_str(), "/path/to/..");
+
+	destroyTypeMan();
+}
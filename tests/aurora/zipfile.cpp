@@ -116,6 +116,21 @@ GTEST_TEST(ZIPFile, getResourceSize) {
 	EXPECT_THROW(zip.getResourceSize(1), Common::Exception);
 }
 
+GTEST_TEST(ZIPFile, getResourceStorage) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kZIPFile);
+	const Aurora::ZIPFile zip(stream);
+
+	Aurora::ZIPFile::ResourceStorage storage;
+	ASSERT_TRUE(zip.getResourceStorage(0, storage));
+
+	EXPECT_EQ(storage.offset, 0);
+	EXPECT_EQ(storage.packedSize, 375);
+	EXPECT_EQ(storage.size, strlen(kFileData));
+	EXPECT_STREQ(storage.compression, "deflate");
+
+	EXPECT_THROW(zip.getResourceStorage(1, storage), Common::Exception);
+}
+
 GTEST_TEST(ZIPFile, findResourceHash) {
 	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kZIPFile);
 	const Aurora::ZIPFile zip(stream);
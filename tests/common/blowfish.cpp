@@ -81,3 +81,92 @@ GTEST_TEST(Blowfish, misalign) {
 
 	EXPECT_THROW(Common::decryptBlowfishEBC(cipherText, key), Common::Exception);
 }
+
+GTEST_TEST(Blowfish, expandedKey) {
+	std::vector<byte> key;
+	createKey(key);
+
+	const Common::BlowfishKey blowfishKey(key);
+
+	// The same key can be used for several streams, in both directions
+
+	for (size_t n = 0; n < 2; n++) {
+		Common::MemoryReadStream clearText(kClearText);
+
+		Common::MemoryReadStream *cipherText = Common::encryptBlowfishEBC(clearText, blowfishKey);
+		ASSERT_EQ(cipherText->size(), ARRAYSIZE(kCypherText));
+
+		for (size_t i = 0; i < ARRAYSIZE(kCypherText); i++)
+			EXPECT_EQ(cipherText->readByte(), kCypherText[i]) << "At index " << i;
+
+		delete cipherText;
+	}
+
+	for (size_t n = 0; n < 2; n++) {
+		Common::MemoryReadStream cipherText(kCypherText);
+
+		Common::MemoryReadStream *clearText = Common::decryptBlowfishEBC(cipherText, blowfishKey);
+		ASSERT_GE(clearText->size(), ARRAYSIZE(kClearText));
+
+		for (size_t i = 0; i < ARRAYSIZE(kClearText); i++)
+			EXPECT_EQ(clearText->readByte(), kClearText[i]) << "At index " << i;
+
+		delete clearText;
+	}
+}
+
+GTEST_TEST(Blowfish, invalidKey) {
+	EXPECT_THROW(Common::BlowfishKey(std::vector<byte>()), Common::Exception);
+	EXPECT_THROW(Common::BlowfishKey(std::vector<byte>(57, 0x42)), Common::Exception);
+}
+
+GTEST_TEST(Blowfish, readStream) {
+	std::vector<byte> key;
+	createKey(key);
+
+	// Several KB of data, so that reads span more than the stream's block cache
+	static const size_t kDataSize = 8192;
+
+	byte clearData[kDataSize];
+	for (size_t i = 0; i < kDataSize; i++)
+		clearData[i] = (byte) ((i * 7) ^ (i >> 8));
+
+	Common::MemoryReadStream clearText(clearData);
+	Common::BlowfishEBCReadStream stream(Common::encryptBlowfishEBC(clearText, key), key);
+
+	ASSERT_EQ(stream.size(), kDataSize);
+
+	byte buffer[kDataSize];
+
+	// Unaligned small reads crossing block boundaries
+	static const size_t kReads[][2] = {
+		{    3,    5 }, {    0,   17 }, { 1021,    6 }, { 4090,   12 }, { 8185,    7 },
+		{  500,   30 }, {    8, 4000 }, {    1, 8000 }, {    0, 8192 }, { 7000, 1000 }
+	};
+
+	for (size_t i = 0; i < ARRAYSIZE(kReads); i++) {
+		const size_t start = kReads[i][0], size = kReads[i][1];
+
+		stream.seek(start);
+		ASSERT_EQ(stream.read(buffer, size), size) << "At read " << i;
+		ASSERT_EQ(stream.pos(), start + size) << "At read " << i;
+
+		for (size_t j = 0; j < size; j++)
+			ASSERT_EQ(buffer[j], clearData[start + j]) << "At read " << i << ", index " << j;
+	}
+
+	// Reading past the end
+	stream.seek(kDataSize - 4);
+	EXPECT_EQ(stream.read(buffer, 8), 4);
+	EXPECT_TRUE(stream.eos());
+
+	EXPECT_THROW(stream.seek(kDataSize + 1), Common::Exception);
+}
+
+GTEST_TEST(Blowfish, readStreamMisalign) {
+	std::vector<byte> key;
+	createKey(key);
+
+	EXPECT_THROW(Common::BlowfishEBCReadStream(new Common::MemoryReadStream(kCypherText, 7), key),
+	             Common::Exception);
+}
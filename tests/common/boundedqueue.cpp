@@ -0,0 +1,97 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our thread-safe bounded queue.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/boundedqueue.h"
+
+typedef Common::BoundedQueue<size_t> SizeQueue;
+
+static void produce(SizeQueue *queue, size_t count) {
+	for (size_t i = 0; i < count; i++)
+		queue->push(i);
+
+	queue->close();
+}
+
+GTEST_TEST(BoundedQueue, pushPop) {
+	SizeQueue queue(4);
+
+	EXPECT_TRUE(queue.push(1));
+	EXPECT_TRUE(queue.push(2));
+	EXPECT_EQ(queue.size(), 2);
+
+	size_t item = 0;
+	EXPECT_TRUE(queue.pop(item));
+	EXPECT_EQ(item, 1);
+	EXPECT_TRUE(queue.pop(item));
+	EXPECT_EQ(item, 2);
+	EXPECT_EQ(queue.size(), 0);
+}
+
+GTEST_TEST(BoundedQueue, close) {
+	SizeQueue queue(4);
+
+	EXPECT_TRUE(queue.push(1));
+	queue.close();
+
+	// No new items, but the queued ones are still there
+	EXPECT_FALSE(queue.push(2));
+
+	size_t item = 0;
+	EXPECT_TRUE(queue.pop(item));
+	EXPECT_EQ(item, 1);
+	EXPECT_FALSE(queue.pop(item));
+}
+
+GTEST_TEST(BoundedQueue, oversizedItem) {
+	SizeQueue queue(4);
+
+	// An item bigger than the capacity is accepted into an empty queue
+	EXPECT_TRUE(queue.push(1, 100));
+	EXPECT_EQ(queue.size(), 1);
+}
+
+GTEST_TEST(BoundedQueue, producerConsumer) {
+	static const size_t kCount = 10000;
+
+	SizeQueue queue(8);
+	std::thread producer(produce, &queue, kCount);
+
+	size_t item = 0, count = 0, sum = 0;
+	while (queue.pop(item)) {
+		EXPECT_EQ(item, count);
+
+		sum += item;
+		count++;
+	}
+
+	producer.join();
+
+	EXPECT_EQ(count, kCount);
+	EXPECT_EQ(sum, (kCount * (kCount - 1)) / 2);
+}
@@ -0,0 +1,83 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our array byte-swapping functions.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/byteswap.h"
+#include "src/common/endianness.h"
+
+// Enough values to exercise both the block-wise and the value-wise code paths
+
+GTEST_TEST(ByteSwap, swapBytes16) {
+	uint16 data[19];
+	for (size_t i = 0; i < ARRAYSIZE(data); i++)
+		data[i] = 0x0102 + i * 0x0101;
+
+	Common::swapBytes16(data, ARRAYSIZE(data));
+
+	for (size_t i = 0; i < ARRAYSIZE(data); i++)
+		EXPECT_EQ(data[i], SWAP_BYTES_16(0x0102 + i * 0x0101)) << "At index " << i;
+}
+
+GTEST_TEST(ByteSwap, swapBytes32) {
+	uint32 data[11];
+	for (size_t i = 0; i < ARRAYSIZE(data); i++)
+		data[i] = 0x01020304 + i * 0x01010101;
+
+	Common::swapBytes32(data, ARRAYSIZE(data));
+
+	for (size_t i = 0; i < ARRAYSIZE(data); i++)
+		EXPECT_EQ(data[i], SWAP_BYTES_32(0x01020304 + i * 0x01010101)) << "At index " << i;
+}
+
+GTEST_TEST(ByteSwap, swapBytes64) {
+	uint64 data[5];
+	for (size_t i = 0; i < ARRAYSIZE(data); i++)
+		data[i] = UINT64_C(0x0102030405060708) + i * UINT64_C(0x0101010101010101);
+
+	Common::swapBytes64(data, ARRAYSIZE(data));
+
+	for (size_t i = 0; i < ARRAYSIZE(data); i++)
+		EXPECT_EQ(data[i], SWAP_BYTES_64(UINT64_C(0x0102030405060708) + i * UINT64_C(0x0101010101010101)))
+			<< "At index " << i;
+}
+
+GTEST_TEST(ByteSwap, convertToNative32) {
+	static const byte kData[8] = { 0x12, 0x34, 0x56, 0x78, 0x78, 0x56, 0x34, 0x12 };
+
+	uint32 dataBE[2], dataLE[2];
+	std::memcpy(dataBE, kData, sizeof(kData));
+	std::memcpy(dataLE, kData, sizeof(kData));
+
+	Common::convertToNative32(dataBE, 2, true);
+	Common::convertToNative32(dataLE, 2, false);
+
+	EXPECT_EQ(dataBE[0], 0x12345678);
+	EXPECT_EQ(dataBE[1], 0x78563412);
+	EXPECT_EQ(dataLE[0], 0x78563412);
+	EXPECT_EQ(dataLE[1], 0x12345678);
+}
@@ -0,0 +1,87 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our CRC-32 implementation.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include <zlib.h>
+
+#include "gtest/gtest.h"
+
+#include "src/common/crc32.h"
+#include "src/common/hash.h"
+#include "src/common/ustring.h"
+
+static const char *kString = "123456789";
+
+static std::vector<byte> createData(size_t size) {
+	std::vector<byte> data(size);
+
+	uint32 seed = 0xDEADBEEF;
+	for (size_t i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = seed >> 24;
+	}
+
+	return data;
+}
+
+GTEST_TEST(CRC32, calcCRC32) {
+	EXPECT_EQ(Common::calcCRC32(reinterpret_cast<const byte *>(kString), strlen(kString)), 0xCBF43926);
+
+	EXPECT_EQ(Common::calcCRC32(0, 0), 0x00000000);
+}
+
+GTEST_TEST(CRC32, hashStringCRC32) {
+	EXPECT_EQ(Common::calcCRC32(reinterpret_cast<const byte *>(kString), strlen(kString)),
+	          Common::hashStringCRC32(kString));
+}
+
+GTEST_TEST(CRC32, zlib) {
+	const std::vector<byte> data = createData(4096);
+
+	// All sizes around the slice size, and at all alignments
+	for (size_t offset = 0; offset < 16; offset++) {
+		for (size_t size = 0; size < 64; size++) {
+			EXPECT_EQ(Common::calcCRC32(&data[offset], size), crc32(0, &data[offset], size))
+				<< "Offset " << offset << ", size " << size;
+		}
+	}
+
+	EXPECT_EQ(Common::calcCRC32(&data[0], data.size()), crc32(0, &data[0], data.size()));
+}
+
+GTEST_TEST(CRC32, updateCRC32) {
+	const std::vector<byte> data = createData(4096);
+
+	const uint32 crc = Common::calcCRC32(&data[0], data.size());
+
+	for (size_t split = 0; split < data.size(); split += 97) {
+		uint32 partCRC = Common::updateCRC32(0, &data[0], split);
+		partCRC = Common::updateCRC32(partCRC, &data[split], data.size() - split);
+
+		EXPECT_EQ(partCRC, crc) << "Split at " << split;
+	}
+}
@@ -22,6 +22,12 @@
  *  Unit tests for our DEFLATE decompressor (which uses zlib).
  */
 
+#include <cstring>
+
+#include <vector>
+
+#include <zlib.h>
+
 #include "gtest/gtest.h"
 
 #include "src/common/deflate.h"
@@ -266,3 +272,118 @@ GTEST_TEST(DEFLATE, decompressChunked) {
 
 	delete[] output;
 }
+
+/** Create test data with a mix of text, runs and noise, to exercise all block types. */
+static std::vector<byte> createOneShotData(size_t size) {
+	std::vector<byte> data(size);
+
+	uint32 seed = 0x12345678;
+
+	const size_t textLength = strlen(kDataUncompressed);
+	for (size_t i = 0; i < size; ) {
+		seed = seed * 1103515245 + 12345;
+
+		const size_t length = MIN<size_t>(size - i, 1 + ((seed >> 16) % 300));
+		const uint32 kind = (seed >> 8) % 3;
+
+		for (size_t j = 0; j < length; j++, i++) {
+			if      (kind == 0)
+				data[i] = kDataUncompressed[(i + j) % textLength];
+			else if (kind == 1)
+				data[i] = seed & 0xFF;
+			else
+				data[i] = (seed = seed * 1103515245 + 12345) >> 24;
+		}
+	}
+
+	return data;
+}
+
+static std::vector<byte> compressOneShotData(const std::vector<byte> &data, int level, int strategy, int windowBits) {
+	z_stream strm;
+	std::memset(&strm, 0, sizeof(strm));
+
+	EXPECT_EQ(deflateInit2(&strm, level, Z_DEFLATED, windowBits, 8, strategy), Z_OK);
+
+	std::vector<byte> compressed(deflateBound(&strm, data.size()));
+
+	strm.next_in   = const_cast<byte *>(&data[0]);
+	strm.avail_in  = data.size();
+	strm.next_out  = &compressed[0];
+	strm.avail_out = compressed.size();
+
+	EXPECT_EQ(deflate(&strm, Z_FINISH), Z_STREAM_END);
+
+	compressed.resize(strm.total_out);
+	deflateEnd(&strm);
+
+	return compressed;
+}
+
+GTEST_TEST(DEFLATE, decompressOneShot) {
+	static const int kLevels[]     = { 0, 1, 6, 9 };
+	static const int kStrategies[] = { Z_DEFAULT_STRATEGY, Z_FIXED, Z_HUFFMAN_ONLY, Z_RLE };
+	static const int kWindowBits[] = { Common::kWindowBitsMaxRaw, Common::kWindowBitsMax, -9, 9 };
+
+	const std::vector<byte> data = createOneShotData(200000);
+
+	for (size_t l = 0; l < ARRAYSIZE(kLevels); l++) {
+		for (size_t s = 0; s < ARRAYSIZE(kStrategies); s++) {
+			for (size_t w = 0; w < ARRAYSIZE(kWindowBits); w++) {
+				const std::vector<byte> compressed =
+					compressOneShotData(data, kLevels[l], kStrategies[s], kWindowBits[w]);
+
+				std::vector<byte> decompressed(data.size());
+				ASSERT_TRUE(Common::decompressDeflateOneShot(&compressed[0], compressed.size(),
+				                                             &decompressed[0], decompressed.size(),
+				                                             kWindowBits[w]))
+					<< "Level " << kLevels[l] << ", strategy " << kStrategies[s] << ", window bits " << kWindowBits[w];
+
+				EXPECT_TRUE(decompressed == data)
+					<< "Level " << kLevels[l] << ", strategy " << kStrategies[s] << ", window bits " << kWindowBits[w];
+			}
+		}
+	}
+}
+
+GTEST_TEST(DEFLATE, decompressOneShotBuf) {
+	static const size_t kSizeCompressed   = sizeof(kDataCompressed);
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	std::vector<byte> decompressed(kSizeDecompressed);
+	ASSERT_TRUE(Common::decompressDeflateOneShot(kDataCompressed, kSizeCompressed,
+	                                             &decompressed[0], kSizeDecompressed, Common::kWindowBitsMaxRaw));
+
+	for (size_t i = 0; i < kSizeDecompressed; i++)
+		EXPECT_EQ(decompressed[i], kDataUncompressed[i]) << "At index " << i;
+}
+
+GTEST_TEST(DEFLATE, decompressOneShotFail) {
+	const std::vector<byte> data = createOneShotData(10000);
+
+	std::vector<byte> compressed = compressOneShotData(data, 6, Z_DEFAULT_STRATEGY, Common::kWindowBitsMax);
+	std::vector<byte> decompressed(data.size() * 2);
+
+	// Output buffer too small or too big
+	EXPECT_FALSE(Common::decompressDeflateOneShot(&compressed[0], compressed.size(),
+	                                              &decompressed[0], data.size() - 1, Common::kWindowBitsMax));
+	EXPECT_FALSE(Common::decompressDeflateOneShot(&compressed[0], compressed.size(),
+	                                              &decompressed[0], data.size() + 1, Common::kWindowBitsMax));
+
+	// Input cut
+	EXPECT_FALSE(Common::decompressDeflateOneShot(&compressed[0], compressed.size() / 2,
+	                                              &decompressed[0], data.size(), Common::kWindowBitsMax));
+
+	// gzip isn't supported
+	EXPECT_FALSE(Common::decompressDeflateOneShot(&compressed[0], compressed.size(),
+	                                              &decompressed[0], data.size(), Common::kWindowBitsMax + 16));
+
+	// Broken checksum
+	compressed.back() ^= 0xFF;
+	EXPECT_FALSE(Common::decompressDeflateOneShot(&compressed[0], compressed.size(),
+	                                              &decompressed[0], data.size(), Common::kWindowBitsMax));
+
+	// But zlib still finds the real error
+	EXPECT_THROW(Common::decompressDeflate(&compressed[0], compressed.size(), data.size(), Common::kWindowBitsMax),
+	             Common::Exception);
+}
@@ -47,6 +47,18 @@ GTEST_TEST(XOREOS_ENCODINGNAME, readStringFixed) {
 	EXPECT_STREQ(string.c_str(), stringUString.c_str());
 }
 
+GTEST_TEST(XOREOS_ENCODINGNAME, readStringFixedAppend) {
+	testSupport(kEncoding);
+
+	Common::MemoryReadStream stream(stringDataX);
+
+	Common::UString string("Foo");
+	Common::readStringFixed(stream, kEncoding, stringBytes, string);
+
+	EXPECT_EQ(string.size(), stringChars + 3);
+	EXPECT_STREQ(string.c_str(), (Common::UString("Foo") + stringUString).c_str());
+}
+
 GTEST_TEST(XOREOS_ENCODINGNAME, readStringLine) {
 	testSupport(kEncoding);
 
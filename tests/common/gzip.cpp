@@ -0,0 +1,237 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our gzip compressing and decompressing streams.
+ */
+
+#include <cstring>
+
+#include <vector>
+#include <algorithm>
+
+#include <zlib.h>
+
+#include "gtest/gtest.h"
+
+#include "src/common/gzip.h"
+#include "src/common/parallel.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/error.h"
+
+static const char *kText =
+	"I met a traveller from an antique land\n"
+	"Who said: Two vast and trunkless legs of stone\n"
+	"Stand in the desert. Near them, on the sand,\n"
+	"Half sunk, a shattered visage lies, whose frown,\n";
+
+/** Create compressible, but not trivially repeating, test data. */
+static void createData(std::vector<byte> &data, size_t size) {
+	data.resize(size);
+
+	uint32 seed = 0x12345678;
+	for (size_t i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+
+		data[i] = "abcdefgh <>/=\"\n"[(seed >> 16) % 15];
+	}
+}
+
+/** Decompress gzip data with zlib directly, independently of GzipReadStream. */
+static void gunzip(const byte *data, size_t size, std::vector<byte> &output) {
+	z_stream strm;
+	std::memset(&strm, 0, sizeof(strm));
+
+	ASSERT_EQ(inflateInit2(&strm, MAX_WBITS + 16), Z_OK);
+
+	strm.next_in  = const_cast<byte *>(data);
+	strm.avail_in = size;
+
+	byte buffer[4096];
+
+	int zResult = Z_OK;
+	while (zResult == Z_OK) {
+		strm.next_out  = buffer;
+		strm.avail_out = sizeof(buffer);
+
+		zResult = inflate(&strm, Z_NO_FLUSH);
+
+		output.insert(output.end(), buffer, buffer + sizeof(buffer) - strm.avail_out);
+	}
+
+	inflateEnd(&strm);
+
+	ASSERT_EQ(zResult, Z_STREAM_END);
+	ASSERT_EQ(strm.avail_in, 0U);
+}
+
+static void compress(const std::vector<byte> &data, std::vector<byte> &output, int level = -1) {
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	Common::GzipWriteStream gzip(&stream, false, level);
+	gzip.write(&data[0], data.size());
+	gzip.finalize();
+
+	output.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+GTEST_TEST(Gzip, isGzip) {
+	static const byte kGzip[] = { 0x1F, 0x8B, 0x08 };
+	static const byte kXML [] = { '<', '?', 'x' };
+
+	EXPECT_TRUE (Common::isGzip(kGzip, sizeof(kGzip)));
+	EXPECT_FALSE(Common::isGzip(kXML , sizeof(kXML )));
+	EXPECT_FALSE(Common::isGzip(kGzip, 1));
+}
+
+GTEST_TEST(Gzip, writeSmall) {
+	const std::vector<byte> data(kText, kText + std::strlen(kText));
+
+	std::vector<byte> compressed;
+	compress(data, compressed);
+
+	ASSERT_GE(compressed.size(), 18U);
+	EXPECT_TRUE(Common::isGzip(&compressed[0], compressed.size()));
+
+	std::vector<byte> decompressed;
+	gunzip(&compressed[0], compressed.size(), decompressed);
+
+	EXPECT_EQ(decompressed, data);
+}
+
+GTEST_TEST(Gzip, writeManyBlocks) {
+	// Span more than one batch of blocks, and end with a partial block
+	const size_t batchSize = 4 * Common::getThreadCount() * Common::GzipWriteStream::kBlockSize;
+
+	std::vector<byte> data;
+	createData(data, 2 * batchSize + 1234);
+
+	std::vector<byte> compressed;
+	compress(data, compressed, 1);
+
+	EXPECT_LT(compressed.size(), data.size());
+
+	std::vector<byte> decompressed;
+	gunzip(&compressed[0], compressed.size(), decompressed);
+
+	EXPECT_EQ(decompressed, data);
+}
+
+GTEST_TEST(Gzip, writeEmpty) {
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	{
+		Common::GzipWriteStream gzip(&stream, false);
+		gzip.flush();
+		gzip.finalize();
+	}
+
+	EXPECT_EQ(stream.size(), 0U);
+}
+
+GTEST_TEST(Gzip, writeFlush) {
+	std::vector<byte> data;
+	createData(data, 100000);
+
+	std::vector<byte> expected;
+
+	Common::MemoryWriteStreamDynamic stream(true);
+	{
+		Common::GzipWriteStream gzip(&stream, false);
+
+		// Flushes of various sizes, some smaller than the deflate window
+		for (size_t size = 1; size < data.size(); size *= 3) {
+			gzip.write(&data[0], size);
+			gzip.flush();
+
+			expected.insert(expected.end(), data.begin(), data.begin() + size);
+		}
+	}
+
+	// zlib stops after the first member, so this also checks that flush() didn't end one
+	std::vector<byte> decompressed;
+	gunzip(stream.getData(), stream.size(), decompressed);
+
+	EXPECT_EQ(decompressed, expected);
+}
+
+GTEST_TEST(Gzip, readMembers) {
+	const size_t textLength = std::strlen(kText);
+
+	// Every finalize() ends a gzip member
+	Common::MemoryWriteStreamDynamic stream(true);
+	{
+		Common::GzipWriteStream gzip(&stream, false);
+
+		gzip.write(kText, textLength);
+		gzip.finalize();
+		gzip.write(kText, textLength);
+	}
+
+	Common::MemoryReadStream compressed(stream.getData(), stream.size());
+	Common::GzipReadStream gzip(&compressed, false);
+
+	std::vector<byte> decompressed(3 * textLength);
+	ASSERT_EQ(gzip.read(&decompressed[0], decompressed.size()), 2 * textLength);
+	EXPECT_TRUE(gzip.eos());
+
+	EXPECT_EQ(std::memcmp(&decompressed[0]             , kText, textLength), 0);
+	EXPECT_EQ(std::memcmp(&decompressed[0] + textLength, kText, textLength), 0);
+}
+
+GTEST_TEST(Gzip, readPrefix) {
+	std::vector<byte> data;
+	createData(data, 300000);
+
+	std::vector<byte> compressed;
+	compress(data, compressed);
+
+	// Hand over the first bytes separately, like a caller that checked the magic bytes
+	Common::MemoryReadStream stream(&compressed[2], compressed.size() - 2);
+	Common::GzipReadStream gzip(&stream, false, &compressed[0], 2);
+
+	std::vector<byte> decompressed(data.size());
+
+	size_t pos = 0;
+	while (!gzip.eos() && (pos < decompressed.size()))
+		pos += gzip.read(&decompressed[pos], std::min<size_t>(4096, decompressed.size() - pos));
+
+	EXPECT_EQ(pos, data.size());
+	EXPECT_EQ(decompressed, data);
+
+	byte extra;
+	EXPECT_EQ(gzip.read(&extra, 1), 0U);
+	EXPECT_TRUE(gzip.eos());
+}
+
+GTEST_TEST(Gzip, readTruncated) {
+	std::vector<byte> data;
+	createData(data, 10000);
+
+	std::vector<byte> compressed;
+	compress(data, compressed);
+
+	Common::MemoryReadStream stream(&compressed[0], compressed.size() - 4);
+	Common::GzipReadStream gzip(&stream, false);
+
+	std::vector<byte> decompressed(data.size() + 1);
+	EXPECT_THROW(gzip.read(&decompressed[0], decompressed.size()), Common::Exception);
+}
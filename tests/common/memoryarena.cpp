@@ -0,0 +1,125 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our memory arena.
+ */
+
+#include <map>
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/memoryarena.h"
+
+GTEST_TEST(MemoryArena, allocate) {
+	Common::MemoryArena arena(1024);
+
+	byte *a = static_cast<byte *>(arena.allocate(10, 1));
+	byte *b = static_cast<byte *>(arena.allocate(10, 1));
+
+	EXPECT_NE(a, b);
+	EXPECT_EQ(b, a + 10);
+
+	EXPECT_EQ(arena.getUsedSize(), 20);
+	EXPECT_EQ(arena.getCapacity(), 1024);
+}
+
+GTEST_TEST(MemoryArena, allocateAligned) {
+	Common::MemoryArena arena(1024);
+
+	arena.allocate(1, 1);
+
+	void *a = arena.allocate(4, 4);
+	void *b = arena.allocate(8, 8);
+	void *c = arena.allocate(1, 64);
+
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 4 , 0);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 8 , 0);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0);
+}
+
+GTEST_TEST(MemoryArena, allocateTyped) {
+	Common::MemoryArena arena(1024);
+
+	arena.allocate(1, 1);
+
+	uint64 *a = arena.allocate<uint64>(4);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(uint64), 0);
+
+	for (size_t i = 0; i < 4; i++)
+		a[i] = i;
+
+	for (size_t i = 0; i < 4; i++)
+		EXPECT_EQ(a[i], i);
+}
+
+GTEST_TEST(MemoryArena, allocateLarge) {
+	Common::MemoryArena arena(1024);
+
+	arena.allocate(512, 1);
+
+	// Bigger than the block size, needs its own block
+	byte *a = static_cast<byte *>(arena.allocate(4096, 1));
+	a[0] = a[4095] = 0xFF;
+
+	EXPECT_EQ(arena.getUsedSize(), 512 + 4096);
+	EXPECT_GE(arena.getCapacity(), 1024 + 4096);
+}
+
+GTEST_TEST(MemoryArena, reset) {
+	Common::MemoryArena arena(1024);
+
+	void *a = arena.allocate(100, 1);
+	arena.allocate(2000, 1);
+
+	const size_t capacity = arena.getCapacity();
+
+	arena.reset();
+	EXPECT_EQ(arena.getUsedSize(), 0);
+
+	// The blocks are reused after a reset
+	void *b = arena.allocate(100, 1);
+	arena.allocate(2000, 1);
+
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(arena.getCapacity(), capacity);
+}
+
+GTEST_TEST(MemoryArena, allocator) {
+	Common::MemoryArena arena(1024);
+
+	typedef std::pair<const uint32, uint32> Entry;
+	typedef std::map<uint32, uint32, std::less<uint32>, Common::ArenaAllocator<Entry> > Map;
+
+	Common::ArenaAllocator<Entry> allocator(arena);
+
+	Map map(std::less<uint32>(), allocator);
+	for (uint32 i = 0; i < 100; i++)
+		map[i] = i * 2;
+
+	EXPECT_EQ(map.size(), 100);
+	EXPECT_GT(arena.getUsedSize(), 0);
+
+	for (uint32 i = 0; i < 100; i++)
+		EXPECT_EQ(map[i], i * 2);
+
+	EXPECT_EQ(map.get_allocator().getArena(), &arena);
+}
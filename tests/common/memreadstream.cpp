@@ -332,3 +332,50 @@ GTEST_TEST(SeekableSubReadStreamEndian, streamEndianBE) {
 	EXPECT_EQ(subStream.readUint32(), 305419896);
 	EXPECT_THROW(subStream.readUint32(), Common::Exception);
 }
+
+GTEST_TEST(SeekableSubReadStreamEndian, streamEndianArrayLE) {
+	static const byte data[14] = {
+		0x34, 0x12, 0x78, 0x56, 0x34, 0x12, 0xEF, 0xCD, 0xAB, 0x89, 0x67, 0x45, 0x23, 0x01
+	};
+	Common::MemoryReadStream stream(data);
+
+	Common::SeekableSubReadStreamEndian subStream(&stream, 0, stream.size(), false);
+
+	uint16 data16[1];
+	subStream.readUint16(data16, 1);
+	EXPECT_EQ(data16[0], 0x1234);
+
+	uint32 data32[1];
+	subStream.readUint32(data32, 1);
+	EXPECT_EQ(data32[0], 0x12345678);
+
+	uint64 data64[1];
+	subStream.readUint64(data64, 1);
+	EXPECT_EQ(data64[0], UINT64_C(0x0123456789ABCDEF));
+
+	EXPECT_THROW(subStream.readUint32(data32, 1), Common::Exception);
+}
+
+GTEST_TEST(SeekableSubReadStreamEndian, streamEndianArrayBE) {
+	static const byte data[12] = {
+		0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x05, 0x00, 0x06
+	};
+	Common::MemoryReadStream stream(data);
+
+	Common::SeekableSubReadStreamEndian subStream(&stream, 0, stream.size(), true);
+
+	uint32 data32[3];
+	subStream.readUint32(data32, 3);
+	EXPECT_EQ(data32[0], 0x00010002);
+	EXPECT_EQ(data32[1], 0x00030004);
+	EXPECT_EQ(data32[2], 0x00050006);
+
+	subStream.seek(0);
+
+	uint16 data16[6];
+	subStream.readUint16(data16, 6);
+	for (size_t i = 0; i < 6; i++)
+		EXPECT_EQ(data16[i], i + 1) << "At index " << i;
+
+	EXPECT_THROW(subStream.readUint16(data16, 1), Common::Exception);
+}
@@ -0,0 +1,294 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our parallel helpers.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/error.h"
+#include "src/common/parallel.h"
+
+class CountJob : public Common::ParallelJob {
+public:
+	CountJob(size_t count) : _counts(count), _total(0) {
+		for (size_t i = 0; i < count; i++)
+			_counts[i] = 0;
+	}
+
+	void run(size_t index) {
+		_counts[index]++;
+		_total++;
+	}
+
+	size_t getCount(size_t index) const {
+		return _counts[index];
+	}
+
+	size_t getTotal() const {
+		return _total;
+	}
+
+private:
+	std::vector<size_t> _counts;
+	std::atomic<size_t> _total;
+};
+
+class ThrowJob : public Common::ParallelJob {
+public:
+	void run(size_t index) {
+		if ((index == 5) || (index == 7))
+			throw Common::Exception("Failed %u", (uint)index);
+	}
+};
+
+class NestedJob : public Common::ParallelJob {
+public:
+	NestedJob() : _total(0) {
+	}
+
+	void run(size_t) {
+		CountJob job(10);
+		Common::parallelFor(10, job);
+
+		_total += job.getTotal();
+	}
+
+	size_t getTotal() const {
+		return _total;
+	}
+
+private:
+	std::atomic<size_t> _total;
+};
+
+GTEST_TEST(Parallel, getHardwareThreadCount) {
+	EXPECT_GE(Common::getHardwareThreadCount(), 1);
+}
+
+GTEST_TEST(Parallel, parallelFor) {
+	static const size_t kCount = 1000;
+
+	CountJob job(kCount);
+	Common::parallelFor(kCount, job, 4);
+
+	EXPECT_EQ(job.getTotal(), kCount);
+	for (size_t i = 0; i < kCount; i++)
+		EXPECT_EQ(job.getCount(i), 1) << "At index " << i;
+}
+
+GTEST_TEST(Parallel, parallelForSerial) {
+	CountJob job(10);
+	Common::parallelFor(10, job, 1);
+
+	EXPECT_EQ(job.getTotal(), 10);
+}
+
+GTEST_TEST(Parallel, parallelForEmpty) {
+	CountJob job(0);
+	Common::parallelFor(0, job);
+
+	EXPECT_EQ(job.getTotal(), 0);
+}
+
+GTEST_TEST(Parallel, parallelForException) {
+	ThrowJob job;
+
+	try {
+		Common::parallelFor(100, job, 4);
+		FAIL() << "No exception thrown";
+	} catch (Common::Exception &e) {
+		// Only the first failed item is reported
+		EXPECT_STREQ(e.what(), "Failed 5");
+	}
+}
+
+GTEST_TEST(Parallel, parallelForNested) {
+	NestedJob job;
+	Common::parallelFor(8, job, 4);
+
+	EXPECT_EQ(job.getTotal(), 80);
+}
+
+class CountTask : public Common::Task {
+public:
+	CountTask(std::atomic<size_t> &total) : _total(&total) {
+	}
+
+	void run() {
+		(*_total)++;
+	}
+
+private:
+	std::atomic<size_t> *_total;
+};
+
+class ThrowTask : public Common::Task {
+public:
+	void run() {
+		throw Common::Exception("Task failed");
+	}
+};
+
+/** A task spawning more tasks into its own group. */
+class SpawnTask : public Common::Task {
+public:
+	SpawnTask(std::atomic<size_t> &total) : _total(&total) {
+	}
+
+	void run() {
+		std::vector<CountTask> tasks(16, CountTask(*_total));
+
+		Common::TaskGroup group;
+		for (std::vector<CountTask>::iterator t = tasks.begin(); t != tasks.end(); ++t)
+			group.run(*t);
+
+		group.wait();
+	}
+
+private:
+	std::atomic<size_t> *_total;
+};
+
+class RangeJob : public Common::ParallelRangeJob {
+public:
+	RangeJob(size_t count) : _counts(count), _ranges(0) {
+		for (size_t i = 0; i < count; i++)
+			_counts[i] = 0;
+	}
+
+	void run(size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			_counts[i]++;
+
+		_ranges++;
+	}
+
+	size_t getCount(size_t index) const {
+		return _counts[index];
+	}
+
+	size_t getRanges() const {
+		return _ranges;
+	}
+
+private:
+	std::vector<size_t> _counts;
+	std::atomic<size_t> _ranges;
+};
+
+GTEST_TEST(Parallel, taskGroup) {
+	std::atomic<size_t> total(0);
+	std::vector<CountTask> tasks(100, CountTask(total));
+
+	Common::TaskGroup group;
+	for (std::vector<CountTask>::iterator t = tasks.begin(); t != tasks.end(); ++t)
+		group.run(*t);
+
+	group.wait();
+
+	EXPECT_EQ(total, 100);
+	EXPECT_FALSE(group.hasFailed());
+}
+
+GTEST_TEST(Parallel, taskGroupNested) {
+	std::atomic<size_t> total(0);
+	std::vector<SpawnTask> tasks(8, SpawnTask(total));
+
+	Common::TaskGroup group;
+	for (std::vector<SpawnTask>::iterator t = tasks.begin(); t != tasks.end(); ++t)
+		group.run(*t);
+
+	group.wait();
+
+	EXPECT_EQ(total, 8 * 16);
+}
+
+GTEST_TEST(Parallel, taskGroupException) {
+	std::atomic<size_t> total(0);
+
+	CountTask countTask(total);
+	ThrowTask throwTask;
+
+	Common::TaskGroup group;
+	group.run(countTask);
+	group.run(throwTask);
+	group.run(countTask);
+
+	EXPECT_THROW(group.wait(), Common::Exception);
+
+	// All other tasks still ran, and the error is only reported once
+	EXPECT_EQ(total, 2);
+	EXPECT_NO_THROW(group.wait());
+}
+
+GTEST_TEST(Parallel, parallelForRange) {
+	static const size_t kCount = 1000;
+
+	RangeJob job(kCount);
+	Common::parallelForRange(kCount, job, 64);
+
+	EXPECT_EQ(job.getRanges(), 16);
+	for (size_t i = 0; i < kCount; i++)
+		EXPECT_EQ(job.getCount(i), 1) << "At index " << i;
+}
+
+GTEST_TEST(Parallel, setThreadCount) {
+	Common::setThreadCount(3);
+	EXPECT_EQ(Common::getThreadCount(), 3);
+
+	CountJob job(100);
+	Common::parallelFor(100, job);
+
+	EXPECT_EQ(job.getTotal(), 100);
+
+	Common::setThreadCount(1);
+	EXPECT_EQ(Common::getThreadCount(), 1);
+
+	NestedJob nestedJob;
+	Common::parallelFor(8, nestedJob);
+
+	EXPECT_EQ(nestedJob.getTotal(), 80);
+
+	Common::setThreadCount(0);
+	EXPECT_EQ(Common::getThreadCount(), Common::getHardwareThreadCount());
+}
+
+GTEST_TEST(Parallel, shutdownScheduler) {
+	CountJob job1(100);
+	Common::parallelFor(100, job1, 4);
+
+	EXPECT_EQ(job1.getTotal(), 100);
+
+	Common::shutdownScheduler();
+	Common::shutdownScheduler();
+
+	// Running tasks again starts new worker threads
+	CountJob job2(100);
+	Common::parallelFor(100, job2, 4);
+
+	EXPECT_EQ(job2.getTotal(), 100);
+
+	Common::shutdownScheduler();
+}
@@ -146,6 +146,54 @@ GTEST_TEST_F(PtrList, eraseRange) {
 	EXPECT_EQ(kDestructorCalled , 3);
 }
 
+GTEST_TEST_F(PtrList, erasePartialRange) {
+	Common::PtrList<TestClass> ptrList;
+
+	ptrList.push_back(new TestClass);
+	ptrList.push_back(new TestClass);
+	ptrList.push_back(new TestClass);
+	ptrList.erase(++ptrList.begin(), ptrList.end());
+
+	EXPECT_EQ(kConstructorCalled, 3);
+	EXPECT_EQ(kDestructorCalled , 2);
+	EXPECT_EQ(ptrList.size(), 1);
+}
+
+GTEST_TEST_F(PtrList, moveConstruct) {
+	Common::PtrList<TestClass> ptrList1;
+
+	ptrList1.push_back(new TestClass);
+	ptrList1.push_back(new TestClass);
+
+	Common::PtrList<TestClass> ptrList2(std::move(ptrList1));
+
+	EXPECT_EQ(kConstructorCalled, 2);
+	EXPECT_EQ(kDestructorCalled , 0);
+
+	EXPECT_TRUE(ptrList1.empty());
+	EXPECT_EQ(ptrList2.size(), 2);
+
+	ptrList2.clear();
+
+	EXPECT_EQ(kDestructorCalled , 2);
+}
+
+GTEST_TEST_F(PtrList, moveAssign) {
+	Common::PtrList<TestClass> ptrList1, ptrList2;
+
+	ptrList1.push_back(new TestClass);
+	ptrList1.push_back(new TestClass);
+	ptrList2.push_back(new TestClass);
+
+	ptrList2 = std::move(ptrList1);
+
+	EXPECT_EQ(kConstructorCalled, 3);
+	EXPECT_EQ(kDestructorCalled , 1);
+
+	EXPECT_TRUE(ptrList1.empty());
+	EXPECT_EQ(ptrList2.size(), 2);
+}
+
 GTEST_TEST_F(PtrList, remove) {
 	Common::PtrList<TestClass> ptrList;
 
@@ -93,6 +93,50 @@ GTEST_TEST_F(PtrMap, eraseRange) {
 	EXPECT_EQ(kDestructorCalled , 3);
 }
 
+GTEST_TEST_F(PtrMap, erasePartialRange) {
+	Common::PtrMap<int, TestClass> ptrMap;
+
+	ptrMap.insert(std::make_pair(0, new TestClass));
+	ptrMap.insert(std::make_pair(1, new TestClass));
+	ptrMap.insert(std::make_pair(2, new TestClass));
+	ptrMap.erase(++ptrMap.begin(), ptrMap.end());
+
+	EXPECT_EQ(kConstructorCalled, 3);
+	EXPECT_EQ(kDestructorCalled , 2);
+	EXPECT_EQ(ptrMap.size(), 1);
+}
+
+GTEST_TEST_F(PtrMap, moveConstruct) {
+	Common::PtrMap<int, TestClass> ptrMap1;
+
+	ptrMap1.insert(std::make_pair(0, new TestClass));
+	ptrMap1.insert(std::make_pair(1, new TestClass));
+
+	Common::PtrMap<int, TestClass> ptrMap2(std::move(ptrMap1));
+
+	EXPECT_EQ(kConstructorCalled, 2);
+	EXPECT_EQ(kDestructorCalled , 0);
+
+	EXPECT_TRUE(ptrMap1.empty());
+	EXPECT_EQ(ptrMap2.size(), 2);
+}
+
+GTEST_TEST_F(PtrMap, moveAssign) {
+	Common::PtrMap<int, TestClass> ptrMap1, ptrMap2;
+
+	ptrMap1.insert(std::make_pair(0, new TestClass));
+	ptrMap1.insert(std::make_pair(1, new TestClass));
+	ptrMap2.insert(std::make_pair(0, new TestClass));
+
+	ptrMap2 = std::move(ptrMap1);
+
+	EXPECT_EQ(kConstructorCalled, 3);
+	EXPECT_EQ(kDestructorCalled , 1);
+
+	EXPECT_TRUE(ptrMap1.empty());
+	EXPECT_EQ(ptrMap2.size(), 2);
+}
+
 GTEST_TEST_F(PtrMap, eraseVal) {
 	Common::PtrMap<int, TestClass> ptrMap;
 
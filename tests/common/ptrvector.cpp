@@ -136,6 +136,54 @@ GTEST_TEST_F(PtrVector, eraseRange) {
 	EXPECT_EQ(kDestructorCalled , 3);
 }
 
+GTEST_TEST_F(PtrVector, erasePartialRange) {
+	Common::PtrVector<TestClass> ptrVector;
+
+	ptrVector.push_back(new TestClass);
+	ptrVector.push_back(new TestClass);
+	ptrVector.push_back(new TestClass);
+	ptrVector.erase(++ptrVector.begin(), ptrVector.end());
+
+	EXPECT_EQ(kConstructorCalled, 3);
+	EXPECT_EQ(kDestructorCalled , 2);
+	EXPECT_EQ(ptrVector.size(), 1);
+}
+
+GTEST_TEST_F(PtrVector, moveConstruct) {
+	Common::PtrVector<TestClass> ptrVector1;
+
+	ptrVector1.push_back(new TestClass);
+	ptrVector1.push_back(new TestClass);
+
+	Common::PtrVector<TestClass> ptrVector2(std::move(ptrVector1));
+
+	EXPECT_EQ(kConstructorCalled, 2);
+	EXPECT_EQ(kDestructorCalled , 0);
+
+	EXPECT_TRUE(ptrVector1.empty());
+	EXPECT_EQ(ptrVector2.size(), 2);
+
+	ptrVector2.clear();
+
+	EXPECT_EQ(kDestructorCalled , 2);
+}
+
+GTEST_TEST_F(PtrVector, moveAssign) {
+	Common::PtrVector<TestClass> ptrVector1, ptrVector2;
+
+	ptrVector1.push_back(new TestClass);
+	ptrVector1.push_back(new TestClass);
+	ptrVector2.push_back(new TestClass);
+
+	ptrVector2 = std::move(ptrVector1);
+
+	EXPECT_EQ(kConstructorCalled, 3);
+	EXPECT_EQ(kDestructorCalled , 1);
+
+	EXPECT_TRUE(ptrVector1.empty());
+	EXPECT_EQ(ptrVector2.size(), 2);
+}
+
 GTEST_TEST_F(PtrVector, assign) {
 	Common::PtrVector<TestClass> ptrVector;
 	ptrVector.push_back(new TestClass);
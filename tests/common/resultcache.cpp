@@ -0,0 +1,217 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our on-disk cache of conversion results.
+ */
+
+#include <ctime>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/platform.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/resultcache.h"
+
+boost::filesystem::path kDirectoryPath;
+
+class ResultCache : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+	}
+
+	void SetUp() {
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kDirectoryPath = tmpPath / uniquePath;
+	}
+
+	void TearDown() {
+		if (!kDirectoryPath.empty())
+			boost::filesystem::remove_all(kDirectoryPath);
+	}
+};
+
+static Common::UString readAll(Common::SeekableReadStream &stream) {
+	Common::UString str;
+
+	byte c;
+	while (stream.read(&c, 1) == 1)
+		str += (uint32) c;
+
+	return str;
+}
+
+static Common::UString makeKey(const char *str) {
+	Common::ResultCacheKey key;
+	key.add(str);
+
+	return key.get();
+}
+
+GTEST_TEST(ResultCacheKey, get) {
+	static const byte kData1[] = { 'f', 'o', 'o' };
+	static const byte kData2[] = { 'b', 'a', 'r' };
+
+	Common::MemoryReadStream stream1(kData1);
+	Common::MemoryReadStream stream2(kData2);
+
+	Common::ResultCacheKey key1, key2, key3, key4, key5;
+
+	key1.add("tool");
+	key1.add(stream1);
+
+	key2.add("tool");
+	key2.add(stream1);
+
+	key3.add("tool");
+	key3.add(stream2);
+
+	key4.add("tool");
+	key4.add("--option");
+	key4.add(stream1);
+
+	// Adding the parts in a different split mustn't produce the same key
+	key5.add("tool--option");
+	key5.add(stream1);
+
+	EXPECT_EQ(key1.get().size(), 32);
+
+	EXPECT_TRUE (key1.get() == key2.get());
+	EXPECT_FALSE(key1.get() == key3.get());
+	EXPECT_FALSE(key1.get() == key4.get());
+	EXPECT_FALSE(key4.get() == key5.get());
+
+	// The stream is rewound after it was hashed
+	EXPECT_EQ(stream1.pos(), 0);
+}
+
+GTEST_TEST_F(ResultCache, storeFind) {
+	Common::ResultCache cache(kDirectoryPath.generic_string());
+
+	const Common::UString key1 = makeKey("1");
+	const Common::UString key2 = makeKey("2");
+
+	EXPECT_EQ(cache.find(key1), (Common::SeekableReadStream *) 0);
+
+	cache.store(key1, reinterpret_cast<const byte *>("foobar"), 6);
+
+	Common::ScopedPtr<Common::SeekableReadStream> result(cache.find(key1));
+	ASSERT_TRUE(result);
+
+	EXPECT_EQ(result->size(), 6);
+	EXPECT_STREQ(readAll(*result).c_str(), "foobar");
+
+	EXPECT_EQ(cache.find(key2), (Common::SeekableReadStream *) 0);
+
+	// Storing under the same key again replaces the result
+	cache.store(key1, reinterpret_cast<const byte *>("barfoo"), 6);
+
+	result.reset(cache.find(key1));
+	ASSERT_TRUE(result);
+
+	EXPECT_STREQ(readAll(*result).c_str(), "barfoo");
+}
+
+GTEST_TEST_F(ResultCache, storeEmpty) {
+	Common::ResultCache cache(kDirectoryPath.generic_string());
+
+	const Common::UString key = makeKey("1");
+
+	cache.store(key, 0, 0);
+
+	Common::ScopedPtr<Common::SeekableReadStream> result(cache.find(key));
+	ASSERT_TRUE(result);
+
+	EXPECT_EQ(result->size(), 0);
+}
+
+GTEST_TEST_F(ResultCache, invalidKey) {
+	Common::ResultCache cache(kDirectoryPath.generic_string());
+
+	EXPECT_THROW(cache.find("../foo"), Common::Exception);
+	EXPECT_THROW(cache.store("", 0, 0), Common::Exception);
+}
+
+GTEST_TEST_F(ResultCache, trim) {
+	static const size_t kResultSize = 100;
+
+	// Space for 10 results, including their headers
+	Common::ResultCache cache(kDirectoryPath.generic_string(), 10 * (kResultSize + 16));
+
+	byte data[kResultSize] = { 0 };
+
+	const std::time_t now = std::time(0);
+
+	std::vector<Common::UString> keys;
+	for (size_t i = 0; i < 10; i++) {
+		keys.push_back(makeKey(Common::composeString(i).c_str()));
+		cache.store(keys.back(), data, kResultSize);
+
+		// Pretend the results were used one after the other, the first one longest ago
+		const Common::UString path = kDirectoryPath.generic_string() + "/" +
+		                             keys.back().substr(keys.back().begin(), keys.back().getPosition(2)) +
+		                             "/" + keys.back();
+		boost::filesystem::last_write_time(path.c_str(), now - 1000 + i);
+	}
+
+	cache.trim(true);
+	for (size_t i = 0; i < 10; i++)
+		EXPECT_TRUE(Common::ScopedPtr<Common::SeekableReadStream>(cache.find(keys[i]))) << i;
+
+	// Using a result makes it the most recently used one
+	for (size_t i = 0; i < 10; i++) {
+		const Common::UString path = kDirectoryPath.generic_string() + "/" +
+		                             keys[i].substr(keys[i].begin(), keys[i].getPosition(2)) + "/" + keys[i];
+		boost::filesystem::last_write_time(path.c_str(), now - 1000 + i);
+	}
+
+	Common::ScopedPtr<Common::SeekableReadStream> result(cache.find(keys[0]));
+	result.reset();
+
+	// One result too many: the least recently used ones are removed, down to 90%
+	keys.push_back(makeKey("10"));
+	cache.store(keys.back(), data, kResultSize);
+	cache.trim(true);
+
+	EXPECT_TRUE (Common::ScopedPtr<Common::SeekableReadStream>(cache.find(keys[0])));
+	EXPECT_FALSE(Common::ScopedPtr<Common::SeekableReadStream>(cache.find(keys[1])));
+	EXPECT_FALSE(Common::ScopedPtr<Common::SeekableReadStream>(cache.find(keys[2])));
+	for (size_t i = 3; i < 11; i++)
+		EXPECT_TRUE(Common::ScopedPtr<Common::SeekableReadStream>(cache.find(keys[i]))) << i;
+}
+
+GTEST_TEST_F(ResultCache, storeTooLarge) {
+	Common::ResultCache cache(kDirectoryPath.generic_string(), 100);
+
+	byte data[26] = { 0 };
+
+	const Common::UString key = makeKey("1");
+	cache.store(key, data, sizeof(data));
+
+	EXPECT_FALSE(Common::ScopedPtr<Common::SeekableReadStream>(cache.find(key)));
+}
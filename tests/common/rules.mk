@@ -162,6 +162,36 @@ tests_common_test_filepath_SOURCES  = tests/common/filepath.cpp
 tests_common_test_filepath_LDADD    = $(common_LIBS)
 tests_common_test_filepath_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                        += tests/common/test_resultcache
+tests_common_test_resultcache_SOURCES  = tests/common/resultcache.cpp
+tests_common_test_resultcache_LDADD    = $(common_LIBS)
+tests_common_test_resultcache_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                     += tests/common/test_byteswap
+tests_common_test_byteswap_SOURCES  = tests/common/byteswap.cpp
+tests_common_test_byteswap_LDADD    = $(common_LIBS)
+tests_common_test_byteswap_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                        += tests/common/test_memoryarena
+tests_common_test_memoryarena_SOURCES  = tests/common/memoryarena.cpp
+tests_common_test_memoryarena_LDADD    = $(common_LIBS)
+tests_common_test_memoryarena_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                     += tests/common/test_parallel
+tests_common_test_parallel_SOURCES  = tests/common/parallel.cpp
+tests_common_test_parallel_LDADD    = $(common_LIBS)
+tests_common_test_parallel_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                         += tests/common/test_boundedqueue
+tests_common_test_boundedqueue_SOURCES  = tests/common/boundedqueue.cpp
+tests_common_test_boundedqueue_LDADD    = $(common_LIBS)
+tests_common_test_boundedqueue_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                  += tests/common/test_trace
+tests_common_test_trace_SOURCES  = tests/common/trace.cpp
+tests_common_test_trace_LDADD    = $(common_LIBS)
+tests_common_test_trace_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                 += tests/common/test_hash
 tests_common_test_hash_SOURCES  = tests/common/hash.cpp
 tests_common_test_hash_LDADD    = $(common_LIBS)
@@ -172,11 +202,21 @@ tests_common_test_md5_SOURCES  = tests/common/md5.cpp
 tests_common_test_md5_LDADD    = $(common_LIBS)
 tests_common_test_md5_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                  += tests/common/test_crc32
+tests_common_test_crc32_SOURCES  = tests/common/crc32.cpp
+tests_common_test_crc32_LDADD    = $(common_LIBS)
+tests_common_test_crc32_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/common/test_deflate
 tests_common_test_deflate_SOURCES  = tests/common/deflate.cpp
 tests_common_test_deflate_LDADD    = $(common_LIBS)
 tests_common_test_deflate_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                 += tests/common/test_gzip
+tests_common_test_gzip_SOURCES  = tests/common/gzip.cpp
+tests_common_test_gzip_LDADD    = $(common_LIBS)
+tests_common_test_gzip_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/common/test_zipfile
 tests_common_test_zipfile_SOURCES  = tests/common/zipfile.cpp
 tests_common_test_zipfile_LDADD    = $(common_LIBS)
@@ -108,6 +108,30 @@ GTEST_TEST_F(ScopedPtr, release) {
 	EXPECT_EQ(kDestructorCalled , 1);
 }
 
+GTEST_TEST_F(ScopedPtr, move) {
+	Common::ScopedPtr<TestClass> scopedPtr1(new TestClass);
+	TestClass *ptr = scopedPtr1.get();
+
+	Common::ScopedPtr<TestClass> scopedPtr2(std::move(scopedPtr1));
+
+	EXPECT_EQ(scopedPtr1.get(), static_cast<TestClass *>(0));
+	EXPECT_EQ(scopedPtr2.get(), ptr);
+
+	Common::ScopedPtr<TestClass> scopedPtr3(new TestClass);
+	scopedPtr3 = std::move(scopedPtr2);
+
+	EXPECT_EQ(scopedPtr2.get(), static_cast<TestClass *>(0));
+	EXPECT_EQ(scopedPtr3.get(), ptr);
+
+	EXPECT_EQ(kConstructorCalled, 2);
+	EXPECT_EQ(kDestructorCalled , 1);
+
+	scopedPtr3.reset();
+
+	EXPECT_EQ(kConstructorCalled, 2);
+	EXPECT_EQ(kDestructorCalled , 2);
+}
+
 GTEST_TEST_F(ScopedPtr, castBool) {
 	Common::ScopedPtr<TestClass> scopedPtr;
 	EXPECT_FALSE((bool) scopedPtr);
@@ -223,6 +247,20 @@ GTEST_TEST_F(ScopedArray, release) {
 	EXPECT_EQ(kDestructorCalled , 5);
 }
 
+GTEST_TEST_F(ScopedArray, move) {
+	Common::ScopedArray<TestClass> scopedArray1(new TestClass[2]);
+	TestClass *ptr = scopedArray1.get();
+
+	Common::ScopedArray<TestClass> scopedArray2;
+	scopedArray2 = std::move(scopedArray1);
+
+	EXPECT_EQ(scopedArray1.get(), static_cast<TestClass *>(0));
+	EXPECT_EQ(scopedArray2.get(), ptr);
+
+	EXPECT_EQ(kConstructorCalled, 2);
+	EXPECT_EQ(kDestructorCalled , 0);
+}
+
 GTEST_TEST_F(ScopedArray, castBool) {
 	Common::ScopedArray<TestClass> scopedArray;
 	EXPECT_FALSE((bool) scopedArray);
@@ -0,0 +1,119 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our tracing helpers.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "src/common/trace.h"
+#include "src/common/parallel.h"
+#include "src/common/memwritestream.h"
+
+static Common::UString writeTrace() {
+	Common::MemoryWriteStreamDynamic stream(true);
+	Common::Tracer::write(stream);
+
+	stream.writeByte('\0');
+
+	return Common::UString(reinterpret_cast<const char *>(stream.getData()));
+}
+
+GTEST_TEST(Trace, disabled) {
+	Common::Tracer::stop();
+	Common::Tracer::clear();
+
+	{
+		XOREOS_TRACE_SPAN("test", "disabled");
+	}
+
+	EXPECT_EQ(Common::Tracer::getSpanCount(), 0);
+}
+
+GTEST_TEST(Trace, enabled) {
+	Common::Tracer::clear();
+	Common::Tracer::start();
+
+	{
+		XOREOS_TRACE_SPAN("test", "outer");
+
+		{
+			XOREOS_TRACE_SPAN("test", "inner");
+		}
+	}
+
+	Common::Tracer::stop();
+
+	{
+		XOREOS_TRACE_SPAN("test", "stopped");
+	}
+
+	EXPECT_EQ(Common::Tracer::getSpanCount(), 2);
+
+	const Common::UString trace = writeTrace();
+
+	EXPECT_TRUE(trace.beginsWith("{\"traceEvents\":["));
+	EXPECT_TRUE(trace.contains("{\"name\":\"inner\",\"cat\":\"test\",\"ph\":\"X\","));
+	EXPECT_TRUE(trace.contains("{\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\","));
+	EXPECT_FALSE(trace.contains("stopped"));
+	EXPECT_TRUE(trace.endsWith("],\"displayTimeUnit\":\"ms\"}\n"));
+
+	Common::Tracer::clear();
+	EXPECT_EQ(Common::Tracer::getSpanCount(), 0);
+}
+
+GTEST_TEST(Trace, escape) {
+	Common::Tracer::clear();
+	Common::Tracer::start();
+
+	Common::Tracer::addSpan("test", "\"quoted\\\"", 10, 15);
+
+	Common::Tracer::stop();
+
+	const Common::UString trace = writeTrace();
+
+	EXPECT_TRUE(trace.contains("{\"name\":\"\\\"quoted\\\\\\\"\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":10,\"dur\":5,"));
+
+	Common::Tracer::clear();
+}
+
+class TraceJob : public Common::ParallelJob {
+public:
+	void run(size_t UNUSED(index)) {
+		XOREOS_TRACE_SPAN("test", "job");
+	}
+};
+
+GTEST_TEST(Trace, threads) {
+	Common::Tracer::clear();
+	Common::Tracer::start();
+
+	TraceJob job;
+	Common::parallelFor(100, job, 4);
+
+	Common::Tracer::stop();
+
+	EXPECT_EQ(Common::Tracer::getSpanCount(), 100);
+
+	Common::Tracer::clear();
+}
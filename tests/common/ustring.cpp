@@ -554,3 +554,50 @@ GTEST_TEST(UString, append) {
 
 	EXPECT_STREQ(str.c_str(), "Foobar Barfoo Quux");
 }
+
+GTEST_TEST(UString, constructorMove) {
+	Common::UString str1("F\xC3\xB6\xC3\xB6" "bar");
+	Common::UString str2(std::move(str1));
+
+	EXPECT_STREQ(str2.c_str(), "F\xC3\xB6\xC3\xB6" "bar");
+	EXPECT_EQ(str2.size(), 6);
+
+	EXPECT_TRUE(str1.empty());
+	EXPECT_EQ(str1.size(), 0);
+}
+
+GTEST_TEST(UString, assignMove) {
+	Common::UString str1("F\xC3\xB6\xC3\xB6" "bar");
+	Common::UString str2("Barfoo");
+
+	str2 = std::move(str1);
+
+	EXPECT_STREQ(str2.c_str(), "F\xC3\xB6\xC3\xB6" "bar");
+	EXPECT_EQ(str2.size(), 6);
+
+	EXPECT_TRUE(str1.empty());
+	EXPECT_EQ(str1.size(), 0);
+
+	std::string str3("F\xC3\xB6\xC3\xB6");
+	str2 = std::move(str3);
+
+	EXPECT_STREQ(str2.c_str(), "F\xC3\xB6\xC3\xB6");
+	EXPECT_EQ(str2.size(), 3);
+}
+
+GTEST_TEST(UString, concatenateTemporary) {
+	const Common::UString str = Common::UString("Foo") + "bar" + Common::UString("Quux") + (uint32) '!';
+
+	EXPECT_STREQ(str.c_str(), "FoobarQuux!");
+	EXPECT_EQ(str.size(), 11);
+}
+
+GTEST_TEST(UString, appendFormat) {
+	Common::UString str("Foo");
+
+	str.appendFormat("%d%s", 23, "bar");
+	str.appendFormat("%c", 'x');
+
+	EXPECT_STREQ(str.c_str(), "Foo23barx");
+	EXPECT_EQ(str.size(), 9);
+}
@@ -22,11 +22,16 @@
  *  Unit tests for our ZIP file reader.
  */
 
+#include <cstring>
+
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/zipfile.h"
 #include "src/common/memreadstream.h"
 #include "src/common/error.h"
+#include "src/common/scopedptr.h"
 
 // Percy Bysshe Shelley's "Ozymandias"
 static const char *kDataUncompressed =
@@ -124,3 +129,34 @@ GTEST_TEST(ZIPFile, brokenZIP) {
 
 	EXPECT_THROW(Common::ZipFile zip(stream), Common::Exception);
 }
+
+GTEST_TEST(ZIPFile, unpackFile) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kDataCompressed);
+	const Common::ZipFile zip(stream);
+
+	Common::MemoryReadStream *packed = zip.getPackedFile(0);
+	ASSERT_NE(packed, static_cast<Common::MemoryReadStream *>(0));
+
+	EXPECT_EQ(packed->size(), 0x177);
+
+	Common::ScopedPtr<Common::SeekableReadStream> file(zip.unpackFile(0, packed));
+	ASSERT_TRUE(file);
+
+	ASSERT_EQ(file->size(), strlen(kDataUncompressed));
+
+	for (size_t i = 0; i < strlen(kDataUncompressed); i++)
+		EXPECT_EQ(file->readByte(), kDataUncompressed[i]) << "At index " << i;
+}
+
+GTEST_TEST(ZIPFile, brokenChecksum) {
+	// The CRC-32 in the central directory
+	static const size_t kCRCOffset = 0x1BF + 16;
+
+	std::vector<byte> data(kDataCompressed, kDataCompressed + sizeof(kDataCompressed));
+	data[kCRCOffset] ^= 0xFF;
+
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(&data[0], data.size());
+	const Common::ZipFile zip(stream);
+
+	EXPECT_THROW(Common::ScopedPtr<Common::SeekableReadStream> file(zip.getFile(0)), Common::Exception);
+}
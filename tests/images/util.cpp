@@ -479,3 +479,25 @@ GTEST_TEST(ImagesUtil, deSwizzleOffset) {
 	for (size_t i = 0; i < (kWidth * kHeight); i++)
 		EXPECT_EQ(buffer[i], kSwizzled[i]) << "At index " << i;
 }
+
+GTEST_TEST(ImagesUtil, deSwizzle) {
+	static const uint32 kWidth = 4, kHeight = 4, kBPP = 2;
+	static const uint32 kSwizzled[kWidth * kHeight] = {
+		 0,  1,  4,  5,
+		 2,  3,  6,  7,
+		 8,  9, 12, 13,
+		10, 11, 14, 15,
+	};
+
+	byte src[kWidth * kHeight * kBPP];
+	for (size_t i = 0; i < sizeof(src); i++)
+		src[i] = i;
+
+	byte dst[kWidth * kHeight * kBPP];
+	Images::deSwizzle(dst, src, kWidth, kHeight, kBPP);
+
+	for (size_t i = 0; i < (kWidth * kHeight); i++) {
+		EXPECT_EQ(dst[i * kBPP + 0], kSwizzled[i] * kBPP + 0) << "At index " << i;
+		EXPECT_EQ(dst[i * kBPP + 1], kSwizzled[i] * kBPP + 1) << "At index " << i;
+	}
+}
@@ -0,0 +1,183 @@
+/* xoreos-tools - Tools to help with xoreos development
+ *
+ * xoreos-tools is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos-tools is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our XML to GFF converter.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/locstring.h"
+#include "src/aurora/gff3file.h"
+#include "src/aurora/gff4file.h"
+
+#include "src/xml/gffcreator.h"
+
+static const char *kXMLGFF3 =
+	"<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\"?>\n"
+	"<gff3 type=\"UTC\">\n"
+	"  <struct id=\"4294967295\">\n"
+	"    <exostring label=\"Tag\">foobar</exostring>\n"
+	"    <double label=\"Double\">2.500000</double>\n"
+	"    <vector label=\"Vector\">\n"
+	"      <double>1.000000</double>\n"
+	"      <double>2.000000</double>\n"
+	"      <double>3.000000</double>\n"
+	"    </vector>\n"
+	"    <orientation label=\"Orientation\">\n"
+	"      <double>4.000000</double>\n"
+	"      <double>5.000000</double>\n"
+	"      <double>6.000000</double>\n"
+	"      <double>7.000000</double>\n"
+	"    </orientation>\n"
+	"    <locstring label=\"Name\" strref=\"4294967295\">\n"
+	"      <string language=\"0\">Foo</string>\n"
+	"      <string language=\"3\">Bar</string>\n"
+	"    </locstring>\n"
+	"  </struct>\n"
+	"</gff3>\n";
+
+static const char *kXMLGFF4 =
+	"<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\"?>\n"
+	"<gff4 type=\"TEST\" version=\"V1.0\" platform=\"PC\" gffversion=\"V4.1\">\n"
+	"  <struct name=\"TOP\">\n"
+	"    <uint32 label=\"1\">23</uint32>\n"
+	"    <string label=\"2\">foobar</string>\n"
+	"    <sint16_list label=\"3\">\n"
+	"      <sint16 index=\"0\">-1</sint16>\n"
+	"      <sint16 index=\"1\">2</sint16>\n"
+	"    </sint16_list>\n"
+	"    <vector3f label=\"4\">\n"
+	"      <float>1.000000</float><float>2.000000</float><float>3.000000</float>\n"
+	"    </vector3f>\n"
+	"    <struct name=\"ITEM\" label=\"5\" id=\"42\">\n"
+	"      <uint8 label=\"1\">5</uint8>\n"
+	"    </struct>\n"
+	"    <struct_list label=\"6\">\n"
+	"      <struct name=\"ITEM\" index=\"0\" ref_id=\"42\"/>\n"
+	"      <struct name=\"\" index=\"1\"/>\n"
+	"    </struct_list>\n"
+	"    <generic label=\"7\">\n"
+	"      <string label=\"0\">barfoo</string>\n"
+	"    </generic>\n"
+	"  </struct>\n"
+	"</gff4>\n";
+
+static Aurora::GFF3File *createGFF3(const char *xml) {
+	Common::MemoryReadStream input(xml);
+	Common::MemoryWriteStreamDynamic output(true);
+
+	XML::GFFCreator::create(output, input, "test.xml");
+	output.setDisposable(false);
+
+	return new Aurora::GFF3File(new Common::MemoryReadStream(output.getData(), output.size(), true));
+}
+
+GTEST_TEST(GFFCreator, createGFF3) {
+	Common::ScopedPtr<Aurora::GFF3File> gff3(createGFF3(kXMLGFF3));
+	const Aurora::GFF3Struct &top = gff3->getTopLevel();
+
+	EXPECT_STREQ(top.getString("Tag").c_str(), "foobar");
+	EXPECT_DOUBLE_EQ(top.getDouble("Double"), 2.5);
+}
+
+GTEST_TEST(GFFCreator, createGFF3Vector) {
+	Common::ScopedPtr<Aurora::GFF3File> gff3(createGFF3(kXMLGFF3));
+	const Aurora::GFF3Struct &top = gff3->getTopLevel();
+
+	float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+
+	top.getVector("Vector", x, y, z);
+	EXPECT_FLOAT_EQ(x, 1.0f);
+	EXPECT_FLOAT_EQ(y, 2.0f);
+	EXPECT_FLOAT_EQ(z, 3.0f);
+
+	top.getOrientation("Orientation", x, y, z, w);
+	EXPECT_FLOAT_EQ(x, 4.0f);
+	EXPECT_FLOAT_EQ(y, 5.0f);
+	EXPECT_FLOAT_EQ(z, 6.0f);
+	EXPECT_FLOAT_EQ(w, 7.0f);
+}
+
+GTEST_TEST(GFFCreator, createGFF3LocString) {
+	Common::ScopedPtr<Aurora::GFF3File> gff3(createGFF3(kXMLGFF3));
+
+	Aurora::LocString locString;
+	ASSERT_TRUE(gff3->getTopLevel().getLocString("Name", locString));
+
+	std::vector<Aurora::LocString::SubLocString> strings;
+	locString.getStrings(strings);
+
+	ASSERT_EQ(strings.size(), 2);
+
+	EXPECT_EQ(strings[0].language, 0);
+	EXPECT_STREQ(strings[0].str.c_str(), "Foo");
+	EXPECT_EQ(strings[1].language, 3);
+	EXPECT_STREQ(strings[1].str.c_str(), "Bar");
+}
+
+GTEST_TEST(GFFCreator, createGFF4) {
+	Common::MemoryReadStream input(kXMLGFF4);
+	Common::MemoryWriteStreamDynamic output(true);
+
+	XML::GFFCreator::create(output, input, "test.xml");
+	output.setDisposable(false);
+
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(output.getData(), output.size(), true));
+	const Aurora::GFF4Struct &top = gff4.getTopLevel();
+
+	EXPECT_EQ(gff4.getType(), MKTAG('T', 'E', 'S', 'T'));
+	EXPECT_EQ(gff4.getVersion(), MKTAG('V', '4', '.', '1'));
+	EXPECT_EQ(top.getLabel(), MKTAG('T', 'O', 'P', ' '));
+
+	EXPECT_EQ(top.getUint(1), 23);
+	EXPECT_STREQ(top.getString(2).c_str(), "foobar");
+
+	std::vector<int64> ints;
+	ASSERT_TRUE(top.getSint(3, ints));
+	ASSERT_EQ(ints.size(), 2);
+	EXPECT_EQ(ints[0], -1);
+	EXPECT_EQ(ints[1], 2);
+
+	std::vector<float> vector;
+	ASSERT_TRUE(top.getVectorMatrix(4, vector));
+	ASSERT_EQ(vector.size(), 3);
+	EXPECT_FLOAT_EQ(vector[2], 3.0f);
+
+	const Aurora::GFF4Struct *item = top.getStruct(5);
+	ASSERT_NE(item, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_EQ(item->getUint(1), 5);
+	EXPECT_EQ(item->getRefCount(), 2);
+
+	const Aurora::GFF4List &list = top.getList(6);
+	ASSERT_EQ(list.size(), 2);
+	EXPECT_EQ(list[0], item);
+	EXPECT_EQ(list[1], static_cast<const Aurora::GFF4Struct *>(0));
+
+	const Aurora::GFF4Struct *generic = top.getGeneric(7);
+	ASSERT_NE(generic, static_cast<const Aurora::GFF4Struct *>(0));
+	EXPECT_STREQ(generic->getString(0).c_str(), "barfoo");
+}
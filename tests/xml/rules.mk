@@ -31,3 +31,8 @@ check_PROGRAMS                   += tests/xml/test_xmlparser
 tests_xml_test_xmlparser_SOURCES  = tests/xml/xmlparser.cpp
 tests_xml_test_xmlparser_LDADD    = $(xml_LIBS)
 tests_xml_test_xmlparser_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/xml/test_gffcreator
+tests_xml_test_gffcreator_SOURCES  = tests/xml/gffcreator.cpp
+tests_xml_test_gffcreator_LDADD    = $(xml_LIBS)
+tests_xml_test_gffcreator_CXXFLAGS = $(test_CXXFLAGS)